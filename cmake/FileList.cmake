@@ -1,6 +1,7 @@
 set(DUNEDYNASTY_SRC_FILES
 	src/ai.c
 	src/animation.c
+	src/arena.c
 	src/audio/adl/fmopl.cpp
 	src/audio/adl/opl_dosbox.cpp
 	src/audio/adl/opl_mame.cpp
@@ -10,8 +11,12 @@ set(DUNEDYNASTY_SRC_FILES
 	src/audio/mt32mpu.c
 	src/binheap.c
 	src/buildqueue.c
+	src/catalogue.c
+	src/codec/digram.c
 	src/codec/format40.c
 	src/codec/format80.c
+	src/codec/image.c
+	src/codec/voc.c
 	src/common_a5.c
 	src/config_a5.c
 	src/crashlog/crashlog_none.c
@@ -19,6 +24,7 @@ set(DUNEDYNASTY_SRC_FILES
 	src/enhancement.c
 	src/explosion.c
 	src/file.c
+	src/gamecontext.c
 	src/gameloop.c
 	src/gfx.c
 	src/gui/font.c
@@ -29,6 +35,7 @@ set(DUNEDYNASTY_SRC_FILES
 	src/gui/widget_click.c
 	src/gui/widget_draw.c
 	src/house.c
+	src/influence.c
 	src/ini.c
 	src/input/input_a5.c
 	src/input/input_dd.c
@@ -43,6 +50,8 @@ set(DUNEDYNASTY_SRC_FILES
 	src/net/message.c
 	src/net/net_enet.c
 	src/net/server.c
+	src/net/telemetry.c
+	src/net/tiledelta.c
 	src/newui/actionpanel.c
 	src/newui/chatbox.c
 	src/newui/editbox.c
@@ -64,6 +73,7 @@ set(DUNEDYNASTY_SRC_FILES
 	src/pool/pool_structure.c
 	src/pool/pool_team.c
 	src/pool/pool_unit.c
+	src/replay.c
 	src/save.c
 	src/saveload/house.c
 	src/saveload/info.c
@@ -82,6 +92,7 @@ set(DUNEDYNASTY_SRC_FILES
 	src/script/team.c
 	src/script/unit.c
 	src/shape.c
+	src/snapshot.c
 	src/sprites.c
 	src/string.c
 	src/structure.c
@@ -105,6 +116,7 @@ set(DUNEDYNASTY_SRC_FILES
 	src/tile.c
 	src/timer/timer.c
 	src/timer/timer_a5.c
+	src/timer/timerwheel.c
 	src/tools/coord.c
 	src/tools/encoded_index.c
 	src/tools/orientation.c
@@ -113,6 +125,7 @@ set(DUNEDYNASTY_SRC_FILES
 	src/tools/random_starport.c
 	src/tools/random_xorshift.c
 	src/unit.c
+	src/video/atlascache_a5.c
 	src/video/prim_a5.c
 	src/video/video_a5.c
 	src/wsa.c
@@ -150,6 +163,19 @@ if(WITH_AUD)
 	${DUNEDYNASTY_SRC_FILES} src/audio/audlib/audlib_a5.c)
 endif(WITH_AUD)
 
+if(WITH_PROFILER)
+    set(DUNEDYNASTY_SRC_FILES
+	${DUNEDYNASTY_SRC_FILES} src/profile.c)
+endif(WITH_PROFILER)
+
+if(WITH_SOFTWARE_VIDEO)
+    set(DUNEDYNASTY_SRC_FILES
+	${DUNEDYNASTY_SRC_FILES}
+	src/video/video_soft.c
+	src/video/video_soft_a5.c
+	)
+endif(WITH_SOFTWARE_VIDEO)
+
 if(WIN32)
     set(DUNEDYNASTY_SRC_FILES
 	${DUNEDYNASTY_SRC_FILES} src/crashlog/errorlog_win32.c)
@@ -158,6 +184,100 @@ else(WIN32)
 	${DUNEDYNASTY_SRC_FILES} src/crashlog/errorlog_std.c)
 endif(WIN32)
 
+# The dedicated server: the simulation without Allegro, plus client_none.c
+# standing in for the interface.
+set(DUNEDYNASTY_SERVER_SRC_FILES
+	src/ai.c
+	src/animation.c
+	src/arena.c
+	src/binheap.c
+	src/buildqueue.c
+	src/client_none.c
+	src/codec/digram.c
+	src/codec/format40.c
+	src/codec/format80.c
+	src/codec/image.c
+	src/crashlog/errorlog_std.c
+	src/dedicated.c
+	src/enhancement.c
+	src/explosion.c
+	src/file.c
+	src/gamecontext.c
+	src/gfx.c
+	src/house.c
+	src/influence.c
+	src/ini.c
+	src/load.c
+	src/map.c
+	src/mods/landscape.c
+	src/mods/mapgenerator.c
+	src/mods/multiplayer.c
+	src/mods/skirmish.c
+	src/net/client.c
+	src/net/message.c
+	src/net/net_enet.c
+	src/net/server.c
+	src/net/telemetry.c
+	src/net/tiledelta.c
+	src/object.c
+	src/opendune.c
+	src/os/endian.c
+	src/pool/pool_house.c
+	src/pool/pool_structure.c
+	src/pool/pool_team.c
+	src/pool/pool_unit.c
+	src/replay.c
+	src/saveload/house.c
+	src/saveload/info.c
+	src/saveload/map.c
+	src/saveload/object.c
+	src/saveload/saveload.c
+	src/saveload/scenario.c
+	src/saveload/scriptengine.c
+	src/saveload/structure.c
+	src/saveload/team.c
+	src/saveload/unit.c
+	src/scenario.c
+	src/script/general.c
+	src/script/script.c
+	src/script/structure.c
+	src/script/team.c
+	src/script/unit.c
+	src/snapshot.c
+	src/sprites.c
+	src/string.c
+	src/structure.c
+	src/table/animation.c
+	src/table/explosion.c
+	src/table/fileinfo.c
+	src/table/houseanimation.c
+	src/table/houseinfo.c
+	src/table/landscapeinfo.c
+	src/table/locale.c
+	src/table/selectiontype.c
+	src/table/sound.c
+	src/table/structureinfo.c
+	src/table/teamaction.c
+	src/table/tilediff.c
+	src/table/unitinfo.c
+	src/table/widget.c
+	src/table/widgetinfo.c
+	src/table/windowdesc.c
+	src/team.c
+	src/tile.c
+	src/timer/timer.c
+	src/timer/timer_posix.c
+	src/timer/timerwheel.c
+	src/tools/coord.c
+	src/tools/encoded_index.c
+	src/tools/orientation.c
+	src/tools/random_general.c
+	src/tools/random_lcg.c
+	src/tools/random_starport.c
+	src/tools/random_xorshift.c
+	src/unit.c
+	)
+
 set(OPENDUNE_UNUSED_SRC_FILES
 	src/audio/driver.c
 	src/audio/sound.c
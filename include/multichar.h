@@ -33,6 +33,7 @@ enum {
 	CC_DDH2 = FOURCC('D','D','H','2'), /* Dune Dynasty House 2. */
 	CC_DDI2 = FOURCC('D','D','I','2'), /* Dune Dynasty Info 2 (multiple selection). */
 	CC_DDM2 = FOURCC('D','D','M','2'), /* Dune Dynasty Map 2 (fog of war). */
+	CC_DDRP = FOURCC('D','D','R','P'), /* Dune Dynasty Replay. */
 	CC_DDS2 = FOURCC('D','D','S','2'), /* Dune Dynasty Scenario 2 (skirmish alliances). */
 	CC_DDS3 = FOURCC('D','D','S','3'), /* Dune Dynasty Scenario 3 (stats). */
 	CC_DDU2 = FOURCC('D','D','U','2'), /* Dune Dynasty Unit 2. */
@@ -62,6 +62,24 @@
 	#define PACK __attribute__((packed))
 #endif /* __GNUC__ / _MSC_VER / __TINYC__ */
 
+/* Per thread in every build.  Only for the few variables that say which
+ *  game a thread works on: the client writes background saves from a
+ *  copy of the game on a thread of their own. */
+#if defined(_MSC_VER)
+	#define THREAD_STORAGE __declspec(thread)
+#else
+	#define THREAD_STORAGE __thread
+#endif
+
+/* The dedicated server runs each match on its own thread, so the
+ *  state of a match is kept per thread there.  The client has only the
+ *  one match. */
+#if defined(DEDICATED_SERVER)
+	#define THREAD_LOCAL THREAD_STORAGE
+#else
+	#define THREAD_LOCAL
+#endif /* DEDICATED_SERVER */
+
 /* Compile time assertions. Prefer c++0x static_assert() */
 #if defined(__STDCXX_VERSION__) || defined(__GXX_EXPERIMENTAL_CXX0X__) || defined(__GXX_EXPERIMENTAL_CPP0X__) || defined(static_assert)
 	/* __STDCXX_VERSION__ is c++0x feature macro, __GXX_EXPERIMENTAL_CXX0X__ is used by gcc, __GXX_EXPERIMENTAL_CPP0X__ by icc */
@@ -5,11 +5,14 @@
 
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 #include "os/math.h"
 
 #include "ai.h"
 
 #include "enhancement.h"
+#include "gamecontext.h"
+#include "influence.h"
 #include "map.h"
 #include "pool/pool.h"
 #include "pool/pool_house.h"
@@ -31,49 +34,6 @@
 # define M_PI (3.14159265358979323846)
 #endif
 
-enum AISquadPlanID {
-	AISQUAD_DIRECT_A,
-	AISQUAD_DIRECT_B,
-	AISQUAD_DIRECT_C,
-	AISQUAD_DIRECT_D,
-	AISQUAD_ENCIRCLE_A, /* 45 */
-	AISQUAD_ENCIRCLE_B,
-
-	AISQUAD_FLANK_A,    /* 45, 90 */
-	AISQUAD_FLANK_B,
-	AISQUAD_135_A,      /* 45, 90, 135 */
-	AISQUAD_135_B,
-	AISQUAD_BACKSTAB_A, /* 60, 120, 180 */
-	AISQUAD_BACKSTAB_B,
-
-	NUM_AISQUAD_ATTACK_PLANS
-};
-
-enum AISquadState {
-	AISQUAD_RECRUITING,
-	AISQUAD_ASSEMBLE_SQUAD,
-	AISQUAD_DETOUR1,
-	AISQUAD_DETOUR2,
-	AISQUAD_DETOUR3,
-	AISQUAD_BATTLE_FORMATION,
-	AISQUAD_CHARGE,
-	AISQUAD_DISBAND
-};
-
-typedef struct AISquad {
-	enum SquadID aiSquad;
-	enum AISquadPlanID plan;
-	enum AISquadState state;
-	enum HouseType houseID;
-	int num_members;
-	int max_members;
-	uint16 waypoint[5];
-	uint16 target;
-
-	int64_t recruitment_timeout;
-	int64_t formation_timeout;
-} AISquad;
-
 typedef struct AISquadPlan {
 	float distance1, angle1;
 	float distance2, angle2;
@@ -97,8 +57,6 @@ static const AISquadPlan aisquad_attack_plan[NUM_AISQUAD_ATTACK_PLANS] = {
 	{ 32.0f, -60.0f, 24.0f, -120.0f, 12.0f, -180.0f }
 };
 
-static AISquad s_aisquad[SQUADID_MAX + 1];
-
 static int UnitAI_CountUnits(enum HouseType houseID, enum UnitType unit_type);
 static Unit *UnitAI_SquadFindNext(PoolFindStruct *find, const AISquad *squad);
 
@@ -148,6 +106,10 @@ StructureAI_ShouldBuildHarvesters(enum HouseType houseID)
 	if (harvester_count == 0)
 		return false;
 
+	/* Nothing left to harvest. */
+	if (Influence_GetTotalSpice() == 0)
+		return false;
+
 	const int refinery_count = StructureAI_CountStructures(houseID, STRUCTURE_REFINERY);
 	const int optimal_harvester_count =
 		(refinery_count == 0) ? 0 :
@@ -408,6 +370,9 @@ UnitAI_GetAnyEnemyInRange(const Unit *unit)
 	const int dist = max(4, ui->fireDistance);
 	PoolFindStruct find;
 
+	if (!Influence_AnyEnemyNear(houseID, Tile_PackTile(unit->o.position), dist))
+		return 0;
+
 	for (const Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
 			u != NULL;
 			u = Unit_FindNext(&find)) {
@@ -481,8 +446,8 @@ UnitAI_CountUnits(enum HouseType houseID, enum UnitType unit_type)
 		unit_count = h->harvestersIncoming;
 
 	/* Count units, including units in production and units deviated. */
-	for (int i = 0; i < g_unitFindCount; i++) {
-		Unit *u = g_unitFindArray[i];
+	for (int i = 0; i < g_game->unitFindCount; i++) {
+		Unit *u = g_game->unitFindArray[i];
 
 		if (u == NULL)
 			continue;
@@ -540,19 +505,51 @@ void
 UnitAI_ClearSquads(void)
 {
 	for (enum SquadID aiSquad = SQUADID_1; aiSquad <= SQUADID_MAX; aiSquad++) {
-		s_aisquad[aiSquad].num_members = 0;
+		g_game->aisquad[aiSquad].num_members = 0;
 	}
 }
 
 static void
 UnitAI_ClampWaypoint(int *x, int *y)
 {
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 
 	*x = clamp(mapInfo->minX, *x, mapInfo->minX + mapInfo->sizeX - 1);
 	*y = clamp(mapInfo->minY, *y, mapInfo->minY + mapInfo->sizeY - 1);
 }
 
+static void
+UnitAI_SquadPlanDetours(const AISquadPlan *plan, int targetx, int targety, float theta, int detourx[3], int detoury[3])
+{
+	const float distance[3] = { plan->distance1, plan->distance2, plan->distance3 };
+	const float angle[3] = { plan->angle1, plan->angle2, plan->angle3 };
+
+	for (int i = 0; i < 3; i++) {
+		detourx[i] = targetx + distance[i] * cos(theta + angle[i] * M_PI / 180.0f);
+		detoury[i] = targety - distance[i] * sin(theta + angle[i] * M_PI / 180.0f);
+		UnitAI_ClampWaypoint(&detourx[i], &detoury[i]);
+	}
+}
+
+static int
+UnitAI_SquadPlanThreat(enum HouseType houseID, uint16 origin, const int detourx[3], const int detoury[3])
+{
+	uint16 from = origin;
+	int threat = 0;
+
+	/* The assault itself is the same for every plan; only the
+	 * approach differs.
+	 */
+	for (int i = 0; i < 3; i++) {
+		const uint16 to = Tile_PackXY(detourx[i], detoury[i]);
+
+		threat += Influence_GetThreatAlongPath(houseID, from, to);
+		from = to;
+	}
+
+	return threat;
+}
+
 static void
 UnitAI_SquadPlotWaypoints(AISquad *squad, Unit *unit, uint16 target_encoded)
 {
@@ -568,39 +565,50 @@ UnitAI_SquadPlotWaypoints(AISquad *squad, Unit *unit, uint16 target_encoded)
 	float dy = targety - originy;
 	float theta = atan2f(dy, dx);
 
-	const int planID = Tools_RandomLCG_Range(0, NUM_AISQUAD_ATTACK_PLANS - 1);
-	const AISquadPlan *plan = &aisquad_attack_plan[planID];
+	int planID = Tools_RandomLCG_Range(0, NUM_AISQUAD_ATTACK_PLANS - 1);
+	int detourx[3], detoury[3];
+
+	/* Starting from a random plan, take the one whose approach
+	 * passes the fewest enemy defences.
+	 */
+	UnitAI_SquadPlanDetours(&aisquad_attack_plan[planID], targetx, targety, theta, detourx, detoury);
+	int best_threat = UnitAI_SquadPlanThreat(squad->houseID, origin, detourx, detoury);
+
+	for (int i = 1; i < NUM_AISQUAD_ATTACK_PLANS && best_threat > 0; i++) {
+		const int id = (planID + i) % NUM_AISQUAD_ATTACK_PLANS;
+		int x[3], y[3];
 
-	int detourx1 = targetx + plan->distance1 * cos(theta + plan->angle1 * M_PI / 180.0f);
-	int detoury1 = targety - plan->distance1 * sin(theta + plan->angle1 * M_PI / 180.0f);
-	int detourx2 = targetx + plan->distance2 * cos(theta + plan->angle2 * M_PI / 180.0f);
-	int detoury2 = targety - plan->distance2 * sin(theta + plan->angle2 * M_PI / 180.0f);
-	int detourx3 = targetx + plan->distance3 * cos(theta + plan->angle3 * M_PI / 180.0f);
-	int detoury3 = targety - plan->distance3 * sin(theta + plan->angle3 * M_PI / 180.0f);
+		UnitAI_SquadPlanDetours(&aisquad_attack_plan[id], targetx, targety, theta, x, y);
+
+		const int threat = UnitAI_SquadPlanThreat(squad->houseID, origin, x, y);
+		if (threat < best_threat) {
+			planID = id;
+			best_threat = threat;
+			memcpy(detourx, x, sizeof(x));
+			memcpy(detoury, y, sizeof(y));
+		}
+	}
 
 	/* Try to disperse to not clog up the factory. */
 	originx += Tools_RandomLCG_Range(0, 9) - 5;
 	originy += Tools_RandomLCG_Range(0, 9) - 5;
 
 	UnitAI_ClampWaypoint(&originx, &originy);
-	UnitAI_ClampWaypoint(&detourx1, &detoury1);
-	UnitAI_ClampWaypoint(&detourx2, &detoury2);
-	UnitAI_ClampWaypoint(&detourx3, &detoury3);
 
 	squad->plan = planID;
 
 	/* Assemble here before the operation. */
 	squad->waypoint[0] = Tile_PackXY(originx, originy);
 
-	if (g_map[squad->waypoint[0]].hasStructure)
+	if (g_game->map[squad->waypoint[0]].hasStructure)
 		squad->waypoint[0] = Tile_PackTile(unit->o.position);
 
 	squad->waypoint[1] = squad->waypoint[0];
 
 	/* Detours. */
-	squad->waypoint[2] = Tile_PackXY(detourx1, detoury1);
-	squad->waypoint[3] = Tile_PackXY(detourx2, detoury2);
-	squad->waypoint[4] = Tile_PackXY(detourx3, detoury3);
+	squad->waypoint[2] = Tile_PackXY(detourx[0], detoury[0]);
+	squad->waypoint[3] = Tile_PackXY(detourx[1], detoury[1]);
+	squad->waypoint[4] = Tile_PackXY(detourx[2], detoury[2]);
 
 	squad->target = target_encoded;
 }
@@ -649,7 +657,7 @@ UnitAI_AssignSquad(Unit *unit, uint16 destination)
 
 	/* Consider joining a squad. */
 	for (enum SquadID aiSquad = SQUADID_1; aiSquad <= SQUADID_MAX; aiSquad++) {
-		AISquad *squad = &s_aisquad[aiSquad];
+		AISquad *squad = &g_game->aisquad[aiSquad];
 
 		/* Consider creating a new squad later. */
 		if (squad->num_members == 0) {
@@ -691,7 +699,7 @@ UnitAI_AssignSquad(Unit *unit, uint16 destination)
 
 	/* Create new squad and attack plan. */
 	if (Tools_Random_256() & 0x1) {
-		AISquad *squad = &s_aisquad[emptySquadID];
+		AISquad *squad = &g_game->aisquad[emptySquadID];
 
 		unit->aiSquad = emptySquadID;
 
@@ -702,7 +710,7 @@ UnitAI_AssignSquad(Unit *unit, uint16 destination)
 		squad->max_members = 3;
 
 		/* 60 ticks per second, distance is roughly 30. */
-		squad->recruitment_timeout = g_timerGame + Tools_AdjustToGameSpeed(120 * (distance - 12), 1, 0xFFFF, true);
+		squad->recruitment_timeout = g_game->timerGame + Tools_AdjustToGameSpeed(120 * (distance - 12), 1, 0xFFFF, true);
 		UnitAI_SquadPlotWaypoints(squad, unit, destination);
 	}
 }
@@ -730,7 +738,7 @@ UnitAI_DetachFromSquad(Unit *unit)
 		Unit_Server_SetAction(unit, ACTION_HUNT);
 
 	unit->aiSquad = SQUADID_INVALID;
-	s_aisquad[unit->aiSquad].num_members--;
+	g_game->aisquad[unit->aiSquad].num_members--;
 }
 
 static void
@@ -754,7 +762,7 @@ UnitAI_AbortMission(Unit *unit, uint16 enemy)
 	if (unit->aiSquad == SQUADID_INVALID)
 		return;
 
-	AISquad *squad = &s_aisquad[unit->aiSquad];
+	AISquad *squad = &g_game->aisquad[unit->aiSquad];
 
 	if (enemy != 0) {
 		squad->target = enemy;
@@ -773,7 +781,7 @@ UnitAI_GetSquadDestination(Unit *unit, uint16 destination)
 	if (unit->aiSquad == SQUADID_INVALID)
 		return destination;
 
-	AISquad *squad = &s_aisquad[unit->aiSquad];
+	AISquad *squad = &g_game->aisquad[unit->aiSquad];
 
 	if (squad->state <= AISQUAD_DETOUR3) {
 		return Tools_Index_Encode(squad->waypoint[squad->state], IT_TILE);
@@ -789,7 +797,7 @@ UnitAI_SquadIsInFormation(const AISquad *squad)
 {
 	PoolFindStruct find;
 
-	if (g_timerGame > squad->formation_timeout)
+	if (g_game->timerGame > squad->formation_timeout)
 		return true;
 
 	for (Unit *u = UnitAI_SquadFindFirst(&find, squad);
@@ -889,20 +897,22 @@ UnitAI_ArrangeBattleFormation(AISquad *squad)
 	}
 
 	/* Time to build formation, 60 ticks per second. */
-	squad->formation_timeout = g_timerGame + Tools_AdjustToGameSpeed(60 * 15, 1, 0xFFFF, true);
+	squad->formation_timeout = g_game->timerGame + Tools_AdjustToGameSpeed(60 * 15, 1, 0xFFFF, true);
 }
 
 void
 UnitAI_SquadLoop(void)
 {
+	Influence_Update();
+
 	for (enum SquadID aiSquad = SQUADID_1; aiSquad <= SQUADID_MAX; aiSquad++) {
-		AISquad *squad = &s_aisquad[aiSquad];
+		AISquad *squad = &g_game->aisquad[aiSquad];
 
 		if (squad->num_members == 0)
 			continue;
 
 		if (squad->state == AISQUAD_RECRUITING) {
-			if (g_timerGame > squad->recruitment_timeout)
+			if (g_game->timerGame > squad->recruitment_timeout)
 				squad->state++;
 
 			continue;
@@ -958,13 +968,13 @@ SaveLoad_BrutalAI_RecruitmentTimeout(void *object, uint32 value, bool loading)
 	AISquad *squad = object;
 
 	if (loading) {
-		squad->recruitment_timeout = (value == 0) ? 0 : (g_timerGame + value);
+		squad->recruitment_timeout = (value == 0) ? 0 : (g_game->timerGame + value);
 		return 0;
 	} else {
-		if (squad->recruitment_timeout <= g_timerGame) {
+		if (squad->recruitment_timeout <= g_game->timerGame) {
 			return 0;
 		} else {
-			return squad->recruitment_timeout - g_timerGame;
+			return squad->recruitment_timeout - g_game->timerGame;
 		}
 	}
 }
@@ -975,13 +985,13 @@ SaveLoad_BrutalAI_FormationTimeout(void *object, uint32 value, bool loading)
 	AISquad *squad = object;
 
 	if (loading) {
-		squad->formation_timeout = (value == 0) ? 0 : (g_timerGame + value);
+		squad->formation_timeout = (value == 0) ? 0 : (g_game->timerGame + value);
 		return 0;
 	} else {
-		if (squad->formation_timeout <= g_timerGame) {
+		if (squad->formation_timeout <= g_game->timerGame) {
 			return 0;
 		} else {
-			return squad->formation_timeout - g_timerGame;
+			return squad->formation_timeout - g_game->timerGame;
 		}
 	}
 }
@@ -990,7 +1000,7 @@ bool
 BrutalAI_Load(FILE *fp, uint32 length)
 {
 	for (int i = 0; (i < SQUADID_MAX + 1) && (length > 0); i++) {
-		if (!SaveLoad_Load(s_saveBrutalAISquad, fp, &s_aisquad[i]))
+		if (!SaveLoad_Load(s_saveBrutalAISquad, fp, &g_game->aisquad[i]))
 			return false;
 
 		length -= SaveLoad_GetLength(s_saveBrutalAISquad);
@@ -1003,7 +1013,7 @@ bool
 BrutalAI_Save(FILE *fp)
 {
 	for (int i = 0; i < SQUADID_MAX + 1; i++) {
-		if (!SaveLoad_Save(s_saveBrutalAISquad, fp, &s_aisquad[i]))
+		if (!SaveLoad_Save(s_saveBrutalAISquad, fp, &g_game->aisquad[i]))
 			return false;
 	}
 
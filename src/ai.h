@@ -1,11 +1,55 @@
 #ifndef BRUTAL_AI_H
 #define BRUTAL_AI_H
 
+#include <stdint.h>
 #include <stdio.h>
 #include "house.h"
 #include "structure.h"
 #include "unit.h"
 
+enum AISquadPlanID {
+	AISQUAD_DIRECT_A,
+	AISQUAD_DIRECT_B,
+	AISQUAD_DIRECT_C,
+	AISQUAD_DIRECT_D,
+	AISQUAD_ENCIRCLE_A, /* 45 */
+	AISQUAD_ENCIRCLE_B,
+
+	AISQUAD_FLANK_A,    /* 45, 90 */
+	AISQUAD_FLANK_B,
+	AISQUAD_135_A,      /* 45, 90, 135 */
+	AISQUAD_135_B,
+	AISQUAD_BACKSTAB_A, /* 60, 120, 180 */
+	AISQUAD_BACKSTAB_B,
+
+	NUM_AISQUAD_ATTACK_PLANS
+};
+
+enum AISquadState {
+	AISQUAD_RECRUITING,
+	AISQUAD_ASSEMBLE_SQUAD,
+	AISQUAD_DETOUR1,
+	AISQUAD_DETOUR2,
+	AISQUAD_DETOUR3,
+	AISQUAD_BATTLE_FORMATION,
+	AISQUAD_CHARGE,
+	AISQUAD_DISBAND
+};
+
+typedef struct AISquad {
+	enum SquadID aiSquad;
+	enum AISquadPlanID plan;
+	enum AISquadState state;
+	enum HouseType houseID;
+	int num_members;
+	int max_members;
+	uint16 waypoint[5];
+	uint16 target;
+
+	int64_t recruitment_timeout;
+	int64_t formation_timeout;
+} AISquad;
+
 extern bool AI_IsBrutalAI(enum HouseType houseID);
 
 extern uint16 StructureAI_PickNextToBuild(const Structure *s);
@@ -8,6 +8,7 @@
 #include "animation.h"
 
 #include "binheap.h"
+#include "gamecontext.h"
 #include "map.h"
 #include "net/server.h"
 #include "sprites.h"
@@ -28,7 +29,7 @@ typedef struct Animation {
 	tile32 tile;                            /*!< Top-left tile of Animation. */
 } Animation;
 
-static BinHeap s_animations;
+static THREAD_LOCAL BinHeap s_animations;
 
 /**
  * Stop with this Animation.
@@ -42,18 +43,19 @@ static void Animation_Func_Stop(Animation *animation, int16 parameter)
 	uint16 packed = Tile_PackTile(animation->tile);
 	VARIABLE_NOT_USED(parameter);
 
-	g_map[packed].hasAnimation = false;
+	g_game->map[packed].hasAnimation = false;
 	animation->commands = NULL;
 
 	for (int i = 0; i < layoutTileCount; i++) {
 		uint16 position = packed + (*layout++);
-		Tile *t = &g_map[position];
+		Tile *t = &g_game->map[position];
 
 		if (animation->tileLayout != 0) {
-			t->groundSpriteID = g_mapSpriteID[position];
+			t->groundSpriteID = g_game->mapSpriteID[position];
 		}
 
 		t->overlaySpriteID = 0;
+		Map_MarkDirty(position);
 	}
 }
 
@@ -68,7 +70,7 @@ static void Animation_Func_Abort(Animation *animation, int16 parameter)
 	uint16 packed = Tile_PackTile(animation->tile);
 	VARIABLE_NOT_USED(parameter);
 
-	g_map[packed].hasAnimation = false;
+	g_game->map[packed].hasAnimation = false;
 	animation->commands = NULL;
 }
 
@@ -95,9 +97,10 @@ static void Animation_Func_SetOverlaySprite(Animation *animation, int16 paramete
 	uint16 packed = Tile_PackTile(animation->tile);
 	assert(parameter >= 0);
 
-	Tile *t = &g_map[packed];
+	Tile *t = &g_game->map[packed];
 	t->overlaySpriteID = g_iconMap[g_iconMap[animation->iconGroup] + parameter];
 	t->houseID = animation->houseID;
+	Map_MarkDirty(packed);
 }
 
 /**
@@ -143,12 +146,13 @@ static void Animation_Func_SetGroundSprite(Animation *animation, int16 parameter
 	for (int i = 0; i < layoutTileCount; i++) {
 		uint16 position = packed + (*layout++);
 		uint16 spriteID = *iconMap++;
-		Tile *t = &g_map[position];
+		Tile *t = &g_game->map[position];
 
 		if (t->groundSpriteID == spriteID) continue;
 		t->groundSpriteID = spriteID;
 		t->overlaySpriteID = 0;
 		t->houseID = animation->houseID;
+		Map_MarkDirty(position);
 	}
 }
 
@@ -197,6 +201,16 @@ Animation_Uninit(void)
 	BinHeap_Free(&s_animations);
 }
 
+/**
+ * @brief   The active animations, for snapshots to copy.
+ * @details Introduced.
+ */
+BinHeap *
+Animation_GetHeap(void)
+{
+	return &s_animations;
+}
+
 /**
  * Start an Animation.
  * @param commands List of commands for the Animation.
@@ -219,8 +233,9 @@ void Animation_Start(const AnimationCommandStruct *commands, tile32 tile, uint16
 		animation->commands   = commands;
 		animation->tile       = tile;
 
-		g_map[packed].houseID = houseID;
-		g_map[packed].hasAnimation = true;
+		g_game->map[packed].houseID = houseID;
+		g_game->map[packed].hasAnimation = true;
+		Map_MarkDirty(packed);
 	}
 }
 
@@ -230,7 +245,7 @@ void Animation_Start(const AnimationCommandStruct *commands, tile32 tile, uint16
  */
 void Animation_Stop_ByTile(uint16 packed)
 {
-	if (!g_map[packed].hasAnimation) return;
+	if (!g_game->map[packed].hasAnimation) return;
 
 	for (int i = 1; i < s_animations.num_elem; i++) {
 		Animation *animation = (Animation *)BinHeap_GetElem(&s_animations, i);
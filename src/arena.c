@@ -0,0 +1,156 @@
+/* arena.c
+ *
+ * Bump allocator for objects that live as long as a scenario.
+ *
+ * Allocations are carved out of large chunks and are never freed one
+ * by one.  Arena_Reset throws everything away at once but keeps the
+ * chunks, so the next scenario reuses the same memory instead of going
+ * back to the heap.  Objects that come and go during a game, such as
+ * build queue items, are recycled through per-type free lists so that
+ * long games do not grow the arena without bound.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+enum {
+	ARENA_CHUNK_SIZE = 16 * 1024
+};
+
+/* C99 has no max_align_t. */
+typedef union ArenaAlign {
+	void *p;
+	int64_t i;
+	long double d;
+} ArenaAlign;
+
+struct ArenaChunk {
+	struct ArenaChunk *next;
+	size_t size;
+
+	/* Followed by size bytes of storage. */
+	ArenaAlign data[];
+};
+
+/* Transient allocations of the current scenario.  Reset by Game_Init. */
+THREAD_LOCAL Arena g_scenarioArena;
+
+/*--------------------------------------------------------------*/
+
+static size_t
+Arena_AlignSize(size_t size)
+{
+	const size_t align = sizeof(ArenaAlign);
+
+	return (size + align - 1) & ~(align - 1);
+}
+
+static ArenaChunk *
+Arena_NewChunk(size_t size)
+{
+	if (size < ARENA_CHUNK_SIZE)
+		size = ARENA_CHUNK_SIZE;
+
+	ArenaChunk *c = malloc(sizeof(*c) + size);
+	assert(c != NULL);
+
+	c->next = NULL;
+	c->size = size;
+	return c;
+}
+
+void *
+Arena_Alloc(Arena *arena, size_t size)
+{
+	size = Arena_AlignSize(size);
+
+	if (arena->chunk == NULL || arena->used + size > arena->chunk->size) {
+		ArenaChunk *prev = arena->chunk;
+		ArenaChunk *c = (prev == NULL) ? arena->first : prev->next;
+
+		/* Reuse the chunks kept by Arena_Reset where they fit. */
+		if (c == NULL || c->size < size) {
+			ArenaChunk *nc = Arena_NewChunk(size);
+
+			nc->next = c;
+			c = nc;
+
+			if (prev == NULL) {
+				arena->first = c;
+			} else {
+				prev->next = c;
+			}
+		}
+
+		arena->chunk = c;
+		arena->used = 0;
+	}
+
+	void *ptr = (char *)arena->chunk->data + arena->used;
+	arena->used += size;
+	return ptr;
+}
+
+/**
+ * @brief   Discards every allocation, keeping the chunks for reuse.
+ */
+void
+Arena_Reset(Arena *arena)
+{
+	arena->chunk = NULL;
+	arena->used = 0;
+
+	memset(arena->free_list, 0, sizeof(arena->free_list));
+}
+
+void
+Arena_Free(Arena *arena)
+{
+	ArenaChunk *c = arena->first;
+
+	while (c != NULL) {
+		ArenaChunk *nx = c->next;
+
+		free(c);
+		c = nx;
+	}
+
+	memset(arena, 0, sizeof(*arena));
+}
+
+/**
+ * @brief   Allocates a fixed size object of the given type.
+ * @details Objects freed with Arena_PoolFree are reused first.  All
+ *          objects of one type must have the same size.
+ */
+void *
+Arena_PoolAlloc(Arena *arena, enum ArenaPoolType type, size_t size)
+{
+	assert(type < ARENAPOOL_MAX);
+	assert(size >= sizeof(void *));
+
+	void *ptr = arena->free_list[type];
+
+	if (ptr != NULL) {
+		memcpy(&arena->free_list[type], ptr, sizeof(void *));
+		return ptr;
+	}
+
+	return Arena_Alloc(arena, size);
+}
+
+void
+Arena_PoolFree(Arena *arena, enum ArenaPoolType type, void *ptr)
+{
+	assert(type < ARENAPOOL_MAX);
+
+	if (ptr == NULL)
+		return;
+
+	memcpy(ptr, &arena->free_list[type], sizeof(void *));
+	arena->free_list[type] = ptr;
+}
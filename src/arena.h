@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include "types.h"
+
+/* Fixed size objects recycled through the arena's free lists. */
+enum ArenaPoolType {
+	ARENAPOOL_BUILDQUEUEITEM,
+
+	ARENAPOOL_MAX
+};
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena {
+	ArenaChunk *first;
+	ArenaChunk *chunk;
+	size_t used;
+
+	void *free_list[ARENAPOOL_MAX];
+} Arena;
+
+extern THREAD_LOCAL Arena g_scenarioArena;
+
+extern void *Arena_Alloc(Arena *arena, size_t size);
+extern void Arena_Reset(Arena *arena);
+extern void Arena_Free(Arena *arena);
+
+extern void *Arena_PoolAlloc(Arena *arena, enum ArenaPoolType type, size_t size);
+extern void Arena_PoolFree(Arena *arena, enum ArenaPoolType type, void *ptr);
+
+#endif
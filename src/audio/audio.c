@@ -5,17 +5,18 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
-#include <sys/stat.h>
 #include "buildcfg.h"
 #include "../os/common.h"
 #include "../os/math.h"
 
 #include "audio.h"
 
+#include "../catalogue.h"
 #include "../config.h"
 #include "../enhancement.h"
 #include "../file.h"
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../map.h"
 #include "../net/net.h"
 #include "../opendune.h"
@@ -49,6 +50,8 @@ static MusicInfo *curr_music;
 char music_message[128];
 
 static enum SampleSet s_curr_sample_set = SAMPLESET_INVALID;
+static enum SampleSet s_prefetch_sample_set = SAMPLESET_INVALID;
+static enum SampleID s_prefetch_sampleID;
 
 static int64_t s_sample_last_played[SAMPLEID_MAX];
 static enum SampleID s_voice_queue[256];
@@ -61,11 +64,14 @@ Audio_DisplayMusicName(void)
 	GUI_DisplayText(music_message, 5);
 }
 
+/**
+ * @brief   Looks for the external music in the catalogue, which lists
+ *          each music directory once, rather than probing every file.
+ */
 void
 Audio_ScanMusic(void)
 {
 	const bool verbose = false;
-	struct stat st;
 
 	for (enum MusicID musicID = MUSIC_LOGOS; musicID < MUSICID_MAX; musicID++) {
 		MusicList *l = &g_table_music[musicID];
@@ -82,31 +88,38 @@ Audio_ScanMusic(void)
 				goto count_song;
 
 			/* External music. */
+			char dirname[PATH_MAX];
 			char buf[PATH_MAX];
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wformat-truncation"
+			snprintf(dirname, sizeof(dirname), "%s/%s", g_dune_data_dir, m->filename);
+
+			char *basename = strrchr(dirname, '/');
+			*basename = '\0';
+			basename++;
+
 #ifdef WITH_ACODEC
-			snprintf(buf, sizeof(buf), "%s/%s.flac", g_dune_data_dir, m->filename);
-			if (stat(buf, &st) == 0)
+			snprintf(buf, sizeof(buf), "%s.flac", basename);
+			if (Catalogue_FileExists(dirname, buf))
 				goto found_song;
 #endif
 
 #ifdef WITH_MAD
-			snprintf(buf, sizeof(buf), "%s/%s.mp3", g_dune_data_dir, m->filename);
-			if (stat(buf, &st) == 0)
+			snprintf(buf, sizeof(buf), "%s.mp3", basename);
+			if (Catalogue_FileExists(dirname, buf))
 				goto found_song;
 #endif
 
 #ifdef WITH_ACODEC
-			snprintf(buf, sizeof(buf), "%s/%s.ogg", g_dune_data_dir, m->filename);
-			if (stat(buf, &st) == 0)
+			snprintf(buf, sizeof(buf), "%s.ogg", basename);
+			if (Catalogue_FileExists(dirname, buf))
 				goto found_song;
 #endif
 
 #ifdef WITH_AUD
-			snprintf(buf, sizeof(buf), "%s/%s.AUD", g_dune_data_dir, m->filename);
-			if (stat(buf, &st) == 0)
+			snprintf(buf, sizeof(buf), "%s.AUD", basename);
+			if (Catalogue_FileExists(dirname, buf))
 				goto found_song;
 #endif
 #pragma GCC diagnostic pop
@@ -134,6 +147,8 @@ count_song:
 			if (verbose) fprintf(stdout, "[found]   %s\n", m->filename);
 		}
 	}
+
+	Catalogue_Save();
 }
 
 static void
@@ -359,7 +374,7 @@ Audio_IsPositionAudible(uint16 packed)
 			&& (g_host_type == HOSTTYPE_CLIENT_SERVER
 			 || g_host_type == HOSTTYPE_DEDICATED_CLIENT)) {
 		return Map_IsUnveiledToHouse(g_playerHouseID, packed)
-			&& (g_mapVisible[packed].timeout[g_playerHouseID] > g_timerGame);
+			&& (g_game->mapVisible[packed].timeout[g_playerHouseID] > g_game->timerGame);
 	}
 
 	return true;
@@ -400,20 +415,21 @@ Audio_GetSamplePrefix(enum SampleSet setID)
 	return 'Z';
 }
 
-static void
+static bool
 Audio_LoadSample(const char *filename, enum SampleID sampleID)
 {
 	if (filename == NULL || !File_Exists(filename))
-		return;
+		return false;
 
 	const uint8 file_index = File_Open(filename, FILE_MODE_READ);
 	const uint32 file_size = File_GetSize(file_index);
 
 	AudioA5_StoreSample(sampleID, file_index, file_size);
 	File_Close(file_index);
+	return true;
 }
 
-static void
+static bool
 Audio_LoadSampleFromSet(enum SampleSet setID, enum SampleID sampleID)
 {
 	const SoundData *s = &g_table_voices[sampleID];
@@ -426,7 +442,7 @@ Audio_LoadSampleFromSet(enum SampleSet setID, enum SampleID sampleID)
 		case '+':
 			/* +: common to all houses. */
 			if (s_curr_sample_set != SAMPLESET_INVALID)
-				return;
+				return false;
 
 			/* +%c: common to all houses, substitute with language prefix. */
 			if (s->string[1] == '%') {
@@ -439,14 +455,14 @@ Audio_LoadSampleFromSet(enum SampleSet setID, enum SampleID sampleID)
 		case '-':
 			/* -: common to all houses. */
 			if (s_curr_sample_set != SAMPLESET_INVALID)
-				return;
+				return false;
 			break;
 
 		case '/':
 			/* /: Bene Gesserit only (called mercenary in Dune II). */
 			/* if (setID != SAMPLESET_BENE_GESSERIT) return; */
 			if (s_curr_sample_set != SAMPLESET_INVALID)
-				return;
+				return false;
 			break;
 
 		case '?':
@@ -468,15 +484,18 @@ Audio_LoadSampleFromSet(enum SampleSet setID, enum SampleID sampleID)
 			break;
 
 		default:
-			return;
+			return false;
 	}
 
-	Audio_LoadSample(filename, sampleID);
+	return Audio_LoadSample(filename, sampleID);
 }
 
 void
 Audio_LoadSampleSet(enum SampleSet setID)
 {
+	enum SampleID sampleID = 0;
+	bool dirty = false;
+
 	if (!g_enable_audio)
 		return;
 
@@ -485,16 +504,77 @@ Audio_LoadSampleSet(enum SampleSet setID)
 		Audio_LoadSample(g_table_voices[SAMPLE_RADAR_STATIC].string + 1, SAMPLE_RADAR_STATIC);
 	}
 
-	if (s_curr_sample_set == setID)
+	/* Finish a prefetch of this set, or undo a prefetch of another. */
+	if (s_prefetch_sample_set == setID) {
+		sampleID = s_prefetch_sampleID;
+	} else if (s_prefetch_sample_set != SAMPLESET_INVALID) {
+		dirty = (s_prefetch_sampleID > 0);
+	}
+
+	s_prefetch_sample_set = SAMPLESET_INVALID;
+
+	if (s_curr_sample_set == setID && !dirty)
 		return;
 
-	for (enum SampleID sampleID = 0; sampleID < SAMPLEID_MAX; sampleID++) {
+	for (; sampleID < SAMPLEID_MAX; sampleID++) {
 		Audio_LoadSampleFromSet(setID, sampleID);
 	}
 
 	s_curr_sample_set = setID;
 }
 
+/**
+ * @brief   Start loading a sample set in the background.
+ * @details Introduced.  The samples are loaded a few at a time by
+ *          Audio_PollPrefetch.  Audio_LoadSampleSet with the same set
+ *          loads whatever is left.
+ */
+void
+Audio_PrefetchSampleSet(enum SampleSet setID)
+{
+	if (!g_enable_audio || setID == SAMPLESET_INVALID)
+		return;
+
+	if (s_prefetch_sample_set == setID)
+		return;
+
+	/* An abandoned prefetch may have replaced some of the current set. */
+	if (s_curr_sample_set == setID
+			&& (s_prefetch_sample_set == SAMPLESET_INVALID || s_prefetch_sampleID == 0)) {
+		s_prefetch_sample_set = SAMPLESET_INVALID;
+		return;
+	}
+
+	s_prefetch_sample_set = setID;
+	s_prefetch_sampleID = 0;
+}
+
+/**
+ * @brief   Load the next sample of a pending prefetch.
+ * @details Introduced.  Common samples that are skipped do not count
+ *          towards the one file loaded per call.
+ * @return  True if there is more to load.
+ */
+bool
+Audio_PollPrefetch(void)
+{
+	const enum SampleSet setID = s_prefetch_sample_set;
+
+	if (setID == SAMPLESET_INVALID)
+		return false;
+
+	while (s_prefetch_sampleID < SAMPLEID_MAX) {
+		const enum SampleID sampleID = s_prefetch_sampleID++;
+
+		if (Audio_LoadSampleFromSet(setID, sampleID))
+			return true;
+	}
+
+	s_prefetch_sample_set = SAMPLESET_INVALID;
+	s_curr_sample_set = setID;
+	return false;
+}
+
 void
 Audio_PlaySample(enum SampleID sampleID, int volume, float pan)
 {
@@ -509,6 +589,9 @@ Audio_PlaySample(enum SampleID sampleID, int volume, float pan)
 	if (curr_ticks - s_sample_last_played[sampleID] > 8) {
 		s_sample_last_played[sampleID] = curr_ticks;
 		AudioA5_PlaySample(sampleID, (float)volume / 255.0f, pan);
+	} else {
+		/* Many explosions at once: one louder sound instead of many. */
+		AudioA5_CoalesceSample(sampleID, (float)volume / 255.0f, pan);
 	}
 }
 
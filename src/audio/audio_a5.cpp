@@ -1,6 +1,7 @@
 /* audio_a5.cpp */
 
 #include <assert.h>
+#include <math.h>
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_audio.h>
 #include <allegro5/allegro_memfile.h>
@@ -39,6 +40,7 @@ extern "C" {
 #include "audio.h"
 #include "midi.h"
 #include "mt32mpu.h"
+#include "../codec/voc.h"
 #include "../common_a5.h"
 #include "../file.h"
 #include "../house.h"
@@ -79,6 +81,11 @@ static AUDSTREAM *s_aud;
 
 static ALLEGRO_SAMPLE *s_sample[SAMPLEID_MAX];
 static ALLEGRO_SAMPLE_INSTANCE *s_instance[MAX_SAMPLE_INSTANCES];
+static enum SampleID s_instance_sampleID[MAX_SAMPLE_INSTANCES];
+static float s_instance_gain[MAX_SAMPLE_INSTANCES];
+static float s_instance_pan[MAX_SAMPLE_INSTANCES];
+static unsigned int s_instance_serial[MAX_SAMPLE_INSTANCES];
+static unsigned int s_serial;
 static ALLEGRO_VOICE *al_voice;
 static ALLEGRO_MIXER *al_mixer;
 
@@ -709,26 +716,73 @@ AudioA5_PlaySoundEffect(enum SoundID effectID)
 void
 AudioA5_StoreSample(enum SampleID sampleID, uint8 file_index, uint32 file_size)
 {
-	char header[0x1A];
-	char ignore1;
-	unsigned int size = 0;
-	unsigned char rate;
-	char ignore2;
-	uint8 *data = (uint8 *)al_malloc(file_size - 32);
-
-	File_Read(file_index, header, 0x1A); /* "Creative Voice File..." */
-	File_Read(file_index, &ignore1, 1); /* block type */
-	File_Read(file_index, &size, 3);
-	File_Read(file_index, &rate, 1);
-	File_Read(file_index, &ignore2, 1);
-	File_Read(file_index, data, file_size - 32);
-
-	unsigned int freq = 1000000 / (256 - rate);
+	uint8 header[VOC_HEADER_SIZE];
+	VocSample voc;
+
+	al_destroy_sample(s_sample[sampleID]);
+	s_sample[sampleID] = NULL;
+
+	File_Read(file_index, header, VOC_HEADER_SIZE);
+	if (!Voc_ReadHeader(header, file_size, &voc))
+		return;
+
+	uint8 *data = (uint8 *)al_malloc(file_size - VOC_HEADER_SIZE);
+	File_Read(file_index, data, file_size - VOC_HEADER_SIZE);
+
 	ALLEGRO_AUDIO_DEPTH depth = ALLEGRO_AUDIO_DEPTH_UINT8;
 	ALLEGRO_CHANNEL_CONF chan_conf = ALLEGRO_CHANNEL_CONF_1;
 
-	al_destroy_sample(s_sample[sampleID]);
-	s_sample[sampleID] = al_create_sample(data, size - 2, freq, depth, chan_conf, true);
+	s_sample[sampleID] = al_create_sample(data, voc.length, voc.frequency, depth, chan_conf, true);
+}
+
+static bool
+AudioA5_StartInstance(int i, enum SampleID sampleID, float gain, float pan)
+{
+	ALLEGRO_SAMPLE_INSTANCE *si = s_instance[i];
+
+	if (!al_set_sample(si, s_sample[sampleID]))
+		return false;
+
+	al_set_sample_instance_gain(si, gain);
+	al_set_sample_instance_pan(si, pan);
+	al_play_sample_instance(si);
+
+	s_instance_sampleID[i] = sampleID;
+	s_instance_gain[i] = gain;
+	s_instance_pan[i] = pan;
+	s_instance_serial[i] = ++s_serial;
+	return true;
+}
+
+/* AudioA5_PlayBattleSample:
+ *
+ * Plays a sample on a free battle sound instance.  If there is none,
+ * the quietest (usually the furthest away) sound that is quieter than
+ * the new one is cut short, oldest first.
+ */
+static bool
+AudioA5_PlayBattleSample(enum SampleID sampleID, float gain, float pan)
+{
+	int steal = -1;
+
+	for (int i = 2; i < MAX_SAMPLE_INSTANCES; i++) {
+		if (!al_get_sample_instance_playing(s_instance[i]))
+			return AudioA5_StartInstance(i, sampleID, gain, pan);
+
+		if (s_instance_gain[i] >= gain)
+			continue;
+
+		if ((steal < 0)
+				|| (s_instance_gain[i] < s_instance_gain[steal])
+				|| (s_instance_gain[i] == s_instance_gain[steal] && s_instance_serial[i] < s_instance_serial[steal]))
+			steal = i;
+	}
+
+	if (steal < 0)
+		return false;
+
+	al_stop_sample_instance(s_instance[steal]);
+	return AudioA5_StartInstance(steal, sampleID, gain, pan);
 }
 
 bool
@@ -752,14 +806,53 @@ AudioA5_PlaySample(enum SampleID sampleID, float volume, float pan)
 		idx_end = 1;
 		gain = voice_volume * volume;
 	} else {
-		idx_start = 2;
-		idx_end = MAX_SAMPLE_INSTANCES - 1;
 		gain = voice_volume * volume;
+		return AudioA5_PlayBattleSample(sampleID, gain, pan);
 	}
 
 	return AudioA5_PlaySampleRaw(sampleID, gain, pan, idx_start, idx_end);
 }
 
+/* AudioA5_CoalesceSample:
+ *
+ * Merges a repeat of a battle sound into the instance that most
+ * recently started playing it: the gains add up as uncorrelated
+ * sources would, and the pan moves towards the louder one.  Returns
+ * false if the sample is not playing.
+ */
+bool
+AudioA5_CoalesceSample(enum SampleID sampleID, float volume, float pan)
+{
+	int idx = -1;
+
+	for (int i = 2; i < MAX_SAMPLE_INSTANCES; i++) {
+		if (s_instance_sampleID[i] != sampleID || !al_get_sample_instance_playing(s_instance[i]))
+			continue;
+
+		if (idx < 0 || s_instance_serial[i] > s_instance_serial[idx])
+			idx = i;
+	}
+
+	if (idx < 0)
+		return false;
+
+	const float g1 = s_instance_gain[idx];
+	const float g2 = voice_volume * volume;
+	const float limit = (g1 > voice_volume) ? g1 : voice_volume;
+	float gain = sqrtf(g1 * g1 + g2 * g2);
+
+	if (gain > limit)
+		gain = limit;
+
+	if ((s_instance_pan[idx] != ALLEGRO_AUDIO_PAN_NONE) && (g1 + g2 > 0.0f))
+		s_instance_pan[idx] = (g1 * s_instance_pan[idx] + g2 * pan) / (g1 + g2);
+
+	s_instance_gain[idx] = gain;
+	al_set_sample_instance_gain(s_instance[idx], gain);
+	al_set_sample_instance_pan(s_instance[idx], s_instance_pan[idx]);
+	return true;
+}
+
 bool
 AudioA5_PlaySampleRaw(enum SampleID sampleID, float volume, float pan, int idx_start, int idx_end)
 {
@@ -770,18 +863,11 @@ AudioA5_PlaySampleRaw(enum SampleID sampleID, float volume, float pan, int idx_s
 		pan = ALLEGRO_AUDIO_PAN_NONE;
 
 	for (int i = idx_start; i <= idx_end; i++) {
-		ALLEGRO_SAMPLE_INSTANCE *si = s_instance[i];
-
-		if (al_get_sample_instance_playing(si))
+		if (al_get_sample_instance_playing(s_instance[i]))
 			continue;
 
-		if (!al_set_sample(si, s_sample[sampleID]))
-			continue;
-
-		al_set_sample_instance_gain(si, volume);
-		al_set_sample_instance_pan(si, pan);
-		al_play_sample_instance(si);
-		return true;
+		if (AudioA5_StartInstance(i, sampleID, volume, pan))
+			return true;
 	}
 
 	return false;
@@ -1,11 +1,12 @@
 /* buildqueue.c */
 
 #include <assert.h>
-#include <stdlib.h>
 #include <string.h>
 
 #include "buildqueue.h"
 
+#include "arena.h"
+
 void
 BuildQueue_Init(BuildQueue *queue)
 {
@@ -15,6 +16,12 @@ BuildQueue_Init(BuildQueue *queue)
 	memset(queue->count, 0, sizeof(queue->count));
 }
 
+static void
+BuildQueue_FreeItem(BuildQueueItem *e)
+{
+	Arena_PoolFree(&g_scenarioArena, ARENAPOOL_BUILDQUEUEITEM, e);
+}
+
 void
 BuildQueue_Free(BuildQueue *queue)
 {
@@ -23,7 +30,7 @@ BuildQueue_Free(BuildQueue *queue)
 	while (e != NULL) {
 		BuildQueueItem *nx = e->next;
 
-		free(e);
+		BuildQueue_FreeItem(e);
 		e = nx;
 	}
 
@@ -33,8 +40,8 @@ BuildQueue_Free(BuildQueue *queue)
 static BuildQueueItem *
 BuildQueue_AllocItem(uint16 objectType, int credits)
 {
-	BuildQueueItem *e = malloc(sizeof(*e));
-	assert(e);
+	BuildQueueItem *e = Arena_PoolAlloc(&g_scenarioArena,
+			ARENAPOOL_BUILDQUEUEITEM, sizeof(*e));
 
 	e->next = NULL;
 	e->prev = NULL;
@@ -47,12 +54,25 @@ BuildQueue_AllocItem(uint16 objectType, int credits)
 void
 BuildQueue_Add(BuildQueue *queue, uint16 objectType, int credits)
 {
-	BuildQueueItem *e = BuildQueue_AllocItem(objectType, credits);
 	assert(objectType < OBJECTTYPE_MAX);
 
 	if (queue->count[objectType] >= 99)
 		return;
-	
+
+	BuildQueue_Append(queue, objectType, credits);
+	queue->count[objectType]++;
+}
+
+/**
+ * @brief   Appends an item without touching the counts.
+ * @details Introduced for snapshots, which restore the counts together
+ *          with the rest of the queue's owner.
+ */
+void
+BuildQueue_Append(BuildQueue *queue, uint16 objectType, int credits)
+{
+	BuildQueueItem *e = BuildQueue_AllocItem(objectType, credits);
+
 	if (queue->first == NULL)
 		queue->first = e;
 
@@ -62,7 +82,6 @@ BuildQueue_Add(BuildQueue *queue, uint16 objectType, int credits)
 	}
 
 	queue->last = e;
-	queue->count[objectType]++;
 }
 
 uint16
@@ -85,7 +104,7 @@ BuildQueue_RemoveHead(BuildQueue *queue)
 		queue->count[ret]--;
 
 		assert(e->prev == NULL);
-		free(e);
+		BuildQueue_FreeItem(e);
 	}
 
 	return ret;
@@ -115,7 +134,7 @@ BuildQueue_RemoveTail(BuildQueue *queue, uint16 objectType, int *credits)
 
 			queue->count[objectType]--;
 
-			free(e);
+			BuildQueue_FreeItem(e);
 			return true;
 		} else {
 			e = e->prev;
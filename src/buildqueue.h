@@ -31,6 +31,7 @@ extern void BuildQueue_Init(BuildQueue *queue);
 extern void BuildQueue_Free(BuildQueue *queue);
 
 extern void BuildQueue_Add(BuildQueue *queue, uint16 objectType, int credits);
+extern void BuildQueue_Append(BuildQueue *queue, uint16 objectType, int credits);
 extern uint16 BuildQueue_RemoveHead(BuildQueue *queue);
 extern bool BuildQueue_RemoveTail(BuildQueue *queue, uint16 objectType, int *credits);
 extern bool BuildQueue_IsEmpty(const BuildQueue *queue);
@@ -0,0 +1,431 @@
+/* catalogue.c
+ *
+ * Catalogue of the data directories scanned at start up.
+ *
+ * Finding the external music used to stat() every candidate file, and
+ * finding the campaigns parsed every META.INI.  Instead, directories
+ * are listed once and matched in memory, and the listings and campaign
+ * details are kept in catalogue.txt in the personal data directory.
+ * An entry is reused for as long as the modification time of its
+ * directory (and META.INI, for campaigns) is unchanged.
+ *
+ * Modification times only have a resolution of a second, so an entry
+ * recorded in the same second as its directory was modified is not
+ * trusted the next time round.
+ *
+ * File layout, one record per line:
+ *
+ *   catalogue <version>
+ *   D <mtime> <scanned> <number of files> <directory>
+ *     followed by one line per file name, sorted
+ *   C <mtime> <META.INI mtime> <scanned> <house> <house> <house> <directory>
+ *     followed by the campaign name
+ */
+
+#include <allegro5/allegro.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "os/common.h"
+#include "os/strings.h"
+
+#include "catalogue.h"
+
+#include "file.h"
+
+#define CATALOGUE_FILENAME      "catalogue.txt"
+#define CATALOGUE_VERSION       1
+
+/* The default filesystems on Windows and macOS ignore case, and so did
+ * the stat() probing that the catalogue replaces.
+ */
+#if defined(_WIN32) || defined(__APPLE__)
+#define CATALOGUE_IGNORE_CASE
+#endif
+
+typedef struct CatalogueDir {
+	char *path;
+	int64_t mtime;
+	int64_t scanned;
+	bool checked;
+
+	int num_files;
+	char **file;
+} CatalogueDir;
+
+typedef struct CatalogueCampaignEntry {
+	char *path;
+	int64_t mtime;
+	int64_t meta_mtime;
+	int64_t scanned;
+
+	CatalogueCampaign camp;
+} CatalogueCampaignEntry;
+
+static CatalogueDir *s_catalogue_dir;
+static int s_catalogue_num_dirs;
+
+static CatalogueCampaignEntry *s_catalogue_campaign;
+static int s_catalogue_num_campaigns;
+
+static bool s_catalogue_loaded;
+static bool s_catalogue_dirty;
+
+/*--------------------------------------------------------------*/
+
+static char *
+Catalogue_StrDup(const char *str)
+{
+	const size_t len = strlen(str) + 1;
+	char *dup = malloc(len);
+
+	memcpy(dup, str, len);
+	return dup;
+}
+
+static int
+Catalogue_CompareFilenames(const void *a, const void *b)
+{
+	const char * const *fa = a;
+	const char * const *fb = b;
+
+#if defined(CATALOGUE_IGNORE_CASE)
+	return strcasecmp(*fa, *fb);
+#else
+	return strcmp(*fa, *fb);
+#endif
+}
+
+/**
+ * @brief   Modification time of a file or directory.
+ * @return  -1 if it does not exist.
+ */
+static int64_t
+Catalogue_GetMTime(const char *path)
+{
+	ALLEGRO_FS_ENTRY *e = al_create_fs_entry(path);
+	int64_t mtime = -1;
+
+	if (e == NULL)
+		return mtime;
+
+	if (al_fs_entry_exists(e))
+		mtime = al_get_fs_entry_mtime(e);
+
+	al_destroy_fs_entry(e);
+	return mtime;
+}
+
+static bool
+Catalogue_IsTrusted(int64_t mtime, int64_t scanned)
+{
+	return mtime < scanned;
+}
+
+static void
+Catalogue_FreeFiles(CatalogueDir *d)
+{
+	for (int i = 0; i < d->num_files; i++)
+		free(d->file[i]);
+
+	free(d->file);
+	d->file = NULL;
+	d->num_files = 0;
+}
+
+static CatalogueDir *
+Catalogue_AddDir(const char *path)
+{
+	s_catalogue_dir = realloc(s_catalogue_dir, (s_catalogue_num_dirs + 1) * sizeof(s_catalogue_dir[0]));
+
+	CatalogueDir *d = &s_catalogue_dir[s_catalogue_num_dirs++];
+	memset(d, 0, sizeof(*d));
+	d->path = Catalogue_StrDup(path);
+	d->mtime = -1;
+	return d;
+}
+
+static CatalogueCampaignEntry *
+Catalogue_FindCampaignEntry(const char *path)
+{
+	for (int i = 0; i < s_catalogue_num_campaigns; i++) {
+		if (strcmp(s_catalogue_campaign[i].path, path) == 0)
+			return &s_catalogue_campaign[i];
+	}
+
+	return NULL;
+}
+
+static CatalogueCampaignEntry *
+Catalogue_AddCampaignEntry(const char *path)
+{
+	s_catalogue_campaign = realloc(s_catalogue_campaign, (s_catalogue_num_campaigns + 1) * sizeof(s_catalogue_campaign[0]));
+
+	CatalogueCampaignEntry *c = &s_catalogue_campaign[s_catalogue_num_campaigns++];
+	memset(c, 0, sizeof(*c));
+	c->path = Catalogue_StrDup(path);
+	return c;
+}
+
+/*--------------------------------------------------------------*/
+
+static bool
+Catalogue_ReadLine(FILE *fp, char *buf, size_t len)
+{
+	if (fgets(buf, len, fp) == NULL)
+		return false;
+
+	buf[strcspn(buf, "\r\n")] = '\0';
+	return true;
+}
+
+static void
+Catalogue_Load(void)
+{
+	char buf[PATH_MAX + 128];
+	int version;
+
+	s_catalogue_loaded = true;
+
+	FILE *fp = File_Open_CaseInsensitive(SEARCHDIR_PERSONAL_DATA_DIR, CATALOGUE_FILENAME, "r");
+	if (fp == NULL)
+		return;
+
+	if (!Catalogue_ReadLine(fp, buf, sizeof(buf))
+			|| sscanf(buf, "catalogue %d", &version) != 1
+			|| version != CATALOGUE_VERSION) {
+		fclose(fp);
+		return;
+	}
+
+	while (Catalogue_ReadLine(fp, buf, sizeof(buf))) {
+		int64_t mtime, meta_mtime, scanned;
+		int num_files, house[3];
+		int n = 0;
+
+		if (sscanf(buf, "D %" SCNd64 " %" SCNd64 " %d %n", &mtime, &scanned, &num_files, &n) == 3
+				&& n > 0 && num_files >= 0) {
+			CatalogueDir *d = Catalogue_AddDir(buf + n);
+
+			d->mtime = mtime;
+			d->scanned = scanned;
+			d->file = calloc(num_files, sizeof(d->file[0]));
+
+			while (d->num_files < num_files && Catalogue_ReadLine(fp, buf, sizeof(buf)))
+				d->file[d->num_files++] = Catalogue_StrDup(buf);
+
+			/* Truncated file: rescan the directory. */
+			if (d->num_files < num_files)
+				d->scanned = d->mtime;
+
+			/* Sorted for lookups, whatever order it was saved in. */
+			qsort(d->file, d->num_files, sizeof(d->file[0]), Catalogue_CompareFilenames);
+		} else if (sscanf(buf, "C %" SCNd64 " %" SCNd64 " %" SCNd64 " %d %d %d %n",
+					&mtime, &meta_mtime, &scanned, &house[0], &house[1], &house[2], &n) == 6
+				&& n > 0) {
+			CatalogueCampaignEntry *c = Catalogue_AddCampaignEntry(buf + n);
+
+			c->mtime = mtime;
+			c->meta_mtime = meta_mtime;
+			c->scanned = scanned;
+			c->camp.house[0] = house[0];
+			c->camp.house[1] = house[1];
+			c->camp.house[2] = house[2];
+
+			if (Catalogue_ReadLine(fp, buf, sizeof(buf))) {
+				snprintf(c->camp.name, sizeof(c->camp.name), "%s", buf);
+			} else {
+				c->scanned = c->mtime;
+			}
+		}
+	}
+
+	fclose(fp);
+}
+
+void
+Catalogue_Save(void)
+{
+	char filename[PATH_MAX];
+	char tmpname[PATH_MAX];
+
+	if (!s_catalogue_dirty)
+		return;
+
+	s_catalogue_dirty = false;
+
+	snprintf(filename, sizeof(filename), "%s/%s", g_personal_data_dir, CATALOGUE_FILENAME);
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+
+	FILE *fp = fopen(tmpname, "w");
+	if (fp == NULL)
+		return;
+
+	fprintf(fp, "catalogue %d\n", CATALOGUE_VERSION);
+
+	for (int i = 0; i < s_catalogue_num_dirs; i++) {
+		const CatalogueDir *d = &s_catalogue_dir[i];
+
+		fprintf(fp, "D %" PRId64 " %" PRId64 " %d %s\n", d->mtime, d->scanned, d->num_files, d->path);
+
+		for (int j = 0; j < d->num_files; j++)
+			fprintf(fp, "%s\n", d->file[j]);
+	}
+
+	for (int i = 0; i < s_catalogue_num_campaigns; i++) {
+		const CatalogueCampaignEntry *c = &s_catalogue_campaign[i];
+
+		fprintf(fp, "C %" PRId64 " %" PRId64 " %" PRId64 " %d %d %d %s\n%s\n",
+				c->mtime, c->meta_mtime, c->scanned,
+				c->camp.house[0], c->camp.house[1], c->camp.house[2],
+				c->path, c->camp.name);
+	}
+
+	if (fclose(fp) == 0) {
+		/* rename does not replace existing files on Windows. */
+		remove(filename);
+		if (rename(tmpname, filename) == 0)
+			return;
+	}
+
+	remove(tmpname);
+}
+
+/*--------------------------------------------------------------*/
+
+static void
+Catalogue_ListDir(CatalogueDir *d, int64_t mtime)
+{
+	Catalogue_FreeFiles(d);
+	d->mtime = mtime;
+	d->scanned = time(NULL);
+	d->checked = true;
+	s_catalogue_dirty = true;
+
+	if (mtime < 0)
+		return;
+
+	ALLEGRO_FS_ENTRY *e = al_create_fs_entry(d->path);
+	if (e == NULL)
+		return;
+
+	if (!al_open_directory(e)) {
+		al_destroy_fs_entry(e);
+		return;
+	}
+
+	int alloc = 0;
+	ALLEGRO_FS_ENTRY *f;
+	while ((f = al_read_directory(e)) != NULL) {
+		const char *name = al_get_fs_entry_name(f);
+		const char *sep = strrchr(name, ALLEGRO_NATIVE_PATH_SEP);
+
+		if (sep == NULL)
+			sep = strrchr(name, '/');
+
+		if (sep != NULL)
+			name = sep + 1;
+
+		if (d->num_files >= alloc) {
+			alloc = (alloc == 0) ? 64 : 2 * alloc;
+			d->file = realloc(d->file, alloc * sizeof(d->file[0]));
+		}
+
+		d->file[d->num_files++] = Catalogue_StrDup(name);
+		al_destroy_fs_entry(f);
+	}
+
+	al_close_directory(e);
+	al_destroy_fs_entry(e);
+
+	qsort(d->file, d->num_files, sizeof(d->file[0]), Catalogue_CompareFilenames);
+}
+
+/**
+ * @brief   Checks if a file exists in a directory.
+ * @details Case is ignored on Windows and macOS, as their filesystems
+ *          would.  The directory is listed the first time it is asked
+ *          about, unless the catalogue already holds an up to date
+ *          listing.  Files added later in the session are not seen.
+ */
+bool
+Catalogue_FileExists(const char *dirname, const char *filename)
+{
+	CatalogueDir *d = NULL;
+
+	if (!s_catalogue_loaded)
+		Catalogue_Load();
+
+	for (int i = 0; i < s_catalogue_num_dirs; i++) {
+		if (strcmp(s_catalogue_dir[i].path, dirname) == 0) {
+			d = &s_catalogue_dir[i];
+			break;
+		}
+	}
+
+	if (d == NULL)
+		d = Catalogue_AddDir(dirname);
+
+	if (!d->checked) {
+		const int64_t mtime = Catalogue_GetMTime(dirname);
+
+		if (mtime == d->mtime && Catalogue_IsTrusted(mtime, d->scanned)) {
+			d->checked = true;
+		} else {
+			Catalogue_ListDir(d, mtime);
+		}
+	}
+
+	return bsearch(&filename, d->file, d->num_files, sizeof(d->file[0]), Catalogue_CompareFilenames) != NULL;
+}
+
+static int64_t
+Catalogue_GetMetaMTime(const char *dirname)
+{
+	char path[PATH_MAX];
+
+	snprintf(path, sizeof(path), "%s/META.INI", dirname);
+	return Catalogue_GetMTime(path);
+}
+
+/**
+ * @brief   Looks up a campaign directory scanned in an earlier session.
+ * @return  NULL if the directory or its META.INI changed since.
+ */
+const CatalogueCampaign *
+Catalogue_FindCampaign(const char *dirname, int64_t dir_mtime)
+{
+	if (!s_catalogue_loaded)
+		Catalogue_Load();
+
+	const CatalogueCampaignEntry *c = Catalogue_FindCampaignEntry(dirname);
+	if (c == NULL)
+		return NULL;
+
+	if (c->mtime != dir_mtime || !Catalogue_IsTrusted(c->mtime, c->scanned))
+		return NULL;
+
+	const int64_t meta_mtime = Catalogue_GetMetaMTime(dirname);
+	if (c->meta_mtime != meta_mtime || !Catalogue_IsTrusted(c->meta_mtime, c->scanned))
+		return NULL;
+
+	return &c->camp;
+}
+
+void
+Catalogue_AddCampaign(const char *dirname, int64_t dir_mtime, const CatalogueCampaign *camp)
+{
+	if (!s_catalogue_loaded)
+		Catalogue_Load();
+
+	CatalogueCampaignEntry *c = Catalogue_FindCampaignEntry(dirname);
+	if (c == NULL)
+		c = Catalogue_AddCampaignEntry(dirname);
+
+	c->mtime = dir_mtime;
+	c->meta_mtime = Catalogue_GetMetaMTime(dirname);
+	c->scanned = time(NULL);
+	c->camp = *camp;
+	s_catalogue_dirty = true;
+}
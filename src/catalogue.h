@@ -0,0 +1,21 @@
+#ifndef CATALOGUE_H
+#define CATALOGUE_H
+
+#include <inttypes.h>
+#include "types.h"
+
+/* What Menu_ScanCampaigns learnt from a campaign directory.  A house
+ * of HOUSE_INVALID in all three slots marks a directory that is not a
+ * playable campaign.
+ */
+typedef struct CatalogueCampaign {
+	char name[32];
+	int house[3];
+} CatalogueCampaign;
+
+extern bool Catalogue_FileExists(const char *dirname, const char *filename);
+extern const CatalogueCampaign *Catalogue_FindCampaign(const char *dirname, int64_t dir_mtime);
+extern void Catalogue_AddCampaign(const char *dirname, int64_t dir_mtime, const CatalogueCampaign *camp);
+extern void Catalogue_Save(void);
+
+#endif
@@ -0,0 +1,342 @@
+/* client_none.c
+ *
+ * The client side of the game, as seen by the dedicated server: no
+ * audio, no interface, and no local player.  The simulation still
+ * calls into these, so they do nothing, or log to stdout.
+ */
+
+#include <stdio.h>
+#include "types.h"
+
+#include "audio/audio.h"
+#include "audio/audio_a5.h"
+#include "common_a5.h"
+#include "config.h"
+#include "gui/font.h"
+#include "gui/gui.h"
+#include "gui/widget.h"
+#include "newui/actionpanel.h"
+#include "newui/chatbox.h"
+#include "newui/mentat.h"
+#include "newui/menubar.h"
+#include "newui/strategicmap.h"
+#include "newui/viewport.h"
+#include "save.h"
+#include "shape.h"
+#include "video/prim.h"
+#include "video/video.h"
+
+THREAD_LOCAL GameCfg g_gameConfig = {
+	.language = LANGUAGE_ENGLISH,
+	.gameSpeed = 2,
+};
+
+/* GFX_Init sizes the screen buffers from the texture rendering
+ * pseudo-widget.
+ */
+WidgetProperties g_widgetProperties[WINDOWID_MAX] = {
+	[WINDOWID_RENDER_TEXTURE] = { 0, 0, 1024, 1024, 0, 0, 0 },
+};
+
+THREAD_LOCAL uint16 g_curWidgetIndex;
+THREAD_LOCAL Widget *g_widgetLinkedListHead = NULL;
+THREAD_LOCAL uint8 g_paletteActive[3 * 256];
+
+THREAD_LOCAL uint16 g_selectionRectanglePosition;
+THREAD_LOCAL uint16 g_selectionPosition;
+THREAD_LOCAL uint16 g_selectionWidth;
+THREAD_LOCAL uint16 g_selectionHeight;
+THREAD_LOCAL int16  g_selectionState = 1;
+
+THREAD_LOCAL uint16 g_viewportPosition;
+THREAD_LOCAL int g_viewport_scrollOffsetX;
+THREAD_LOCAL int g_viewport_scrollOffsetY;
+
+THREAD_LOCAL FactoryWindowItem g_factoryWindowItems[MAX_FACTORY_WINDOW_ITEMS];
+THREAD_LOCAL int g_factoryWindowTotal;
+
+THREAD_LOCAL uint32 g_strategicRegionBits;
+
+/*--------------------------------------------------------------*/
+
+void
+A5_Uninit(void)
+{
+}
+
+void
+Font_Uninit(void)
+{
+}
+
+void
+AudioA5_PollMusic(void)
+{
+}
+
+void
+Audio_PlaySample(enum SampleID sampleID, int volume, float pan)
+{
+	VARIABLE_NOT_USED(sampleID);
+	VARIABLE_NOT_USED(volume);
+	VARIABLE_NOT_USED(pan);
+}
+
+void
+Audio_PlaySound(enum SoundID soundID)
+{
+	VARIABLE_NOT_USED(soundID);
+}
+
+void
+Audio_PlaySoundAtTile(enum SoundID soundID, tile32 position)
+{
+	VARIABLE_NOT_USED(soundID);
+	VARIABLE_NOT_USED(position);
+}
+
+void
+Audio_PlayVoice(enum VoiceID voiceID)
+{
+	VARIABLE_NOT_USED(voiceID);
+}
+
+void
+Audio_PlayVoiceAtTile(enum VoiceID voiceID, uint16 packed)
+{
+	VARIABLE_NOT_USED(voiceID);
+	VARIABLE_NOT_USED(packed);
+}
+
+bool
+Audio_Poll(void)
+{
+	return false;
+}
+
+void
+ChatBox_AddChat(int peerID, const char *name, const char *msg)
+{
+	VARIABLE_NOT_USED(peerID);
+
+	if (name == NULL) {
+		printf("%s\n", msg);
+	} else {
+		printf("%s: %s\n", name, msg);
+	}
+}
+
+void
+ChatBox_AddLog(enum ChatType type, const char *msg)
+{
+	VARIABLE_NOT_USED(type);
+
+	printf("%s\n", msg);
+}
+
+void
+ChatBox_ClearHistory(void)
+{
+}
+
+void
+GUI_ChangeSelectionType(uint16 selectionType)
+{
+	VARIABLE_NOT_USED(selectionType);
+}
+
+void
+GUI_DisplayHint(enum HouseType houseID, enum StringID stringID, enum ShapeID shapeID)
+{
+	VARIABLE_NOT_USED(houseID);
+	VARIABLE_NOT_USED(stringID);
+	VARIABLE_NOT_USED(shapeID);
+}
+
+void
+GUI_DisplayText(const char *str, int16 importance, ...)
+{
+	VARIABLE_NOT_USED(str);
+	VARIABLE_NOT_USED(importance);
+}
+
+void
+GUI_DrawStatusBarTextWrapper(uint8 priority, uint16 str1, uint16 str2, uint16 str3)
+{
+	VARIABLE_NOT_USED(priority);
+	VARIABLE_NOT_USED(str1);
+	VARIABLE_NOT_USED(str2);
+	VARIABLE_NOT_USED(str3);
+}
+
+void
+GUI_Palette_CreateRemap(uint8 houseID)
+{
+	VARIABLE_NOT_USED(houseID);
+}
+
+uint16
+GUI_DisplayModalMessage(const char *str, uint16 shapeID, ...)
+{
+	VARIABLE_NOT_USED(shapeID);
+
+	printf("%s\n", str);
+	return 0;
+}
+
+bool
+GUI_Widget_Cancel_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+bool
+GUI_Widget_Name_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+bool
+GUI_Widget_Picture_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+bool
+GUI_Widget_RepairUpgrade_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+bool
+GUI_Widget_SpriteTextButton_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+bool
+GUI_Widget_TextButton_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+void
+ActionPanel_BeginPlacementMode(void)
+{
+}
+
+enum MentatID
+Mentat_InitFromString(const char *str, enum HouseType houseID)
+{
+	VARIABLE_NOT_USED(str);
+	VARIABLE_NOT_USED(houseID);
+
+	return MENTAT_CUSTOM;
+}
+
+bool
+MenuBar_ClickMentat(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+bool
+MenuBar_ClickOptions(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+void
+MenuBar_DisplayWinLose(bool win)
+{
+	VARIABLE_NOT_USED(win);
+}
+
+void
+MenuBar_StartRadarAnimation(bool activate)
+{
+	VARIABLE_NOT_USED(activate);
+}
+
+bool
+Viewport_Click(Widget *w)
+{
+	VARIABLE_NOT_USED(w);
+
+	return false;
+}
+
+/* The dedicated server neither saves nor records replays. */
+bool
+SaveFile(const char *filename, const char *description)
+{
+	VARIABLE_NOT_USED(filename);
+	VARIABLE_NOT_USED(description);
+
+	return false;
+}
+
+void
+SaveFile_WaitForBackground(void)
+{
+}
+
+void
+Prim_Rect_i(int x1, int y1, int x2, int y2, uint8 c)
+{
+	VARIABLE_NOT_USED(x1);
+	VARIABLE_NOT_USED(y1);
+	VARIABLE_NOT_USED(x2);
+	VARIABLE_NOT_USED(y2);
+	VARIABLE_NOT_USED(c);
+}
+
+void
+Shape_DrawRemap(enum ShapeID shapeID, enum HouseType houseID, int x, int y, enum WindowID windowID, int flags)
+{
+	VARIABLE_NOT_USED(shapeID);
+	VARIABLE_NOT_USED(houseID);
+	VARIABLE_NOT_USED(x);
+	VARIABLE_NOT_USED(y);
+	VARIABLE_NOT_USED(windowID);
+	VARIABLE_NOT_USED(flags);
+}
+
+void
+Video_DrawMinimap(int left, int top, int map_scale, enum MinimapDrawMode mode)
+{
+	VARIABLE_NOT_USED(left);
+	VARIABLE_NOT_USED(top);
+	VARIABLE_NOT_USED(map_scale);
+	VARIABLE_NOT_USED(mode);
+}
+
+void
+Video_InitMentatSprites(bool use_benepal)
+{
+	VARIABLE_NOT_USED(use_benepal);
+}
+
+void
+Video_SetPalette(const uint8 *palette, int from, int length)
+{
+	VARIABLE_NOT_USED(palette);
+	VARIABLE_NOT_USED(from);
+	VARIABLE_NOT_USED(length);
+}
@@ -0,0 +1,34 @@
+/** @file src/codec/digram.c Decoder for compressed strings. */
+
+#include "types.h"
+
+#include "digram.h"
+
+static const char * const s_digramTable = " etainosrlhcdupmtasio wb rnsdalmh ieorasnrtlc synstcloer dtgesionr ufmsw tep.icae oiadur laeiyodeia otruetoakhlr eiu,.oansrctlaileoiratpeaoip bm";
+
+/**
+ * Decompress a string.
+ *
+ * @param source The compressed string.
+ * @param dest The decompressed string.
+ * @return The length of decompressed string.
+ */
+uint16 Digram_Decode(const char *source, char *dest)
+{
+	uint16 count;
+	const char *s;
+
+	count = 0;
+
+	for (s = source; *s != '\0'; s++) {
+		uint8 c = *s;
+		if ((c & 0x80) != 0) {
+			c &= 0x7F;
+			dest[count++] = s_digramTable[c >> 3];
+			c = s_digramTable[c + 16];
+		}
+		dest[count++] = c;
+	}
+	dest[count] = '\0';
+	return count;
+}
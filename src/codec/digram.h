@@ -0,0 +1,8 @@
+/** @file src/codec/digram.h Function signature for decoder of compressed strings. */
+
+#ifndef CODEC_DIGRAM_H
+#define CODEC_DIGRAM_H
+
+extern uint16 Digram_Decode(const char *source, char *dest);
+
+#endif /* CODEC_DIGRAM_H */
@@ -1,11 +1,53 @@
 /** @file src/codec/format40.c Decoder for 'format40' files. */
 
+#include <inttypes.h>
+#include <string.h>
 #include "types.h"
 
 #include "format40.h"
 
 #include "../gfx.h"
 
+/**
+ * Xor n bytes of src into dst, a machine word at a time.
+ */
+static void Format40_XorBytes(uint8 *dst, const uint8 *src, uint32 n)
+{
+	for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t)) {
+		uint64_t a, b;
+
+		memcpy(&a, dst, sizeof(a));
+		memcpy(&b, src, sizeof(b));
+		a ^= b;
+		memcpy(dst, &a, sizeof(a));
+
+		dst += sizeof(uint64_t);
+		src += sizeof(uint64_t);
+	}
+
+	for (; n > 0; n--) *dst++ ^= *src++;
+}
+
+/**
+ * Xor n bytes of dst with value, a machine word at a time.
+ */
+static void Format40_XorValue(uint8 *dst, uint8 value, uint32 n)
+{
+	const uint64_t v = value * UINT64_C(0x0101010101010101);
+
+	for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t)) {
+		uint64_t a;
+
+		memcpy(&a, dst, sizeof(a));
+		a ^= v;
+		memcpy(dst, &a, sizeof(a));
+
+		dst += sizeof(uint64_t);
+	}
+
+	for (; n > 0; n--) *dst++ ^= value;
+}
+
 /**
  * Decode a memory fragment which is encoded with 'format40'.
  * @param dst The place the decoded fragment will be loaded.
@@ -20,18 +62,15 @@ void Format40_Decode(uint8 *dst, uint8 *src)
 
 		if (flag == 0) {
 			flag = *src++;
-			for (; flag > 0; flag--) {
-				*dst++ ^= *src;
-			}
-			src++;
-
+			Format40_XorValue(dst, *src++, flag);
+			dst += flag;
 			continue;
 		}
 
 		if ((flag & 0x80) == 0) {
-			for (; flag > 0; flag--) {
-				*dst++ ^= *src++;
-			}
+			Format40_XorBytes(dst, src, flag);
+			dst += flag;
+			src += flag;
 			continue;
 		}
 
@@ -52,24 +91,64 @@ void Format40_Decode(uint8 *dst, uint8 *src)
 
 		if ((flag & 0x4000) == 0) {
 			flag &= 0x3FFF;
-			for (; flag > 0; flag--) {
-				*dst++ ^= *src++;
-			}
+			Format40_XorBytes(dst, src, flag);
+			dst += flag;
+			src += flag;
 			continue;
 		}
 
 		{
 			flag &= 0x3FFF;
-			for (; flag > 0; flag--) {
-				*dst++ ^= *src;
-			}
-			src++;
+			Format40_XorValue(dst, *src++, flag);
+			dst += flag;
 			continue;
 		}
 	}
 }
 
 
+/**
+ * Xor count bytes, from src or of value if src is NULL, into a rectangle
+ *  on the screen, going to the next row every width bytes.
+ * @param base Base of the current row; advanced when the row is full.
+ * @param dst Where to start.
+ * @param length Bytes already done in the current row.
+ * @param width Width of the rectangle.
+ * @param src Data source, or NULL.
+ * @param value The value to xor with if src is NULL.
+ * @param count The number of bytes.  The original loops ran 65536 times
+ *  when given 0, so 0 means that here too.
+ * @return The new destination.
+ */
+static uint8 *Format40_XorSpanToScreen(uint8 **base, uint8 *dst, uint16 *length, uint16 width,
+		const uint8 *src, uint8 value, uint32 count)
+{
+	if (count == 0) count = 0x10000;
+
+	while (count > 0) {
+		const uint32 n = (count < (uint32)(width - *length)) ? count : (uint32)(width - *length);
+
+		if (src != NULL) {
+			Format40_XorBytes(dst, src, n);
+			src += n;
+		} else {
+			Format40_XorValue(dst, value, n);
+		}
+
+		dst     += n;
+		*length += n;
+		count   -= n;
+
+		if (*length == width) {
+			*length = 0;
+			*base += SCREEN_WIDTH;
+			dst = *base;
+		}
+	}
+
+	return dst;
+}
+
 /**
  * Xor a rectangle from a format40 compressed data source to the screen.
  * @param base Base of the rectangle (top-left pixel).
@@ -90,34 +169,14 @@ void Format40_Decode_XorToScreen(uint8 *base, uint8 *src, uint16 width)
 		flag = *src++;
 
 		if (flag == 0) {
-			uint8 value;
-
 			flag = *src++;
-			value = *src++;
-			do {
-				*dst++ ^= value;
-				length++;
-				if (length == width) {
-					length = 0;
-					base += SCREEN_WIDTH;
-					dst = base;
-				}
-				flag--;
-			} while (flag != 0);
+			dst = Format40_XorSpanToScreen(&base, dst, &length, width, NULL, *src++, flag);
 			continue;
 		}
 
 		if (flag < 128) {
-			do {
-				*dst++ ^= *src++;
-				length++;
-				if (length == width) {
-					length = 0;
-					base += SCREEN_WIDTH;
-					dst = base;
-				}
-				flag--;
-			} while (flag != 0);
+			dst = Format40_XorSpanToScreen(&base, dst, &length, width, src, 0, flag);
+			src += flag;
 			continue;
 		}
 
@@ -150,34 +209,14 @@ void Format40_Decode_XorToScreen(uint8 *base, uint8 *src, uint16 width)
 
 		if ((flag & 0x4000) == 0) {
 			flag &= 0x3FFF;
-			do {
-				*dst++ ^= *src++;
-				length++;
-				if (length == width) {
-					length = 0;
-					base += SCREEN_WIDTH;
-					dst = base;
-				}
-				flag--;
-			} while (flag != 0);
+			dst = Format40_XorSpanToScreen(&base, dst, &length, width, src, 0, flag);
+			src += (flag != 0) ? flag : 0x10000;
 			continue;
 		}
 
 		{
-			uint8 value;
-
 			flag &= 0x3FFF;
-			value = *src++;
-			do {
-				*dst++ ^= value;
-				length++;
-				if (length == width) {
-					length = 0;
-					base += SCREEN_WIDTH;
-					dst = base;
-				}
-				flag--;
-			} while (flag != 0);
+			dst = Format40_XorSpanToScreen(&base, dst, &length, width, NULL, *src++, flag);
 			continue;
 		}
 	}
@@ -5,6 +5,22 @@
 
 #include "format80.h"
 
+/**
+ * Copy size bytes from src to dest, where src may overlap the bytes
+ *  being written.  Overlapping copies repeat the pattern, as the format
+ *  requires, so they go byte by byte; the rest are handed to memcpy.
+ */
+static void Format80_Copy(uint8 *dest, const uint8 *src, uint16 size)
+{
+	if (src + size <= dest || dest + size <= src) {
+		memcpy(dest, src, size);
+	} else if (src + 1 == dest) {
+		memset(dest, *src, size);
+	} else {
+		for (; size > 0; size--) *dest++ = *src++;
+	}
+}
+
 /**
  * Decode a memory fragment which is encoded with 'format80'.
  * @param dest The place the decoded fragment will be loaded.
@@ -31,8 +47,8 @@ uint16 Format80_Decode(uint8 *dest, const uint8 *source, uint16 destLength)
 
 			offset = ((flag & 0xF) << 8) + (*source++);
 
-			/* This decoder assumes memcpy. As some platforms implement memcpy as memmove, this is much safer */
-			for (; size > 0; size--) { *dest = *(dest - offset); dest++; }
+			Format80_Copy(dest, dest - offset, size);
+			dest += size;
 			continue;
 		}
 
@@ -62,8 +78,8 @@ uint16 Format80_Decode(uint8 *dest, const uint8 *source, uint16 destLength)
 			offset += (*source++) << 8;
 
 			s = end - destLength + offset;
-			/* This decoder assumes memcpy. As some platforms implement memcpy as memmove, this is much safer */
-			for (; size > 0; size--) *dest++ = *s++;
+			Format80_Copy(dest, s, size);
+			dest += size;
 			continue;
 		}
 
@@ -78,8 +94,8 @@ uint16 Format80_Decode(uint8 *dest, const uint8 *source, uint16 destLength)
 			offset += (*source++) << 8;
 
 			s = end - destLength + offset;
-			/* This decoder assumes memcpy. As some platforms implement memcpy as memmove, this is much safer */
-			for (; size > 0; size--) *dest++ = *s++;
+			Format80_Copy(dest, s, size);
+			dest += size;
 			continue;
 		}
 
@@ -88,8 +104,10 @@ uint16 Format80_Decode(uint8 *dest, const uint8 *source, uint16 destLength)
 			size = flag & 0x3F;
 			if (size > end - dest) size = end - dest;
 
-			/* This decoder assumes memcpy. As some platforms implement memcpy as memmove, this is much safer */
-			for (; size > 0; size--) *dest++ = *source++;
+			/* WSA_LoadFile decodes in place, from the end of the buffer. */
+			memmove(dest, source, size);
+			dest += size;
+			source += size;
 			continue;
 		}
 	}
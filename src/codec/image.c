@@ -0,0 +1,43 @@
+/** @file src/codec/image.c Decoder for compressed images (CPS and ICN sprite sets). */
+
+#include <string.h>
+#include "types.h"
+#include "../os/endian.h"
+
+#include "image.h"
+
+#include "format80.h"
+
+/**
+ * Decodes an image.
+ *
+ * @param source The encoded image.
+ * @param dest The place the decoded image will be.
+ * @return The size of the decoded image.
+ */
+uint32 Image_Decode(const uint8 *source, uint8 *dest)
+{
+	uint32 size = 0;
+
+	switch(*source) {
+		case 0x0:
+			source += 2;
+			size = READ_LE_UINT32(source);
+			source += 4;
+			source += READ_LE_UINT16(source);
+			source += 2;
+			memmove(dest, source, size);
+			break;
+
+		case 0x4:
+			source += 6;
+			source += READ_LE_UINT16(source);
+			source += 2;
+			size = Format80_Decode(dest, source, 0xFFFF);
+			break;
+
+		default: break;
+	}
+
+	return size;
+}
@@ -0,0 +1,8 @@
+/** @file src/codec/image.h Function signature for decoder of compressed images. */
+
+#ifndef CODEC_IMAGE_H
+#define CODEC_IMAGE_H
+
+extern uint32 Image_Decode(const uint8 *source, uint8 *dest);
+
+#endif /* CODEC_IMAGE_H */
@@ -0,0 +1,38 @@
+/** @file src/codec/voc.c Reader for 'Creative Voice' (VOC) files. */
+
+#include "types.h"
+
+#include "voc.h"
+
+/**
+ * Reads the header of a VOC file.  The file is taken to hold a single
+ *  block of 8 bit mono sound data, as all of Dune II's do; the block
+ *  type and codec are not checked.
+ * @param header The first VOC_HEADER_SIZE bytes of the file.
+ * @param file_size The size of the whole file.
+ * @param voc Set to where the samples are.
+ * @return False if the file is too short to hold any samples.  The
+ *  length is clamped to the end of the file.
+ */
+bool Voc_ReadHeader(const uint8 *header, uint32 file_size, VocSample *voc)
+{
+	/* "Creative Voice File\x1A", then the data offset, version and
+	 * checksum, then the first block's type and 24 bit size.
+	 */
+	const uint8 *block = header + 0x1A;
+	uint32 size;
+	uint8 rate;
+
+	if (file_size <= VOC_HEADER_SIZE) return false;
+
+	size = block[1] | (block[2] << 8) | ((uint32)block[3] << 16);
+	rate = block[4];
+	if (size <= 2) return false;
+
+	voc->offset    = VOC_HEADER_SIZE;
+	voc->length    = size - 2;
+	voc->frequency = 1000000 / (256 - rate);
+
+	if (voc->length > file_size - VOC_HEADER_SIZE) voc->length = file_size - VOC_HEADER_SIZE;
+	return true;
+}
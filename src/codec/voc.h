@@ -0,0 +1,19 @@
+/** @file src/codec/voc.h Definitions for 'Creative Voice' (VOC) files. */
+
+#ifndef CODEC_VOC_H
+#define CODEC_VOC_H
+
+enum {
+	VOC_HEADER_SIZE = 0x20 /*!< File header and the first block's header. */
+};
+
+/** Where the samples of a VOC file are, and how to play them. */
+typedef struct VocSample {
+	uint32 offset;    /*!< Offset of the first sample from the start of the file. */
+	uint32 length;    /*!< Number of samples; unsigned 8 bit mono. */
+	uint32 frequency; /*!< Samples per second. */
+} VocSample;
+
+extern bool Voc_ReadHeader(const uint8 *header, uint32 file_size, VocSample *voc);
+
+#endif /* CODEC_VOC_H */
@@ -36,7 +36,7 @@ typedef struct GameCfg {
 	struct DisplayMode displayMode;
 } GameCfg;
 
-extern GameCfg g_gameConfig;
+extern THREAD_LOCAL GameCfg g_gameConfig;
 
 extern void Config_GetCampaign(void);
 extern void Config_SaveCampaignCompletion(void);
@@ -14,8 +14,12 @@
 #include "enhancement.h"
 #include "file.h"
 #include "gfx.h"
+#include "net/client.h"
 #include "net/net.h"
+#include "net/telemetry.h"
 #include "opendune.h"
+#include "replay.h"
+#include "save.h"
 #include "scenario.h"
 #include "string.h"
 #include "table/locale.h"
@@ -72,7 +76,7 @@ typedef struct GameOption {
 
 static ALLEGRO_CONFIG *s_configFile;
 
-GameCfg g_gameConfig = {
+THREAD_LOCAL GameCfg g_gameConfig = {
 #ifdef __PANDORA__
 	WM_FULLSCREEN,
 #else
@@ -104,6 +108,8 @@ static const GameOption s_game_option[] = {
 	{ "game",   "game_speed",       CONFIG_INT_0_4, .d._int = &g_gameConfig.gameSpeed },
 	{ "game",   "hints",            CONFIG_BOOL,    .d._bool = &g_gameConfig.hints },
 	{ "game",   "campaign",         CONFIG_CAMPAIGN,.d._int = &g_campaign_selected },
+	{ "game",   "record_replay",    CONFIG_BOOL,    .d._bool = &g_record_replay },
+	{ "game",   "autosave_interval",CONFIG_INT,     .d._int = &g_autosave_interval },
 
 	{ "graphics",   "driver",           CONFIG_GRAPHICS_DRIVER, .d._graphics_driver = &g_graphics_driver },
 	{ "graphics",   "window_mode",      CONFIG_WINDOW_MODE,     .d._window_mode = &g_gameConfig.windowMode },
@@ -181,6 +187,9 @@ static const GameOption s_game_option[] = {
 	{ "multiplayer",    "host_port",    CONFIG_STRING_PORT, .d._string = g_host_port },
 	{ "multiplayer",    "join_address", CONFIG_STRING,      .d._string = g_join_addr },
 	{ "multiplayer",    "join_port",    CONFIG_STRING_PORT, .d._string = g_join_port },
+	{ "multiplayer",    "extrapolation_ticks",  CONFIG_INT, .d._int = &g_client_extrapolation_ticks },
+	{ "multiplayer",    "compression",  CONFIG_BOOL,        .d._bool = &g_net_compression },
+	{ "multiplayer",    "telemetry_interval",   CONFIG_INT, .d._int = &g_net_telemetry_interval },
 
 	{ NULL, NULL, CONFIG_BOOL, .d._bool = NULL }
 };
@@ -0,0 +1,268 @@
+/* dedicated.c
+ *
+ * Headless dedicated server.  It hosts the multiplayer lobby, starts
+ * the game once every client has picked a house, and runs the
+ * simulation without Allegro, a window, or a player of its own.
+ *
+ * With --matches N it hosts N matches side by side, one per thread,
+ * on consecutive ports.  Each thread runs its match on a game context
+ * of its own (see gamecontext.c).
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "buildcfg.h"
+#include "enum_string.h"
+
+#include "file.h"
+#include "gamecontext.h"
+#include "gfx.h"
+#include "house.h"
+#include "mods/mapgenerator.h"
+#include "mods/multiplayer.h"
+#include "mods/skirmish.h"
+#include "net/net.h"
+#include "opendune.h"
+#include "scenario.h"
+#include "sprites.h"
+#include "string.h"
+#include "structure.h"
+#include "timer/timer_posix.h"
+#include "tools/random_lcg.h"
+#include "tools/random_xorshift.h"
+#include "unit.h"
+
+/* Seconds between every client being ready and the game starting. */
+#define DEDICATED_START_DELAY   5
+
+/* Most matches one server will host. */
+#define DEDICATED_MATCHES_MAX   16
+
+typedef struct DedicatedMatch {
+	pthread_t thread;
+	const char *addr;
+	int port;
+	unsigned int seed;
+} DedicatedMatch;
+
+THREAD_LOCAL enum MapGeneratorMode lobby_map_generator_mode;
+
+static bool
+Dedicated_AnyClientInGame(void)
+{
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (g_peer_data[i].state == CLIENTSTATE_IN_GAME)
+			return true;
+	}
+
+	return false;
+}
+
+/* Runs the lobby until the game starts.  The start is announced in
+ * the chat, and called off if anyone changes their mind in the
+ * meantime.
+ */
+static void
+Dedicated_Lobby(void)
+{
+	double start_time = 0.0;
+
+	lobby_map_generator_mode = MAP_GENERATOR_TRY_TEST_ELSE_RAND;
+
+	for (;;) {
+		Server_WaitForMessages(50);
+		Server_RecvMessages();
+
+		if (lobby_map_generator_mode != MAP_GENERATOR_STOP) {
+			lobby_map_generator_mode = Multiplayer_GenerateMap(lobby_map_generator_mode);
+
+			if (lobby_map_generator_mode == MAP_GENERATOR_STOP)
+				g_sendScenario = true;
+		}
+
+		const bool ready
+			= Net_IsPlayable() && (lobby_map_generator_mode == MAP_GENERATOR_STOP);
+
+		if (!ready) {
+			if (start_time > 0.0) {
+				start_time = 0.0;
+				Server_Recv_Chat(0, FLAG_HOUSE_ALL, "Countdown cancelled");
+			}
+		} else if (start_time <= 0.0) {
+			char msg[MAX_CHAT_LEN + 1];
+
+			snprintf(msg, sizeof(msg), "Game starts in %d seconds", DEDICATED_START_DELAY);
+			Server_Recv_Chat(0, FLAG_HOUSE_ALL, msg);
+			start_time = Timer_GetTime() + DEDICATED_START_DELAY;
+		} else if (Timer_GetTime() >= start_time) {
+			Server_SendMessages();
+
+			if (Server_Send_StartGame())
+				return;
+
+			start_time = 0.0;
+		}
+
+		Server_SendMessages();
+	}
+}
+
+/* Runs the game until every client has returned to the lobby. */
+static void
+Dedicated_PlayGame(void)
+{
+	Sprites_UnloadTiles();
+	Sprites_LoadTiles();
+
+	Timer_ResetScriptTimers();
+	Net_Synchronise();
+	Skirmish_StartScenario();
+
+	g_gameMode = GM_NORMAL;
+	g_inGame = true;
+	Timer_SetTimer(TIMER_GAME, true);
+
+	while (g_gameMode == GM_NORMAL && Dedicated_AnyClientInGame()) {
+		const int64_t curr_ticks = Timer_GameTicks();
+
+		if (g_game->timerGame == curr_ticks) {
+			Server_WaitForMessages(TimerPosix_GetMillisecondsToNextTick(TIMER_GAME));
+			continue;
+		}
+
+		g_game->timerGame = curr_ticks;
+		GameLoop_Server_Step();
+		GameLoop_LevelEnd();
+		Server_SendMessages();
+	}
+
+	g_inGame = false;
+	Server_SendMessages();
+}
+
+static void
+Dedicated_Usage(const char *argv0)
+{
+	fprintf(stderr,
+			"Usage: %s [--addr ADDR] [--port PORT] [--data-dir DIR] [--matches N]\n",
+			argv0);
+}
+
+/* Sets up the state of one match on the calling thread. */
+static void
+Dedicated_InitMatch(unsigned int seed)
+{
+	g_game = GameContext_Create();
+
+	FileHash_Init();
+
+	memcpy(g_table_houseInfo, g_table_houseInfo_original, sizeof(g_table_houseInfo_original));
+	memcpy(g_table_structureInfo, g_table_structureInfo_original, sizeof(g_table_structureInfo_original));
+	memcpy(g_table_unitInfo, g_table_unitInfo_original, sizeof(g_table_unitInfo_original));
+
+	Tools_RandomLCG_Seed(seed);
+	Random_Xorshift_Seed(seed, rand(), rand(), rand());
+
+	GFX_Init();
+	String_Init();
+
+	/* The campaign IDs must match the client's. */
+	Campaign *camp;
+
+	camp = Campaign_Alloc(NULL);
+	camp->house[0] = HOUSE_ATREIDES;
+	camp->house[1] = HOUSE_ORDOS;
+	camp->house[2] = HOUSE_HARKONNEN;
+	camp->intermission = true;
+	snprintf(camp->name, sizeof(camp->name), "%s", String_Get_ByIndex(STR_THE_BATTLE_FOR_ARRAKIS));
+
+	camp = Campaign_Alloc("skirmish");
+	snprintf(camp->name, sizeof(camp->name), "Skirmish");
+
+	camp = Campaign_Alloc("multiplayer");
+	snprintf(camp->name, sizeof(camp->name), "Multiplayer");
+
+	g_campaign_selected = CAMPAIGNID_MULTIPLAYER;
+	g_playerHouseID = HOUSE_INVALID;
+	Sprites_LoadTiles();
+}
+
+/* Hosts one match after another on a single port. */
+static void *
+Dedicated_RunMatch(void *arg)
+{
+	const DedicatedMatch *match = arg;
+
+	Dedicated_InitMatch(match->seed);
+
+	if (!Net_CreateServer(match->addr, match->port, NULL)) {
+		fprintf(stderr, "Could not create server on %s:%d\n", match->addr, match->port);
+		exit(1);
+	}
+
+	printf("Dune Dynasty dedicated server on %s:%d\n", match->addr, match->port);
+	Timer_SetTimer(TIMER_GUI, true);
+
+	for (;;) {
+		Dedicated_Lobby();
+		Dedicated_PlayGame();
+	}
+
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	static DedicatedMatch matches[DEDICATED_MATCHES_MAX];
+	const char *addr = g_host_addr;
+	int port = DEFAULT_PORT;
+	int num_matches = 1;
+
+	snprintf(g_dune_data_dir, sizeof(g_dune_data_dir), "%s", DUNE_DATA_DIR);
+	snprintf(g_personal_data_dir, sizeof(g_personal_data_dir), "%s", DUNE_DATA_DIR);
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--addr") == 0 && i + 1 < argc) {
+			addr = argv[++i];
+		} else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+			port = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc) {
+			snprintf(g_dune_data_dir, sizeof(g_dune_data_dir), "%s", argv[++i]);
+			snprintf(g_personal_data_dir, sizeof(g_personal_data_dir), "%s", g_dune_data_dir);
+		} else if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+			num_matches = atoi(argv[++i]);
+		} else {
+			Dedicated_Usage(argv[0]);
+			exit(1);
+		}
+	}
+
+	if (num_matches < 1 || num_matches > DEDICATED_MATCHES_MAX) {
+		fprintf(stderr, "--matches must be between 1 and %d\n", DEDICATED_MATCHES_MAX);
+		exit(1);
+	}
+
+	srand((unsigned)time(NULL));
+	Net_Initialise();
+
+	for (int i = 0; i < num_matches; i++) {
+		DedicatedMatch *match = &matches[i];
+
+		match->addr = addr;
+		match->port = port + i;
+		match->seed = (unsigned)time(NULL) + i;
+
+		if (pthread_create(&match->thread, NULL, Dedicated_RunMatch, match) != 0) {
+			fprintf(stderr, "Could not start match %d\n", i);
+			exit(1);
+		}
+	}
+
+	for (int i = 0; i < num_matches; i++)
+		pthread_join(matches[i].thread, NULL);
+
+	return 0;
+}
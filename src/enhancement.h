@@ -4,6 +4,7 @@
 #define ENHANCEMENT_H
 
 #include <stdbool.h>
+#include "types.h"
 
 enum HealthBarMode {
 	HEALTH_BAR_DISABLE,
@@ -46,45 +47,45 @@ extern bool const enhancement_fix_ix_colour_remapping;
 extern bool const enhancement_fix_selection_after_entering_structure;
 extern bool const enhancement_fix_typos;
 
-extern bool enhancement_ai_respects_structure_placement;
-extern bool enhancement_brutal_ai;
-extern bool enhancement_construction_does_not_pause;
-extern enum HealthBarMode enhancement_draw_health_bars;
-extern bool enhancement_fog_covers_units;
-extern bool enhancement_fog_of_war;
-extern bool enhancement_fog_of_war_backup;
-extern bool enhancement_high_res_overlays;
-extern bool enhancement_i_mean_where_i_clicked;
-extern bool enhancement_infantry_squad_death_animations;
-extern bool enhancement_insatiable_sandworms;
-extern bool enhancement_invisible_saboteurs;
-extern bool enhancement_nonblocking_radar_animation;
-extern bool enhancement_nonordos_deviation;
-extern bool enhancement_permanent_follow_mode;
-extern bool enhancement_play_additional_voices;
-extern bool enhancement_raise_unit_cap;
-extern bool enhancement_raise_structure_cap;
-extern bool enhancement_repeat_reinforcements;
-extern enum SecurityQuestionMode enhancement_security_question;
-extern enum SmoothUnitAnimationMode enhancement_smooth_unit_animation;
-extern enum SmoothUnitAnimationMode enhancement_smooth_unit_animation_backup;
-extern bool enhancement_soldier_engineers;
-extern bool enhancement_structures_on_concrete_do_not_degrade;
-extern enum SubtitleOverride enhancement_subtitle_override;
-extern bool enhancement_targetted_sabotage;
-extern bool enhancement_true_game_speed_adjustment;
-extern bool enhancement_true_unit_movement_speed;
-extern bool enhancement_attack_dir_consistency;
-extern bool enhancement_skip_introduction;
-extern bool enhancement_extend_sight_range;
-extern bool enhancement_show_outpost_unit_info;
-extern bool enhancement_instant_walls;
+extern THREAD_LOCAL bool enhancement_ai_respects_structure_placement;
+extern THREAD_LOCAL bool enhancement_brutal_ai;
+extern THREAD_LOCAL bool enhancement_construction_does_not_pause;
+extern THREAD_LOCAL enum HealthBarMode enhancement_draw_health_bars;
+extern THREAD_LOCAL bool enhancement_fog_covers_units;
+extern THREAD_LOCAL bool enhancement_fog_of_war;
+extern THREAD_LOCAL bool enhancement_fog_of_war_backup;
+extern THREAD_LOCAL bool enhancement_high_res_overlays;
+extern THREAD_LOCAL bool enhancement_i_mean_where_i_clicked;
+extern THREAD_LOCAL bool enhancement_infantry_squad_death_animations;
+extern THREAD_LOCAL bool enhancement_insatiable_sandworms;
+extern THREAD_LOCAL bool enhancement_invisible_saboteurs;
+extern THREAD_LOCAL bool enhancement_nonblocking_radar_animation;
+extern THREAD_LOCAL bool enhancement_nonordos_deviation;
+extern THREAD_LOCAL bool enhancement_permanent_follow_mode;
+extern THREAD_LOCAL bool enhancement_play_additional_voices;
+extern THREAD_LOCAL bool enhancement_raise_unit_cap;
+extern THREAD_LOCAL bool enhancement_raise_structure_cap;
+extern THREAD_LOCAL bool enhancement_repeat_reinforcements;
+extern THREAD_LOCAL enum SecurityQuestionMode enhancement_security_question;
+extern THREAD_LOCAL enum SmoothUnitAnimationMode enhancement_smooth_unit_animation;
+extern THREAD_LOCAL enum SmoothUnitAnimationMode enhancement_smooth_unit_animation_backup;
+extern THREAD_LOCAL bool enhancement_soldier_engineers;
+extern THREAD_LOCAL bool enhancement_structures_on_concrete_do_not_degrade;
+extern THREAD_LOCAL enum SubtitleOverride enhancement_subtitle_override;
+extern THREAD_LOCAL bool enhancement_targetted_sabotage;
+extern THREAD_LOCAL bool enhancement_true_game_speed_adjustment;
+extern THREAD_LOCAL bool enhancement_true_unit_movement_speed;
+extern THREAD_LOCAL bool enhancement_attack_dir_consistency;
+extern THREAD_LOCAL bool enhancement_skip_introduction;
+extern THREAD_LOCAL bool enhancement_extend_sight_range;
+extern THREAD_LOCAL bool enhancement_show_outpost_unit_info;
+extern THREAD_LOCAL bool enhancement_instant_walls;
 
-extern bool enhancement_fix_scenario_typos;
-extern bool enhancement_read_scenario_structure_health;
-extern bool enhancement_undelay_ordos_siege_tank_tech;
-extern bool enhancement_infantry_mini_rockets;
-extern enum RepairCostFormula enhancement_repair_cost_formula;
-extern bool enhancement_special_trooper_portaits;
+extern THREAD_LOCAL bool enhancement_fix_scenario_typos;
+extern THREAD_LOCAL bool enhancement_read_scenario_structure_health;
+extern THREAD_LOCAL bool enhancement_undelay_ordos_siege_tank_tech;
+extern THREAD_LOCAL bool enhancement_infantry_mini_rockets;
+extern THREAD_LOCAL enum RepairCostFormula enhancement_repair_cost_formula;
+extern THREAD_LOCAL bool enhancement_special_trooper_portaits;
 
 #endif
@@ -10,6 +10,7 @@
 #include "animation.h"
 #include "binheap.h"
 #include "enhancement.h"
+#include "gamecontext.h"
 #include "house.h"
 #include "map.h"
 #include "net/server.h"
@@ -22,7 +23,7 @@
 #include "tools/random_general.h"
 #include "tools/random_lcg.h"
 
-static BinHeap s_explosions;
+static THREAD_LOCAL BinHeap s_explosions;
 
 extern const ExplosionCommandStruct * const g_table_explosion[EXPLOSIONTYPE_MAX];
 
@@ -53,10 +54,11 @@ static void Explosion_Func_TileDamage(Explosion *e, uint16 parameter)
 
 	if (type == LST_STRUCTURE || type == LST_DESTROYED_WALL) return;
 
-	t = &g_map[packed];
+	t = &g_game->map[packed];
 
 	if (type == LST_CONCRETE_SLAB) {
-		t->groundSpriteID = g_mapSpriteID[packed];
+		t->groundSpriteID = g_game->mapSpriteID[packed];
+		Map_MarkDirty(packed);
 	}
 
 	if (g_table_landscapeInfo[type].craterType == 0) return;
@@ -85,6 +87,7 @@ static void Explosion_Func_TileDamage(Explosion *e, uint16 parameter)
 
 	/* Update the tile with the crater */
 	t->overlaySpriteID = overlaySpriteID + iconMap[0];
+	Map_MarkDirty(packed);
 }
 
 /**
@@ -119,7 +122,7 @@ static void Explosion_Func_BloomExplosion(Explosion *e, uint16 parameter)
 	uint16 packed = Tile_PackTile(e->position);
 	VARIABLE_NOT_USED(parameter);
 
-	if (g_map[packed].groundSpriteID != g_bloomSpriteID) return;
+	if (g_game->map[packed].groundSpriteID != g_bloomSpriteID) return;
 
 	Map_Bloom_ExplodeSpice(packed, FLAG_HOUSE_ALL);
 }
@@ -162,7 +165,7 @@ static void Explosion_Func_Stop(Explosion *e, uint16 parameter)
 	uint16 packed = Tile_PackTile(e->position);
 	VARIABLE_NOT_USED(parameter);
 
-	g_map[packed].hasExplosion = false;
+	g_game->map[packed].hasExplosion = false;
 
 	Explosion_Update(e);
 
@@ -207,7 +210,7 @@ static void Explosion_Func_SetSpriteID(Explosion *e, uint16 spriteID)
  */
 static void Explosion_StopAtPosition(uint16 packed)
 {
-	if (!g_map[packed].hasExplosion) return;
+	if (!g_game->map[packed].hasExplosion) return;
 
 	for (int i = 1; i < s_explosions.num_elem; i++) {
 		Explosion *e = (Explosion *)BinHeap_GetElem(&s_explosions, i);
@@ -232,6 +235,16 @@ Explosion_Uninit(void)
 	BinHeap_Free(&s_explosions);
 }
 
+/**
+ * @brief   The active explosions, for snapshots to copy.
+ * @details Introduced.
+ */
+BinHeap *
+Explosion_GetHeap(void)
+{
+	return &s_explosions;
+}
+
 /**
  * Start a Explosion on a tile.
  * @param explosionType Type of Explosion.
@@ -253,7 +266,7 @@ void Explosion_Start(uint16 explosionType, tile32 position, uint8 houseID)
 		e->position = position;
 		e->houseID = houseID;
 
-		g_map[packed].hasExplosion = true;
+		g_game->map[packed].hasExplosion = true;
 
 		/* Do not unveil for sandworm eat and spice bloom explosion types.
 		 * In multiplayer, only reveal nearby explosions.
@@ -71,8 +71,11 @@ typedef struct Explosion {
 	uint8 houseID;                          /*!< House from which the explosion originates. Determines deviator gas color. */
 } Explosion;
 
+struct BinHeap;
+
 extern void Explosion_Init(void);
 extern void Explosion_Uninit(void);
+extern struct BinHeap *Explosion_GetHeap(void);
 extern void Explosion_Start(uint16 explosionType, tile32 position, uint8 houseID);
 extern void Explosion_Tick(void);
 extern void Explosion_Draw(void);
@@ -1,7 +1,12 @@
 /** @file src/file.c %File access routines. */
 
+#ifdef DEDICATED_SERVER
+#include <errno.h>
+#include <sys/stat.h>
+#else
 /* Use Allegro to create directories. */
 #include <allegro5/allegro.h>
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -34,8 +39,8 @@ typedef struct File {
 	uint32 position;
 } File;
 
-static File s_file[FILE_MAX];
-static FileInfo s_hash_file[HASH_SIZE];
+static THREAD_LOCAL File s_file[FILE_MAX];
+static THREAD_LOCAL FileInfo s_hash_file[HASH_SIZE];
 
 char g_dune_data_dir[PATH_MAX];
 char g_personal_data_dir[PATH_MAX];
@@ -193,6 +198,38 @@ File_MakeCompleteFilename(char *buf, size_t len, enum SearchDirectory dir, const
 	}
 }
 
+/* Creates the directory and any missing parents. */
+static bool
+File_MakeDirectory(const char *path)
+{
+#ifdef DEDICATED_SERVER
+	/* The dedicated server does without Allegro. */
+	char buf[1024];
+
+	snprintf(buf, sizeof(buf), "%s", path);
+
+	for (char *c = buf + 1; ; c++) {
+		if (*c != '/' && *c != '\0')
+			continue;
+
+		const char old = *c;
+
+		*c = '\0';
+		if (mkdir(buf, 0755) != 0 && errno != EEXIST)
+			return false;
+
+		if (old == '\0' || c[1] == '\0')
+			break;
+
+		*c = old;
+	}
+
+	return true;
+#else
+	return al_make_directory(path);
+#endif
+}
+
 FILE *
 File_Open_CaseInsensitive(enum SearchDirectory dir, const char *filename, const char *mode)
 {
@@ -202,7 +239,7 @@ File_Open_CaseInsensitive(enum SearchDirectory dir, const char *filename, const
 	/* Create directories. */
 	if (dir == SEARCHDIR_PERSONAL_DATA_DIR && mode[0] == 'w') {
 		File_MakeCompleteFilename(buf, sizeof(buf), dir, "", false);
-		if (!al_make_directory(buf))
+		if (!File_MakeDirectory(buf))
 			return NULL;
 	}
 
@@ -0,0 +1,168 @@
+/**
+ * @file src/gamecontext.c
+ *
+ * Game contexts.
+ *
+ * A game context holds the simulation state of one match: the map,
+ * the object pools, the game timers, the scenario and the AI squads.
+ * The simulation reaches it through g_game.  The client has the one
+ * context for its whole run.  The dedicated server gives each match
+ * thread a context of its own; g_game is per thread there, as is the
+ * rest of the state a match writes (see THREAD_LOCAL).  g_game is per
+ * thread in the client too, whose background saves are written from a
+ * copy of the context on a thread of their own.
+ *
+ * The build queues of structures and houses point into the scenario
+ * arena, which is not part of the context.  GameContext_CopyQueues
+ * gives a copy queues of its own.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gamecontext.h"
+
+static GameContext s_gameContext;
+
+/** The context the simulation on this thread runs on. */
+THREAD_STORAGE GameContext *g_game = &s_gameContext;
+
+/**
+ * @brief   Allocates an empty game context.
+ * @details Introduced.
+ */
+GameContext *
+GameContext_Create(void)
+{
+	GameContext *ctx = calloc(1, sizeof(GameContext));
+	assert(ctx != NULL);
+
+	return ctx;
+}
+
+void
+GameContext_Free(GameContext *ctx)
+{
+	if (ctx == NULL || ctx == &s_gameContext)
+		return;
+
+	free(ctx);
+}
+
+/**
+ * @brief   Moves a pointer into src to the same place in dst.
+ * @details Introduced.
+ */
+static void *
+GameContext_Rebase(void *ptr, GameContext *dst, const GameContext *src)
+{
+	if (ptr == NULL)
+		return NULL;
+
+	return (char *)dst + ((const char *)ptr - (const char *)src);
+}
+
+/**
+ * @brief   Copies the state in src over dst.
+ * @details Introduced.  The find arrays and the current script objects
+ *          point into the context, so they are moved to point into dst.
+ */
+void
+GameContext_Copy(GameContext *dst, const GameContext *src)
+{
+	if (dst == src)
+		return;
+
+	memcpy(dst, src, sizeof(GameContext));
+
+	for (int i = 0; i < src->unitFindCount; i++) {
+		dst->unitFindArray[i] = GameContext_Rebase(src->unitFindArray[i], dst, src);
+	}
+
+	for (int i = 0; i < src->structureFindCount; i++) {
+		dst->structureFindArray[i] = GameContext_Rebase(src->structureFindArray[i], dst, src);
+	}
+
+	for (int i = 0; i < src->houseFindCount; i++) {
+		dst->houseFindArray[i] = GameContext_Rebase(src->houseFindArray[i], dst, src);
+	}
+
+	for (int i = 0; i < src->teamFindCount; i++) {
+		dst->teamFindArray[i] = GameContext_Rebase(src->teamFindArray[i], dst, src);
+	}
+
+	dst->scriptCurrentObject = GameContext_Rebase(src->scriptCurrentObject, dst, src);
+	dst->scriptCurrentStructure = GameContext_Rebase(src->scriptCurrentStructure, dst, src);
+	dst->scriptCurrentUnit = GameContext_Rebase(src->scriptCurrentUnit, dst, src);
+	dst->scriptCurrentTeam = GameContext_Rebase(src->scriptCurrentTeam, dst, src);
+}
+
+/**
+ * @brief   Copies the items of a queue into items, and links the queue
+ *          to the copies.
+ * @return  The number of items copied.
+ */
+static int
+GameContext_CopyQueue(BuildQueue *queue, BuildQueueItem *items)
+{
+	BuildQueueItem *prev = NULL;
+	int n = 0;
+
+	for (const BuildQueueItem *e = queue->first; e != NULL; e = e->next, n++) {
+		items[n] = *e;
+		items[n].prev = prev;
+		items[n].next = NULL;
+
+		if (prev != NULL)
+			prev->next = &items[n];
+
+		prev = &items[n];
+	}
+
+	queue->first = (n > 0) ? &items[0] : NULL;
+	queue->last = prev;
+	return n;
+}
+
+/**
+ * @brief   Gives the build queues in ctx items of their own.
+ * @details Introduced.  After GameContext_Copy, the queues still share
+ *          their items with the live game.  The items are copied into
+ *          *items, which is grown as needed, so that ctx can be read
+ *          while the game goes on.  Call it on the thread of the game.
+ */
+void
+GameContext_CopyQueues(GameContext *ctx, BuildQueueItem **items, int *max_items)
+{
+	const int num_structures = StructurePool_GetIndex(STRUCTURE_INDEX_MAX_HARD);
+	int num_items = 0;
+
+	for (int i = 0; i < num_structures; i++) {
+		for (const BuildQueueItem *e = ctx->structureArray[i].queue.first; e != NULL; e = e->next)
+			num_items++;
+	}
+
+	for (int i = 0; i < HOUSE_MAX; i++) {
+		for (const BuildQueueItem *e = ctx->houseArray[i].starportQueue.first; e != NULL; e = e->next)
+			num_items++;
+	}
+
+	if (num_items == 0)
+		return;
+
+	if (*max_items < num_items) {
+		free(*items);
+		*items = malloc(num_items * sizeof(BuildQueueItem));
+		*max_items = num_items;
+		assert(*items != NULL);
+	}
+
+	BuildQueueItem *e = *items;
+
+	for (int i = 0; i < num_structures; i++)
+		e += GameContext_CopyQueue(&ctx->structureArray[i].queue, e);
+
+	for (int i = 0; i < HOUSE_MAX; i++)
+		e += GameContext_CopyQueue(&ctx->houseArray[i].starportQueue, e);
+}
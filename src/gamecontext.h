@@ -0,0 +1,92 @@
+/** @file src/gamecontext.h Game context definitions. */
+
+#ifndef GAMECONTEXT_H
+#define GAMECONTEXT_H
+
+#include <stdint.h>
+#include "types.h"
+
+#include "ai.h"
+#include "house.h"
+#include "map.h"
+#include "pool/pool_house.h"
+#include "pool/pool_structure.h"
+#include "pool/pool_team.h"
+#include "pool/pool_unit.h"
+#include "scenario.h"
+#include "structure.h"
+#include "team.h"
+#include "unit.h"
+
+/**
+ * The simulation state of one match.
+ */
+typedef struct GameContext {
+	/* In fog of war, map is the TRUE information, and the map
+	 * scouted.  mapVisible is the KNOWN information, and the map
+	 * currently visible.
+	 */
+	Tile map[MAP_SIZE_MAX * MAP_SIZE_MAX];                  /*!< What is on the map. */
+	FogOfWarTile mapVisible[MAP_SIZE_MAX * MAP_SIZE_MAX];   /*!< What each house knows of the map. */
+	uint16 mapSpriteID[MAP_SIZE_MAX * MAP_SIZE_MAX];        /*!< The sprite drawn on each tile. */
+
+	Unit unitArray[UNIT_INDEX_MAX_RAISED];                  /*!< The Unit pool. */
+	Unit *unitFindArray[UNIT_INDEX_MAX_RAISED];             /*!< The allocated Units, in the order they are found. */
+	uint16 unitFindCount;                                   /*!< Number of allocated Units. */
+
+	Structure structureArray[STRUCTURE_INDEX_MAX_HARD + STRUCTURE_INDEX_RAISED_AMOUNT]; /*!< The Structure pool. */
+	Structure *structureFindArray[STRUCTURE_INDEX_MAX_SOFT + STRUCTURE_INDEX_RAISED_AMOUNT]; /*!< The allocated Structures, in the order they are found. */
+	uint16 structureFindCount;                              /*!< Number of allocated Structures. */
+	uint16 structureIndexHead[HOUSE_NEUTRAL][STRUCTURE_MAX]; /*!< First Structure of each house and type. */
+	uint16 structureIndexNext[STRUCTURE_INDEX_MAX_SOFT + STRUCTURE_INDEX_RAISED_AMOUNT]; /*!< Next Structure of the same house and type. */
+	uint8  structureIndexHouse[STRUCTURE_INDEX_MAX_SOFT + STRUCTURE_INDEX_RAISED_AMOUNT]; /*!< House each Structure is indexed under. */
+	uint32 structureFindOrder[STRUCTURE_INDEX_MAX_SOFT + STRUCTURE_INDEX_RAISED_AMOUNT]; /*!< Position of each Structure in structureFindArray's order. */
+	uint32 structureFindOrderNext;                          /*!< Position of the next Structure allocated. */
+
+	House houseArray[HOUSE_INDEX_MAX];                      /*!< The House pool. */
+	House *houseFindArray[HOUSE_INDEX_MAX];                 /*!< The allocated Houses. */
+	uint16 houseFindCount;                                  /*!< Number of allocated Houses. */
+
+	Team teamArray[TEAM_INDEX_MAX];                         /*!< The Team pool. */
+	Team *teamFindArray[TEAM_INDEX_MAX];                    /*!< The allocated Teams. */
+	uint16 teamFindCount;                                   /*!< Number of allocated Teams. */
+
+	int64_t timerGame;                                      /*!< Game ticks so far. */
+	int64_t tickScenarioStart;                              /*!< Tick the scenario started. */
+	int64_t tickHousePowerMaintenance;                      /*!< Next tick to pay for power and maintenance. */
+	int64_t tickHouseHouse;                                 /*!< Next tick of the house logic. */
+	int64_t tickHouseStarport;                              /*!< Next tick of the starport delivery. */
+	int64_t tickHouseReinforcement;                         /*!< Next tick of the reinforcements. */
+	int64_t tickHouseMissileCountdown;                      /*!< Next tick of the missile countdown. */
+	int64_t tickHouseStarportAvailability;                  /*!< Next tick of the starport availability. */
+	int64_t tickHouseStarportRecalculatePrices;             /*!< Next tick the starport prices change. */
+	int64_t tickStructureDegrade;                           /*!< Next tick Structures degrade. */
+	int64_t tickStructureStructure;                         /*!< Next tick of the Structure logic. */
+	int64_t tickStructureScript;                            /*!< Next tick of the Structure scripts. */
+	int64_t tickStructurePalace;                            /*!< Next tick of the palace countdown. */
+	int64_t tickTeamGameLoop;                               /*!< Next tick of the Team logic. */
+	int64_t tickUnitMovement;                               /*!< Next tick Units move. */
+	int64_t tickUnitRotation;                               /*!< Next tick Units rotate. */
+	int64_t tickUnitBlinking;                               /*!< Next tick Units blink. */
+	int64_t tickUnitUnknown4;                               /*!< Next tick Units fire. */
+	int64_t tickUnitScript;                                 /*!< Next tick of the Unit scripts. */
+	int64_t tickUnitUnknown5;                               /*!< Next tick Units animate. */
+	int64_t tickUnitDeviation;                              /*!< Next tick deviated Units may return. */
+
+	Scenario scenario;                                      /*!< The scenario being played. */
+	AISquad aisquad[SQUADID_MAX + 1];                       /*!< Squads of the brutal AI. */
+
+	struct Object *scriptCurrentObject;                     /*!< The Object whose script is running. */
+	struct Structure *scriptCurrentStructure;               /*!< The Structure whose script is running, if any. */
+	struct Unit *scriptCurrentUnit;                         /*!< The Unit whose script is running, if any. */
+	struct Team *scriptCurrentTeam;                         /*!< The Team whose script is running, if any. */
+} GameContext;
+
+extern THREAD_STORAGE GameContext *g_game;
+
+extern GameContext *GameContext_Create(void);
+extern void GameContext_Free(GameContext *ctx);
+extern void GameContext_Copy(GameContext *dst, const GameContext *src);
+extern void GameContext_CopyQueues(GameContext *ctx, BuildQueueItem **items, int *max_items);
+
+#endif /* GAMECONTEXT_H */
@@ -8,13 +8,11 @@
 
 #include "gameloop.h"
 
-#include "ai.h"
-#include "animation.h"
 #include "audio/audio.h"
 #include "common_a5.h"
 #include "config.h"
 #include "enhancement.h"
-#include "explosion.h"
+#include "gamecontext.h"
 #include "gui/gui.h"
 #include "house.h"
 #include "input/input.h"
@@ -32,9 +30,11 @@
 #include "pool/pool.h"
 #include "pool/pool_structure.h"
 #include "pool/pool_unit.h"
+#include "profile.h"
+#include "replay.h"
+#include "save.h"
 #include "sprites.h"
 #include "structure.h"
-#include "team.h"
 #include "tile.h"
 #include "timer/timer.h"
 #include "tools/coord.h"
@@ -75,19 +75,6 @@ GameLoop_Client_Unit(void)
 	}
 }
 
-static void
-GameLoop_Server_Logic(void)
-{
-	UnitAI_SquadLoop();
-	GameLoop_Team();
-	GameLoop_Unit();
-	GameLoop_Structure();
-	GameLoop_House();
-	Explosion_Tick();
-	Animation_Tick();
-	Unit_Sort();
-}
-
 static void
 GameLoop_Client_Logic(void)
 {
@@ -388,28 +375,56 @@ static void
 GameLoop_Client_Draw(void)
 {
 	if (g_gameOverlay == GAMEOVERLAY_NONE) {
-		GUI_DrawInterfaceAndRadar();
+		PROFILE(PROFILE_DRAW_INTERFACE, GUI_DrawInterfaceAndRadar());
 		ChatBox_DrawInGame(g_chat_buf);
 	} else if (g_gameOverlay == GAMEOVERLAY_HINT
 	        || g_gameOverlay == GAMEOVERLAY_WIN
 	        || g_gameOverlay == GAMEOVERLAY_LOSE) {
-		GUI_DrawInterfaceAndRadar();
+		PROFILE(PROFILE_DRAW_INTERFACE, GUI_DrawInterfaceAndRadar());
 		ChatBox_DrawInGame(g_chat_buf);
 		MenuBar_DrawInGameOverlay();
 	} else if (g_gameOverlay == GAMEOVERLAY_MENTAT) {
 		MenuBar_DrawMentatOverlay();
 	} else {
-		GUI_DrawInterfaceAndRadar();
+		PROFILE(PROFILE_DRAW_INTERFACE, GUI_DrawInterfaceAndRadar());
 		ChatBox_DrawInGame(g_chat_buf);
 		MenuBar_DrawOptionsOverlay();
 	}
 
-	Video_Tick();
+	PROFILE(PROFILE_DRAW_FLIP, Video_Tick());
 	A5_UseTransform(SCREENDIV_MAIN);
 }
 
 /*--------------------------------------------------------------*/
 
+/**
+ * @brief   Autosaves every g_autosave_interval minutes of game time.
+ * @details Called between two server steps.  The save is written to
+ *          _SAVE000.DAT, a slot the save menu never hands out, so it
+ *          shows up in the load menu without clobbering a real save.
+ */
+static void
+GameLoop_Autosave(void)
+{
+	static int64_t l_tickAutosave;
+
+	if (g_autosave_interval <= 0
+			|| g_host_type != HOSTTYPE_NONE
+			|| g_debugScenario
+			|| Replay_IsPlaying())
+		return;
+
+	/* Start counting afresh in a new scenario or loaded game. */
+	if (l_tickAutosave < g_game->tickScenarioStart || l_tickAutosave > g_game->timerGame)
+		l_tickAutosave = g_game->timerGame;
+
+	if (g_game->timerGame - l_tickAutosave < (int64_t)g_autosave_interval * 60 * 60)
+		return;
+
+	l_tickAutosave = g_game->timerGame;
+	SaveFile_Background("_SAVE000.DAT", "Autosave");
+}
+
 static void
 GameLoop_ProcessGUITimer(void)
 {
@@ -435,18 +450,57 @@ GameLoop_ProcessGUITimer(void)
 	}
 }
 
+/**
+ * @brief   Runs the server from a replay instead of client messages.
+ * @details One recorded step is played per game tick, or as many as
+ *          fit between frames when fast-forwarding.
+ */
+static void
+GameLoop_ProcessReplayTimer(void)
+{
+	static int64_t l_ticks = -1;
+	const int64_t curr_ticks = Timer_GameTicks();
+
+	if (g_selectionTypeNew != g_selectionType) {
+		GUI_ChangeSelectionType(g_selectionTypeNew);
+	}
+
+	if (g_gameOverlay != GAMEOVERLAY_NONE || l_ticks == curr_ticks)
+		return;
+
+	l_ticks = curr_ticks;
+
+	do {
+		if (!Replay_PlaybackStep()) {
+			g_gameMode = GM_QUITGAME;
+			return;
+		}
+
+		GameLoop_Server_Logic();
+		Replay_EndStep();
+		GameLoop_LevelEnd();
+	} while (Replay_IsFastForward()
+	      && Timer_QueueIsEmpty()
+	      && g_gameMode == GM_NORMAL);
+}
+
 static void
 GameLoop_ProcessGameTimer(void)
 {
 	static int64_t l_timerUnitStatus = 0;
 	static int16 l_selectionState = -2;
 
+	if (Replay_IsPlaying()) {
+		GameLoop_ProcessReplayTimer();
+		return;
+	}
+
 	if ((g_gameOverlay == GAMEOVERLAY_NONE)
 			|| (g_host_type != HOSTTYPE_NONE)) {
 		const int64_t curr_ticks = Timer_GameTicks();
 
-		if (g_timerGame != curr_ticks) {
-			g_timerGame = curr_ticks;
+		if (g_game->timerGame != curr_ticks) {
+			g_game->timerGame = curr_ticks;
 		} else {
 			return;
 		}
@@ -468,9 +522,9 @@ GameLoop_ProcessGameTimer(void)
 			 || g_selectionType == SELECTIONTYPE_UNIT
 			 || g_selectionType == SELECTIONTYPE_STRUCTURE)) {
 		if (Unit_AnySelected()) {
-			if (l_timerUnitStatus < g_timerGame) {
+			if (l_timerUnitStatus < g_game->timerGame) {
 				Unit_DisplayGroupStatusText();
-				l_timerUnitStatus = g_timerGame + 300;
+				l_timerUnitStatus = g_game->timerGame + 300;
 			}
 
 			if (g_selectionType != SELECTIONTYPE_TARGET) {
@@ -484,15 +538,14 @@ GameLoop_ProcessGameTimer(void)
 		}
 
 		if (g_host_type != HOSTTYPE_DEDICATED_CLIENT) {
-			Server_RecvMessages();
-			GameLoop_Server_Logic();
+			GameLoop_Server_Step();
+			GameLoop_Autosave();
 		} else {
 			GameLoop_Client_Logic();
 		}
 	} else if (g_host_type == HOSTTYPE_DEDICATED_SERVER
 	        || g_host_type == HOSTTYPE_CLIENT_SERVER) {
-		Server_RecvMessages();
-		GameLoop_Server_Logic();
+		GameLoop_Server_Step();
 	}
 
 	if (g_host_type != HOSTTYPE_DEDICATED_CLIENT) {
@@ -523,12 +576,13 @@ GameLoop_Loop(void)
 			GameLoop_ProcessGameTimer();
 		}
 
-		Server_SendMessages();
+		PROFILE(PROFILE_NET_SEND, Server_SendMessages());
 
 		if (redraw && Timer_QueueIsEmpty()) {
 			redraw = false;
 			GUI_PaletteAnimate();
 			GameLoop_Client_Draw();
+			PROFILE_END_FRAME();
 		}
 	}
 
@@ -19,16 +19,16 @@ int TRUE_DISPLAY_HEIGHT = 480;
 enum AspectRatioCorrection g_aspect_correction = ASPECT_RATIO_CORRECTION_AUTO;
 float g_pixel_aspect_ratio = 1.2f;
 
-static uint16 s_spriteSpacing  = 0;
-static uint16 s_spriteHeight   = 0;
-static uint16 s_spriteWidth    = 0;
-static uint8  s_spriteMode     = 0;
-static uint8  s_spriteInfoSize = 0;
+static THREAD_LOCAL uint16 s_spriteSpacing  = 0;
+static THREAD_LOCAL uint16 s_spriteHeight   = 0;
+static THREAD_LOCAL uint16 s_spriteWidth    = 0;
+static THREAD_LOCAL uint8  s_spriteMode     = 0;
+static THREAD_LOCAL uint8  s_spriteInfoSize = 0;
 
 static const uint16 s_screenBufferSize[5] = { 0xFA00, 0xFBF4, 0xFA00, 0xFD0D, 0xA044 };
-static void *s_screenBuffer[5] = { NULL, NULL, NULL, NULL, NULL };
+static THREAD_LOCAL void *s_screenBuffer[5] = { NULL, NULL, NULL, NULL, NULL };
 
-Screen g_screenActiveID = SCREEN_0;
+THREAD_LOCAL Screen g_screenActiveID = SCREEN_0;
 
 ScreenDiv g_screenDiv[SCREENDIV_MAX] = {
 	{ 1.0f, 1.0f,   0,   0, 320, 200 }, /* SCREENDIV_MAIN */
@@ -456,7 +456,7 @@ extern void GFX_CopyToBuffer(int16 left, int16 top, uint16 width, uint16 height,
 /* Simulate the screen shakes present in the game.  That is, shift the
  * screen 4 pixels up for (2 * num_ticks) frames.
  */
-static int s_screen_shake_ticks = 0;
+static THREAD_LOCAL int s_screen_shake_ticks = 0;
 
 void
 GFX_ScreenShake_Start(uint16 packed, int num_ticks)
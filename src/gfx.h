@@ -47,7 +47,7 @@ extern int TRUE_DISPLAY_HEIGHT;
 extern enum AspectRatioCorrection g_aspect_correction;
 extern float g_pixel_aspect_ratio;      /* pixel height to pixel width. */
 
-extern Screen g_screenActiveID;
+extern THREAD_LOCAL Screen g_screenActiveID;
 
 extern ScreenDiv g_screenDiv[SCREENDIV_MAX];
 
@@ -69,17 +69,17 @@ bool g_structureHighHealth;
 uint16 g_viewportMessageCounter;                            /*!< Countdown counter for displaying #g_viewportMessageText, bit 0 means 'display the text'. */
 const char *g_viewportMessageText;                          /*!< If not \c NULL, message text displayed in the viewport. */
 
-uint16 g_viewportPosition;                                  /*!< Top-left tile of the viewport. */
-int g_viewport_scrollOffsetX;
-int g_viewport_scrollOffsetY;
+THREAD_LOCAL uint16 g_viewportPosition;                                  /*!< Top-left tile of the viewport. */
+THREAD_LOCAL int g_viewport_scrollOffsetX;
+THREAD_LOCAL int g_viewport_scrollOffsetY;
 float g_viewport_desiredDX;
 float g_viewport_desiredDY;
 
-uint16 g_selectionRectanglePosition;                        /*!< Position of the structure selection rectangle. */
-uint16 g_selectionPosition;                                 /*!< Current selection position (packed). */
-uint16 g_selectionWidth;                                    /*!< Width of the selection. */
-uint16 g_selectionHeight;                                   /*!< Height of the selection. */
-int16  g_selectionState = 1;                                /*!< State of the selection (\c 1 is valid, \c 0 is not valid, \c <0 valid but missing some slabs. */
+THREAD_LOCAL uint16 g_selectionRectanglePosition;                        /*!< Position of the structure selection rectangle. */
+THREAD_LOCAL uint16 g_selectionPosition;                                 /*!< Current selection position (packed). */
+THREAD_LOCAL uint16 g_selectionWidth;                                    /*!< Width of the selection. */
+THREAD_LOCAL uint16 g_selectionHeight;                                   /*!< Height of the selection. */
+THREAD_LOCAL int16  g_selectionState = 1;                                /*!< State of the selection (\c 1 is valid, \c 0 is not valid, \c <0 valid but missing some slabs. */
 
 /*!< Colours used for the border of widgets. */
 uint8 s_colourBorderSchema[5][4] = {
@@ -400,7 +400,7 @@ void GUI_DrawText(const char *string, int16 left, int16 top, uint8 fgColour, uin
 	x = left;
 	y = top;
 
-	Video_HoldBitmapDrawing(true);
+	Video_DrawTextBegin(g_colours, 0xFF);
 
 	while (*s != '\0') {
 		uint16 width;
@@ -420,13 +420,13 @@ void GUI_DrawText(const char *string, int16 left, int16 top, uint8 fgColour, uin
 		}
 		if (y > TRUE_DISPLAY_HEIGHT) break;
 
-		Video_DrawChar(*s, g_colours, x, y);
+		Video_DrawTextChar(*s, x, y);
 
 		x += width;
 		s++;
 	}
 
-	Video_HoldBitmapDrawing(false);
+	Video_DrawTextEnd();
 }
 
 void
@@ -434,16 +434,16 @@ GUI_DrawTextAlpha(const char *string, int x, int y, unsigned char alpha)
 {
 	const char *s = string;
 
-	Video_HoldBitmapDrawing(true);
+	Video_DrawTextBegin(g_colours, alpha);
 
 	while (*s != '\0') {
-		Video_DrawCharAlpha(*s, g_colours, x, y, alpha);
+		Video_DrawTextChar(*s, x, y);
 
 		x += Font_GetCharWidth(*s);
 		s++;
 	}
 
-	Video_HoldBitmapDrawing(false);
+	Video_DrawTextEnd();
 }
 
 /**
@@ -2146,6 +2146,7 @@ uint16 GUI_HallOfFame_DrawData(HallOfFameStruct *data, bool show)
 	oldScreenID = GFX_Screen_SetActive(SCREEN_1);
 	Prim_FillRect_i(8, 80, 311, 178, 116);
 	GUI_DrawText_Wrapper(NULL, 0, 0, 0, 0, 0x22);
+	Video_HoldBitmapDrawing(true);
 
 	battleString = String_Get_ByIndex(STR_BATTLE);
 	scoreString = String_Get_ByIndex(STR_SCORE);
@@ -2188,6 +2189,7 @@ uint16 GUI_HallOfFame_DrawData(HallOfFameStruct *data, bool show)
 		GUI_DrawText_Wrapper("%u", scoreX, offsetY, 15, 0, 0x122, data[i].score);
 	}
 
+	Video_HoldBitmapDrawing(false);
 	GFX_Screen_SetActive(oldScreenID);
 
 	return width;
@@ -65,17 +65,17 @@ extern uint16 g_productionStringID;
 
 extern uint16 g_viewportMessageCounter;
 extern const char *g_viewportMessageText;
-extern uint16 g_viewportPosition;
-extern int g_viewport_scrollOffsetX;
-extern int g_viewport_scrollOffsetY;
+extern THREAD_LOCAL uint16 g_viewportPosition;
+extern THREAD_LOCAL int g_viewport_scrollOffsetX;
+extern THREAD_LOCAL int g_viewport_scrollOffsetY;
 extern float g_viewport_desiredDX;
 extern float g_viewport_desiredDY;
 
-extern uint16 g_selectionRectanglePosition;
-extern uint16 g_selectionPosition;
-extern uint16 g_selectionWidth;
-extern uint16 g_selectionHeight;
-extern int16  g_selectionState;
+extern THREAD_LOCAL uint16 g_selectionRectanglePosition;
+extern THREAD_LOCAL uint16 g_selectionPosition;
+extern THREAD_LOCAL uint16 g_selectionWidth;
+extern THREAD_LOCAL uint16 g_selectionHeight;
+extern THREAD_LOCAL int16  g_selectionState;
 
 extern uint16 g_cursorSpriteID;
 
@@ -14,9 +14,11 @@
 #include "font.h"
 #include "gui.h"
 #include "widget.h"
+#include "../codec/digram.h"
 #include "../config.h"
 #include "../enhancement.h"
 #include "../file.h"
+#include "../gamecontext.h"
 #include "../gfx.h"
 #include "../house.h"
 #include "../input/input.h"
@@ -344,7 +346,7 @@ GUI_Mentat_ShowHelp(Widget *scrollbar, enum SearchDirectory dir,
 	fileID = File_Open_Ex(dir, s_mentatFilename, FILE_MODE_READ);
 	File_Seek(fileID, offset, 0);
 	File_Read(fileID, compressedText, info.length);
-	String_Decompress(compressedText, text);
+	Digram_Decode(compressedText, text);
 	String_TranslateSpecial(text, text);
 	File_Close(fileID);
 
@@ -353,7 +355,7 @@ GUI_Mentat_ShowHelp(Widget *scrollbar, enum SearchDirectory dir,
 	*text++ = '\0';
 
 	if (noDesc) {
-		picture = g_scenario.pictureBriefing;
+		picture = g_game->scenario.pictureBriefing;
 		desc    = NULL;
 		text    = (char *)g_readBuffer;
 
@@ -8,11 +8,13 @@
 #include "../common_a5.h"
 #include "../enhancement.h"
 #include "../explosion.h"
+#include "../gamecontext.h"
 #include "../map.h"
 #include "../newui/viewport.h"
 #include "../opendune.h"
 #include "../pool/pool.h"
 #include "../pool/pool_unit.h"
+#include "../profile.h"
 #include "../scenario.h"
 #include "../sprites.h"
 #include "../structure.h"
@@ -32,7 +34,9 @@ void GUI_Widget_Viewport_Draw(void)
 	const uint16 oldValue_07AE_0000 = Widget_SetCurrentWidget(2);
 	PoolFindStruct find;
 
-	Viewport_DrawTiles();
+	Video_BeginViewport();
+
+	PROFILE(PROFILE_DRAW_TILES, Viewport_DrawTiles());
 
 	for (const Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_SANDWORM);
 			u != NULL;
@@ -50,6 +54,7 @@ void GUI_Widget_Viewport_Draw(void)
 		Prim_Rect_i(x1, y1, x2, y2, 0xFF);
 	}
 
+	PROFILE_BEGIN(PROFILE_DRAW_UNITS);
 	for (const Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
 			u != NULL;
 			u = Unit_FindNext(&find)) {
@@ -62,14 +67,14 @@ void GUI_Widget_Viewport_Draw(void)
 
 		Viewport_DrawUnit(u, 0, 0, false);
 	}
+	PROFILE_END(PROFILE_DRAW_UNITS);
 
-	Explosion_Draw();
-	Viewport_DrawTileFog();
+	PROFILE(PROFILE_DRAW_EXPLOSIONS, Explosion_Draw());
+	PROFILE(PROFILE_DRAW_FOG, Viewport_DrawTileFog());
 
 	Viewport_DrawRallyPoint();
 	Viewport_DrawSelectionHealthBars();
 	Viewport_DrawSelectionBox();
-	Viewport_DrawPanCursor();
 
 	/* Draw placement box over fog. */
 	if (g_selectionType == SELECTIONTYPE_PLACE) {
@@ -86,12 +91,17 @@ void GUI_Widget_Viewport_Draw(void)
 		}
 	}
 
+	PROFILE_BEGIN(PROFILE_DRAW_AIR_UNITS);
 	for (const Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
 			u != NULL;
 			u = Unit_FindNext(&find)) {
 		if (u->o.index <= 15)
 			Viewport_DrawAirUnit(u);
 	}
+	PROFILE_END(PROFILE_DRAW_AIR_UNITS);
+
+	Video_EndViewport();
+	Viewport_DrawPanCursor();
 
 	if ((g_viewportMessageCounter & 1) != 0 && g_viewportMessageText != NULL) {
 		const enum ScreenDivID old_div = A5_SaveTransform();
@@ -119,7 +129,8 @@ void GUI_Widget_Viewport_RedrawMap(void)
 {
 	const WidgetInfo *wi = &g_table_gameWidgetInfo[GAME_WIDGET_MINIMAP];
 
-	Video_DrawMinimap(wi->offsetX, wi->offsetY, g_scenario.mapScale, MINIMAP_IN_GAME);
+	PROFILE(PROFILE_DRAW_MINIMAP,
+			Video_DrawMinimap(wi->offsetX, wi->offsetY, g_game->scenario.mapScale, MINIMAP_IN_GAME));
 
 	Map_UpdateMinimapPosition(g_viewportPosition, true);
 }
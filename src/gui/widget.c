@@ -16,13 +16,13 @@
 #include "../video/video.h"
 
 
-uint8 g_paletteActive[3 * 256];
+THREAD_LOCAL uint8 g_paletteActive[3 * 256];
 uint8 g_palette1[3 * 256];
 uint8 g_palette2[3 * 256];
 uint8 g_paletteMapping1[256];
 uint8 g_paletteMapping2[256];
 
-Widget *g_widgetLinkedListHead = NULL;
+THREAD_LOCAL Widget *g_widgetLinkedListHead = NULL;
 Widget *g_widgetLinkedListTail = NULL;
 Widget *g_widgetInvoiceTail = NULL;
 Widget *g_widgetMentatFirst = NULL;
@@ -59,7 +59,7 @@ WidgetProperties g_widgetProperties[WINDOWID_MAX] = {
 	{ 0*8,   0, 1024,1024,   0,   0,  0}  /* 22: texture rendering pseudo-widget */
 };
 
-uint16 g_curWidgetIndex;          /*!< Index of the currently selected widget in #g_widgetProperties. */
+THREAD_LOCAL uint16 g_curWidgetIndex;          /*!< Index of the currently selected widget in #g_widgetProperties. */
 uint16 g_curWidgetXBase;          /*!< Horizontal base position of the currently selected widget. */
 uint16 g_curWidgetYBase;          /*!< Vertical base position of the currently selected widget. */
 uint16 g_curWidgetWidth;          /*!< Width of the currently selected widget. */
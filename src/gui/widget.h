@@ -161,13 +161,13 @@ extern WindowDesc g_yesNoWindowDesc;
 extern WindowDesc g_saveLoadWindowDesc;
 extern WindowDesc g_savegameNameWindowDesc;
 
-extern uint8 g_paletteActive[3 * 256];
+extern THREAD_LOCAL uint8 g_paletteActive[3 * 256];
 extern uint8 g_palette1[3 * 256];
 extern uint8 g_palette2[3 * 256];
 extern uint8 g_paletteMapping1[256];
 extern uint8 g_paletteMapping2[256];
 
-extern Widget *g_widgetLinkedListHead;
+extern THREAD_LOCAL Widget *g_widgetLinkedListHead;
 extern Widget *g_widgetLinkedListTail;
 extern Widget *g_widgetInvoiceTail;
 extern Widget *g_widgetMentatFirst;
@@ -177,7 +177,7 @@ extern Widget *g_widgetMentatScrollDown;
 extern Widget *g_widgetMentatScrollbar;
 
 extern WidgetProperties g_widgetProperties[WINDOWID_MAX];
-extern uint16 g_curWidgetIndex;
+extern THREAD_LOCAL uint16 g_curWidgetIndex;
 extern uint16 g_curWidgetXBase;
 extern uint16 g_curWidgetYBase;
 extern uint16 g_curWidgetWidth;
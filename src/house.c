@@ -10,6 +10,7 @@
 
 #include "audio/audio.h"
 #include "enhancement.h"
+#include "gamecontext.h"
 #include "gfx.h"
 #include "gui/gui.h"
 #include "gui/widget.h"
@@ -38,9 +39,9 @@
 #include "wsa.h"
 
 
-House *g_playerHouse = NULL;
-enum HouseType g_playerHouseID = HOUSE_INVALID;
-uint16 g_playerCredits = 0; /*!< Credits shown to player as 'current'. */
+THREAD_LOCAL House *g_playerHouse = NULL;
+THREAD_LOCAL enum HouseType g_playerHouseID = HOUSE_INVALID;
+THREAD_LOCAL uint16 g_playerCredits = 0; /*!< Credits shown to player as 'current'. */
 
 static void House_EnsureHarvesterAvailable(uint8 houseID);
 static void House_Server_TickMissileCountdown(House *h);
@@ -60,37 +61,37 @@ void GameLoop_House(void)
 
 	if (g_debugScenario) return;
 
-	if (g_tickHouseHouse <= g_timerGame) {
+	if (g_game->tickHouseHouse <= g_game->timerGame) {
 		tickHouse = true;
-		g_tickHouseHouse = g_timerGame + 900;
+		g_game->tickHouseHouse = g_game->timerGame + 900;
 	}
 
-	if (g_tickHousePowerMaintenance <= g_timerGame) {
+	if (g_game->tickHousePowerMaintenance <= g_game->timerGame) {
 		tickPowerMaintenance = true;
-		g_tickHousePowerMaintenance = g_timerGame + 10800;
+		g_game->tickHousePowerMaintenance = g_game->timerGame + 10800;
 	}
 
-	if (g_tickHouseStarport <= g_timerGame) {
+	if (g_game->tickHouseStarport <= g_game->timerGame) {
 		tickStarport = true;
-		g_tickHouseStarport = g_timerGame + 180;
+		g_game->tickHouseStarport = g_game->timerGame + 180;
 	}
 
-	if (g_tickHouseReinforcement <= g_timerGame) {
+	if (g_game->tickHouseReinforcement <= g_game->timerGame) {
 		tickReinforcement = true;
-		g_tickHouseReinforcement = g_timerGame + (g_debugGame ? 60 : 600);
+		g_game->tickHouseReinforcement = g_game->timerGame + (g_debugGame ? 60 : 600);
 	}
 
-	if (g_tickHouseMissileCountdown <= g_timerGame) {
+	if (g_game->tickHouseMissileCountdown <= g_game->timerGame) {
 		tickMissileCountdown = true;
-		g_tickHouseMissileCountdown = g_timerGame + 60;
+		g_game->tickHouseMissileCountdown = g_game->timerGame + 60;
 	}
 
-	if (g_tickHouseStarportAvailability <= g_timerGame) {
+	if (g_game->tickHouseStarportAvailability <= g_game->timerGame) {
 		tickStarportAvailability = true;
-		g_tickHouseStarportAvailability = g_timerGame + 1800;
+		g_game->tickHouseStarportAvailability = g_game->timerGame + 1800;
 	}
 
-	if (g_tickHouseStarportRecalculatePrices <= g_timerGame) {
+	if (g_game->tickHouseStarportRecalculatePrices <= g_game->timerGame) {
 		const int64_t next_minute = Random_Starport_GetSeedTime() + 1;
 		uint16 seed;
 
@@ -100,7 +101,7 @@ void GameLoop_House(void)
 			seed = Random_Starport_GetSeed(g_multiplayer.curr_seed, 0);
 		}
 
-		g_tickHouseStarportRecalculatePrices = g_tickScenarioStart + next_minute * 60 * 60;
+		g_game->tickHouseStarportRecalculatePrices = g_game->tickScenarioStart + next_minute * 60 * 60;
 		Random_Starport_Seed(seed);
 		g_factoryWindowTotal = -1;
 	}
@@ -134,13 +135,13 @@ void GameLoop_House(void)
 			bool deployed;
 			Unit *u;
 
-			if (g_scenario.reinforcement[i].unitID == UNIT_INDEX_INVALID) continue;
-			if (g_scenario.reinforcement[i].timeLeft == 0) continue;
-			if (--g_scenario.reinforcement[i].timeLeft != 0) continue;
+			if (g_game->scenario.reinforcement[i].unitID == UNIT_INDEX_INVALID) continue;
+			if (g_game->scenario.reinforcement[i].timeLeft == 0) continue;
+			if (--g_game->scenario.reinforcement[i].timeLeft != 0) continue;
 
-			u = Unit_Get_ByIndex(g_scenario.reinforcement[i].unitID);
+			u = Unit_Get_ByIndex(g_game->scenario.reinforcement[i].unitID);
 
-			locationID = g_scenario.reinforcement[i].locationID;
+			locationID = g_game->scenario.reinforcement[i].locationID;
 			deployed   = false;
 
 			if (locationID >= 4) {
@@ -157,17 +158,17 @@ void GameLoop_House(void)
 					u->o.linkedID = nu->o.linkedID;
 					nu->o.linkedID = (uint8)u->o.index;
 					nu->o.flags.s.inTransport = true;
-					g_scenario.reinforcement[i].unitID = UNIT_INDEX_INVALID;
+					g_game->scenario.reinforcement[i].unitID = UNIT_INDEX_INVALID;
 					deployed = true;
 				} else {
 					/* Failed to create carry-all, try again in a short moment */
-					g_scenario.reinforcement[i].timeLeft = 1;
+					g_game->scenario.reinforcement[i].timeLeft = 1;
 				}
 			} else {
 				deployed = Unit_SetPosition(u, Tile_UnpackTile(Map_Server_FindLocationTile(locationID, u->o.houseID)));
 			}
 
-			if (deployed && g_scenario.reinforcement[i].repeat != 0) {
+			if (deployed && g_game->scenario.reinforcement[i].repeat != 0) {
 				tile32 tile;
 				tile.x = 0xFFFF;
 				tile.y = 0xFFFF;
@@ -177,8 +178,8 @@ void GameLoop_House(void)
 				g_validateStrictIfZero--;
 
 				if (u != NULL) {
-					g_scenario.reinforcement[i].unitID = u->o.index;
-					g_scenario.reinforcement[i].timeLeft = g_scenario.reinforcement[i].timeBetween;
+					g_game->scenario.reinforcement[i].unitID = u->o.index;
+					g_game->scenario.reinforcement[i].timeLeft = g_game->scenario.reinforcement[i].timeBetween;
 				}
 			}
 		}
@@ -613,7 +614,7 @@ void House_CalculatePowerAndCredit(House *h)
 	 * ENHANCEMENT -- check if we actually lost a structure, or if it was an MCV start.
 	 */
 	if (g_validateStrictIfZero == 0 && h->structuresBuilt == 0) {
-		if (g_scenario.structuresLost[h->index] > 0)
+		if (g_game->scenario.structuresLost[h->index] > 0)
 			h->creditsStorageNoSilo = 0;
 	}
 }
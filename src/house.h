@@ -113,13 +113,13 @@ typedef struct HouseInfo {
 } HouseInfo;
 
 extern const HouseInfo g_table_houseInfo_original[HOUSE_NEUTRAL];
-extern HouseInfo g_table_houseInfo[HOUSE_NEUTRAL];
-extern enum HouseAlliance g_table_houseAlliance[HOUSE_NEUTRAL][HOUSE_NEUTRAL];
+extern THREAD_LOCAL HouseInfo g_table_houseInfo[HOUSE_NEUTRAL];
+extern THREAD_LOCAL enum HouseAlliance g_table_houseAlliance[HOUSE_NEUTRAL][HOUSE_NEUTRAL];
 extern const enum HouseType g_table_houseRemap6to3[HOUSE_NEUTRAL];
 
-extern House *g_playerHouse;
-extern enum HouseType g_playerHouseID;
-extern uint16 g_playerCredits;
+extern THREAD_LOCAL House *g_playerHouse;
+extern THREAD_LOCAL enum HouseType g_playerHouseID;
+extern THREAD_LOCAL uint16 g_playerCredits;
 
 extern void GameLoop_House(void);
 extern void House_Client_TickMissileCountdown(void);
@@ -0,0 +1,247 @@
+/* influence.c
+ *
+ * Influence map for brutal AI.
+ *
+ * The map is divided into INFLUENCE_CELL_SIZE square cells.  Each cell
+ * holds, for every house, the number of objects it has there and the
+ * threat they pose, along with the spice in the cell.  The map is
+ * rebuilt from the pools every INFLUENCE_UPDATE_TICKS ticks, so the AI
+ * can answer "is there anything hostile around here?" with a few
+ * lookups instead of walking the pools for every unit.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "os/math.h"
+
+#include "influence.h"
+
+#include "enhancement.h"
+#include "gamecontext.h"
+#include "house.h"
+#include "map.h"
+#include "pool/pool.h"
+#include "pool/pool_structure.h"
+#include "pool/pool_unit.h"
+#include "structure.h"
+#include "timer/timer.h"
+#include "tools/coord.h"
+#include "unit.h"
+
+enum {
+	INFLUENCE_UPDATE_TICKS = 15,
+
+	/* How far, in tiles, objects may have moved since the last
+	 * update.  Queries widen their search by this much.
+	 */
+	INFLUENCE_SLACK = 2
+};
+
+typedef struct InfluenceCell {
+	/* Ground units and structures, as targets. */
+	int presence[HOUSE_MAX];
+
+	/* Build cost of armed ground units and turrets. */
+	int threat[HOUSE_MAX];
+
+	/* 1 per spice tile, 2 per thick spice tile. */
+	int spice;
+} InfluenceCell;
+
+static THREAD_LOCAL InfluenceCell s_influence[INFLUENCE_GRID_SIZE][INFLUENCE_GRID_SIZE];
+static THREAD_LOCAL int s_influence_spice_total;
+static THREAD_LOCAL int64_t s_influence_timeout;
+static THREAD_LOCAL bool s_influence_valid;
+
+/*--------------------------------------------------------------*/
+
+static InfluenceCell *
+Influence_GetCell(uint16 packed)
+{
+	const int x = Tile_GetPackedX(packed) >> INFLUENCE_CELL_SHIFT;
+	const int y = Tile_GetPackedY(packed) >> INFLUENCE_CELL_SHIFT;
+
+	return &s_influence[y][x];
+}
+
+/**
+ * @brief   Forces a rebuild on the next update.
+ * @details Called when the pools are replaced wholesale, e.g. by
+ *          Game_Init or restoring a snapshot.
+ */
+void
+Influence_Invalidate(void)
+{
+	s_influence_valid = false;
+}
+
+/**
+ * @brief   Rebuilds the whole map in one pass over the pools.
+ */
+static void
+Influence_Rebuild(void)
+{
+	PoolFindStruct find;
+
+	memset(s_influence, 0, sizeof(s_influence));
+	s_influence_spice_total = 0;
+
+	for (const Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
+			u != NULL;
+			u = Unit_FindNext(&find)) {
+		const UnitInfo *ui = &g_table_unitInfo[u->o.type];
+
+		if (u->o.type == UNIT_SANDWORM || !ui->flags.isGroundUnit)
+			continue;
+
+		const enum HouseType houseID = Unit_GetHouseID(u);
+		InfluenceCell *cell = Influence_GetCell(Tile_PackTile(u->o.position));
+
+		cell->presence[houseID]++;
+
+		if (ui->damage > 0)
+			cell->threat[houseID] += ui->o.buildCredits;
+	}
+
+	for (const Structure *s = Structure_FindFirst(&find, HOUSE_INVALID, STRUCTURE_INVALID);
+			s != NULL;
+			s = Structure_FindNext(&find)) {
+		InfluenceCell *cell = Influence_GetCell(Tile_PackTile(s->o.position));
+
+		cell->presence[s->o.houseID]++;
+
+		if (s->o.type == STRUCTURE_TURRET || s->o.type == STRUCTURE_ROCKET_TURRET)
+			cell->threat[s->o.houseID] += g_table_structureInfo[s->o.type].o.buildCredits;
+	}
+
+	for (uint16 packed = 0; packed < MAP_SIZE_MAX * MAP_SIZE_MAX; packed++) {
+		const uint16 lst = Map_GetLandscapeType(packed);
+		int spice;
+
+		if (lst == LST_THICK_SPICE) {
+			spice = 2;
+		} else if (lst == LST_SPICE) {
+			spice = 1;
+		} else {
+			continue;
+		}
+
+		Influence_GetCell(packed)->spice += spice;
+		s_influence_spice_total += spice;
+	}
+}
+
+static void
+Influence_Validate(void)
+{
+	if (s_influence_valid)
+		return;
+
+	Influence_Rebuild();
+	s_influence_timeout = g_game->timerGame + INFLUENCE_UPDATE_TICKS;
+	s_influence_valid = true;
+}
+
+void
+Influence_Update(void)
+{
+	if (!enhancement_brutal_ai)
+		return;
+
+	if (g_game->timerGame >= s_influence_timeout)
+		s_influence_valid = false;
+
+	Influence_Validate();
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Threat posed to houseID by its enemies in the cell.
+ */
+int
+Influence_GetThreat(enum HouseType houseID, uint16 packed)
+{
+	const InfluenceCell *cell = Influence_GetCell(packed);
+	int threat = 0;
+
+	Influence_Validate();
+
+	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_MAX; h++) {
+		if (!House_AreAllied(houseID, h))
+			threat += cell->threat[h];
+	}
+
+	return threat;
+}
+
+/**
+ * @brief   Threat summed over the cells crossed going in a straight
+ *          line from one tile to another.
+ */
+int
+Influence_GetThreatAlongPath(enum HouseType houseID, uint16 packed_from, uint16 packed_to)
+{
+	const int x0 = Tile_GetPackedX(packed_from);
+	const int y0 = Tile_GetPackedY(packed_from);
+	const int x1 = Tile_GetPackedX(packed_to);
+	const int y1 = Tile_GetPackedY(packed_to);
+
+	/* Sample twice per cell so that no cell is skipped. */
+	const int steps = 1 + 2 * max(abs(x1 - x0), abs(y1 - y0)) / INFLUENCE_CELL_SIZE;
+	const InfluenceCell *prev = NULL;
+	int threat = 0;
+
+	for (int i = 0; i <= steps; i++) {
+		const uint16 packed = Tile_PackXY(x0 + (x1 - x0) * i / steps, y0 + (y1 - y0) * i / steps);
+		const InfluenceCell *cell = Influence_GetCell(packed);
+
+		if (cell == prev)
+			continue;
+
+		threat += Influence_GetThreat(houseID, packed);
+		prev = cell;
+	}
+
+	return threat;
+}
+
+/**
+ * @brief   False if no enemy ground unit or structure can be within
+ *          radius tiles of the tile.
+ * @details Conservative: true only means there may be one.
+ */
+bool
+Influence_AnyEnemyNear(enum HouseType houseID, uint16 packed, int radius)
+{
+	Influence_Validate();
+
+	const int x = Tile_GetPackedX(packed);
+	const int y = Tile_GetPackedY(packed);
+	const int r = radius + INFLUENCE_SLACK;
+	const int cx1 = max(0, x - r) >> INFLUENCE_CELL_SHIFT;
+	const int cy1 = max(0, y - r) >> INFLUENCE_CELL_SHIFT;
+	const int cx2 = min(MAP_SIZE_MAX - 1, x + r) >> INFLUENCE_CELL_SHIFT;
+	const int cy2 = min(MAP_SIZE_MAX - 1, y + r) >> INFLUENCE_CELL_SHIFT;
+
+	for (int cy = cy1; cy <= cy2; cy++) {
+		for (int cx = cx1; cx <= cx2; cx++) {
+			const InfluenceCell *cell = &s_influence[cy][cx];
+
+			for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_MAX; h++) {
+				if (cell->presence[h] > 0 && !House_AreAllied(houseID, h))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int
+Influence_GetTotalSpice(void)
+{
+	Influence_Validate();
+
+	return s_influence_spice_total;
+}
@@ -0,0 +1,21 @@
+#ifndef INFLUENCE_H
+#define INFLUENCE_H
+
+#include "enumeration.h"
+#include "types.h"
+
+enum {
+	INFLUENCE_CELL_SHIFT = 3,
+	INFLUENCE_CELL_SIZE = 1 << INFLUENCE_CELL_SHIFT,
+	INFLUENCE_GRID_SIZE = 64 >> INFLUENCE_CELL_SHIFT
+};
+
+extern void Influence_Invalidate(void);
+extern void Influence_Update(void);
+
+extern int Influence_GetThreat(enum HouseType houseID, uint16 packed);
+extern int Influence_GetThreatAlongPath(enum HouseType houseID, uint16 packed_from, uint16 packed_to);
+extern bool Influence_AnyEnemyNear(enum HouseType houseID, uint16 packed, int radius);
+extern int Influence_GetTotalSpice(void);
+
+#endif
@@ -13,6 +13,7 @@
 #include "../input/input.h"
 #include "../input/mouse.h"
 #include "../opendune.h"
+#include "../profile.h"
 #include "../video/video_a5.h"
 #include "scancode.h"
 
@@ -152,6 +153,17 @@ InputA5_ProcessEvent(ALLEGRO_EVENT *event, bool apply_mouse_transform)
 			    (event->keyboard.keycode == ALLEGRO_KEY_ENTER && (event->keyboard.modifiers & (ALLEGRO_KEYMOD_ALT | ALLEGRO_KEYMOD_ALTGR)))) {
 				VideoA5_ToggleFullscreen();
 				return true;
+#ifdef WITH_PROFILER
+			} else if (event->keyboard.keycode == ALLEGRO_KEY_F10 && (event->keyboard.modifiers & ALLEGRO_KEYMOD_CTRL)) {
+				VideoA5_ToggleProfiler();
+				return true;
+			} else if (event->keyboard.keycode == ALLEGRO_KEY_F12 && (event->keyboard.modifiers & ALLEGRO_KEYMOD_CTRL)) {
+				Profile_WriteTrace();
+				return true;
+#endif /* WITH_PROFILER */
+			} else if (event->keyboard.keycode == ALLEGRO_KEY_F10 && (event->keyboard.modifiers & ALLEGRO_KEYMOD_SHIFT)) {
+				VideoA5_ToggleNetStats();
+				return true;
 			} else if (event->keyboard.keycode == ALLEGRO_KEY_F10) {
 				VideoA5_ToggleFPS();
 				return true;
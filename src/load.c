@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include "enum_string.h"
 #include "errorlog.h"
+#include "gamecontext.h"
 #include "multichar.h"
 #include "types.h"
 #include "os/endian.h"
@@ -14,10 +15,12 @@
 #include "ai.h"
 #include "audio/audio.h"
 #include "file.h"
+#include "influence.h"
 #include "map.h"
 #include "mods/skirmish.h"
 #include "newui/menubar.h"
 #include "opendune.h"
+#include "save.h"
 #include "saveload/saveload.h"
 #include "scenario.h"
 #include "sprites.h"
@@ -121,6 +124,7 @@ static bool Load_Main(FILE *fp)
 		switch (BETOH32(header)) {
 			case CC_NAME: break; /* 'NAME' chunk is of no interest to us */
 			case CC_INFO: break; /* 'INFO' chunk is already read */
+			case CC_DDRP: break; /* 'DDRP' chunk is read by the replay player */
 			case CC_MAP : if (!Map_Load      (fp, length)) return false; load_map  = true; Map_Load2Fallback(); break;
 			case CC_PLYR: if (!House_Load    (fp, length)) return false; load_plyr = true; break;
 			case CC_UNIT: if (!Unit_Load     (fp, length)) return false; load_unit = true; break;
@@ -205,6 +209,7 @@ LoadFile(const char *filename)
 	bool res;
 
 	Audio_PlayVoice(VOICE_STOP);
+	SaveFile_WaitForBackground();
 
 	Game_Init();
 
@@ -235,6 +240,9 @@ LoadFile(const char *filename)
 		return false;
 	}
 
+	/* The saved g_game->timerGame would leave the map's timeout meaningless. */
+	Influence_Invalidate();
+
 	if (g_gameMode != GM_RESTART) Game_Prepare();
 
 	return true;
@@ -13,6 +13,7 @@
 #include "animation.h"
 #include "enhancement.h"
 #include "explosion.h"
+#include "gamecontext.h"
 #include "gfx.h"
 #include "gui/gui.h"
 #include "gui/widget.h"
@@ -39,20 +40,13 @@
 #include "unit.h"
 #include "video/video.h"
 
-
-uint16 g_mapSpriteID[64 * 64];
-
-/* Map data.  In fog of war:
- * g_map[] corresponds to TRUE information, and the map scouted.
- * g_mapVisible[] corresponds to KNOWN information, and the map currently visible.
- */
-Tile g_map[MAP_SIZE_MAX * MAP_SIZE_MAX];
-FogOfWarTile g_mapVisible[MAP_SIZE_MAX * MAP_SIZE_MAX];
-
 const uint8 g_functions[3][3] = {{0, 1, 0}, {2, 3, 0}, {0, 1, 0}};
 
 static bool s_debugNoExplosionDamage = false;               /*!< When non-zero, explosions do no damage to their surrounding. */
 
+/* Tiles changed since the landscape was last sent, one bit per tile. */
+static THREAD_LOCAL uint32 s_mapDirty[MAP_SIZE_MAX * MAP_SIZE_MAX / 32];
+
 /**
  * Map definitions.
  * Map sizes: [0] is 62x62, [1] is 32x32, [2] is 21x21.
@@ -66,7 +60,7 @@ const MapInfo g_mapInfos[3] = {
 bool
 Map_InRangeX(int x)
 {
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 
 	return (mapInfo->minX <= x && x < mapInfo->minX + mapInfo->sizeX);
 }
@@ -74,7 +68,7 @@ Map_InRangeX(int x)
 bool
 Map_InRangeY(int y)
 {
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 
 	return (mapInfo->minY <= y && y < mapInfo->minY + mapInfo->sizeY);
 }
@@ -113,7 +107,7 @@ Map_CentreViewport(int x, int y)
 	const int w = wi->width;
 	const int h = wi->height;
 
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 	int minx = TILE_SIZE * mapInfo->minX + w / 2;
 	int miny = TILE_SIZE * mapInfo->minY + h / 2;
 	int maxx = TILE_SIZE * (mapInfo->minX + mapInfo->sizeX) - w + (w / 2);
@@ -160,7 +154,7 @@ void Map_SetSelection(uint16 packed)
 		return;
 	}
 
-	if ((packed != 0xFFFF && g_mapVisible[packed].fogSpriteID != g_veiledSpriteID) || g_debugScenario) {
+	if ((packed != 0xFFFF && g_game->mapVisible[packed].fogSpriteID != g_veiledSpriteID) || g_debugScenario) {
 		Structure *s;
 
 		s = Structure_Get_ByPackedTile(packed);
@@ -229,7 +223,7 @@ void Map_SetSelectionSize(uint16 layout)
  */
 uint16 Map_SetSelectionObjectPosition(uint16 packed)
 {
-	static uint16 selectionPosition = 0xFFFF;
+	static THREAD_LOCAL uint16 selectionPosition = 0xFFFF;
 
 	uint16 oldPacked = selectionPosition;
 
@@ -248,7 +242,7 @@ uint16 Map_SetSelectionObjectPosition(uint16 packed)
  */
 void Map_UpdateMinimapPosition(uint16 packed, bool forceUpdate)
 {
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 	const WidgetInfo *minimap = &g_table_gameWidgetInfo[GAME_WIDGET_MINIMAP];
 	const WidgetInfo *viewport = &g_table_gameWidgetInfo[GAME_WIDGET_VIEWPORT];
 	const int tx = Tile_GetPackedX(packed) - mapInfo->minX;
@@ -286,7 +280,7 @@ bool Map_IsValidPosition(uint16 position)
 	x = Tile_GetPackedX(position);
 	y = Tile_GetPackedY(position);
 
-	mapInfo = &g_mapInfos[g_scenario.mapScale];
+	mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 
 	return (mapInfo->minX <= x && x < (mapInfo->minX + mapInfo->sizeX) && mapInfo->minY <= y && y < (mapInfo->minY + mapInfo->sizeY));
 }
@@ -300,7 +294,7 @@ uint16 Map_Clamp_Packed(uint16 position)
 	uint16 x = Tile_GetPackedX(position);
 	uint16 y = Tile_GetPackedY(position);
 
-	mapInfo = &g_mapInfos[g_scenario.mapScale];
+	mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 
 	if (mapInfo->minX > x) x = mapInfo->minX;
 	if ( (mapInfo->minX + mapInfo->sizeX - 1) < x) x = mapInfo->minX + mapInfo->sizeX - 1;
@@ -313,7 +307,7 @@ uint16 Map_Clamp_Packed(uint16 position)
 bool
 Map_IsUnveiledToHouse(enum HouseType houseID, uint16 packed)
 {
-	return (g_mapVisible[packed].isUnveiled & (1 << houseID));
+	return (g_game->mapVisible[packed].isUnveiled & (1 << houseID));
 }
 
 bool
@@ -328,11 +322,11 @@ Map_IsPositionUnveiled(enum HouseType houseID, uint16 packed)
 	const enum HouseFlag houseIDBit = (1 << houseID);
 
 	return (65 <= packed && packed < MAP_SIZE_MAX * MAP_SIZE_MAX - 65)
-		&& (g_mapVisible[packed].isUnveiled & houseIDBit)
-		&& (g_mapVisible[packed - 1].isUnveiled & houseIDBit)
-		&& (g_mapVisible[packed + 1].isUnveiled & houseIDBit)
-		&& (g_mapVisible[packed - MAP_SIZE_MAX].isUnveiled & houseIDBit)
-		&& (g_mapVisible[packed + MAP_SIZE_MAX].isUnveiled & houseIDBit);
+		&& (g_game->mapVisible[packed].isUnveiled & houseIDBit)
+		&& (g_game->mapVisible[packed - 1].isUnveiled & houseIDBit)
+		&& (g_game->mapVisible[packed + 1].isUnveiled & houseIDBit)
+		&& (g_game->mapVisible[packed - MAP_SIZE_MAX].isUnveiled & houseIDBit)
+		&& (g_game->mapVisible[packed + MAP_SIZE_MAX].isUnveiled & houseIDBit);
 }
 
 /**
@@ -378,9 +372,9 @@ Map_FindHousesInRadius(tile32 tile, int radius)
 
 			Unit *u;
 			enum HouseType houseID = HOUSE_INVALID;
-			if (g_map[packed].hasStructure) {
-				houseID = g_map[packed].houseID;
-			} else if (g_map[packed].hasUnit && (u = Unit_Get_ByPackedTile(packed)) != NULL) {
+			if (g_game->map[packed].hasStructure) {
+				houseID = g_game->map[packed].houseID;
+			} else if (g_game->map[packed].hasUnit && (u = Unit_Get_ByPackedTile(packed)) != NULL) {
 				const UnitInfo *ui = &g_table_unitInfo[u->o.type];
 				if (!ui->flags.isBullet
 						&&  u->o.flags.s.used
@@ -404,10 +398,11 @@ static bool Map_UpdateWall(uint16 packed)
 
 	if (Map_GetLandscapeType(packed) != LST_WALL) return false;
 
-	t = &g_map[packed];
+	t = &g_game->map[packed];
 
-	t->groundSpriteID = g_mapSpriteID[packed] & 0x1FF;
+	t->groundSpriteID = g_game->mapSpriteID[packed] & 0x1FF;
 	t->overlaySpriteID = g_wallSpriteID;
+	Map_MarkDirty(packed);
 
 	Structure_ConnectWall(packed, true);
 
@@ -624,7 +619,7 @@ Map_GetLandscapeType_BySpriteID(uint16 spriteID, bool hasStructure)
 
 uint16 Map_GetLandscapeType(uint16 packed)
 {
-	Tile *t = &g_map[packed];
+	Tile *t = &g_game->map[packed];
 
 	if (t->overlaySpriteID == g_wallSpriteID) return LST_DESTROYED_WALL;
 
@@ -634,7 +629,7 @@ uint16 Map_GetLandscapeType(uint16 packed)
 enum LandscapeType
 Map_GetLandscapeTypeVisible(uint16 packed)
 {
-	FogOfWarTile *t = &g_mapVisible[packed];
+	FogOfWarTile *t = &g_game->mapVisible[packed];
 
 	return Map_GetLandscapeType_BySpriteID(t->groundSpriteID, t->hasStructure);
 }
@@ -642,7 +637,7 @@ Map_GetLandscapeTypeVisible(uint16 packed)
 enum LandscapeType
 Map_GetLandscapeTypeOriginal(uint16 packed)
 {
-	return Map_GetLandscapeType_BySpriteID(g_mapSpriteID[packed] & 0x7FFF, false);
+	return Map_GetLandscapeType_BySpriteID(g_game->mapSpriteID[packed] & 0x7FFF, false);
 }
 
 /**
@@ -677,7 +672,8 @@ void Map_Bloom_ExplodeSpice(uint16 packed, enum HouseFlag houses)
 {
 	if (g_validateStrictIfZero == 0) {
 		Unit_Remove(Unit_Get_ByPackedTile(packed));
-		g_map[packed].groundSpriteID = g_mapSpriteID[packed] & 0x1FF;
+		g_game->map[packed].groundSpriteID = g_game->mapSpriteID[packed] & 0x1FF;
+		Map_MarkDirty(packed);
 		Map_MakeExplosion(EXPLOSION_SPICE_BLOOM_TREMOR, Tile_UnpackTile(packed), 0, 0);
 	}
 
@@ -765,8 +761,9 @@ static void Map_FixupSpiceEdges(uint16 packed)
 		spriteID += (type == LST_SPICE) ? 49 : 65;
 
 		spriteID = g_iconMap[g_iconMap[ICM_ICONGROUP_LANDSCAPE] + spriteID] & 0x1FF;
-		g_mapSpriteID[packed] = 0x8000 | spriteID;
-		g_map[packed].groundSpriteID = spriteID;
+		g_game->mapSpriteID[packed] = 0x8000 | spriteID;
+		g_game->map[packed].groundSpriteID = spriteID;
+		Map_MarkDirty(packed);
 	}
 }
 
@@ -799,8 +796,9 @@ void Map_ChangeSpiceAmount(uint16 packed, int16 dir)
 	if (type == LST_THICK_SPICE) spriteID = 65;
 
 	spriteID = g_iconMap[g_iconMap[ICM_ICONGROUP_LANDSCAPE] + spriteID] & 0x1FF;
-	g_mapSpriteID[packed] = 0x8000 | spriteID;
-	g_map[packed].groundSpriteID = spriteID;
+	g_game->mapSpriteID[packed] = 0x8000 | spriteID;
+	g_game->map[packed].groundSpriteID = spriteID;
+	Map_MarkDirty(packed);
 
 	Map_FixupSpiceEdges(packed);
 	Map_FixupSpiceEdges(packed + 1);
@@ -823,8 +821,9 @@ void Map_Bloom_ExplodeSpecial(uint16 packed, uint8 houseID)
 
 	h = House_Get_ByIndex(houseID);
 
-	g_map[packed].groundSpriteID = g_landscapeSpriteID;
-	g_mapSpriteID[packed] = 0x8000 | g_landscapeSpriteID;
+	g_game->map[packed].groundSpriteID = g_landscapeSpriteID;
+	g_game->mapSpriteID[packed] = 0x8000 | g_landscapeSpriteID;
+	Map_MarkDirty(packed);
 
 	enemyHouseID = houseID;
 
@@ -896,8 +895,8 @@ uint16
 Map_Server_FindLocationTile(uint16 locationID, enum HouseType houseID)
 {
 	static const int16 mapBase[3] = {1, -2, -2};
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
-	const uint16 mapOffset = mapBase[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
+	const uint16 mapOffset = mapBase[g_game->scenario.mapScale];
 
 	uint16 ret = 0;
 
@@ -1060,6 +1059,56 @@ void Map_UpdateAround(uint16 radius, tile32 position, Unit *unit, uint8 function
 	} while ((diff.x != 0) || (diff.y != 0));
 }
 
+/**
+ * Marks a tile as changed, so that it is sent with the next landscape
+ *  update.
+ * @param packed The tile that changed.
+ */
+void Map_MarkDirty(uint16 packed)
+{
+	assert(packed < MAP_SIZE_MAX * MAP_SIZE_MAX);
+
+	s_mapDirty[packed / 32] |= (1u << (packed % 32));
+}
+
+/**
+ * Marks every tile as changed, e.g. after the map was (re)loaded.
+ */
+void Map_MarkAllDirty(void)
+{
+	memset(s_mapDirty, 0xFF, sizeof(s_mapDirty));
+}
+
+void Map_ClearDirty(uint16 packed)
+{
+	assert(packed < MAP_SIZE_MAX * MAP_SIZE_MAX);
+
+	s_mapDirty[packed / 32] &= ~(1u << (packed % 32));
+}
+
+/**
+ * Find the next changed tile.
+ * @param packed The tile to start searching from.
+ * @return The first changed tile at or after \a packed, or
+ *  MAP_SIZE_MAX * MAP_SIZE_MAX if there are none.
+ */
+uint16 Map_NextDirty(uint16 packed)
+{
+	while (packed < MAP_SIZE_MAX * MAP_SIZE_MAX) {
+		const uint32 bits = s_mapDirty[packed / 32] >> (packed % 32);
+
+		if (bits == 0) {
+			packed = (packed | 31) + 1;
+		} else if (bits & 1) {
+			return packed;
+		} else {
+			packed++;
+		}
+	}
+
+	return MAP_SIZE_MAX * MAP_SIZE_MAX;
+}
+
 /**
  * Search for spice around a position. Thick spice is preferred if it is not too far away.
  * @param packed Center position.
@@ -1088,7 +1137,7 @@ uint16 Map_SearchSpice(uint16 packed, uint16 radius)
 
 	found = false;
 
-	mapInfo = &g_mapInfos[g_scenario.mapScale];
+	mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 
 	xmin = max(Tile_GetPackedX(packed) - radius, mapInfo->minX);
 	xmax = min(Tile_GetPackedX(packed) + radius, mapInfo->minX + mapInfo->sizeX - 1);
@@ -1102,7 +1151,7 @@ uint16 Map_SearchSpice(uint16 packed, uint16 radius)
 			uint16 distance;
 
 			if (!Map_IsValidPosition(curPacked)) continue;
-			if (g_map[curPacked].hasStructure) continue;
+			if (g_game->map[curPacked].hasStructure) continue;
 			if (Unit_Get_ByPackedTile(curPacked) != NULL) continue;
 
 			type = Map_GetLandscapeType(curPacked);
@@ -1144,7 +1193,7 @@ Map_GetUnveilTimeout(enum TileUnveilCause cause)
 		= (cause == UNVEILCAUSE_EXPLOSION || cause == UNVEILCAUSE_SHORT)
 		? 2 : 10;
 
-	return g_timerGame + Tools_AdjustToGameSpeed(duration * 60, 0, 0xFFFF, true);
+	return g_game->timerGame + Tools_AdjustToGameSpeed(duration * 60, 0, 0xFFFF, true);
 }
 
 /**
@@ -1181,7 +1230,7 @@ Map_UnveilTile_Neighbour(enum HouseType houseID, uint16 packed)
 	}
 
 	if (houseID == g_playerHouseID) {
-		g_mapVisible[packed].fogSpriteID
+		g_game->mapVisible[packed].fogSpriteID
 			= (bits != 0)
 			? g_iconMap[g_iconMap[ICM_ICONGROUP_FOG_OF_WAR] + bits] : 0;
 	}
@@ -1197,7 +1246,7 @@ Map_UnveilTile(enum HouseType houseID, enum TileUnveilCause cause,
 	if (Tile_IsOutOfMap(packed))
 		return;
 
-	FogOfWarTile *f = &g_mapVisible[packed];
+	FogOfWarTile *f = &g_game->mapVisible[packed];
 
 	f->cause[houseID] = max(f->cause[houseID], cause);
 	f->timeout[houseID] = Map_GetUnveilTimeout(cause);
@@ -1232,7 +1281,7 @@ Map_RefreshTile(enum HouseType houseID, enum TileUnveilCause cause, uint16 packe
 
 	if (Map_IsUnveiledToHouse(houseID, packed)) {
 		const int64_t timeout = Map_GetUnveilTimeout(cause);
-		FogOfWarTile *f = &g_mapVisible[packed];
+		FogOfWarTile *f = &g_game->mapVisible[packed];
 
 		if (f->timeout[houseID] < timeout) {
 			f->cause[houseID] = max(f->cause[houseID], cause);
@@ -1244,10 +1293,10 @@ Map_RefreshTile(enum HouseType houseID, enum TileUnveilCause cause, uint16 packe
 void
 Map_ResetFogOfWar(void)
 {
-	memset(g_mapVisible, 0, sizeof(g_mapVisible));
+	memset(g_game->mapVisible, 0, sizeof(g_game->mapVisible));
 
 	for (uint16 packed = 0; packed < MAP_SIZE_MAX * MAP_SIZE_MAX; packed++) {
-		FogOfWarTile *f = &g_mapVisible[packed];
+		FogOfWarTile *f = &g_game->mapVisible[packed];
 
 		f->fogSpriteID = g_veiledSpriteID;
 		f->fogOverlayBits = 0xF;
@@ -1259,13 +1308,13 @@ Map_Client_UpdateFogOfWar(void)
 {
 	if (enhancement_fog_of_war) {
 		for (uint16 packed = 65; packed < MAP_SIZE_MAX * MAP_SIZE_MAX - 65; packed++) {
-			FogOfWarTile *f = &g_mapVisible[packed];
+			FogOfWarTile *f = &g_game->mapVisible[packed];
 
 			if (!Map_IsUnveiledToHouse(g_playerHouseID, packed)
-					|| (f->timeout[g_playerHouseID] <= g_timerGame)) {
+					|| (f->timeout[g_playerHouseID] <= g_game->timerGame)) {
 				f->fogOverlayBits = 0xF;
 			} else {
-				const Tile *t = &g_map[packed];
+				const Tile *t = &g_game->map[packed];
 
 				f->groundSpriteID = t->groundSpriteID;
 				f->overlaySpriteID = t->overlaySpriteID;
@@ -1273,16 +1322,16 @@ Map_Client_UpdateFogOfWar(void)
 				f->hasStructure = t->hasStructure;
 				f->fogOverlayBits = 0;
 
-				if (g_mapVisible[packed - 64].timeout[g_playerHouseID] <= g_timerGame) f->fogOverlayBits |= 0x1;
-				if (g_mapVisible[packed +  1].timeout[g_playerHouseID] <= g_timerGame) f->fogOverlayBits |= 0x2;
-				if (g_mapVisible[packed + 64].timeout[g_playerHouseID] <= g_timerGame) f->fogOverlayBits |= 0x4;
-				if (g_mapVisible[packed -  1].timeout[g_playerHouseID] <= g_timerGame) f->fogOverlayBits |= 0x8;
+				if (g_game->mapVisible[packed - 64].timeout[g_playerHouseID] <= g_game->timerGame) f->fogOverlayBits |= 0x1;
+				if (g_game->mapVisible[packed +  1].timeout[g_playerHouseID] <= g_game->timerGame) f->fogOverlayBits |= 0x2;
+				if (g_game->mapVisible[packed + 64].timeout[g_playerHouseID] <= g_game->timerGame) f->fogOverlayBits |= 0x4;
+				if (g_game->mapVisible[packed -  1].timeout[g_playerHouseID] <= g_game->timerGame) f->fogOverlayBits |= 0x8;
 			}
 		}
 	} else {
 		for (uint16 packed = 65; packed < MAP_SIZE_MAX * MAP_SIZE_MAX - 65; packed++) {
-			const Tile *t = &g_map[packed];
-			FogOfWarTile *f = &g_mapVisible[packed];
+			const Tile *t = &g_game->map[packed];
+			FogOfWarTile *f = &g_game->mapVisible[packed];
 
 			f->groundSpriteID = t->groundSpriteID;
 			f->overlaySpriteID = t->overlaySpriteID;
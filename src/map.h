@@ -71,9 +71,6 @@ typedef struct LandscapeInfo {
 
 struct Unit;
 
-extern uint16 g_mapSpriteID[MAP_SIZE_MAX * MAP_SIZE_MAX];
-extern Tile g_map[MAP_SIZE_MAX * MAP_SIZE_MAX];
-extern FogOfWarTile g_mapVisible[MAP_SIZE_MAX * MAP_SIZE_MAX];
 extern const uint8 g_functions[3][3];
 
 extern const MapInfo g_mapInfos[3];
@@ -109,6 +106,10 @@ extern void Map_ChangeSpiceAmount(uint16 packed, int16 dir);
 extern void Map_Bloom_ExplodeSpecial(uint16 packed, uint8 houseID);
 extern uint16 Map_Server_FindLocationTile(uint16 locationID, enum HouseType houseID);
 extern void Map_UpdateAround(uint16 radius, tile32 position, struct Unit *unit, uint8 function);
+extern void Map_MarkDirty(uint16 packed);
+extern void Map_MarkAllDirty(void);
+extern void Map_ClearDirty(uint16 packed);
+extern uint16 Map_NextDirty(uint16 packed);
 extern uint16 Map_SearchSpice(uint16 packed, uint16 radius);
 extern void Map_UnveilTile(enum HouseType houseID, enum TileUnveilCause cause, uint16 packed);
 extern void Map_RefreshTile(enum HouseType houseID, enum TileUnveilCause cause, uint16 packed);
@@ -11,6 +11,7 @@
 
 #include "landscape.h"
 
+#include "../gamecontext.h"
 #include "../map.h"
 #include "../sprites.h"
 #include "../tools/coord.h"
@@ -51,17 +52,17 @@ static const uint16 k_offsetTable[2][21][4] = {
  * @details f__B4B8_0899_002D_EBA1.  Removed redundant recursive call.
  */
 static void
-LandscapeGenerator_AddSpiceOnTile(uint16 packed, Tile *map)
+LandscapeGenerator_AddSpiceOnTile(uint16 packed, uint16 *height)
 {
 	int i, j;
-	Tile *t;
-	Tile *t2;
+	uint16 *t;
+	uint16 *t2;
 
-	t = &map[packed];
+	t = &height[packed];
 
-	switch (t->groundSpriteID) {
+	switch (*t) {
 		case LST_SPICE:
-			t->groundSpriteID = LST_THICK_SPICE;
+			*t = LST_THICK_SPICE;
 			/* Fall through. */
 		case LST_THICK_SPICE:
 			for (j = -1; j <= 1; j++) {
@@ -73,20 +74,20 @@ LandscapeGenerator_AddSpiceOnTile(uint16 packed, Tile *map)
 					if (Tile_IsOutOfMap(packed2))
 						continue;
 
-					t2 = &map[packed2];
+					t2 = &height[packed2];
 
-					if (!g_table_landscapeInfo[t2->groundSpriteID].canBecomeSpice) {
-						t->groundSpriteID = LST_SPICE;
-					} else if (t2->groundSpriteID != LST_THICK_SPICE) {
-						t2->groundSpriteID = LST_SPICE;
+					if (!g_table_landscapeInfo[*t2].canBecomeSpice) {
+						*t = LST_SPICE;
+					} else if (*t2 != LST_THICK_SPICE) {
+						*t2 = LST_SPICE;
 					}
 				}
 			}
 			return;
 
 		default:
-			if (g_table_landscapeInfo[t->groundSpriteID].canBecomeSpice)
-				t->groundSpriteID = LST_SPICE;
+			if (g_table_landscapeInfo[*t].canBecomeSpice)
+				*t = LST_SPICE;
 			return;
 	}
 }
@@ -96,7 +97,7 @@ LandscapeGenerator_AddSpiceOnTile(uint16 packed, Tile *map)
  * @details f__B4B8_0000_001F_3BC3 between labels (l__001F, l__0191).
  */
 static void
-LandscapeGenerator_MakeRoughLandscape(Tile *map)
+LandscapeGenerator_MakeRoughLandscape(uint16 *height)
 {
 	unsigned int i, j;
 	uint8 memory[273];
@@ -132,7 +133,7 @@ LandscapeGenerator_MakeRoughLandscape(Tile *map)
 	for (j = 0; j < 16; j++) {
 		for (i = 0; i < 16; i++) {
 			const uint16 packed = Tile_PackXY(4*i, 4*j);
-			map[packed].groundSpriteID = memory[16*j + i];
+			height[packed] = memory[16*j + i];
 		}
 	}
 }
@@ -142,7 +143,7 @@ LandscapeGenerator_MakeRoughLandscape(Tile *map)
  * @details f__B4B8_0000_001F_3BC3 between labels (l__0191, l__02B8).
  */
 static void
-LandscapeGenerator_AverageRoughLandscape(Tile *map)
+LandscapeGenerator_AverageRoughLandscape(uint16 *height)
 {
 	unsigned int i, j, k;
 
@@ -176,15 +177,15 @@ LandscapeGenerator_AverageRoughLandscape(Tile *map)
 				packed2 = Tile_PackXY(x2 & 0x3F, y2);
 
 				assert(packed1 < 64 * 64);
-				sprite1 = map[packed1].groundSpriteID;
+				sprite1 = height[packed1];
 
 				/* ENHANCEMENT -- use groundSpriteID=0 when
 				 * out-of-bounds to generate the original maps.
 				 */
 				sprite2 = (packed2 < 64 * 64)
-					? map[packed2].groundSpriteID : 0;
+					? height[packed2] : 0;
 
-				map[packed].groundSpriteID = (sprite1 + sprite2 + 1) / 2;
+				height[packed] = (sprite1 + sprite2 + 1) / 2;
 			}
 		}
 	}
@@ -193,39 +194,55 @@ LandscapeGenerator_AverageRoughLandscape(Tile *map)
 /**
  * @brief   Average a tile and its immediate neighbours.
  * @details f__B4B8_0000_001F_3BC3 between labels (l_02B8, l__0442).
+ *          Rewritten as a separable 3x3 box filter.  The original
+ *          substitutes the centre tile for any neighbour outside the
+ *          map, which is a zero-padded sum plus the centre tile once for
+ *          each missing neighbour.
  */
 static void
-LandscapeGenerator_Average(Tile *map)
+LandscapeGenerator_Average(uint16 *height)
 {
 	unsigned int i, j;
-	uint16 currRow[64];
-	uint16 prevRow[64];
+	uint16 hsum[(64 + 2) * 64];
+	uint16 vsum[64 * 64];
 
-	memset(currRow, 0, sizeof(currRow));
+	/* Horizontal sums, with a row of zeros above and below the map. */
+	memset(hsum, 0, 64 * sizeof(hsum[0]));
+	memset(&hsum[65 * 64], 0, 64 * sizeof(hsum[0]));
 
 	for (j = 0; j < 64; j++) {
-		Tile *t = &map[64 * j];
-		memcpy(prevRow, currRow, sizeof(prevRow));
+		const uint16 *src = &height[64 * j];
+		uint16 *dst = &hsum[64 * (j + 1)];
 
-		for (i = 0; i < 64; i++) {
-			currRow[i] = t[i].groundSpriteID;
+		dst[0] = src[0] + src[1];
+		for (i = 1; i < 63; i++) {
+			dst[i] = src[i - 1] + src[i] + src[i + 1];
 		}
+		dst[63] = src[62] + src[63];
+	}
 
-		for (i = 0; i < 64; i++) {
-			uint16 sum = 0;
-
-			sum += (i == 0  || j == 0)  ? currRow[i] : prevRow[i - 1];
-			sum += (           j == 0)  ? currRow[i] : prevRow[i];
-			sum += (i == 63 || j == 0)  ? currRow[i] : prevRow[i + 1];
-			sum += (i == 0)             ? currRow[i] : currRow[i - 1];
-			sum +=                        currRow[i];
-			sum += (i == 63)            ? currRow[i] : currRow[i + 1];
-			sum += (i == 0  || j == 63) ? currRow[i] : t[i + 63].groundSpriteID;
-			sum += (           j == 63) ? currRow[i] : t[i + 64].groundSpriteID;
-			sum += (i == 63 || j == 63) ? currRow[i] : t[i + 65].groundSpriteID;
-
-			t[i].groundSpriteID = sum / 9;
-		}
+	/* Vertical sums. */
+	for (i = 0; i < 64 * 64; i++) {
+		vsum[i] = hsum[i] + hsum[i + 64] + hsum[i + 128];
+	}
+
+	/* Edges: top and bottom rows miss three neighbours, left and
+	 * right columns miss three, corners miss five.
+	 */
+	for (i = 0; i < 64; i++) {
+		vsum[i] += 3 * height[i];
+		vsum[63 * 64 + i] += 3 * height[63 * 64 + i];
+	}
+
+	for (j = 0; j < 64; j++) {
+		const unsigned int missing = (j == 0 || j == 63) ? 2 : 3;
+
+		vsum[64 * j] += missing * height[64 * j];
+		vsum[64 * j + 63] += missing * height[64 * j + 63];
+	}
+
+	for (i = 0; i < 64 * 64; i++) {
+		height[i] = vsum[i] / 9;
 	}
 }
 
@@ -234,7 +251,7 @@ LandscapeGenerator_Average(Tile *map)
  * @details f__B4B8_0000_001F_3BC3 between labels (l__0442, l__004ED).
  */
 static void
-LandscapeGenerator_DetermineLandscapeTypes(Tile *map)
+LandscapeGenerator_DetermineLandscapeTypes(uint16 *height)
 {
 	unsigned int i;
 	uint16 spriteID1;
@@ -251,14 +268,14 @@ LandscapeGenerator_DetermineLandscapeTypes(Tile *map)
 		spriteID2 = spriteID1 - 3;
 
 	for (i = 0; i < 64 * 64; i++) {
-		const uint16 spriteID = map[i].groundSpriteID;
+		const uint16 spriteID = height[i];
 		const enum LandscapeType lst
 			= (spriteID >  spriteID1 + 4) ? LST_ENTIRELY_MOUNTAIN
 			: (spriteID >= spriteID1) ? LST_ENTIRELY_ROCK
 			: (spriteID <= spriteID2) ? LST_ENTIRELY_DUNE
 			: LST_NORMAL_SAND;
 
-		map[i].groundSpriteID = lst;
+		height[i] = lst;
 	}
 }
 
@@ -267,7 +284,8 @@ LandscapeGenerator_DetermineLandscapeTypes(Tile *map)
  * @details f__B4B8_0000_001F_3BC3 between labels (l__04ED, l__0596).
  */
 static void
-LandscapeGenerator_AddSpice(const LandscapeGeneratorParams *params, Tile *map)
+LandscapeGenerator_AddSpice(const LandscapeGeneratorParams *params,
+		uint16 *height)
 {
 	const unsigned int max_count = 65535;
 	unsigned int count = 0;
@@ -294,7 +312,7 @@ LandscapeGenerator_AddSpice(const LandscapeGeneratorParams *params, Tile *map)
 			const uint16 y = Tools_Random_256() & 0x3F;
 			const uint16 x = Tools_Random_256() & 0x3F;
 			const uint16 packed = Tile_PackXY(x, y);
-			const enum LandscapeType lst = map[packed].groundSpriteID;
+			const enum LandscapeType lst = height[packed];
 
 			if (g_table_landscapeInfo[lst].canBecomeSpice) {
 				tile = Tile_UnpackTile(packed);
@@ -315,7 +333,7 @@ LandscapeGenerator_AddSpice(const LandscapeGeneratorParams *params, Tile *map)
 				const uint16 packed = Tile_PackTile(tile2);
 
 				if (!Tile_IsOutOfMap(packed)) {
-					LandscapeGenerator_AddSpiceOnTile(packed, map);
+					LandscapeGenerator_AddSpiceOnTile(packed, height);
 					break;
 				}
 			}
@@ -328,28 +346,24 @@ LandscapeGenerator_AddSpice(const LandscapeGeneratorParams *params, Tile *map)
  * @details f__B4B8_0000_001F_3BC3 between labels (l__0596, l__07D3).
  */
 static void
-LandscapeGenerator_Smooth(Tile *map)
+LandscapeGenerator_Smooth(uint16 *height)
 {
 	unsigned int i, j;
-	uint16 currRow[64];
-	uint16 prevRow[64];
+	uint16 src[64 * 64];
 
-	memset(currRow, 0, sizeof(currRow));
+	memcpy(src, height, sizeof(src));
 
 	for (j = 0; j < 64; j++) {
-		Tile *t = &map[64 * j];
-
-		memcpy(prevRow, currRow, sizeof(prevRow));
+		const uint16 *prevRow = &src[64 * (j - (j > 0))];
+		const uint16 *currRow = &src[64 * j];
+		const uint16 *nextRow = &src[64 * (j + (j < 63))];
+		uint16 *dst = &height[64 * j];
 
 		for (i = 0; i < 64; i++) {
-			currRow[i] = t[i].groundSpriteID;
-		}
-
-		for (i = 0; i < 64; i++) {
-			const uint16 curr   = t[i].groundSpriteID;
-			const uint16 up     = (j == 0)  ? curr : prevRow[i];
+			const uint16 curr   = currRow[i];
+			const uint16 up     = prevRow[i];
 			const uint16 right  = (i == 63) ? curr : currRow[i + 1];
-			const uint16 down   = (j == 63) ? curr : t[i + 64].groundSpriteID;
+			const uint16 down   = nextRow[i];
 			const uint16 left   = (i == 0)  ? curr : currRow[i - 1];
 			uint16 spriteID = 0;
 
@@ -389,7 +403,7 @@ LandscapeGenerator_Smooth(Tile *map)
 					break;
 			}
 
-			t[i].groundSpriteID = spriteID;
+			dst[i] = spriteID;
 		}
 	}
 }
@@ -397,9 +411,10 @@ LandscapeGenerator_Smooth(Tile *map)
 /**
  * @brief   Finalises the generated landscape's groundSpriteIDs.
  * @details f__B4B8_0000_001F_3BC3 between labels (l__07D3, l__088D).
+ *          This is the only pass that writes to the map.
  */
 static void
-LandscapeGenerator_Finalise(Tile *map)
+LandscapeGenerator_Finalise(const uint16 *height, Tile *map)
 {
 	const uint16 *iconMap = &g_iconMap[g_iconMap[ICM_ICONGROUP_LANDSCAPE]];
 	int i;
@@ -407,7 +422,8 @@ LandscapeGenerator_Finalise(Tile *map)
 	for (i = 0; i < 64 * 64; i++) {
 		Tile *t = &map[i];
 
-		t->groundSpriteID   = iconMap[t->groundSpriteID];
+		t->groundSpriteID   = iconMap[height[i]];
+		g_game->mapSpriteID[i]    = t->groundSpriteID;
 		t->overlaySpriteID  = 0;
 		t->houseID          = HOUSE_HARKONNEN;
 		t->isUnveiled_      = false;
@@ -417,41 +433,42 @@ LandscapeGenerator_Finalise(Tile *map)
 		t->hasExplosion     = false;
 		t->index            = 0;
 	}
-
-	for (i = 0; i < 64 * 64; i++) {
-		g_mapSpriteID[i] = map[i].groundSpriteID;
-	}
 }
 
 /**
  * @brief   f__B4B8_0000_001F_3BC3.
  * @details Refactored into several smaller functions.
  *          params=NULL defaults to original Dune II parameters.
+ *          The passes work on a plain height plane rather than the
+ *          groundSpriteID bitfield, which is only written at the end.
  */
 void
 Map_CreateLandscape(uint32 seed, const LandscapeGeneratorParams *params,
 		Tile *map)
 {
+	uint16 height[64 * 64];
+
 	Tools_Random_Seed(seed);
+	memset(height, 0, sizeof(height));
 
 	/* Place random data on a 4x4 grid. */
-	LandscapeGenerator_MakeRoughLandscape(map);
+	LandscapeGenerator_MakeRoughLandscape(height);
 
 	/* Average around the 4x4 grid. */
-	LandscapeGenerator_AverageRoughLandscape(map);
+	LandscapeGenerator_AverageRoughLandscape(height);
 
 	/* Average each tile with its neighbours. */
-	LandscapeGenerator_Average(map);
+	LandscapeGenerator_Average(height);
 
 	/* Filter each tile to determine its final type. */
-	LandscapeGenerator_DetermineLandscapeTypes(map);
+	LandscapeGenerator_DetermineLandscapeTypes(height);
 
 	/* Add some spice. */
-	LandscapeGenerator_AddSpice(params, map);
+	LandscapeGenerator_AddSpice(params, height);
 
 	/* Make everything smoother and use the right sprite indexes. */
-	LandscapeGenerator_Smooth(map);
+	LandscapeGenerator_Smooth(height);
 
 	/* Finalise the tiles with the real sprites. */
-	LandscapeGenerator_Finalise(map);
+	LandscapeGenerator_Finalise(height, map);
 }
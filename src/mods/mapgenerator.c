@@ -6,13 +6,14 @@
 
 #include "mapgenerator.h"
 
+#include "../gamecontext.h"
 #include "../map.h"
 #include "../pool/pool_house.h"
 #include "../pool/pool_structure.h"
 #include "../pool/pool_team.h"
 #include "../pool/pool_unit.h"
 
-static struct {
+static THREAD_LOCAL struct {
 	Tile map[MAP_SIZE_MAX * MAP_SIZE_MAX];
 	uint16 mapSpriteID[MAP_SIZE_MAX * MAP_SIZE_MAX];
 	struct HousePool *house_pool;
@@ -20,8 +21,8 @@ static struct {
 	struct TeamPool *team_pool;
 	struct UnitPool *unit_pool;
 } s_world_state;
-assert_compile(sizeof(s_world_state.map) == sizeof(g_map));
-assert_compile(sizeof(s_world_state.mapSpriteID) == sizeof(g_mapSpriteID));
+assert_compile(sizeof(s_world_state.map) == sizeof(g_game->map));
+assert_compile(sizeof(s_world_state.mapSpriteID) == sizeof(g_game->mapSpriteID));
 
 /*--------------------------------------------------------------*/
 
@@ -58,8 +59,8 @@ MapGenerator_PickRandomSeed(void)
 void
 MapGenerator_SaveWorldState(void)
 {
-	memcpy(s_world_state.map, g_map, sizeof(g_map));
-	memcpy(s_world_state.mapSpriteID, g_mapSpriteID, sizeof(g_mapSpriteID));
+	memcpy(s_world_state.map, g_game->map, sizeof(g_game->map));
+	memcpy(s_world_state.mapSpriteID, g_game->mapSpriteID, sizeof(g_game->mapSpriteID));
 	s_world_state.house_pool = HousePool_Save();
 	s_world_state.structure_pool = StructurePool_Save();
 	s_world_state.team_pool = TeamPool_Save();
@@ -73,6 +74,6 @@ MapGenerator_LoadWorldState(void)
 	TeamPool_Load(s_world_state.team_pool);
 	StructurePool_Load(s_world_state.structure_pool);
 	HousePool_Load(s_world_state.house_pool);
-	memcpy(g_mapSpriteID, s_world_state.mapSpriteID, sizeof(g_mapSpriteID));
-	memcpy(g_map, s_world_state.map, sizeof(g_map));
+	memcpy(g_game->mapSpriteID, s_world_state.mapSpriteID, sizeof(g_game->mapSpriteID));
+	memcpy(g_game->map, s_world_state.map, sizeof(g_game->map));
 }
@@ -19,7 +19,7 @@
 #include "../unit.h"
 #include "../video/video.h"
 
-Multiplayer g_multiplayer;
+THREAD_LOCAL Multiplayer g_multiplayer;
 
 void
 Multiplayer_Init(void)
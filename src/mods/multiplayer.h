@@ -48,7 +48,7 @@ typedef struct Multiplayer {
 
 struct SkirmishData;
 
-extern Multiplayer g_multiplayer;
+extern THREAD_LOCAL Multiplayer g_multiplayer;
 
 extern void Multiplayer_Init(void);
 extern bool Multiplayer_IsHouseAvailable(enum HouseType houseID);
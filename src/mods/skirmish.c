@@ -12,6 +12,7 @@
 #include "../ai.h"
 #include "../enhancement.h"
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../map.h"
 #include "../opendune.h"
 #include "../pool/pool.h"
@@ -116,7 +117,7 @@ static const SkirmishBuildOrder buildorder[] = {
 	{ STRUCTURE_INVALID,            99, false, 0    },
 };
 
-Skirmish g_skirmish;
+THREAD_LOCAL Skirmish g_skirmish;
 
 /*--------------------------------------------------------------*/
 
@@ -221,7 +222,7 @@ Skirmish_PickRandomLocation(uint16 acceptableLstFlags, uint16 unacceptableLstFla
 	const int y = mi->minY + Tools_RandomLCG_Range(0, mi->sizeY - 1);
 
 	const uint16 packed = Tile_PackXY(x, y);
-	if (g_map[packed].hasUnit)
+	if (g_game->map[packed].hasUnit)
 		return 0;
 
 	const enum LandscapeType lst = Map_GetLandscapeType(packed);
@@ -306,7 +307,7 @@ Skirmish_StartScenario(void)
 	assert(g_playerHouseID != HOUSE_INVALID);
 
 	Game_Prepare();
-	g_tickScenarioStart = g_timerGame;
+	g_game->tickScenarioStart = g_game->timerGame;
 
 	GUI_ChangeSelectionType(SELECTIONTYPE_STRUCTURE);
 	Scenario_CentreViewport(g_playerHouseID);
@@ -321,12 +322,12 @@ Skirmish_StartScenario(void)
 static void
 Skirmish_GenGeneral(uint32 seed)
 {
-	memset(&g_scenario, 0, sizeof(Scenario));
-	g_scenario.winFlags = 3;
-	g_scenario.loseFlags = 1;
-	g_scenario.mapSeed = seed;
-	g_scenario.mapScale = 0;
-	g_scenario.timeOut = 0;
+	memset(&g_game->scenario, 0, sizeof(Scenario));
+	g_game->scenario.winFlags = 3;
+	g_game->scenario.loseFlags = 1;
+	g_game->scenario.mapSeed = seed;
+	g_game->scenario.mapScale = 0;
+	g_game->scenario.timeOut = 0;
 }
 
 static void
@@ -340,9 +341,9 @@ Skirmish_GenSpiceBlooms(void)
 			continue;
 
 		if ((Tools_Random_256() & 0x3) == 0) {
-			Scenario_Load_Map_Field(packed, &g_map[packed]);
+			Scenario_Load_Map_Field(packed, &g_game->map[packed]);
 		} else {
-			Scenario_Load_Map_Bloom(packed, &g_map[packed]);
+			Scenario_Load_Map_Bloom(packed, &g_game->map[packed]);
 		}
 	}
 }
@@ -527,7 +528,8 @@ Skirmish_GenStructuresAI(enum HouseType houseID, SkirmishData *sd)
 	uint16 structure = 0;
 	int structure_count = 0;
 	int structure_threshold = 100;
-	bool is_cpu_allied_with_player = pc[houseID].brain == BRAIN_CPU && pc[g_playerHouseID].brain == pc[houseID].brain;
+	bool is_cpu_allied_with_player = pc[houseID].brain == BRAIN_CPU
+		&& g_playerHouseID != HOUSE_INVALID && pc[g_playerHouseID].brain == pc[houseID].brain;
 
 	int cpu_count = 0;
 	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++) {
@@ -1061,7 +1063,7 @@ Skirmish_GenerateMap2(bool only_landscape, SkirmishData *sd)
 	Sprites_UnloadTiles();
 	Sprites_LoadTiles();
 	Tools_RandomLCG_Seed(seed);
-	Map_CreateLandscape(seed, params, g_map);
+	Map_CreateLandscape(seed, params, g_game->map);
 
 	if (only_landscape)
 		return true;
@@ -1118,7 +1120,7 @@ Skirmish_GenerateMap2(bool only_landscape, SkirmishData *sd)
 			continue;
 
 		for (int i = sd.island[island].start; i < sd.island[island].end; i++) {
-			g_map[sd.buildable[i].packed].groundSpriteID = g_veiledSpriteID;
+			g_game->map[sd.buildable[i].packed].groundSpriteID = g_veiledSpriteID;
 		}
 	}
 #endif
@@ -27,7 +27,7 @@ typedef struct Skirmish {
 
 struct SkirmishData;
 
-extern Skirmish g_skirmish;
+extern THREAD_LOCAL Skirmish g_skirmish;
 
 extern uint16 Skirmish_FindStartLocation(enum HouseType houseID, struct SkirmishData *sd);
 
@@ -10,9 +10,12 @@
 
 #include "message.h"
 #include "net.h"
+#include "telemetry.h"
+#include "tiledelta.h"
 #include "../audio/audio.h"
 #include "../enhancement.h"
 #include "../explosion.h"
+#include "../gamecontext.h"
 #include "../gfx.h"
 #include "../gui/gui.h"
 #include "../house.h"
@@ -29,7 +32,10 @@
 #include "../pool/pool_structure.h"
 #include "../pool/pool_unit.h"
 #include "../structure.h"
+#include "../timer/timer.h"
+#include "../tools/coord.h"
 #include "../tools/random_starport.h"
+#include "../unit.h"
 
 #if 0
 #define CLIENT_LOG(FORMAT,...)	\
@@ -38,6 +44,19 @@
 #define CLIENT_LOG(...)
 #endif
 
+/* The last two positions of a unit received from the server. */
+typedef struct UnitSnapshot {
+	int64_t tick[2];
+	tile32 position[2];
+	bool moving;
+} UnitSnapshot;
+
+THREAD_LOCAL int g_client_extrapolation_ticks = 15;
+
+static THREAD_LOCAL UnitSnapshot s_unitSnapshot[UNIT_INDEX_MAX_RAISED];
+static THREAD_LOCAL int64_t s_serverTickOffset;
+static THREAD_LOCAL bool s_serverTickOffsetValid;
+
 /*--------------------------------------------------------------*/
 
 void
@@ -45,6 +64,90 @@ Client_ResetCache(void)
 {
 	memset(g_client2server_message_buf, 0, MAX_CLIENT_MESSAGE_LEN);
 	g_client2server_message_len = 0;
+
+	memset(s_unitSnapshot, 0, sizeof(s_unitSnapshot));
+	s_serverTickOffsetValid = false;
+}
+
+/* Client_SyncServerTick:
+ *
+ * Estimates the server's tick counter from the stamps on unit updates.
+ * The least delayed update gives the best estimate.  The estimate
+ * creeps back a tick per update so that it follows clock drift.
+ */
+static void
+Client_SyncServerTick(int64_t server_tick)
+{
+	const int64_t offset = server_tick - g_game->timerGame;
+
+	if (!s_serverTickOffsetValid || offset > s_serverTickOffset) {
+		s_serverTickOffset = offset;
+		s_serverTickOffsetValid = true;
+	} else {
+		s_serverTickOffset--;
+	}
+}
+
+static void
+Client_UpdateSnapshot(uint16 index, int64_t tick, tile32 position, bool moving, bool reset)
+{
+	UnitSnapshot *snap = &s_unitSnapshot[index];
+
+	/* Do not smooth over warps, e.g. leaving a carryall. */
+	if (reset
+			|| (tick <= snap->tick[1])
+			|| (Tile_GetDistance(snap->position[1], position) > 0x200)) {
+		snap->tick[0] = tick;
+		snap->position[0] = position;
+	} else {
+		snap->tick[0] = snap->tick[1];
+		snap->position[0] = snap->position[1];
+	}
+
+	snap->tick[1] = tick;
+	snap->position[1] = position;
+	snap->moving = moving;
+}
+
+/**
+ * @brief   Position at which to draw a unit on a dedicated client.
+ * @details Introduced.  Interpolates between the last two updates from
+ *          the server, or extrapolates along the unit's orientation at
+ *          its last observed speed for up to
+ *          g_client_extrapolation_ticks past the last update.
+ */
+tile32
+Client_GetUnitPosition(const Unit *u)
+{
+	const UnitSnapshot *snap = &s_unitSnapshot[u->o.index];
+	const int64_t dt01 = snap->tick[1] - snap->tick[0];
+
+	if (!s_serverTickOffsetValid || dt01 <= 0)
+		return u->o.position;
+
+	const int64_t now = g_game->timerGame + s_serverTickOffset;
+	const tile32 p0 = snap->position[0];
+	const tile32 p1 = snap->position[1];
+	tile32 pos;
+
+	if (now <= snap->tick[0]) {
+		pos = p0;
+	} else if (now < snap->tick[1]) {
+		const int64_t t = now - snap->tick[0];
+
+		pos.x = p0.x + ((int)p1.x - p0.x) * t / dt01;
+		pos.y = p0.y + ((int)p1.y - p0.y) * t / dt01;
+	} else if (snap->moving) {
+		const int64_t window = max(0, g_client_extrapolation_ticks);
+		const int64_t t = min(now - snap->tick[1], window);
+		const int dist = Tile_GetDistance(p0, p1) * t / dt01;
+
+		pos = Tile_MoveByDirectionUnbounded(p1, u->orientation[0].current, dist);
+	} else {
+		pos = p1;
+	}
+
+	return pos;
 }
 
 /*--------------------------------------------------------------*/
@@ -242,40 +345,76 @@ Client_Send_Chat(const char *msg)
 
 /*--------------------------------------------------------------*/
 
+/**
+ * @brief   Drops the rest of a packet after a malformed message.
+ * @details Messages carry no length, so the end of a bad one cannot be
+ *          found, and anything decoded after it would be misaligned.
+ */
 static void
-Client_Recv_UpdateLandscape(const unsigned char **buf)
+Client_SkipMalformed(const unsigned char **buf, const unsigned char *end)
 {
-	const int count = Net_Decode_uint16(buf);
+	*buf = end;
+}
+
+static void
+Client_Recv_UpdateLandscape(const unsigned char **buf, const unsigned char *end)
+{
+	const int count = Net_Decode_uint8(buf);
 
 	for (int i = 0; i < count; i++) {
-		const uint16 packed = Net_Decode_uint16(buf);
-		const Tile *s = (const Tile *)(*buf);
-		Tile *t = &g_map[packed];
-
-		t->groundSpriteID   = s->groundSpriteID;
-		t->overlaySpriteID  = s->overlaySpriteID;
-		t->houseID          = s->houseID;
-		t->hasUnit          = s->hasUnit;
-		t->hasStructure     = s->hasStructure;
-		t->index            = s->index;
-
-		(*buf) += sizeof(Tile);
+		uint32 value[TILEDELTA_BLOCK_TILES];
+		uint64_t changed;
+
+		const int block = TileDelta_DecodeBlock(buf, end,
+				&changed, value, sizeof(Tile));
+		if (block < 0) {
+			Client_SkipMalformed(buf, end);
+			return;
+		}
+
+		for (int bit = 0; bit < TILEDELTA_BLOCK_TILES; bit++) {
+			if (!(changed & ((uint64_t)1 << bit)))
+				continue;
+
+			Tile s;
+			Tile *t = &g_game->map[TileDelta_GetPacked(block, bit)];
+
+			memcpy(&s, &value[bit], sizeof(Tile));
+			t->groundSpriteID   = s.groundSpriteID;
+			t->overlaySpriteID  = s.overlaySpriteID;
+			t->houseID          = s.houseID;
+			t->hasUnit          = s.hasUnit;
+			t->hasStructure     = s.hasStructure;
+			t->index            = s.index;
+		}
 	}
 }
 
 static void
-Client_Recv_UpdateFogOfWar(const unsigned char **buf)
+Client_Recv_UpdateFogOfWar(const unsigned char **buf, const unsigned char *end)
 {
-	const int count = Net_Decode_uint16(buf);
+	const int count = Net_Decode_uint8(buf);
 
 	for (int i = 0; i < count; i++) {
-		const uint16 encoded = Net_Decode_uint16(buf);
-		const uint16 packed  = encoded & 0x3FFF;
+		uint32 value[TILEDELTA_BLOCK_TILES];
+		uint64_t changed;
+
+		const int block = TileDelta_DecodeBlock(buf, end,
+				&changed, value, 1);
+		if (block < 0) {
+			Client_SkipMalformed(buf, end);
+			return;
+		}
 
-		const enum TileUnveilCause cause
-			= (encoded & 0x8000) ? UNVEILCAUSE_SHORT : UNVEILCAUSE_LONG;
+		for (int bit = 0; bit < TILEDELTA_BLOCK_TILES; bit++) {
+			if (!(changed & ((uint64_t)1 << bit)))
+				continue;
 
-		Map_UnveilTile(g_playerHouseID, cause, packed);
+			const enum TileUnveilCause cause
+				= (value[bit] != 0) ? UNVEILCAUSE_SHORT : UNVEILCAUSE_LONG;
+
+			Map_UnveilTile(g_playerHouseID, cause, TileDelta_GetPacked(block, bit));
+		}
 	}
 }
 
@@ -368,9 +507,12 @@ Client_Recv_UpdateStructures(const unsigned char **buf)
 static void
 Client_Recv_UpdateUnits(const unsigned char **buf)
 {
+	const int64_t tick = Net_Decode_uint32(buf);
 	const int count = Net_Decode_uint8(buf);
 	bool recount = false;
 
+	Client_SyncServerTick(tick);
+
 	for (int i = 0; i < count; i++) {
 		const uint16 index = Net_Decode_ObjectIndex(buf);
 		Unit *u = Unit_Get_ByIndex(index);
@@ -396,8 +538,12 @@ Client_Recv_UpdateUnits(const unsigned char **buf)
 		u->spriteOffset = Net_Decode_uint8(buf);
 		u->blinkHouse   = Net_Decode_uint8(buf);
 
-		/* XXX -- Smooth animation not yet implemented. */
+		const uint8 speed = Net_Decode_uint8(buf);
+
 		u->lastPosition = o->position;
+		Client_UpdateSnapshot(index, tick, o->position, (speed != 0),
+				(o->flags.s.used && !old_flags.s.used)
+				|| (o->flags.s.isNotOnMap != old_flags.s.isNotOnMap));
 
 		if (o->flags.s.used != old_flags.s.used)
 			recount = true;
@@ -596,7 +742,7 @@ Client_Recv_Chat(const unsigned char **buf)
 void
 Client_ChangeSelectionMode(void)
 {
-	static bool l_houseMissileWasActive; /* XXX */
+	static THREAD_LOCAL bool l_houseMissileWasActive; /* XXX */
 
 	if ((g_playerHouse->structureActiveID != STRUCTURE_INDEX_INVALID)
 			&& (g_structureActive == NULL)) {
@@ -641,11 +787,11 @@ Client_ProcessMessage(const unsigned char *buf, int count)
 				break;
 
 			case SCMSG_UPDATE_LANDSCAPE:
-				Client_Recv_UpdateLandscape(&buf);
+				Client_Recv_UpdateLandscape(&buf, buf0 + count);
 				break;
 
 			case SCMSG_UPDATE_FOG_OF_WAR:
-				Client_Recv_UpdateFogOfWar(&buf);
+				Client_Recv_UpdateFogOfWar(&buf, buf0 + count);
 				break;
 
 			case SCMSG_UPDATE_HOUSE:
@@ -724,6 +870,7 @@ Client_ProcessMessage(const unsigned char *buf, int count)
 				break;
 		}
 
+		NetTelemetry_CountServerClientMsg(msg, 1 + (buf - buf0));
 		count -= (buf - buf0);
 	}
 
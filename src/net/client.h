@@ -6,8 +6,12 @@
 #include "net.h"
 
 struct Object;
+struct Unit;
+
+extern THREAD_LOCAL int g_client_extrapolation_ticks;
 
 extern void Client_ResetCache(void);
+extern tile32 Client_GetUnitPosition(const struct Unit *u);
 
 extern void Client_Send_ReturnToLobby(void);
 extern void Client_Send_RepairUpgradeStructure(const struct Object *o);
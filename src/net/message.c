@@ -50,11 +50,11 @@ static unsigned char s_table_scmsg[SCMSG_MAX] = {
 	'"', /* SCMSG_CHAT */
 };
 
-unsigned char g_server_broadcast_message_buf[MAX_SERVER_BROADCAST_MESSAGE_LEN];
-unsigned char g_server2client_message_buf[HOUSE_NEUTRAL][MAX_SERVER_TO_CLIENT_MESSAGE_LEN];
-unsigned char g_client2server_message_buf[MAX_CLIENT_MESSAGE_LEN];
-int g_server2client_message_len[HOUSE_NEUTRAL];
-int g_client2server_message_len;
+THREAD_LOCAL unsigned char g_server_broadcast_message_buf[MAX_SERVER_BROADCAST_MESSAGE_LEN];
+THREAD_LOCAL unsigned char g_server2client_message_buf[HOUSE_NEUTRAL][MAX_SERVER_TO_CLIENT_MESSAGE_LEN];
+THREAD_LOCAL unsigned char g_client2server_message_buf[MAX_CLIENT_MESSAGE_LEN];
+THREAD_LOCAL int g_server2client_message_len[HOUSE_NEUTRAL];
+THREAD_LOCAL int g_client2server_message_len;
 
 /*--------------------------------------------------------------*/
 
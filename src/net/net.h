@@ -39,22 +39,29 @@ typedef struct PeerData {
 	enum ClientState state;
 	int id;
 	void *peer;
+	bool compress;
 	char name[MAX_NAME_LEN + 1];
+
+	/* Game ticks between world updates that this client's link keeps
+	 * up with.  See Server_ScheduleWorldUpdate.
+	 */
+	int update_interval;
 } PeerData;
 
-extern char g_net_name[MAX_NAME_LEN + 1];
-extern char g_host_addr[MAX_ADDR_LEN + 1];
-extern char g_host_port[MAX_PORT_LEN + 1];
-extern char g_join_addr[MAX_ADDR_LEN + 1];
-extern char g_join_port[MAX_PORT_LEN + 1];
-extern char g_chat_buf[MAX_CHAT_LEN + 1];
+extern THREAD_LOCAL char g_net_name[MAX_NAME_LEN + 1];
+extern THREAD_LOCAL char g_host_addr[MAX_ADDR_LEN + 1];
+extern THREAD_LOCAL char g_host_port[MAX_PORT_LEN + 1];
+extern THREAD_LOCAL char g_join_addr[MAX_ADDR_LEN + 1];
+extern THREAD_LOCAL char g_join_port[MAX_PORT_LEN + 1];
+extern THREAD_LOCAL char g_chat_buf[MAX_CHAT_LEN + 1];
+extern THREAD_LOCAL bool g_net_compression;
 
-extern bool g_sendClientList;
-extern bool g_sendScenario;
-extern enum HouseFlag g_client_houses;
-extern enum NetHostType g_host_type;
-extern int g_local_client_id;
-extern PeerData g_peer_data[MAX_CLIENTS];
+extern THREAD_LOCAL bool g_sendClientList;
+extern THREAD_LOCAL bool g_sendScenario;
+extern THREAD_LOCAL enum HouseFlag g_client_houses;
+extern THREAD_LOCAL enum NetHostType g_host_type;
+extern THREAD_LOCAL int g_local_client_id;
+extern THREAD_LOCAL PeerData g_peer_data[MAX_CLIENTS];
 
 extern PeerData *Net_GetPeerData(int peerID);
 extern const char *Net_GetClientName(enum HouseType houseID);
@@ -78,6 +85,7 @@ extern bool Server_Send_StartGame(void);
 extern void Server_SendMessages(void);
 extern void Server_DisconnectClient(PeerData *data);
 extern void Server_RecvMessages(void);
+extern void Server_WaitForMessages(int timeout);
 extern void Client_SendMessages(void);
 extern enum NetEvent Client_RecvMessages(void);
 
@@ -3,21 +3,27 @@
 #include <assert.h>
 #include <enet/enet.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "../os/math.h"
 
 #include "net.h"
 
 #include "client.h"
 #include "message.h"
 #include "server.h"
+#include "telemetry.h"
 #include "../audio/audio.h"
 #include "../enhancement.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../mods/multiplayer.h"
 #include "../newui/chatbox.h"
 #include "../newui/menu.h"
 #include "../opendune.h"
 #include "../pool/pool_house.h"
+#include "../replay.h"
+#include "../timer/timer.h"
 
 #if 0
 #define NET_LOG(FORMAT,...)	\
@@ -26,22 +32,59 @@
 #define NET_LOG(...)
 #endif
 
-char g_net_name[MAX_NAME_LEN + 1] = "Name";
-char g_host_addr[MAX_ADDR_LEN + 1] = "0.0.0.0";
-char g_host_port[MAX_PORT_LEN + 1] = DEFAULT_PORT_STR;
-char g_join_addr[MAX_ADDR_LEN + 1] = "localhost";
-char g_join_port[MAX_PORT_LEN + 1] = DEFAULT_PORT_STR;
-char g_chat_buf[MAX_CHAT_LEN + 1];
-
-bool g_sendClientList;
-bool g_sendScenario;
-enum HouseFlag g_client_houses;
-enum NetHostType g_host_type;
-static ENetHost *s_enet_host;
-static ENetPeer *s_enet_peer;
-
-int g_local_client_id;
-PeerData g_peer_data[MAX_CLIENTS];
+/* Encodes a message into buf and counts it for the telemetry. */
+#define SEND_COUNTED(MSG, CALL)	\
+	do { const unsigned char *prev = buf; CALL; NetTelemetry_CountServerClientMsg(MSG, buf - prev); } while (false)
+
+THREAD_LOCAL char g_net_name[MAX_NAME_LEN + 1] = "Name";
+THREAD_LOCAL char g_host_addr[MAX_ADDR_LEN + 1] = "0.0.0.0";
+THREAD_LOCAL char g_host_port[MAX_PORT_LEN + 1] = DEFAULT_PORT_STR;
+THREAD_LOCAL char g_join_addr[MAX_ADDR_LEN + 1] = "localhost";
+THREAD_LOCAL char g_join_port[MAX_PORT_LEN + 1] = DEFAULT_PORT_STR;
+THREAD_LOCAL char g_chat_buf[MAX_CHAT_LEN + 1];
+THREAD_LOCAL bool g_net_compression = true;
+
+THREAD_LOCAL bool g_sendClientList;
+THREAD_LOCAL bool g_sendScenario;
+THREAD_LOCAL enum HouseFlag g_client_houses;
+THREAD_LOCAL enum NetHostType g_host_type;
+static THREAD_LOCAL ENetHost *s_enet_host;
+static THREAD_LOCAL ENetPeer *s_enet_peer;
+
+/* Server to client broadcasts are range coded if the client asked for
+ * it in the connect data.  Compressed packets start with a marker byte
+ * that is not a message type, and travel on the same channel as
+ * everything else so that the order of messages is kept.
+ */
+enum {
+	NET_CONNECT_FLAG_COMPRESSION = 0x01,
+	NET_COMPRESSED_PACKET = 'z'
+};
+
+static THREAD_LOCAL void *s_range_coder;
+static THREAD_LOCAL unsigned char s_compressed_buf[MAX_SERVER_BROADCAST_MESSAGE_LEN];
+
+/* World updates (landscape, structures, units, explosions) are encoded
+ * once and broadcast, so they go out at the pace of the slowest client
+ * in the game.  A client's interval doubles while its reliable queue
+ * backs up, and shrinks again once the queue drains.  Deltas that are
+ * held back stay dirty in the server's cache and coalesce into the
+ * next update.
+ */
+enum {
+	NET_UPDATE_INTERVAL_MAX = 8,
+	NET_UPDATE_QUEUE_HIGH   = 16,
+	NET_UPDATE_QUEUE_LOW    = 2,
+	NET_UPDATE_BUDGET_MIN   = 512,
+
+	/* Game ticks per second at normal speed. */
+	NET_TICKS_PER_SECOND    = 60
+};
+
+static THREAD_LOCAL int64_t s_lastWorldUpdate;
+
+THREAD_LOCAL int g_local_client_id;
+THREAD_LOCAL PeerData g_peer_data[MAX_CLIENTS];
 
 /*--------------------------------------------------------------*/
 
@@ -55,6 +98,7 @@ Net_NewPeerData(int peerID)
 			data->state = CLIENTSTATE_IN_LOBBY;
 			data->id = peerID;
 			data->name[0] = '\0';
+			data->update_interval = 1;
 			return data;
 		}
 	}
@@ -65,7 +109,7 @@ Net_NewPeerData(int peerID)
 static PeerData *
 Server_NewClient(void)
 {
-	static int l_peerID = 0;
+	static THREAD_LOCAL int l_peerID = 0;
 
 	l_peerID = (l_peerID + 1) & 0xFF;
 
@@ -139,6 +183,72 @@ Net_WaitForEvent(enum _ENetEventType type, enet_uint32 duration)
 	return false;
 }
 
+static void *
+Net_GetRangeCoder(void)
+{
+	if (s_range_coder == NULL)
+		s_range_coder = enet_range_coder_create();
+
+	return s_range_coder;
+}
+
+/**
+ * @brief   Creates a broadcast packet for peers that accept compression.
+ * @return  NULL if compression did not make the packet any smaller.
+ */
+static ENetPacket *
+Server_CreateCompressedPacket(const unsigned char *buf, size_t len)
+{
+	void *context = Net_GetRangeCoder();
+	if (context == NULL || len < 2)
+		return NULL;
+
+	ENetBuffer in;
+	in.data = (void *)buf;
+	in.dataLength = len;
+
+	const size_t compressed_len = enet_range_coder_compress(context,
+			&in, 1, len, s_compressed_buf + 1, len - 2);
+
+	if (compressed_len == 0)
+		return NULL;
+
+	s_compressed_buf[0] = NET_COMPRESSED_PACKET;
+	return enet_packet_create(s_compressed_buf, 1 + compressed_len,
+			ENET_PACKET_FLAG_RELIABLE);
+}
+
+/**
+ * @brief   Sends a broadcast to one peer.
+ * @details The raw and compressed packets are created on first use and
+ *          shared between the peers receiving the same broadcast.
+ */
+static void
+Server_SendBroadcast(const PeerData *data, const unsigned char *buf, size_t len,
+		ENetPacket **raw, ENetPacket **compressed, bool *tried_compression)
+{
+	ENetPeer *peer = data->peer;
+
+	if (data->compress) {
+		if (!(*tried_compression)) {
+			*compressed = Server_CreateCompressedPacket(buf, len);
+			*tried_compression = true;
+		}
+
+		if (*compressed != NULL) {
+			NetTelemetry_CountPacket((*compressed)->dataLength);
+			enet_peer_send(peer, 0, *compressed);
+			return;
+		}
+	}
+
+	if (*raw == NULL)
+		*raw = enet_packet_create(buf, len, ENET_PACKET_FLAG_RELIABLE);
+
+	NetTelemetry_CountPacket(len);
+	enet_peer_send(peer, 0, *raw);
+}
+
 bool
 Server_Send_StartGame(void)
 {
@@ -179,6 +289,14 @@ Net_CreateServer(const char *addr, int port, const char *name)
 		g_client_houses = 0;
 		memset(g_peer_data, 0, sizeof(g_peer_data));
 		Multiplayer_Init();
+		NetTelemetry_Reset();
+
+		/* A dedicated server has no local player. */
+		if (name == NULL) {
+			g_host_type = HOSTTYPE_DEDICATED_SERVER;
+			g_local_client_id = 0;
+			return true;
+		}
 
 		g_host_type = HOSTTYPE_CLIENT_SERVER;
 		PeerData *data = Server_NewClient();
@@ -206,7 +324,11 @@ Net_ConnectToServer(const char *hostname, int port, const char *name)
 		if (s_enet_host == NULL)
 			goto error_host_create;
 
-		s_enet_peer = enet_host_connect(s_enet_host, &address, 2, 0);
+		const enet_uint32 flags
+			= (g_net_compression && Net_GetRangeCoder() != NULL)
+			? NET_CONNECT_FLAG_COMPRESSION : 0;
+
+		s_enet_peer = enet_host_connect(s_enet_host, &address, 2, flags);
 		if (s_enet_peer == NULL)
 			goto error_host_connect;
 
@@ -218,6 +340,7 @@ Net_ConnectToServer(const char *hostname, int port, const char *name)
 
 		memset(g_peer_data, 0, sizeof(g_peer_data));
 		Multiplayer_Init();
+		NetTelemetry_Reset();
 
 		enhancement_smooth_unit_animation = SMOOTH_UNIT_ANIMATION_DISABLE;
 
@@ -449,6 +572,81 @@ Server_Recv_Chat(int peerID, enum HouseFlag houses, const char *buf)
 	}
 }
 
+/* Estimates how many bytes per second the client's link carries: ENet
+ * keeps at most a window of reliable data in flight per round trip,
+ * scaled down by its packet throttle when the link is congested.
+ */
+static double
+Server_EstimateBandwidth(const ENetPeer *peer)
+{
+	const enet_uint32 rtt = (peer->roundTripTime > 0) ? peer->roundTripTime : 1;
+
+	return (double)peer->windowSize * 1000.0 / rtt
+		* peer->packetThrottle / ENET_PEER_PACKET_THROTTLE_SCALE;
+}
+
+/* Returns true if a world update is due this call, and the number of
+ * bytes it may use in budget.
+ */
+static bool
+Server_ScheduleWorldUpdate(size_t *budget)
+{
+	*budget = MAX_SERVER_BROADCAST_MESSAGE_LEN;
+
+	if (!g_inGame)
+		return true;
+
+	if (s_lastWorldUpdate > g_game->timerGame)
+		s_lastWorldUpdate = g_game->timerGame - NET_UPDATE_INTERVAL_MAX;
+
+	int interval = 1;
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		const PeerData *data = &g_peer_data[i];
+
+		if (data->peer != NULL && data->state == CLIENTSTATE_IN_GAME)
+			interval = max(interval, data->update_interval);
+	}
+
+	if (g_game->timerGame - s_lastWorldUpdate < interval)
+		return false;
+
+	s_lastWorldUpdate = g_game->timerGame;
+
+	double bandwidth = -1.0;
+	interval = 1;
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		PeerData *data = &g_peer_data[i];
+		ENetPeer *peer = data->peer;
+
+		if (peer == NULL || data->state != CLIENTSTATE_IN_GAME)
+			continue;
+
+		const size_t queue = enet_list_size(&peer->outgoingReliableCommands);
+
+		if (queue >= NET_UPDATE_QUEUE_HIGH) {
+			data->update_interval = min(2 * data->update_interval, NET_UPDATE_INTERVAL_MAX);
+		} else if (queue <= NET_UPDATE_QUEUE_LOW) {
+			data->update_interval = max(data->update_interval - 1, 1);
+		}
+
+		const double estimate = Server_EstimateBandwidth(peer);
+		if (bandwidth < 0.0 || estimate < bandwidth)
+			bandwidth = estimate;
+
+		interval = max(interval, data->update_interval);
+	}
+
+	if (bandwidth >= 0.0) {
+		const double bytes = bandwidth * interval / NET_TICKS_PER_SECOND;
+
+		*budget = clamp((size_t)NET_UPDATE_BUDGET_MIN, (size_t)bytes,
+				(size_t)MAX_SERVER_BROADCAST_MESSAGE_LEN);
+	}
+
+	return true;
+}
+
 void
 Server_SendMessages(void)
 {
@@ -456,13 +654,17 @@ Server_SendMessages(void)
 	 && g_host_type != HOSTTYPE_CLIENT_SERVER)
 		return;
 
+	const double start_time = Timer_GetTime();
 	unsigned char *buf = g_server_broadcast_message_buf;
 
-	Server_Send_ClientList(&buf);
-	Server_Send_Scenario(&buf);
+	SEND_COUNTED(SCMSG_CLIENT_LIST, Server_Send_ClientList(&buf));
+	SEND_COUNTED(SCMSG_SCENARIO, Server_Send_Scenario(&buf));
 
 	if (buf - g_server_broadcast_message_buf > 0) {
 		const size_t len = buf - g_server_broadcast_message_buf;
+		ENetPacket *raw = NULL;
+		ENetPacket *compressed = NULL;
+		bool tried_compression = false;
 
 		for (int i = 0; i < MAX_CLIENTS; i++) {
 			const PeerData *data = &g_peer_data[i];
@@ -474,19 +676,23 @@ Server_SendMessages(void)
 			NET_LOG("packet size=%d, num outgoing packets=%lu",
 					len, enet_list_size(&peer->outgoingReliableCommands));
 
-			ENetPacket *packet
-				= enet_packet_create(g_server_broadcast_message_buf, len,
-						ENET_PACKET_FLAG_RELIABLE);
-
-			enet_peer_send(peer, 0, packet);
+			Server_SendBroadcast(data, g_server_broadcast_message_buf, len,
+					&raw, &compressed, &tried_compression);
 		}
 	}
 
-	Server_Send_UpdateCHOAM(&buf);
-	Server_Send_UpdateLandscape(&buf);
-	Server_Send_UpdateStructures(&buf);
-	Server_Send_UpdateUnits(&buf);
-	Server_Send_UpdateExplosions(&buf);
+	size_t budget;
+	if (Server_ScheduleWorldUpdate(&budget)) {
+		Server_SetUpdateBudget(buf + budget);
+
+		SEND_COUNTED(SCMSG_UPDATE_CHOAM, Server_Send_UpdateCHOAM(&buf));
+		SEND_COUNTED(SCMSG_UPDATE_LANDSCAPE, Server_Send_UpdateLandscape(&buf));
+		SEND_COUNTED(SCMSG_UPDATE_STRUCTURES, Server_Send_UpdateStructures(&buf));
+		SEND_COUNTED(SCMSG_UPDATE_UNITS, Server_Send_UpdateUnits(&buf));
+		SEND_COUNTED(SCMSG_UPDATE_EXPLOSIONS, Server_Send_UpdateExplosions(&buf));
+
+		Server_SetUpdateBudget(NULL);
+	}
 
 	unsigned char * const buf_start_client_specific = buf;
 
@@ -496,8 +702,8 @@ Server_SendMessages(void)
 
 		buf = buf_start_client_specific;
 
-		Server_Send_UpdateHouse(houseID, &buf);
-		Server_Send_UpdateFogOfWar(houseID, &buf);
+		SEND_COUNTED(SCMSG_UPDATE_HOUSE, Server_Send_UpdateHouse(houseID, &buf));
+		SEND_COUNTED(SCMSG_UPDATE_FOG_OF_WAR, Server_Send_UpdateFogOfWar(houseID, &buf));
 
 		if ((g_server2client_message_len[houseID] > 0)
 				&& (buf + g_server2client_message_len[houseID]
@@ -512,9 +718,9 @@ Server_SendMessages(void)
 		if (len <= 0)
 			continue;
 
-		ENetPacket *packet
-			= enet_packet_create(g_server_broadcast_message_buf, len,
-					ENET_PACKET_FLAG_RELIABLE);
+		ENetPacket *raw = NULL;
+		ENetPacket *compressed = NULL;
+		bool tried_compression = false;
 
 		for (int i = 0; i < MAX_CLIENTS; i++) {
 			const PeerData *data = &g_peer_data[i];
@@ -526,9 +732,23 @@ Server_SendMessages(void)
 			NET_LOG("packet size=%d, num outgoing packets=%lu",
 					len, enet_list_size(&peer->outgoingReliableCommands));
 
-			enet_peer_send(peer, 0, packet);
+			Server_SendBroadcast(data, g_server_broadcast_message_buf, len,
+					&raw, &compressed, &tried_compression);
 		}
 	}
+
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		ENetPeer *peer = g_peer_data[i].peer;
+
+		if (peer != NULL) {
+			NetTelemetry_SamplePeer(peer->roundTripTime,
+					enet_list_size(&peer->outgoingReliableCommands));
+		}
+	}
+
+	const double end_time = Timer_GetTime();
+	NetTelemetry_RecordSendLoop(end_time - start_time);
+	NetTelemetry_Update(end_time);
 }
 
 static void
@@ -559,6 +779,7 @@ Server_Recv_ConnectClient(ENetEvent *event)
 	if (data != NULL) {
 		event->peer->data = data;
 		data->peer = event->peer;
+		data->compress = (event->data & NET_CONNECT_FLAG_COMPRESSION) != 0;
 
 		Server_Send_ClientID(event->peer);
 		lobby_map_generator_mode = MAP_GENERATOR_TRY_TEST_ELSE_RAND;
@@ -577,8 +798,19 @@ Server_DisconnectClient(PeerData *data)
 
 	snprintf(chat_log, sizeof(chat_log), "%s left", data->name);
 
-	if (data->state == CLIENTSTATE_IN_GAME)
-		Server_Recv_ReturnToLobby(Net_GetClientHouse(data->id), false);
+	if (data->state == CLIENTSTATE_IN_GAME) {
+		const enum HouseType houseID = Net_GetClientHouse(data->id);
+		unsigned char msg[1];
+		unsigned char *end = msg;
+
+		/* Replays see the drop as the client returning to the lobby,
+		 * so the house is handed to the AI on the same tick.
+		 */
+		Net_Encode_ClientServerMsg(&end, CSMSG_RETURN_TO_LOBBY);
+		Replay_RecordMessage(houseID, CSMSG_RETURN_TO_LOBBY, msg, end - msg);
+
+		Server_Recv_ReturnToLobby(houseID, false);
+	}
 
 	Server_Recv_PrefHouse(data->id, HOUSE_INVALID);
 	enet_peer_disconnect(data->peer, 0);
@@ -607,6 +839,35 @@ Server_Recv_DisconnectClient(ENetEvent *event)
 	}
 }
 
+static void
+Server_Recv_Event(ENetEvent *event)
+{
+	switch (event->type) {
+		case ENET_EVENT_TYPE_RECEIVE:
+			{
+				ENetPacket *packet = event->packet;
+				const PeerData *data = event->peer->data;
+				const enum HouseType houseID = Net_GetClientHouse(data->id);
+				Server_ProcessMessage(data->id, houseID,
+						packet->data, packet->dataLength);
+				enet_packet_destroy(packet);
+			}
+			break;
+
+		case ENET_EVENT_TYPE_CONNECT:
+			Server_Recv_ConnectClient(event);
+			break;
+
+		case ENET_EVENT_TYPE_DISCONNECT:
+			Server_Recv_DisconnectClient(event);
+			break;
+
+		case ENET_EVENT_TYPE_NONE:
+		default:
+			break;
+	}
+}
+
 void
 Server_RecvMessages(void)
 {
@@ -625,32 +886,23 @@ Server_RecvMessages(void)
 	}
 
 	ENetEvent event;
-	while (enet_host_service(s_enet_host, &event, 0) > 0) {
-		switch (event.type) {
-			case ENET_EVENT_TYPE_RECEIVE:
-				{
-					ENetPacket *packet = event.packet;
-					const PeerData *data = event.peer->data;
-					const enum HouseType houseID = Net_GetClientHouse(data->id);
-					Server_ProcessMessage(data->id, houseID,
-							packet->data, packet->dataLength);
-					enet_packet_destroy(packet);
-				}
-				break;
-
-			case ENET_EVENT_TYPE_CONNECT:
-				Server_Recv_ConnectClient(&event);
-				break;
+	while (enet_host_service(s_enet_host, &event, 0) > 0)
+		Server_Recv_Event(&event);
+}
 
-			case ENET_EVENT_TYPE_DISCONNECT:
-				Server_Recv_DisconnectClient(&event);
-				break;
+/* Blocks for up to timeout milliseconds until a client sends
+ * something, then handles it.  The dedicated server idles here
+ * instead of polling.
+ */
+void
+Server_WaitForMessages(int timeout)
+{
+	if (g_host_type != HOSTTYPE_DEDICATED_SERVER)
+		return;
 
-			case ENET_EVENT_TYPE_NONE:
-			default:
-				break;
-		}
-	}
+	ENetEvent event;
+	if (enet_host_service(s_enet_host, &event, timeout) > 0)
+		Server_Recv_Event(&event);
 }
 
 void
@@ -694,7 +946,20 @@ Client_RecvMessages(void)
 			case ENET_EVENT_TYPE_RECEIVE:
 				{
 					ENetPacket *packet = event.packet;
-					ret = Client_ProcessMessage(packet->data, packet->dataLength);
+
+					NetTelemetry_CountPacket(packet->dataLength);
+
+					if (packet->dataLength > 0 && packet->data[0] == NET_COMPRESSED_PACKET) {
+						const size_t len = enet_range_coder_decompress(Net_GetRangeCoder(),
+								packet->data + 1, packet->dataLength - 1,
+								s_compressed_buf, sizeof(s_compressed_buf));
+
+						if (len > 0)
+							ret = Client_ProcessMessage(s_compressed_buf, len);
+					} else {
+						ret = Client_ProcessMessage(packet->data, packet->dataLength);
+					}
+
 					enet_packet_destroy(packet);
 				}
 				break;
@@ -710,5 +975,9 @@ Client_RecvMessages(void)
 		}
 	}
 
+	NetTelemetry_SamplePeer(s_enet_peer->roundTripTime,
+			enet_list_size(&s_enet_peer->outgoingReliableCommands));
+	NetTelemetry_Update(Timer_GetTime());
+
 	return ret;
 }
@@ -14,22 +14,25 @@
 
 #include "message.h"
 #include "net.h"
+#include "telemetry.h"
+#include "tiledelta.h"
 #include "../audio/audio.h"
 #include "../enhancement.h"
 #include "../explosion.h"
 #include "../newui/actionpanel.h"
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../map.h"
 #include "../mods/multiplayer.h"
 #include "../newui/chatbox.h"
 #include "../newui/menu.h"
 #include "../newui/menubar.h"
-#include "../newui/viewport.h"
 #include "../opendune.h"
 #include "../pool/pool_house.h"
 #include "../pool/pool_structure.h"
 #include "../pool/pool_unit.h"
+#include "../replay.h"
 #include "../shape.h"
 #include "../string.h"
 #include "../structure.h"
@@ -46,6 +49,11 @@
 #define SERVER_LOG(...)
 #endif
 
+/* Tiles compared against the client's copy per landscape update, on top
+ * of those marked dirty.  The whole map is covered every 64 updates.
+ */
+#define SERVER_LANDSCAPE_SWEEP  (MAP_SIZE_MAX * MAP_SIZE_MAX / 64)
+
 typedef struct StructureDelta {
 	uint8       type;
 	uint8       linkedID;
@@ -82,13 +90,22 @@ typedef struct UnitDelta {
 	uint8   wobbleIndex;
 	uint8   spriteOffset;
 	uint8   blinkHouse;
+	uint8   speed;
 } UnitDelta;
 
-static Tile s_mapCopy[MAP_SIZE_MAX * MAP_SIZE_MAX];
-static int64_t s_choamLastUpdate;
-static StructureDelta s_structureCopy[STRUCTURE_INDEX_MAX_HARD + STRUCTURE_INDEX_RAISED_AMOUNT];
-static UnitDelta s_unitCopy[UNIT_INDEX_MAX_RAISED];
-static int s_explosionLastCount;
+static THREAD_LOCAL Tile s_mapCopy[MAP_SIZE_MAX * MAP_SIZE_MAX];
+static THREAD_LOCAL uint64_t s_mapPending[TILEDELTA_NUM_BLOCKS];
+static THREAD_LOCAL uint16 s_mapSweep;
+static THREAD_LOCAL int64_t s_choamLastUpdate;
+static THREAD_LOCAL StructureDelta s_structureCopy[STRUCTURE_INDEX_MAX_HARD + STRUCTURE_INDEX_RAISED_AMOUNT];
+static THREAD_LOCAL UnitDelta s_unitCopy[UNIT_INDEX_MAX_RAISED];
+static THREAD_LOCAL int s_explosionLastCount;
+static THREAD_LOCAL int s_unitNext;
+
+/* Where the world update being encoded must stop, if sooner than the
+ * end of the broadcast buffer.
+ */
+static THREAD_LOCAL const unsigned char *s_updateEnd;
 
 static void Server_ReturnToLobbyNow(bool win);
 
@@ -121,12 +138,26 @@ Server_DepleteStarport(enum UnitType unitType)
 
 /*--------------------------------------------------------------*/
 
-static bool
-Server_CanEncodeFixedWidthBuffer(unsigned char **buf, size_t len)
+void
+Server_SetUpdateBudget(const unsigned char *end)
+{
+	s_updateEnd = end;
+}
+
+static const unsigned char *
+Server_GetEncodeEnd(void)
 {
 	const unsigned char * const end
 		= g_server_broadcast_message_buf + MAX_SERVER_BROADCAST_MESSAGE_LEN;
 
+	return (s_updateEnd != NULL && s_updateEnd < end) ? s_updateEnd : end;
+}
+
+static bool
+Server_CanEncodeFixedWidthBuffer(unsigned char **buf, size_t len)
+{
+	const unsigned char * const end = Server_GetEncodeEnd();
+
 	return (*buf + len <= end);
 }
 
@@ -134,8 +165,7 @@ static int
 Server_MaxElementsToEncode(unsigned char **buf,
 		size_t header_len, size_t element_len)
 {
-	const unsigned char * const end
-		= g_server_broadcast_message_buf + MAX_SERVER_BROADCAST_MESSAGE_LEN;
+	const unsigned char * const end = Server_GetEncodeEnd();
 
 	if (*buf + header_len + element_len <= end) {
 		return (end - *buf - header_len) / element_len;
@@ -195,6 +225,7 @@ Server_InitUnitDelta(const Unit *u, UnitDelta *d)
 	d->wobbleIndex          = u->wobbleIndex;
 	d->spriteOffset         = u->spriteOffset;
 	d->blinkHouse		   	= u->blinkHouse;
+	d->speed                = u->speed;
 }
 
 void
@@ -208,52 +239,102 @@ Server_ResetCache(void)
 	}
 
 	memset(s_mapCopy, 0, sizeof(s_mapCopy));
+	memset(s_mapPending, 0, sizeof(s_mapPending));
+	s_mapSweep = 0;
+	Map_MarkAllDirty();
 	memset(s_structureCopy, 0, sizeof(s_structureCopy));
 	memset(s_unitCopy, 0, sizeof(s_unitCopy));
 	s_choamLastUpdate = 0;
 	s_explosionLastCount = 0;
+	s_unitNext = 0;
 }
 
 /*--------------------------------------------------------------*/
 
+static uint32
+Server_GetLandscapeValue(uint16 packed)
+{
+	uint32 value;
+
+	memcpy(&value, &s_mapCopy[packed], sizeof(value));
+	return value;
+}
+
+/**
+ * @brief   Queues the tile for sending if it differs from the client's
+ *          copy.
+ */
+static void
+Server_Compare_LandscapeTile(uint16 packed)
+{
+	if (packed < 65 || packed >= MAP_SIZE_MAX * MAP_SIZE_MAX - 65)
+		return;
+
+	Tile d = g_game->map[packed];
+	d.hasAnimation = 0;
+	d.hasExplosion = 0;
+
+	if (memcmp(&s_mapCopy[packed], &d, sizeof(Tile)) == 0)
+		return;
+
+	s_mapCopy[packed] = d;
+	s_mapPending[TileDelta_GetBlock(packed)] |= (uint64_t)1 << TileDelta_GetBit(packed);
+}
+
 void
 Server_Send_UpdateLandscape(unsigned char **buf)
 {
-	const size_t header_len  = 1 + 2;
-	const size_t element_len = 2 + sizeof(Tile);
-	const int max = Server_MaxElementsToEncode(buf, header_len, element_len);
+	const unsigned char * const end = Server_GetEncodeEnd();
 
-	if (max <= 0)
+	if (!Server_CanEncodeFixedWidthBuffer(buf, 1 + 1))
 		return;
 
 	Net_Encode_ServerClientMsg(buf, SCMSG_UPDATE_LANDSCAPE);
 
-	unsigned char *buf_count = *buf; (*buf) += 2;
-	uint16 count = 0;
+	unsigned char *buf_count = *buf; (*buf) += 1;
+	uint8 count = 0;
+
+	for (uint16 packed = Map_NextDirty(0);
+			packed < MAP_SIZE_MAX * MAP_SIZE_MAX;
+			packed = Map_NextDirty(packed + 1)) {
+		Map_ClearDirty(packed);
+		Server_Compare_LandscapeTile(packed);
+	}
 
-	for (uint16 packed = 65;
-			packed < MAP_SIZE_MAX * MAP_SIZE_MAX - 65 && count < max;
-			packed++) {
-		Tile d = g_map[packed];
-		d.hasAnimation = 0;
-		d.hasExplosion = 0;
+	/* Also compare a slice of the map, in case a tile was changed
+	 * without being marked.
+	 */
+	for (int i = 0; i < SERVER_LANDSCAPE_SWEEP; i++) {
+		Server_Compare_LandscapeTile(s_mapSweep);
+		s_mapSweep = (s_mapSweep + 1) % (MAP_SIZE_MAX * MAP_SIZE_MAX);
+	}
 
-		if (memcmp(&s_mapCopy[packed], &d, sizeof(Tile)) == 0)
+	/* Blocks left over when the message fills up stay pending for
+	 * the next update.
+	 */
+	for (int block = 0; block < TILEDELTA_NUM_BLOCKS; block++) {
+		if (s_mapPending[block] == 0)
 			continue;
 
-		s_mapCopy[packed] = d;
+		uint32 value[TILEDELTA_BLOCK_TILES];
+		for (int bit = 0; bit < TILEDELTA_BLOCK_TILES; bit++) {
+			value[bit] = Server_GetLandscapeValue(TileDelta_GetPacked(block, bit));
+		}
 
-		Net_Encode_uint16(buf, packed);
-		memcpy(*buf, &d, sizeof(Tile));
-		(*buf) += sizeof(Tile);
+		const size_t len = TileDelta_EncodeBlock(*buf, end - *buf,
+				block, s_mapPending[block], value, sizeof(Tile));
+		if (len == 0)
+			break;
 
+		(*buf) += len;
+		s_mapPending[block] = 0;
 		count++;
 	}
 
-	SERVER_LOG("tiles changed=%d, %lu bytes",
+	SERVER_LOG("blocks changed=%d, %lu bytes",
 			count, *buf - buf_count + 1);
 
-	Net_Encode_uint16(&buf_count, count);
+	Net_Encode_uint8(&buf_count, count);
 }
 
 void
@@ -262,45 +343,61 @@ Server_Send_UpdateFogOfWar(enum HouseType houseID, unsigned char **buf)
 	if (!enhancement_fog_of_war)
 		return;
 
-	const size_t header_len  = 1 + 2;
-	const size_t element_len = 2;
-	const int max = Server_MaxElementsToEncode(buf, header_len, element_len);
+	const unsigned char * const end = Server_GetEncodeEnd();
 
-	if (max <= 0)
+	if (!Server_CanEncodeFixedWidthBuffer(buf, 1 + 1))
 		return;
 
 	Net_Encode_ServerClientMsg(buf, SCMSG_UPDATE_FOG_OF_WAR);
 
-	unsigned char *buf_count = *buf; (*buf) += 2;
-	uint16 count = 0;
+	unsigned char *buf_count = *buf; (*buf) += 1;
+	uint8 count = 0;
 
-	for (uint16 packed = 65;
-			packed < MAP_SIZE_MAX * MAP_SIZE_MAX - 65 && count < max;
-			packed++) {
-		FogOfWarTile *f = &g_mapVisible[packed];
+	for (int block = 0; block < TILEDELTA_NUM_BLOCKS; block++) {
+		uint32 value[TILEDELTA_BLOCK_TILES];
+		uint64_t unveiled = 0;
+		uint64_t seen = 0;
 
-		if (f->cause[houseID] == UNVEILCAUSE_UNCHANGED)
-			continue;
+		for (int bit = 0; bit < TILEDELTA_BLOCK_TILES; bit++) {
+			const uint16 packed = TileDelta_GetPacked(block, bit);
 
-		if (f->cause[houseID] < UNVEILCAUSE_STRUCTURE_VISION) {
-			uint16 encoded = packed;
+			if (packed < 65 || packed >= MAP_SIZE_MAX * MAP_SIZE_MAX - 65)
+				continue;
+
+			const FogOfWarTile *f = &g_game->mapVisible[packed];
+
+			if (f->cause[houseID] == UNVEILCAUSE_UNCHANGED)
+				continue;
 
-			/* Short unveil. */
-			if (f->cause[houseID] == UNVEILCAUSE_EXPLOSION)
-				encoded |= 0x8000;
+			seen |= (uint64_t)1 << bit;
 
-			Net_Encode_uint16(buf, encoded);
+			if (f->cause[houseID] < UNVEILCAUSE_STRUCTURE_VISION) {
+				/* 1 for a short unveil. */
+				value[bit] = (f->cause[houseID] == UNVEILCAUSE_EXPLOSION) ? 1 : 0;
+				unveiled |= (uint64_t)1 << bit;
+			}
+		}
+
+		if (unveiled != 0) {
+			const size_t len = TileDelta_EncodeBlock(*buf, end - *buf,
+					block, unveiled, value, 1);
+			if (len == 0)
+				break;
 
+			(*buf) += len;
 			count++;
 		}
 
-		f->cause[houseID] = UNVEILCAUSE_UNCHANGED;
+		for (int bit = 0; bit < TILEDELTA_BLOCK_TILES; bit++) {
+			if (seen & ((uint64_t)1 << bit))
+				g_game->mapVisible[TileDelta_GetPacked(block, bit)].cause[houseID] = UNVEILCAUSE_UNCHANGED;
+		}
 	}
 
-	SERVER_LOG("unveiled tiles=%d, %lu bytes",
+	SERVER_LOG("unveiled blocks=%d, %lu bytes",
 			count, *buf - buf_count + 1);
 
-	Net_Encode_uint16(&buf_count, count);
+	Net_Encode_uint8(&buf_count, count);
 }
 
 void
@@ -335,7 +432,7 @@ Server_Send_UpdateHouse(enum HouseType houseID, unsigned char **buf)
 void
 Server_Send_UpdateCHOAM(unsigned char **buf)
 {
-	if (s_choamLastUpdate == g_tickHouseStarportRecalculatePrices)
+	if (s_choamLastUpdate == g_game->tickHouseStarportRecalculatePrices)
 		return;
 
 	const size_t len = 1 + 2 + (UNIT_MCV - UNIT_CARRYALL + 1) * 1;
@@ -351,7 +448,7 @@ Server_Send_UpdateCHOAM(unsigned char **buf)
 		Net_Encode_uint8(buf, g_starportAvailable[u]);
 	}
 
-	s_choamLastUpdate = g_tickHouseStarportRecalculatePrices;
+	s_choamLastUpdate = g_game->tickHouseStarportRecalculatePrices;
 }
 
 void
@@ -415,11 +512,47 @@ Server_Send_UpdateStructures(unsigned char **buf)
 	Net_Encode_uint8(&buf_count, count);
 }
 
+static bool
+Server_IsUrgentUnitDelta(const UnitDelta *prev, const UnitDelta *d)
+{
+	return (prev->type != d->type)
+		|| (prev->flags.all != d->flags.all)
+		|| (prev->houseID != d->houseID)
+		|| (prev->hitpoints != d->hitpoints);
+}
+
+static void
+Server_EncodeUnitDelta(unsigned char **buf, const Unit *u, const UnitDelta *d)
+{
+	Net_Encode_ObjectIndex(buf, &u->o);
+
+	/* 12 bytes. */
+	Net_Encode_uint8 (buf, d->type);
+	Net_Encode_uint32(buf, d->flags.all);
+	Net_Encode_uint8 (buf, d->houseID);
+	Net_Encode_uint16(buf, d->position.x);
+	Net_Encode_uint16(buf, d->position.y);
+	Net_Encode_uint16(buf, d->hitpoints);
+
+	/* 11 bytes. */
+	Net_Encode_uint8 (buf, d->actionID);
+	Net_Encode_uint8 (buf, d->nextActionID);
+	Net_Encode_uint8 (buf, d->amount);
+	Net_Encode_uint8 (buf, d->deviated);
+	Net_Encode_uint8 (buf, d->deviatedHouse);
+	Net_Encode_uint8 (buf, d->orientation0_current);
+	Net_Encode_uint8 (buf, d->orientation1_current);
+	Net_Encode_uint8 (buf, d->wobbleIndex);
+	Net_Encode_uint8 (buf, d->spriteOffset);
+	Net_Encode_uint8 (buf, d->blinkHouse);
+	Net_Encode_uint8 (buf, d->speed);
+}
+
 void
 Server_Send_UpdateUnits(unsigned char **buf)
 {
-	const size_t header_len  = 1 + 1;
-	const size_t element_len = 2 + 12 + 10;
+	const size_t header_len  = 1 + 4 + 1;
+	const size_t element_len = 2 + 12 + 11;
 	const int max = Server_MaxElementsToEncode(buf, header_len, element_len);
 
 	if (max <= 0)
@@ -427,44 +560,38 @@ Server_Send_UpdateUnits(unsigned char **buf)
 
 	Net_Encode_ServerClientMsg(buf, SCMSG_UPDATE_UNITS);
 
+	/* Tick stamp, for client-side smoothing. */
+	Net_Encode_uint32(buf, (uint32)g_game->timerGame);
+
 	unsigned char *buf_count = *buf; (*buf) += 1;
 	uint8 count = 0;
 
-	for (int i = 0;
-			i < UnitPool_GetMaxIndex() && count < max;
-			i++) {
-		const Unit *u = Unit_Get_ByIndex(i);
-		UnitDelta d;
-
-		Server_InitUnitDelta(u, &d);
-		if (memcmp(&s_unitCopy[i], &d, sizeof(UnitDelta)) == 0)
-			continue;
+	/* Units that were created, killed, hit, or changed hands go first,
+	 * so a tight budget is not spent on movement while combat waits.
+	 * The rest go round-robin from where the last update stopped.
+	 */
+	const int total = UnitPool_GetMaxIndex();
 
-		memcpy(&s_unitCopy[i], &d, sizeof(UnitDelta));
+	for (int pass = 0; pass < 2; pass++) {
+		for (int j = 0; j < total && count < max; j++) {
+			const int i = (pass == 0) ? j : (s_unitNext + j) % total;
+			const Unit *u = Unit_Get_ByIndex(i);
+			UnitDelta d;
 
-		Net_Encode_ObjectIndex(buf, &u->o);
+			Server_InitUnitDelta(u, &d);
+			if (memcmp(&s_unitCopy[i], &d, sizeof(UnitDelta)) == 0)
+				continue;
 
-		/* 12 bytes. */
-		Net_Encode_uint8 (buf, d.type);
-		Net_Encode_uint32(buf, d.flags.all);
-		Net_Encode_uint8 (buf, d.houseID);
-		Net_Encode_uint16(buf, d.position.x);
-		Net_Encode_uint16(buf, d.position.y);
-		Net_Encode_uint16(buf, d.hitpoints);
+			if (pass == 0 && !Server_IsUrgentUnitDelta(&s_unitCopy[i], &d))
+				continue;
 
-		/* 10 bytes. */
-		Net_Encode_uint8 (buf, d.actionID);
-		Net_Encode_uint8 (buf, d.nextActionID);
-		Net_Encode_uint8 (buf, d.amount);
-		Net_Encode_uint8 (buf, d.deviated);
-		Net_Encode_uint8 (buf, d.deviatedHouse);
-		Net_Encode_uint8 (buf, d.orientation0_current);
-		Net_Encode_uint8 (buf, d.orientation1_current);
-		Net_Encode_uint8 (buf, d.wobbleIndex);
-		Net_Encode_uint8 (buf, d.spriteOffset);
-		Net_Encode_uint8 (buf, d.blinkHouse);
+			memcpy(&s_unitCopy[i], &d, sizeof(UnitDelta));
+			Server_EncodeUnitDelta(buf, u, &d);
+			count++;
 
-		count++;
+			if (pass == 1)
+				s_unitNext = (i + 1) % total;
+		}
 	}
 
 	SERVER_LOG("units changed=%d, %lu bytes",
@@ -513,6 +640,7 @@ Server_BufferGameEvent(enum HouseFlag houses, int len, const unsigned char *src)
 				src, len);
 
 		g_server2client_message_len[houseID] += len;
+		NetTelemetry_CountServerClientMsg(Net_Decode_ServerClientMsg(src[0]), len);
 	}
 }
 
@@ -833,7 +961,10 @@ void
 Server_Recv_ReturnToLobby(enum HouseType houseID, bool log_message)
 {
 	PeerData *data = Net_GetPeerData(g_multiplayer.client[houseID]);
-	data->state = CLIENTSTATE_IN_LOBBY;
+
+	/* Replays have no peers. */
+	if (data != NULL)
+		data->state = CLIENTSTATE_IN_LOBBY;
 
 	if (g_multiplayer.state[houseID] == MP_HOUSE_PLAYING) {
 		g_multiplayer.state[houseID] = MP_HOUSE_LOST;
@@ -1151,6 +1282,60 @@ Server_Recv_EnterLeavePlacementMode(enum HouseType houseID, const unsigned char
 	}
 }
 
+static void
+Server_PlaceStructure(House *h, Structure *s, uint16 packed)
+{
+	const StructureInfo *si = &g_table_structureInfo[s->o.type];
+	const enum HouseType houseID = h->index;
+
+	if (Structure_Place(s, packed, houseID)) {
+		h->structureActiveID = STRUCTURE_INDEX_INVALID;
+
+		Server_Send_PlaySound(1 << houseID, SOUND_PLACEMENT);
+
+		if (s->o.type == STRUCTURE_PALACE)
+			h->palacePosition = s->o.position;
+
+		if (g_validateStrictIfZero == 0 && s->o.type == STRUCTURE_REFINERY) {
+			Unit *u;
+
+			g_validateStrictIfZero++;
+			u = Unit_CreateWrapper(houseID, UNIT_HARVESTER, Tools_Index_Encode(s->o.index, IT_STRUCTURE));
+			g_validateStrictIfZero--;
+
+			if (u == NULL) {
+				h->harvestersIncoming++;
+			} else {
+				u->originEncoded = Tools_Index_Encode(s->o.index, IT_STRUCTURE);
+			}
+		}
+
+		Structure_Server_BuildObject(s, 0xFFFE);
+
+		if ((h->powerProduction < h->powerUsage)
+				&& (h->structuresBuilt & FLAG_STRUCTURE_OUTPOST)) {
+			Server_Send_StatusMessage1(1 << houseID, 3,
+					STR_NOT_ENOUGH_POWER_FOR_RADAR_BUILD_WINDTRAPS);
+		}
+
+		GUI_DisplayHint(houseID, si->o.hintStringID, si->o.spriteID);
+	} else {
+		Server_Send_PlaySound(1 << houseID, EFFECT_ERROR_OCCURRED);
+
+		if (s->o.type == STRUCTURE_SLAB_1x1
+		 || s->o.type == STRUCTURE_SLAB_2x2) {
+			Server_Send_StatusMessage1(1 << houseID, 2,
+					STR_CAN_NOT_PLACE_FOUNDATION_HERE);
+		} else {
+			GUI_DisplayHint(houseID,
+					STR_HINT_STRUCTURES_MUST_BE_PLACED_ON_CLEAR_ROCK_OR_CONCRETE_AND_ADJACENT_TO_ANOTHER_FRIENDLY_STRUCTURE,
+					SHAPE_INVALID);
+			Server_Send_StatusMessage2(1 << houseID, 2,
+					STR_CAN_NOT_PLACE_S_HERE, si->o.stringID_abbrev);
+		}
+	}
+}
+
 static void
 Server_Recv_PlaceStructure(enum HouseType houseID, const unsigned char *buf)
 {
@@ -1165,7 +1350,7 @@ Server_Recv_PlaceStructure(enum HouseType houseID, const unsigned char *buf)
 		return;
 
 	Structure *s = Structure_Get_ByIndex(objectID);
-	Viewport_Server_Place(h, s, packed);
+	Server_PlaceStructure(h, s, packed);
 }
 
 static void
@@ -1472,6 +1657,11 @@ Server_ProcessMessage(int peerID, enum HouseType houseID,
 			break;
 		}
 
+		Replay_RecordMessage(houseID, msg, buf - 1, len + 1);
+
+		if (peerID != g_local_client_id)
+			NetTelemetry_CountClientServerMsg(msg, len + 1);
+
 		switch (msg) {
 			case CSMSG_DISCONNECT:
 				assert(false);
@@ -1549,6 +1739,7 @@ Server_Console_Help(const char *msg)
 		"Commands",
 		" /list",
 		" /kick <id | name>",
+		" /netstats [reset]",
 		" /credits <N>",
 		" /seed <N>",
 		" /spice <min> <max>",
@@ -1602,6 +1793,24 @@ Server_Console_List(const char *msg)
 	}
 }
 
+static void
+Server_Console_NetStats(const char *msg)
+{
+	char chat_log[MAX_CHAT_LEN + 1];
+
+	if (strcmp(msg, "reset") == 0) {
+		NetTelemetry_Reset();
+		return;
+	}
+
+	for (int line = 0; line < 8; line++) {
+		if (!NetTelemetry_GetLine(line, chat_log, sizeof(chat_log)))
+			break;
+
+		ChatBox_AddLog(CHATTYPE_CONSOLE, chat_log);
+	}
+}
+
 static void
 Server_Console_Credits(const char *msg)
 {
@@ -1670,6 +1879,7 @@ Server_ProcessCommand(const char *msg)
 		{ "/help",      Server_Console_Help },
 		{ "/list",      Server_Console_List },
 		{ "/kick",      Server_Console_Kick },
+		{ "/netstats",  Server_Console_NetStats },
 
 		/* Lobby only commands below this point. */
 		{ NULL,         NULL },
@@ -8,6 +8,7 @@
 extern void Server_RestockStarport(enum UnitType type);
 
 extern void Server_ResetCache(void);
+extern void Server_SetUpdateBudget(const unsigned char *end);
 
 extern void Server_Send_UpdateLandscape(unsigned char **buf);
 extern void Server_Send_UpdateFogOfWar(enum HouseType houseID, unsigned char **buf);
@@ -0,0 +1,284 @@
+/* telemetry.c
+ *
+ * Network telemetry.  Counts bytes and messages for each message type,
+ * samples the round trip time and the reliable send queue of each
+ * peer, and times the server's send loop.
+ *
+ * Server to client messages are counted as they are encoded on the
+ * server, and as they are decoded on a client.  Client to server
+ * messages are counted on the server only.  Packet bytes are what
+ * actually goes over the wire, after compression.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../os/common.h"
+#include "../os/math.h"
+
+#include "telemetry.h"
+
+#include "../file.h"
+
+#define NET_TELEMETRY_FILENAME  "netstats.csv"
+
+enum {
+	RTT_BUCKETS = 6,
+	QUEUE_BUCKETS = 7
+};
+
+typedef struct NetTelemetry {
+	bool started;
+	double start_time;
+	double last_time;
+	double last_dump;
+
+	unsigned int sc_bytes[SCMSG_MAX];
+	unsigned int sc_count[SCMSG_MAX];
+	unsigned int cs_bytes[CSMSG_MAX];
+	unsigned int cs_count[CSMSG_MAX];
+
+	unsigned int packet_bytes;
+	unsigned int packet_count;
+
+	/* RTT buckets: <25, <50, <100, <200, <400, >=400 ms. */
+	unsigned int rtt_hist[RTT_BUCKETS];
+	unsigned int rtt_total;
+	unsigned int rtt_max;
+
+	/* Queue buckets: 0, 1, 2-3, 4-7, 8-15, 16-31, >=32 commands. */
+	unsigned int queue_hist[QUEUE_BUCKETS];
+	unsigned int queue_total;
+	unsigned int queue_max;
+	unsigned int peer_samples;
+
+	double send_total;
+	double send_max;
+	unsigned int send_count;
+} NetTelemetry;
+
+static const char * const s_sc_name[SCMSG_MAX] = {
+	"disconnect", "landscape", "fog", "house", "choam", "structures",
+	"units", "explosions", "shake", "status", "sound", "sound_tile",
+	"voice", "battle_music", "win_lose", "identity", "client_list",
+	"scenario", "start_game", "chat",
+};
+
+static const char * const s_cs_name[CSMSG_MAX] = {
+	"disconnect", "return_to_lobby", "repair_upgrade", "rally_point",
+	"purchase_resume", "pause_cancel", "placement_mode", "place_structure",
+	"structure_ability", "deathhand", "unit_action", "pref_name",
+	"pref_house", "chat",
+};
+
+/* Seconds between dumps to netstats.csv, or 0 to disable. */
+int g_net_telemetry_interval = 0;
+
+static THREAD_LOCAL NetTelemetry s_telemetry;
+static THREAD_LOCAL bool s_csv_header_written;
+
+/*--------------------------------------------------------------*/
+
+void
+NetTelemetry_Reset(void)
+{
+	memset(&s_telemetry, 0, sizeof(s_telemetry));
+	s_csv_header_written = false;
+}
+
+void
+NetTelemetry_CountServerClientMsg(enum ServerClientMsg msg, int len)
+{
+	if (msg >= SCMSG_MAX || len <= 0)
+		return;
+
+	s_telemetry.sc_bytes[msg] += len;
+	s_telemetry.sc_count[msg]++;
+}
+
+void
+NetTelemetry_CountClientServerMsg(enum ClientServerMsg msg, int len)
+{
+	if (msg >= CSMSG_MAX || len <= 0)
+		return;
+
+	s_telemetry.cs_bytes[msg] += len;
+	s_telemetry.cs_count[msg]++;
+}
+
+void
+NetTelemetry_CountPacket(int len)
+{
+	s_telemetry.packet_bytes += len;
+	s_telemetry.packet_count++;
+}
+
+void
+NetTelemetry_SamplePeer(int rtt, int queue)
+{
+	int r = 0;
+	int q = 0;
+
+	while (r < RTT_BUCKETS - 1 && rtt >= (25 << r))
+		r++;
+
+	while (q < QUEUE_BUCKETS - 1 && queue >= (1 << q))
+		q++;
+
+	s_telemetry.rtt_hist[r]++;
+	s_telemetry.rtt_total += rtt;
+	s_telemetry.rtt_max = max(s_telemetry.rtt_max, (unsigned int)rtt);
+
+	s_telemetry.queue_hist[q]++;
+	s_telemetry.queue_total += queue;
+	s_telemetry.queue_max = max(s_telemetry.queue_max, (unsigned int)queue);
+
+	s_telemetry.peer_samples++;
+}
+
+void
+NetTelemetry_RecordSendLoop(double seconds)
+{
+	s_telemetry.send_total += seconds;
+	s_telemetry.send_max = max(s_telemetry.send_max, seconds);
+	s_telemetry.send_count++;
+}
+
+static void
+NetTelemetry_WriteCSV(double now)
+{
+	const NetTelemetry *t = &s_telemetry;
+	FILE *fp = File_Open_CaseInsensitive(SEARCHDIR_PERSONAL_DATA_DIR,
+			NET_TELEMETRY_FILENAME, s_csv_header_written ? "a" : "w");
+
+	if (fp == NULL)
+		return;
+
+	if (!s_csv_header_written) {
+		fprintf(fp, "time,packets,packet_bytes");
+
+		for (int i = 0; i < SCMSG_MAX; i++)
+			fprintf(fp, ",sc_%s_bytes,sc_%s_count", s_sc_name[i], s_sc_name[i]);
+
+		for (int i = 0; i < CSMSG_MAX; i++)
+			fprintf(fp, ",cs_%s_bytes,cs_%s_count", s_cs_name[i], s_cs_name[i]);
+
+		fprintf(fp, ",rtt_25,rtt_50,rtt_100,rtt_200,rtt_400,rtt_inf,rtt_max");
+		fprintf(fp, ",queue_0,queue_1,queue_2,queue_4,queue_8,queue_16,queue_32,queue_max");
+		fprintf(fp, ",send_ms_avg,send_ms_max\n");
+		s_csv_header_written = true;
+	}
+
+	fprintf(fp, "%.2f,%u,%u", now - t->start_time, t->packet_count, t->packet_bytes);
+
+	for (int i = 0; i < SCMSG_MAX; i++)
+		fprintf(fp, ",%u,%u", t->sc_bytes[i], t->sc_count[i]);
+
+	for (int i = 0; i < CSMSG_MAX; i++)
+		fprintf(fp, ",%u,%u", t->cs_bytes[i], t->cs_count[i]);
+
+	for (int i = 0; i < RTT_BUCKETS; i++)
+		fprintf(fp, ",%u", t->rtt_hist[i]);
+
+	fprintf(fp, ",%u", t->rtt_max);
+
+	for (int i = 0; i < QUEUE_BUCKETS; i++)
+		fprintf(fp, ",%u", t->queue_hist[i]);
+
+	fprintf(fp, ",%u,%.3f,%.3f\n", t->queue_max,
+			(t->send_count > 0) ? 1000.0 * t->send_total / t->send_count : 0.0,
+			1000.0 * t->send_max);
+
+	fclose(fp);
+}
+
+/**
+ * @brief   Advances the telemetry clock, and dumps the counters to
+ *          netstats.csv every g_net_telemetry_interval seconds.
+ */
+void
+NetTelemetry_Update(double now)
+{
+	if (!s_telemetry.started) {
+		s_telemetry.started = true;
+		s_telemetry.start_time = now;
+		s_telemetry.last_dump = now;
+	}
+
+	s_telemetry.last_time = now;
+
+	if (g_net_telemetry_interval > 0
+			&& now - s_telemetry.last_dump >= g_net_telemetry_interval) {
+		NetTelemetry_WriteCSV(now);
+		s_telemetry.last_dump = now;
+	}
+}
+
+/**
+ * @brief   Formats one line of the telemetry summary.
+ * @details The first lines are the totals; the rest are the server to
+ *          client message types, most bytes first.
+ * @return  false when there are no more lines.
+ */
+bool
+NetTelemetry_GetLine(int line, char *buf, size_t len)
+{
+	const NetTelemetry *t = &s_telemetry;
+	const double elapsed = max(1.0, t->last_time - t->start_time);
+
+	switch (line) {
+		case 0:
+			snprintf(buf, len, "Net: %.0f B/s, %.1f pkt/s",
+					t->packet_bytes / elapsed, t->packet_count / elapsed);
+			return true;
+
+		case 1:
+			snprintf(buf, len, "RTT: %u avg, %u max",
+					(t->peer_samples > 0) ? t->rtt_total / t->peer_samples : 0,
+					t->rtt_max);
+			return true;
+
+		case 2:
+			snprintf(buf, len, "Queue: %.1f avg, %u max",
+					(t->peer_samples > 0) ? (double)t->queue_total / t->peer_samples : 0.0,
+					t->queue_max);
+			return true;
+
+		case 3:
+			snprintf(buf, len, "Send: %.2f ms avg, %.2f ms max",
+					(t->send_count > 0) ? 1000.0 * t->send_total / t->send_count : 0.0,
+					1000.0 * t->send_max);
+			return true;
+
+		default:
+			break;
+	}
+
+	/* Selection by rank; there are only a handful of message types. */
+	int rank = line - 4;
+	bool used[SCMSG_MAX];
+	memset(used, 0, sizeof(used));
+
+	for (;;) {
+		int best = -1;
+
+		for (int i = 0; i < SCMSG_MAX; i++) {
+			if (used[i] || t->sc_count[i] == 0)
+				continue;
+
+			if (best < 0 || t->sc_bytes[i] > t->sc_bytes[best])
+				best = i;
+		}
+
+		if (best < 0)
+			return false;
+
+		if (rank-- == 0) {
+			snprintf(buf, len, "%s: %.0f B/s, %.1f msg/s",
+					s_sc_name[best],
+					t->sc_bytes[best] / elapsed, t->sc_count[best] / elapsed);
+			return true;
+		}
+
+		used[best] = true;
+	}
+}
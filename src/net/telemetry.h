@@ -0,0 +1,19 @@
+#ifndef NET_TELEMETRY_H
+#define NET_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "message.h"
+
+extern int g_net_telemetry_interval;
+
+extern void NetTelemetry_Reset(void);
+extern void NetTelemetry_CountServerClientMsg(enum ServerClientMsg msg, int len);
+extern void NetTelemetry_CountClientServerMsg(enum ClientServerMsg msg, int len);
+extern void NetTelemetry_CountPacket(int len);
+extern void NetTelemetry_SamplePeer(int rtt, int queue);
+extern void NetTelemetry_RecordSendLoop(double seconds);
+extern void NetTelemetry_Update(double now);
+extern bool NetTelemetry_GetLine(int line, char *buf, size_t len);
+
+#endif
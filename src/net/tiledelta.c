@@ -0,0 +1,300 @@
+/* tiledelta.c
+ *
+ * Encoding of changed map tiles, for the landscape and fog of war
+ * updates.
+ *
+ * Tiles are grouped into 8x8 blocks.  Each block with changes is sent
+ * as a header byte, holding the block number and the mode, followed by
+ * the values in one of two forms, whichever is shorter:
+ *
+ * - sparse: a 64 bit mask of the changed tiles, then the values of the
+ *   changed tiles only;
+ * - dense: the values of all 64 tiles, with unchanged tiles given the
+ *   skip value (all ones).
+ *
+ * Either way, the values are run-length encoded: a control byte with
+ * the top bit set is followed by one value repeated (c & 0x7F) + 1
+ * times; otherwise it is followed by c + 1 literal values.  Values are
+ * value_size bytes each, little endian.  Explosions and fog sweeps
+ * change tiles in patches, often to the same sprite, which this packs
+ * well compared to sending every tile with its position.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "tiledelta.h"
+
+enum {
+	TILEDELTA_MODE_DENSE = 0x80,
+	TILEDELTA_RUN = 0x80,
+	TILEDELTA_MAX_RUN = 0x80
+};
+
+static uint32
+TileDelta_GetSkipValue(int value_size)
+{
+	return (value_size >= 4) ? 0xFFFFFFFF : ((1u << (8 * value_size)) - 1);
+}
+
+int
+TileDelta_GetBlock(uint16 packed)
+{
+	const int x = packed & 0x3F;
+	const int y = (packed >> 6) & 0x3F;
+
+	return (y >> TILEDELTA_BLOCK_SHIFT) * TILEDELTA_BLOCKS_PER_ROW + (x >> TILEDELTA_BLOCK_SHIFT);
+}
+
+int
+TileDelta_GetBit(uint16 packed)
+{
+	const int x = packed & (TILEDELTA_BLOCK_SIZE - 1);
+	const int y = (packed >> 6) & (TILEDELTA_BLOCK_SIZE - 1);
+
+	return (y << TILEDELTA_BLOCK_SHIFT) + x;
+}
+
+uint16
+TileDelta_GetPacked(int block, int bit)
+{
+	const int x = (block % TILEDELTA_BLOCKS_PER_ROW) * TILEDELTA_BLOCK_SIZE + (bit & (TILEDELTA_BLOCK_SIZE - 1));
+	const int y = (block / TILEDELTA_BLOCKS_PER_ROW) * TILEDELTA_BLOCK_SIZE + (bit >> TILEDELTA_BLOCK_SHIFT);
+
+	return (y << 6) + x;
+}
+
+/*--------------------------------------------------------------*/
+
+static unsigned char *
+TileDelta_EncodeValue(unsigned char *out, uint32 value, int value_size)
+{
+	for (int i = 0; i < value_size; i++) {
+		*out++ = (value >> (8 * i)) & 0xFF;
+	}
+
+	return out;
+}
+
+static uint32
+TileDelta_DecodeValue(const unsigned char **buf, int value_size)
+{
+	uint32 value = 0;
+
+	for (int i = 0; i < value_size; i++) {
+		value |= (uint32)(*buf)[i] << (8 * i);
+	}
+
+	(*buf) += value_size;
+	return value;
+}
+
+/**
+ * @brief   Run-length encodes n values into out.
+ * @return  The end of the output.
+ */
+static unsigned char *
+TileDelta_EncodeRuns(unsigned char *out, const uint32 *value, int n, int value_size)
+{
+	int i = 0;
+
+	while (i < n) {
+		int run = 1;
+		while (i + run < n && run < TILEDELTA_MAX_RUN && value[i + run] == value[i])
+			run++;
+
+		if (run >= 2) {
+			*out++ = TILEDELTA_RUN | (run - 1);
+			out = TileDelta_EncodeValue(out, value[i], value_size);
+			i += run;
+			continue;
+		}
+
+		/* Literals, up to the start of the next run. */
+		int lit = 1;
+		while (i + lit < n && lit < TILEDELTA_MAX_RUN
+				&& !(i + lit + 1 < n && value[i + lit] == value[i + lit + 1]))
+			lit++;
+
+		*out++ = lit - 1;
+		for (int j = 0; j < lit; j++) {
+			out = TileDelta_EncodeValue(out, value[i + j], value_size);
+		}
+
+		i += lit;
+	}
+
+	return out;
+}
+
+/**
+ * @brief   Decodes exactly n run-length encoded values.
+ * @return  False if the runs are malformed or overrun the buffer.
+ */
+static bool
+TileDelta_DecodeRuns(const unsigned char **buf, const unsigned char *end,
+		uint32 *value, int n, int value_size)
+{
+	int i = 0;
+
+	while (i < n) {
+		if (*buf >= end)
+			return false;
+
+		const unsigned char c = *(*buf)++;
+		const int count = (c & ~TILEDELTA_RUN) + 1;
+
+		if (i + count > n)
+			return false;
+
+		if (c & TILEDELTA_RUN) {
+			if (*buf + value_size > end)
+				return false;
+
+			const uint32 v = TileDelta_DecodeValue(buf, value_size);
+
+			for (int j = 0; j < count; j++) {
+				value[i++] = v;
+			}
+		} else {
+			if (*buf + count * value_size > end)
+				return false;
+
+			for (int j = 0; j < count; j++) {
+				value[i++] = TileDelta_DecodeValue(buf, value_size);
+			}
+		}
+	}
+
+	return true;
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Encodes the changed tiles of one block.
+ * @param   buf The output.
+ * @param   len The space left in buf.
+ * @param   block The block number.
+ * @param   changed Bit i set if tile i of the block changed.
+ * @param   value The values of the block's tiles, indexed by bit.  Only
+ *                the changed ones are read, and none may be the skip
+ *                value.
+ * @param   value_size Bytes per value, 1 to 4.
+ * @return  The number of bytes written, or 0 if it did not fit.
+ */
+size_t
+TileDelta_EncodeBlock(unsigned char *buf, size_t len, int block,
+		uint64_t changed, const uint32 *value, int value_size)
+{
+	const uint32 skip = TileDelta_GetSkipValue(value_size);
+	unsigned char sparse[TILEDELTA_MAX_BLOCK_LEN];
+	unsigned char dense[TILEDELTA_MAX_BLOCK_LEN];
+	uint32 list[TILEDELTA_BLOCK_TILES];
+	uint32 all[TILEDELTA_BLOCK_TILES];
+	int n = 0;
+
+	assert(0 <= block && block < TILEDELTA_NUM_BLOCKS);
+	assert(1 <= value_size && value_size <= 4);
+
+	for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++) {
+		if (changed & ((uint64_t)1 << i)) {
+			assert(value[i] != skip);
+			list[n++] = value[i];
+			all[i] = value[i];
+		} else {
+			all[i] = skip;
+		}
+	}
+
+	unsigned char *end = sparse;
+	*end++ = block;
+	for (int i = 0; i < 8; i++) {
+		*end++ = (changed >> (8 * i)) & 0xFF;
+	}
+	end = TileDelta_EncodeRuns(end, list, n, value_size);
+	size_t sparse_len = end - sparse;
+
+	end = dense;
+	*end++ = block | TILEDELTA_MODE_DENSE;
+	end = TileDelta_EncodeRuns(end, all, TILEDELTA_BLOCK_TILES, value_size);
+	size_t dense_len = end - dense;
+
+	const bool use_dense = (dense_len < sparse_len);
+	const size_t out_len = use_dense ? dense_len : sparse_len;
+
+	if (out_len > len)
+		return 0;
+
+	memcpy(buf, use_dense ? dense : sparse, out_len);
+	return out_len;
+}
+
+/**
+ * @brief   Decodes one block written by TileDelta_EncodeBlock.
+ * @param   changed Set to the mask of the tiles with new values.
+ * @param   value The block's 64 values, indexed by bit.  Only the ones
+ *                in changed are written.
+ * @return  The block number, or -1 if the data is malformed.
+ */
+int
+TileDelta_DecodeBlock(const unsigned char **buf, const unsigned char *end,
+		uint64_t *changed, uint32 *value, int value_size)
+{
+	const uint32 skip = TileDelta_GetSkipValue(value_size);
+	uint32 list[TILEDELTA_BLOCK_TILES];
+
+	if (*buf >= end)
+		return -1;
+
+	const unsigned char header = *(*buf)++;
+	const int block = header & ~TILEDELTA_MODE_DENSE;
+
+	if (block >= TILEDELTA_NUM_BLOCKS)
+		return -1;
+
+	*changed = 0;
+
+	if (header & TILEDELTA_MODE_DENSE) {
+		if (!TileDelta_DecodeRuns(buf, end, list, TILEDELTA_BLOCK_TILES, value_size))
+			return -1;
+
+		for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++) {
+			if (list[i] == skip)
+				continue;
+
+			*changed |= (uint64_t)1 << i;
+			value[i] = list[i];
+		}
+
+		return block;
+	}
+
+	if (*buf + 8 > end)
+		return -1;
+
+	uint64_t mask = 0;
+	int n = 0;
+
+	for (int i = 0; i < 8; i++) {
+		mask |= (uint64_t)(*buf)[i] << (8 * i);
+	}
+	(*buf) += 8;
+
+	for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++) {
+		if (mask & ((uint64_t)1 << i))
+			n++;
+	}
+
+	if (!TileDelta_DecodeRuns(buf, end, list, n, value_size))
+		return -1;
+
+	n = 0;
+	for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++) {
+		if (mask & ((uint64_t)1 << i))
+			value[i] = list[n++];
+	}
+
+	*changed = mask;
+	return block;
+}
@@ -0,0 +1,26 @@
+#ifndef NET_TILEDELTA_H
+#define NET_TILEDELTA_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "types.h"
+
+enum {
+	TILEDELTA_BLOCK_SHIFT = 3,
+	TILEDELTA_BLOCK_SIZE = 1 << TILEDELTA_BLOCK_SHIFT,
+	TILEDELTA_BLOCK_TILES = TILEDELTA_BLOCK_SIZE * TILEDELTA_BLOCK_SIZE,
+	TILEDELTA_BLOCKS_PER_ROW = 64 >> TILEDELTA_BLOCK_SHIFT,
+	TILEDELTA_NUM_BLOCKS = TILEDELTA_BLOCKS_PER_ROW * TILEDELTA_BLOCKS_PER_ROW,
+
+	/* Largest encoded block: header, mask, and 64 literals. */
+	TILEDELTA_MAX_BLOCK_LEN = 1 + 8 + 1 + TILEDELTA_BLOCK_TILES * 4
+};
+
+extern int TileDelta_GetBlock(uint16 packed);
+extern int TileDelta_GetBit(uint16 packed);
+extern uint16 TileDelta_GetPacked(int block, int bit);
+
+extern size_t TileDelta_EncodeBlock(unsigned char *buf, size_t len, int block, uint64_t changed, const uint32 *value, int value_size);
+extern int TileDelta_DecodeBlock(const unsigned char **buf, const unsigned char *end, uint64_t *changed, uint32 *value, int value_size);
+
+#endif
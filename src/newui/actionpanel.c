@@ -15,6 +15,7 @@
 #include "../audio/audio.h"
 #include "../config.h"
 #include "../enhancement.h"
+#include "../gamecontext.h"
 #include "../gfx.h"
 #include "../gui/font.h"
 #include "../gui/gui.h"
@@ -55,8 +56,8 @@ enum FactoryPanelLayout {
 	FACTORYPANEL_STARPORT_FLAG      = 0x04,
 };
 
-FactoryWindowItem g_factoryWindowItems[MAX_FACTORY_WINDOW_ITEMS];
-int g_factoryWindowTotal;
+THREAD_LOCAL FactoryWindowItem g_factoryWindowItems[MAX_FACTORY_WINDOW_ITEMS];
+THREAD_LOCAL int g_factoryWindowTotal;
 
 static enum FactoryPanelLayout s_factory_panel_layout;
 
@@ -275,8 +276,8 @@ ActionPanel_DrawStructureDescription(Structure *s)
 					int units_total = 0;
 					int units_not_on_map = 0;
 
-					for (int i = 0; i < g_unitFindCount; i++) {
-						Unit *u = g_unitFindArray[i];
+					for (int i = 0; i < g_game->unitFindCount; i++) {
+						Unit *u = g_game->unitFindArray[i];
 
 						if (u == NULL)
 							continue;
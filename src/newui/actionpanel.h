@@ -26,8 +26,8 @@ typedef struct FactoryWindowItem {
 	uint16 shortcut;
 } FactoryWindowItem;
 
-extern FactoryWindowItem g_factoryWindowItems[MAX_FACTORY_WINDOW_ITEMS];
-extern int g_factoryWindowTotal;
+extern THREAD_LOCAL FactoryWindowItem g_factoryWindowItems[MAX_FACTORY_WINDOW_ITEMS];
+extern THREAD_LOCAL int g_factoryWindowTotal;
 
 extern void ActionPanel_HighlightIcon(enum HouseType houseID, int x1, int y1, bool large_icon);
 extern void ActionPanel_DrawPortrait(uint16 action_type, enum ShapeID shapeID);
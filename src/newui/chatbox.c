@@ -198,6 +198,8 @@ ChatBox_DrawHistory(int x, int y, int style, int64_t curr_ticks)
 {
 	const int h = (style == 0x11) ? 7 : 10;
 
+	Video_HoldBitmapDrawing(true);
+
 	for (unsigned int i = s_historyHead;
 			i != s_historyTail;
 			i = (i + 1) % MAX_CHAT_LINES) {
@@ -239,6 +241,8 @@ ChatBox_DrawHistory(int x, int y, int style, int64_t curr_ticks)
 
 		y += h;
 	}
+
+	Video_HoldBitmapDrawing(false);
 }
 
 void
@@ -40,12 +40,12 @@ typedef struct HallOfFameData {
 	int curr_meter_val;
 
 	/* Meters are:
-	 * spice harvested by you (g_scenario.harvestedAllied)
-	 * spice harvested by enemy (g_scenario.harvestedEnemy)
-	 * units destroyed by you (g_scenario.killedEnemy)
-	 * units destroyed by enemy (g_scenario.killedAllied)
-	 * structures destroyed by you (g_scenario.destroyedEnemy)
-	 * structures destroyed by enemy (g_scenario.destroyedAllied)
+	 * spice harvested by you (g_game->scenario.harvestedAllied)
+	 * spice harvested by enemy (g_game->scenario.harvestedEnemy)
+	 * units destroyed by you (g_game->scenario.killedEnemy)
+	 * units destroyed by enemy (g_game->scenario.killedAllied)
+	 * structures destroyed by you (g_game->scenario.destroyedEnemy)
+	 * structures destroyed by enemy (g_game->scenario.destroyedAllied)
 	 */
 	struct {
 		int max;
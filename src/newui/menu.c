@@ -20,11 +20,13 @@
 #include "scrollbar.h"
 #include "strategicmap.h"
 #include "../audio/audio.h"
+#include "../catalogue.h"
 #include "../common_a5.h"
 #include "../config.h"
 #include "../cutscene.h"
 #include "../enhancement.h"
 #include "../file.h"
+#include "../gamecontext.h"
 #include "../gfx.h"
 #include "../gui/font.h"
 #include "../gui/gui.h"
@@ -37,7 +39,9 @@
 #include "../net/client.h"
 #include "../net/net.h"
 #include "../opendune.h"
+#include "../replay.h"
 #include "../scenario.h"
+#include "../snapshot.h"
 #include "../sprites.h"
 #include "../string.h"
 #include "../table/sound.h"
@@ -209,13 +213,17 @@ Briefing_InitWidgets(void)
 	briefing_proceed_repeat_widgets = GUI_Widget_Link(briefing_proceed_repeat_widgets, w);
 }
 
+/**
+ * @brief   Parses a campaign directory's META.INI and checks that its
+ *          scenarios are present.
+ * @details Houses without scenarios are set to HOUSE_INVALID.
+ */
 static void
-Menu_AddCampaign(ALLEGRO_PATH *path)
+Menu_ReadCampaign(ALLEGRO_PATH *path, CatalogueCampaign *camp)
 {
-	/* Don't add CAMPAIGNID_SKIRMISH nor CAMPAIGNID_MULTIPLAYER again. */
-	if ((strcasecmp(al_get_path_tail(path), "skirmish") == 0)
-	 || (strcasecmp(al_get_path_tail(path), "multiplayer") == 0))
-		return;
+	int *house = camp->house;
+
+	house[0] = house[1] = house[2] = HOUSE_INVALID;
 
 	al_set_path_filename(path, "META.INI");
 	const char *meta = al_path_cstr(path, ALLEGRO_NATIVE_PATH_SEP);
@@ -225,12 +233,12 @@ Menu_AddCampaign(ALLEGRO_PATH *path)
 
 	char *source = File_ReadWholeFile_Ex(SEARCHDIR_ABSOLUTE, meta);
 	char buffer[120];
-	int house[3];
 
 	Ini_GetString("CAMPAIGN", "House", NULL, buffer, sizeof(buffer), source);
 	String_Trim(buffer);
 
 	if (sscanf(buffer, "%d,%d,%d", &house[0], &house[1], &house[2]) < 3) {
+		house[0] = house[1] = house[2] = HOUSE_INVALID;
 		free(source);
 		return;
 	}
@@ -282,21 +290,52 @@ Menu_AddCampaign(ALLEGRO_PATH *path)
 		}
 	}
 
+	al_set_path_filename(path, NULL);
+	Ini_GetString("CAMPAIGN", "Name", al_get_path_tail(path), camp->name, sizeof(camp->name), source);
+
+	free(source);
+}
+
+static void
+Menu_AddCampaign(ALLEGRO_FS_ENTRY *f)
+{
+	ALLEGRO_PATH *path = al_create_path_for_directory(al_get_fs_entry_name(f));
+
+	/* Don't add CAMPAIGNID_SKIRMISH nor CAMPAIGNID_MULTIPLAYER again. */
+	if ((strcasecmp(al_get_path_tail(path), "skirmish") == 0)
+	 || (strcasecmp(al_get_path_tail(path), "multiplayer") == 0)) {
+		al_destroy_path(path);
+		return;
+	}
+
+	/* Only parse campaigns that changed since the last scan. */
+	const char *dirname = al_get_fs_entry_name(f);
+	const int64_t mtime = al_get_fs_entry_mtime(f);
+	const CatalogueCampaign *cached = Catalogue_FindCampaign(dirname, mtime);
+	CatalogueCampaign camp;
+
+	if (cached != NULL) {
+		camp = *cached;
+	} else {
+		memset(&camp, 0, sizeof(camp));
+		Menu_ReadCampaign(path, &camp);
+		Catalogue_AddCampaign(dirname, mtime, &camp);
+	}
+
 	/* Add campaign to list. */
-	if ((house[0] != HOUSE_INVALID) || (house[1] != HOUSE_INVALID) || (house[2] != HOUSE_INVALID)) {
+	if ((camp.house[0] != HOUSE_INVALID) || (camp.house[1] != HOUSE_INVALID) || (camp.house[2] != HOUSE_INVALID)) {
 		al_set_path_filename(path, NULL);
-		const char *module = al_get_path_tail(path);
 
-		Campaign *camp = Campaign_Alloc(module);
+		Campaign *c = Campaign_Alloc(al_get_path_tail(path));
 
 		for (int h = 0; h < 3; h++) {
-			camp->house[h] = house[h];
+			c->house[h] = camp.house[h];
 		}
 
-		Ini_GetString("CAMPAIGN", "Name", module, camp->name, sizeof(camp->name), source);
+		snprintf(c->name, sizeof(c->name), "%s", camp.name);
 	}
 
-	free(source);
+	al_destroy_path(path);
 }
 
 static int
@@ -332,11 +371,8 @@ Menu_ScanCampaigns(void)
 	while (f != NULL) {
 		const bool is_directory = (al_get_fs_entry_mode(f) & ALLEGRO_FILEMODE_ISDIR);
 
-		if (is_directory) {
-			ALLEGRO_PATH *path = al_create_path_for_directory(al_get_fs_entry_name(f));
-			Menu_AddCampaign(path);
-			al_destroy_path(path);
-		}
+		if (is_directory)
+			Menu_AddCampaign(f);
 
 		al_destroy_fs_entry(f);
 		f = al_read_directory(e);
@@ -344,6 +380,7 @@ Menu_ScanCampaigns(void)
 
 	al_close_directory(e);
 	al_destroy_fs_entry(e);
+	Catalogue_Save();
 
 	/* Sort campaigns. */
 	if (g_campaign_total > CAMPAIGNID_MULTIPLAYER + 1) {
@@ -835,6 +872,9 @@ Briefing_Initialise(enum MenuAction menu, MentatState *mentat)
 		MentatBriefing_InitWSA(g_playerHouseID, g_scenarioID, entry, mentat);
 
 		Audio_PlayMusic(MUSIC_STOP);
+
+		if (menu == MENU_BRIEFING)
+			Audio_PrefetchSampleSet(g_table_houseInfo[g_playerHouseID].sampleSet);
 	}
 
 	mentat->state = MENTAT_SHOW_TEXT;
@@ -910,6 +950,10 @@ Briefing_Loop(enum MenuAction curr_menu, enum HouseType houseID, MentatState *me
 		}
 	}
 
+	/* Load the scenario's assets a bit at a time while the mentat talks. */
+	if (curr_menu == MENU_BRIEFING && !Audio_PollPrefetch())
+		Sprites_PrefetchTiles();
+
 	if (mentat->state == MENTAT_IDLE) {
 		if (curr_menu == MENU_CONFIRM_HOUSE) {
 			widgetID = GUI_Widget_HandleEvents(briefing_yes_no_widgets);
@@ -1066,12 +1110,28 @@ LoadGame_Loop(void)
 static enum MenuAction
 PlaySkirmish_Loop(void)
 {
-	do {
-		if (!Skirmish_GenerateMap(MAP_GENERATOR_FINAL))
-			return MENU_SKIRMISH_LOBBY;
+	if (!Skirmish_GenerateMap(MAP_GENERATOR_FINAL))
+		return MENU_SKIRMISH_LOBBY;
 
+	/* Restarting goes back to the freshly generated map, instead of
+	 * generating it again.
+	 */
+	GameSnapshot *start = GameSnapshot_Create();
+	GameSnapshot_Take(start);
+
+	for (;;) {
 		PlayAGame_StartGame(false);
-	} while (g_gameMode == GM_RESTART);
+
+		if (g_gameMode != GM_RESTART)
+			break;
+
+		Campaign_Load();
+		Skirmish_Prepare();
+		GameSnapshot_Restore(start);
+		Game_ResetInterface();
+	}
+
+	GameSnapshot_Free(start);
 
 	if (g_gameMode == GM_WIN) {
 		Audio_PlayMusic(g_table_houseInfo[g_playerHouseID].musicWin);
@@ -1092,6 +1152,15 @@ PlayMultiplayer_Loop(void)
 	return MENU_MULTIPLAYER_LOBBY;
 }
 
+static enum MenuAction
+PlayReplay_Loop(void)
+{
+	if (Replay_LoadPlayback())
+		PlayAGame_StartGame(false);
+
+	return MENU_NO_TRANSITION | MENU_EXIT_GAME;
+}
+
 /*--------------------------------------------------------------*/
 
 static void
@@ -1105,7 +1174,7 @@ BattleSummary_Initialise(enum HouseType houseID, HallOfFameData *fame)
 	fame->pause_timer = Timer_GetTicks() + 45;
 	fame->score = Update_Score(stats.score,
 			&stats.harvestedAllied, &stats.harvestedEnemy, houseID);
-	fame->time = ((g_timerGame - g_tickScenarioStart) / 3600) + 1;
+	fame->time = ((g_game->timerGame - g_game->tickScenarioStart) / 3600) + 1;
 
 	HallOfFame_InitRank(fame->score, fame);
 
@@ -1306,6 +1375,9 @@ Menu_Run(void)
 	if (enhancement_skip_introduction == true) {
 		curr_menu = MENU_FADE_IN | MENU_MAIN_MENU;		
 	}
+	if (Replay_IsPlaybackPending()) {
+		curr_menu = MENU_PLAY_REPLAY;
+	}
 	enum MenuAction next_menu = curr_menu;
 	int64_t fade_start = Timer_GetTicks();
 	int64_t last_redraw_time = 0;
@@ -1517,6 +1589,10 @@ Menu_Run(void)
 				res = PlayMultiplayer_Loop();
 				break;
 
+			case MENU_PLAY_REPLAY:
+				res = PlayReplay_Loop();
+				break;
+
 			case MENU_BATTLE_SUMMARY:
 			case MENU_SKIRMISH_SUMMARY:
 				if (event.type == ALLEGRO_EVENT_TIMER) {
@@ -38,6 +38,7 @@ enum MenuAction {
 	MENU_PLAY_CUTSCENE,
 	MENU_CAMPAIGN_CUTSCENE,
 	MENU_STRATEGIC_MAP,
+	MENU_PLAY_REPLAY,
 	MENU_EXIT_GAME,
 
 	MENU_NO_TRANSITION = 0x0100,
@@ -51,7 +52,7 @@ struct MentatState;
 struct Widget;
 
 extern struct Widget *main_menu_widgets;
-extern enum MapGeneratorMode lobby_map_generator_mode;
+extern THREAD_LOCAL enum MapGeneratorMode lobby_map_generator_mode;
 
 extern void Menu_FreeWidgets(struct Widget *w);
 extern void Menu_LoadPalette(void);
@@ -37,7 +37,7 @@ static Widget *skirmish_lobby_widgets;
 static Widget *map_options_lobby_widgets;
 static Widget *multiplayer_lobby_widgets;
 static int64_t lobby_radar_timer;
-enum MapGeneratorMode lobby_map_generator_mode;
+THREAD_LOCAL enum MapGeneratorMode lobby_map_generator_mode;
 
 char map_options_fixed_seed[5 + 1] = "";
 char map_options_starting_credits[5 + 1] = "0";
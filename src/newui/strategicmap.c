@@ -30,7 +30,7 @@ static struct {
 } region_data[1 + STRATEGIC_MAP_MAX_REGIONS];
 
 StrategicMapData g_strategic_map_state;
-uint32 g_strategicRegionBits;   /* bits designating regions attempted. */
+THREAD_LOCAL uint32 g_strategicRegionBits;   /* bits designating regions attempted. */
 
 uint16
 StrategicMap_CampaignChoiceToScenarioID(int campaignID, int nth)
@@ -56,7 +56,7 @@ typedef struct StrategicMapData {
 } StrategicMapData;
 
 extern StrategicMapData g_strategic_map_state;
-extern uint32 g_strategicRegionBits;
+extern THREAD_LOCAL uint32 g_strategicRegionBits;
 
 extern uint16 StrategicMap_CampaignChoiceToScenarioID(int campaignID, int nth);
 extern void StrategicMap_Init(void);
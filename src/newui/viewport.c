@@ -12,6 +12,7 @@
 #include "../common_a5.h"
 #include "../config.h"
 #include "../enhancement.h"
+#include "../gamecontext.h"
 #include "../gfx.h"
 #include "../gui/gui.h"
 #include "../house.h"
@@ -154,7 +155,7 @@ Viewport_SelectRegion(void)
 
 		const uint16 packed = Tile_PackXY(tilex, tiley);
 
-		if (g_mapVisible[packed].fogOverlayBits == 0xF)
+		if (g_game->mapVisible[packed].fogOverlayBits == 0xF)
 			return;
 
 		bool unselect = false;
@@ -273,60 +274,6 @@ Viewport_Target(const Unit *u, enum UnitActionType action, uint16 packed)
 	}
 }
 
-void
-Viewport_Server_Place(House *h, Structure *s, uint16 packed)
-{
-	const StructureInfo *si = &g_table_structureInfo[s->o.type];
-	const enum HouseType houseID = h->index;
-
-	if (Structure_Place(s, packed, houseID)) {
-		h->structureActiveID = STRUCTURE_INDEX_INVALID;
-
-		Server_Send_PlaySound(1 << houseID, SOUND_PLACEMENT);
-
-		if (s->o.type == STRUCTURE_PALACE)
-			h->palacePosition = s->o.position;
-
-		if (g_validateStrictIfZero == 0 && s->o.type == STRUCTURE_REFINERY) {
-			Unit *u;
-
-			g_validateStrictIfZero++;
-			u = Unit_CreateWrapper(houseID, UNIT_HARVESTER, Tools_Index_Encode(s->o.index, IT_STRUCTURE));
-			g_validateStrictIfZero--;
-
-			if (u == NULL) {
-				h->harvestersIncoming++;
-			} else {
-				u->originEncoded = Tools_Index_Encode(s->o.index, IT_STRUCTURE);
-			}
-		}
-
-		Structure_Server_BuildObject(s, 0xFFFE);
-
-		if ((h->powerProduction < h->powerUsage)
-				&& (h->structuresBuilt & FLAG_STRUCTURE_OUTPOST)) {
-			Server_Send_StatusMessage1(1 << houseID, 3,
-					STR_NOT_ENOUGH_POWER_FOR_RADAR_BUILD_WINDTRAPS);
-		}
-
-		GUI_DisplayHint(houseID, si->o.hintStringID, si->o.spriteID);
-	} else {
-		Server_Send_PlaySound(1 << houseID, EFFECT_ERROR_OCCURRED);
-
-		if (s->o.type == STRUCTURE_SLAB_1x1
-		 || s->o.type == STRUCTURE_SLAB_2x2) {
-			Server_Send_StatusMessage1(1 << houseID, 2,
-					STR_CAN_NOT_PLACE_FOUNDATION_HERE);
-		} else {
-			GUI_DisplayHint(houseID,
-					STR_HINT_STRUCTURES_MUST_BE_PLACED_ON_CLEAR_ROCK_OR_CONCRETE_AND_ADJACENT_TO_ANOTHER_FRIENDLY_STRUCTURE,
-					SHAPE_INVALID);
-			Server_Send_StatusMessage2(1 << houseID, 2,
-					STR_CAN_NOT_PLACE_S_HERE, si->o.stringID_abbrev);
-		}
-	}
-}
-
 static bool
 Viewport_MouseInScrollWidget(void)
 {
@@ -402,7 +349,7 @@ Viewport_GenericCommandCanAttack(uint16 packed, enum LandscapeType lst, bool vis
 	if (lst == LST_BLOOM_FIELD)
 		return true;
 
-	if ((lst == LST_WALL || lst == LST_STRUCTURE) && (!House_AreAllied(g_playerHouseID, g_mapVisible[packed].houseID)))
+	if ((lst == LST_WALL || lst == LST_STRUCTURE) && (!House_AreAllied(g_playerHouseID, g_game->mapVisible[packed].houseID)))
 		return true;
 
 	if (visible) {
@@ -422,7 +369,7 @@ Viewport_GenericCommandCanSabotageAlly(uint16 packed)
 	/* Allow sabotaging allied and deviated units if only a single saboteur is selected. */
 	const Unit *u = Unit_FirstSelected(&iter);
 	if ((u != NULL) && (u->o.type == UNIT_SABOTEUR) && (Unit_NextSelected(&iter) == NULL)) {
-		return (g_map[packed].hasUnit && Unit_Get_ByPackedTile(packed) != u);
+		return (g_game->map[packed].hasUnit && Unit_Get_ByPackedTile(packed) != u);
 	}
 
 	return false;
@@ -474,7 +421,7 @@ static bool
 Viewport_PerformContextSensitiveAction(uint16 packed, bool dry_run)
 {
 	const enum LandscapeType lst = Map_GetLandscapeTypeVisible(packed);
-	const bool visible = (g_mapVisible[packed].fogOverlayBits != 0xF);
+	const bool visible = (g_game->mapVisible[packed].fogOverlayBits != 0xF);
 	const bool scouted = Map_IsUnveiledToHouse(g_playerHouseID, packed);
 	const bool attack = Viewport_GenericCommandCanAttack(packed, lst, visible, scouted);
 	const bool sabotage = Viewport_GenericCommandCanSabotageAlly(packed);
@@ -531,8 +478,8 @@ Viewport_Click(Widget *w)
 		: (g_selectionType == SELECTIONTYPE_TARGET) ? SHAPE_CURSOR_TARGET : SHAPE_CURSOR_NORMAL;
 
 	if (w->index == 45) {
-		if ((cursorID != g_cursorSpriteID) && (g_timerGame - l_tickCursor > 10)) {
-			l_tickCursor = g_timerGame;
+		if ((cursorID != g_cursorSpriteID) && (g_game->timerGame - l_tickCursor > 10)) {
+			l_tickCursor = g_game->timerGame;
 			Video_SetCursor(cursorID);
 		}
 
@@ -549,7 +496,7 @@ Viewport_Click(Widget *w)
 	if (w->index == 44) {
 		Mouse_TransformToDiv(SCREENDIV_SIDEBAR, &mouseX, &mouseY);
 
-		const int mapScale = g_scenario.mapScale;
+		const int mapScale = g_game->scenario.mapScale;
 		const MapInfo *mapInfo = &g_mapInfos[mapScale];
 		const int tilex = Map_Clamp(mapInfo->minX + (mouseX - w->offsetX) / (mapScale + 1));
 		const int tiley = Map_Clamp(mapInfo->minY + (mouseY - w->offsetY) / (mapScale + 1));
@@ -567,7 +514,7 @@ Viewport_Click(Widget *w)
 	/* Context-sensitive mouse cursor. */
 	do {
 		if (w->index != 43) break;
-		if ((cursorID == SHAPE_CURSOR_TARGET) || (g_timerGame - l_tickCursor <= 10)) break;
+		if ((cursorID == SHAPE_CURSOR_TARGET) || (g_game->timerGame - l_tickCursor <= 10)) break;
 
 		if ((viewport_click_action == VIEWPORT_CLICK_NONE) ||
 		    (viewport_click_action == VIEWPORT_LMB && g_gameConfig.leftClickOrders) ||
@@ -577,8 +524,8 @@ Viewport_Click(Widget *w)
 		}
 	} while (false);
 
-	if ((cursorID != g_cursorSpriteID) && (g_timerGame - l_tickCursor > 10)) {
-		l_tickCursor = g_timerGame;
+	if ((cursorID != g_cursorSpriteID) && (g_game->timerGame - l_tickCursor > 10)) {
+		l_tickCursor = g_game->timerGame;
 		Video_SetCursor(cursorID);
 	}
 
@@ -683,7 +630,7 @@ Viewport_Click(Widget *w)
 		} else if (viewport_click_action == VIEWPORT_PAN_MINIMAP) {
 			/* High-resolution panning. */
 			const ScreenDiv *div = &g_screenDiv[SCREENDIV_SIDEBAR];
-			const uint16 mapScale = g_scenario.mapScale;
+			const uint16 mapScale = g_game->scenario.mapScale;
 			const MapInfo *mapInfo = &g_mapInfos[mapScale];
 
 			float x, y;
@@ -738,7 +685,7 @@ Viewport_Click(Widget *w)
 					const Structure *s = Structure_Get_ByPackedTile(g_selectionPosition);
 
 					/* Set rally point if we left click on an empty tile. */
-					if ((s != NULL) && !g_map[packed].hasUnit && !g_map[packed].hasStructure &&
+					if ((s != NULL) && !g_game->map[packed].hasUnit && !g_game->map[packed].hasStructure &&
 							Structure_SupportsRallyPoints(s->o.type)) {
 						perform_context_sensitive_action = true;
 					}
@@ -1043,7 +990,7 @@ Viewport_DrawTilesInRange(int x0, int y0,
 		int viewportX1, int viewportY1, int viewportX2, int viewportY2,
 		bool draw_tile, bool draw_fog)
 {
-	const MapInfo *mapInfo = &g_mapInfos[g_scenario.mapScale];
+	const MapInfo *mapInfo = &g_mapInfos[g_game->scenario.mapScale];
 	int left, top;
 	int x, y;
 
@@ -1064,13 +1011,13 @@ Viewport_DrawTilesInRange(int x0, int y0,
 	y = y0;
 	for (top = viewportY1; top < viewportY2; top += TILE_SIZE, y++) {
 		int curPos = Tile_PackXY(x0, y);
-		const Tile *t = &g_map[curPos];
-		const FogOfWarTile *f = &g_mapVisible[curPos];
+		const Tile *t = &g_game->map[curPos];
+		const FogOfWarTile *f = &g_game->mapVisible[curPos];
 
 		for (left = viewportX1; left < viewportX2; left += TILE_SIZE, curPos++, t++, f++) {
 			if (draw_tile && (f->fogSpriteID != g_veiledSpriteID - 1) && (f->fogSpriteID != g_veiledSpriteID)) {
 				if (Viewport_TileIsDebris(f->groundSpriteID)) {
-					const uint16 iconID = g_mapSpriteID[curPos] & ~0x8000;
+					const uint16 iconID = g_game->mapSpriteID[curPos] & ~0x8000;
 
 					Video_DrawIcon(iconID, HOUSE_HARKONNEN, left, top);
 				}
@@ -1295,7 +1242,7 @@ Viewport_DrawSelectionHealthBars(void)
 	if (!unit_selected &&
 			(g_selectionType != SELECTIONTYPE_PLACE) &&
 			(g_selectionPosition != 0xFFFF) &&
-			(g_mapVisible[g_selectionPosition].fogOverlayBits != 0xF) &&
+			(g_game->mapVisible[g_selectionPosition].fogOverlayBits != 0xF) &&
 			(s = Structure_Get_ByPackedTile(g_selectionPosition)) != NULL) {
 		const StructureInfo *si = &g_table_structureInfo[s->o.type];
 		const int x = TILE_SIZE * (Tile_GetPackedX(g_selectionPosition) - Tile_GetPackedX(g_viewportPosition)) - g_viewport_scrollOffsetX;
@@ -1311,7 +1258,7 @@ Viewport_DrawSelectionHealthBars(void)
 			Viewport_DrawSpiceBricks(x + 2, y + TILE_SIZE * g_selectionHeight - 3, 10, creditsStored, si->creditsStorage);
 		}
 
-		y += (ty == g_mapInfos[g_scenario.mapScale].minY ? 1 : -2);
+		y += (ty == g_mapInfos[g_game->scenario.mapScale].minY ? 1 : -2);
 		Viewport_DrawHealthBar(x + 1, y, TILE_SIZE * g_selectionWidth - 3, s->o.hitpoints, si->o.hitpoints);
 	}
 
@@ -1329,7 +1276,7 @@ Viewport_DrawSelectionHealthBars(void)
 			next = Unit_NextSelected(&iter);
 		}
 
-		if (ui->o.flags.tabSelectable && Map_IsValidPosition(packed) && (g_mapVisible[packed].fogOverlayBits != 0xF)) {
+		if (ui->o.flags.tabSelectable && Map_IsValidPosition(packed) && (g_game->mapVisible[packed].fogOverlayBits != 0xF)) {
 			int x, y;
 
 			Map_IsPositionInViewport(u->o.position, &x, &y);
@@ -1337,8 +1284,8 @@ Viewport_DrawSelectionHealthBars(void)
 			y = y - TILE_SIZE / 2 - 3;
 
 			/* Shift the meter down if off the top of the screen. */
-			if ((u->o.position.y >> 4) - TILE_SIZE / 2 - 3 <= TILE_SIZE * g_mapInfos[g_scenario.mapScale].minY) {
-				y += TILE_SIZE * g_mapInfos[g_scenario.mapScale].minY - ((u->o.position.y >> 4) - TILE_SIZE / 2 - 3);
+			if ((u->o.position.y >> 4) - TILE_SIZE / 2 - 3 <= TILE_SIZE * g_mapInfos[g_game->scenario.mapScale].minY) {
+				y += TILE_SIZE * g_mapInfos[g_game->scenario.mapScale].minY - ((u->o.position.y >> 4) - TILE_SIZE / 2 - 3);
 			}
 
 			Viewport_DrawHealthBar(x - 7, y, 13, u->o.hitpoints, ui->o.hitpoints);
@@ -1370,7 +1317,7 @@ Viewport_DrawSelectedUnit(int x, int y)
 void
 Viewport_DrawSandworm(const Unit *u)
 {
-	if (g_mapVisible[Tile_PackTile(u->o.position)].fogOverlayBits == 0xF)
+	if (g_game->mapVisible[Tile_PackTile(u->o.position)].fogOverlayBits == 0xF)
 		return;
 
 	const enum ShapeID shapeID = g_table_unitInfo[UNIT_SANDWORM].groundSpriteID;
@@ -1463,7 +1410,7 @@ Viewport_DrawUnit(const Unit *u, int windowX, int windowY, bool render_for_blur_
 
 	uint16 packed = Tile_PackTile(u->o.position);
 
-	if (g_mapVisible[packed].fogOverlayBits == 0xF)
+	if (g_game->mapVisible[packed].fogOverlayBits == 0xF)
 		return;
 
 	int x, y;
@@ -1602,7 +1549,7 @@ Viewport_DrawAirUnit(const Unit *u)
 
 	/* Allied air units don't get concealed by fog of war. */
 	if (!Map_IsUnveiledToHouse(g_playerHouseID, curPos)
-			|| ((g_mapVisible[curPos].fogOverlayBits == 0xF) && !House_AreAllied(u->o.houseID, g_playerHouseID))) {
+			|| ((g_game->mapVisible[curPos].fogOverlayBits == 0xF) && !House_AreAllied(u->o.houseID, g_playerHouseID))) {
 		return;
 	}
 
@@ -1795,7 +1742,7 @@ Viewport_RenderBrush(int x, int y, int blurx)
 				continue;
 
 			const uint16 packed = Tile_PackXY(tilex, tiley);
-			const Tile *t = &g_map[packed];
+			const Tile *t = &g_game->map[packed];
 
 			if (!t->hasUnit || (t->index == 0))
 				continue;
@@ -1834,6 +1781,8 @@ Viewport_InterpolateMovement(const Unit *u, int *x, int *y)
 {
 	if (enhancement_smooth_unit_animation == SMOOTH_UNIT_ANIMATION_DISABLE) {
 		return Map_IsPositionInViewport(u->o.position, x, y);
+	} else if (g_host_type == HOSTTYPE_DEDICATED_CLIENT) {
+		return Map_IsPositionInViewport(Client_GetUnitPosition(u), x, y);
 	} else {
 		const double frame = Timer_GetUnitMovementFrame();
 		tile32 pos = Unit_GetNextDestination(u);
@@ -23,7 +23,6 @@ extern void Viewport_DrawSelectionHealthBars(void);
 extern void Viewport_DrawSelectionBox(void);
 extern void Viewport_DrawPanCursor(void);
 extern void Viewport_RenderBrush(int x, int y, int blurx);
-extern void Viewport_Server_Place(struct House *h, struct Structure *s, uint16 packed);
 extern bool Viewport_Click(Widget *w);
 
 #endif
@@ -4,6 +4,7 @@
 
 #include "object.h"
 
+#include "gamecontext.h"
 #include "map.h"
 #include "pool/pool_structure.h"
 #include "pool/pool_unit.h"
@@ -101,7 +102,7 @@ Object *Object_GetByPackedTile(uint16 packed)
 
 	if (Tile_IsOutOfMap(packed)) return NULL;
 
-	t = &g_map[packed];
+	t = &g_game->map[packed];
 	if (t->hasUnit) return &Unit_Get_ByIndex(t->index - 1)->o;
 	if (t->hasStructure) return &Structure_Get_ByIndex(t->index - 1)->o;
 	return NULL;
@@ -1,6 +1,6 @@
 /** @file src/opendune.c Gameloop and other main routines. */
 
-#ifdef __APPLE__
+#if defined(__APPLE__) && !defined(DEDICATED_SERVER)
 /* We need Allegro to mangle main, and Allegro can't define the
  * _al_mangled_main prototype for us.
  */
@@ -26,6 +26,7 @@ extern int _al_mangled_main(int argc, char **argv);
 
 #include "ai.h"
 #include "animation.h"
+#include "arena.h"
 #include "audio/audio.h"
 #include "common_a5.h"
 #include "config.h"
@@ -34,6 +35,7 @@ extern int _al_mangled_main(int argc, char **argv);
 #include "enhancement.h"
 #include "explosion.h"
 #include "file.h"
+#include "gamecontext.h"
 #include "gameloop.h"
 #include "gfx.h"
 #include "gui/font.h"
@@ -41,6 +43,7 @@ extern int _al_mangled_main(int argc, char **argv);
 #include "gui/mentat.h"
 #include "gui/widget.h"
 #include "house.h"
+#include "influence.h"
 #include "ini.h"
 #include "input/input.h"
 #include "input/mouse.h"
@@ -59,6 +62,9 @@ extern int _al_mangled_main(int argc, char **argv);
 #include "pool/pool_structure.h"
 #include "pool/pool_team.h"
 #include "pool/pool_unit.h"
+#include "profile.h"
+#include "replay.h"
+#include "save.h"
 #include "scenario.h"
 #include "shape.h"
 #include "sprites.h"
@@ -75,29 +81,29 @@ extern int _al_mangled_main(int argc, char **argv);
 #include "video/video.h"
 
 
-uint32 g_hintsShown1 = 0;          /*!< A bit-array to indicate which hints has been show already (0-31). */
-uint32 g_hintsShown2 = 0;          /*!< A bit-array to indicate which hints has been show already (32-63). */
-bool   g_inGame;
-enum GameMode g_gameMode = GM_NORMAL;
-enum GameOverlay g_gameOverlay;
-uint16 g_campaignID = 0;
-uint16 g_scenarioID = 1;
-uint16 g_activeAction = 0xFFFF;      /*!< Action the controlled unit will do. */
+THREAD_LOCAL uint32 g_hintsShown1 = 0;          /*!< A bit-array to indicate which hints has been show already (0-31). */
+THREAD_LOCAL uint32 g_hintsShown2 = 0;          /*!< A bit-array to indicate which hints has been show already (32-63). */
+THREAD_LOCAL bool   g_inGame;
+THREAD_LOCAL enum GameMode g_gameMode = GM_NORMAL;
+THREAD_LOCAL enum GameOverlay g_gameOverlay;
+THREAD_LOCAL uint16 g_campaignID = 0;
+THREAD_LOCAL uint16 g_scenarioID = 1;
+THREAD_LOCAL uint16 g_activeAction = 0xFFFF;      /*!< Action the controlled unit will do. */
 
-bool   g_debugGame = false;        /*!< When true, you can control the AI. */
-bool   g_debugScenario = false;    /*!< When true, you can review the scenario. There is no fog. The game is not running (no unit-movement, no structure-building, etc). You can click on individual tiles. */
+THREAD_LOCAL bool   g_debugGame = false;        /*!< When true, you can control the AI. */
+THREAD_LOCAL bool   g_debugScenario = false;    /*!< When true, you can review the scenario. There is no fog. The game is not running (no unit-movement, no structure-building, etc). You can click on individual tiles. */
 
-void *g_readBuffer = NULL;
-uint32 g_readBufferSize = 0;
+THREAD_LOCAL void *g_readBuffer = NULL;
+THREAD_LOCAL uint32 g_readBufferSize = 0;
 
-static bool  s_debugForceWin = false; /*!< When true, you immediately win the level. */
+static THREAD_LOCAL bool  s_debugForceWin = false; /*!< When true, you immediately win the level. */
 
-uint16 g_validateStrictIfZero = 0; /*!< 0 = strict validation, basically: no-cheat-mode. */
-uint16 g_selectionType = 0;
-uint16 g_selectionTypeNew = 0;
-bool g_isEnteringChat = false;
+THREAD_STORAGE uint16 g_validateStrictIfZero = 0; /*!< 0 = strict validation, basically: no-cheat-mode. */
+THREAD_LOCAL uint16 g_selectionType = 0;
+THREAD_LOCAL uint16 g_selectionTypeNew = 0;
+THREAD_LOCAL bool g_isEnteringChat = false;
 
-int16 g_musicInBattle = 0; /*!< 0 = no battle, 1 = fight is going on, -1 = music of fight is going on is active. */
+THREAD_LOCAL int16 g_musicInBattle = 0; /*!< 0 = no battle, 1 = fight is going on, -1 = music of fight is going on is active. */
 
 static enum GameMode
 GameLoop_Server_IsHouseFinished(enum HouseType houseID)
@@ -114,7 +120,7 @@ GameLoop_Server_IsHouseFinished(enum HouseType houseID)
 		return GM_NORMAL;
 
 	/* Check structures remaining. */
-	if ((g_scenario.winFlags & 0x3) || (g_scenario.loseFlags & 0x3)) {
+	if ((g_game->scenario.winFlags & 0x3) || (g_game->scenario.loseFlags & 0x3)) {
 		PoolFindStruct find;
 		bool foundFriendly = false;
 		bool foundOwn = false;
@@ -184,24 +190,24 @@ GameLoop_Server_IsHouseFinished(enum HouseType houseID)
 			
 		}
 
-		if (g_scenario.winFlags & 0x3) {
-			if ((g_scenario.winFlags & 0x1) && !foundEnemy)
+		if (g_game->scenario.winFlags & 0x3) {
+			if ((g_game->scenario.winFlags & 0x1) && !foundEnemy)
 				finish = true;
-			if ((g_scenario.winFlags & 0x2) && !foundFriendly)
+			if ((g_game->scenario.winFlags & 0x2) && !foundFriendly)
 				finish = true;
 		}
 
-		if (g_scenario.loseFlags & 0x3) {
+		if (g_game->scenario.loseFlags & 0x3) {
 			win = true;
-			if (g_scenario.loseFlags & 0x1)
+			if (g_game->scenario.loseFlags & 0x1)
 				win = win && (!foundEnemy);
-			if (g_scenario.loseFlags & 0x2)
+			if (g_game->scenario.loseFlags & 0x2)
 				win = win && foundFriendly;
 		}
 	}
 
 	/* Check spice quota. */
-	if ((g_scenario.winFlags & 0x4) || (g_scenario.loseFlags & 0x4)) {
+	if ((g_game->scenario.winFlags & 0x4) || (g_game->scenario.loseFlags & 0x4)) {
 		bool reached_quota;
 
 		/* SINGLE PLAYER -- Wait until the counter ticks over the quota. */
@@ -216,9 +222,9 @@ GameLoop_Server_IsHouseFinished(enum HouseType houseID)
 		}
 
 		if (reached_quota) {
-			if (g_scenario.winFlags & 0x4)
+			if (g_game->scenario.winFlags & 0x4)
 				finish = true;
-			if (g_scenario.loseFlags & 0x4)
+			if (g_game->scenario.loseFlags & 0x4)
 				win = true;
 		}
 	}
@@ -233,11 +239,11 @@ GameLoop_Server_IsHouseFinished(enum HouseType houseID)
 	 * survival: winFlags = 11, loseFlags = 9.
 	 * lose:     winFlags = 11, loseFlags = 1.
 	 */
-	if ((g_scenario.winFlags & 0x8) || (g_scenario.loseFlags & 0x8)) {
-		if (g_timerGame - g_tickScenarioStart >= g_scenario.timeOut) {
-			if (g_scenario.winFlags & 0x8)
+	if ((g_game->scenario.winFlags & 0x8) || (g_game->scenario.loseFlags & 0x8)) {
+		if (g_game->timerGame - g_game->tickScenarioStart >= g_game->scenario.timeOut) {
+			if (g_game->scenario.winFlags & 0x8)
 				finish = true;
-			if (g_scenario.loseFlags & 0x8)
+			if (g_game->scenario.loseFlags & 0x8)
 				win = true;
 		}
 	}
@@ -258,8 +264,8 @@ void GameLoop_Uninit(void)
 		free(w);
 	}
 
-	Script_ClearInfo(g_scriptStructure);
-	Script_ClearInfo(g_scriptTeam);
+	Script_ClearInfo(&g_scriptStructure);
+	Script_ClearInfo(&g_scriptTeam);
 
 	free(g_readBuffer); g_readBuffer = NULL;
 }
@@ -270,14 +276,14 @@ void GameLoop_Uninit(void)
  */
 void GameLoop_LevelEnd(void)
 {
-	static int64_t l_levelEndTimer = 0;
+	static THREAD_LOCAL int64_t l_levelEndTimer = 0;
 
-	if (l_levelEndTimer >= g_timerGame && !s_debugForceWin)
+	if (l_levelEndTimer >= g_game->timerGame && !s_debugForceWin)
 		return;
 
 	/* You have to play at least 7200 ticks before you can win the game */
 	if (!s_debugForceWin
-			&& g_timerGame - g_tickScenarioStart < 7200
+			&& g_game->timerGame - g_game->tickScenarioStart < 7200
 			&& g_campaign_selected != CAMPAIGNID_SKIRMISH
 			&& g_campaign_selected != CAMPAIGNID_MULTIPLAYER)
 		return;
@@ -297,7 +303,36 @@ void GameLoop_LevelEnd(void)
 		}
 	}
 
-	l_levelEndTimer = g_timerGame + 300;
+	l_levelEndTimer = g_game->timerGame + 300;
+}
+
+/**
+ * Runs the simulation for one game tick.
+ */
+void
+GameLoop_Server_Logic(void)
+{
+	PROFILE(PROFILE_LOGIC_SQUADS, UnitAI_SquadLoop());
+	PROFILE(PROFILE_LOGIC_TEAMS, GameLoop_Team());
+	PROFILE(PROFILE_LOGIC_UNITS, GameLoop_Unit());
+	PROFILE(PROFILE_LOGIC_STRUCTURES, GameLoop_Structure());
+	PROFILE(PROFILE_LOGIC_HOUSES, GameLoop_House());
+	PROFILE(PROFILE_LOGIC_EXPLOSIONS, Explosion_Tick());
+	PROFILE(PROFILE_LOGIC_ANIMATIONS, Animation_Tick());
+	PROFILE(PROFILE_LOGIC_UNIT_SORT, Unit_Sort());
+}
+
+/**
+ * Applies the commands received from the clients, then runs the
+ * simulation for one game tick.
+ */
+void
+GameLoop_Server_Step(void)
+{
+	Replay_RecordStep();
+	Server_RecvMessages();
+	GameLoop_Server_Logic();
+	Replay_EndStep();
 }
 
 #if 0
@@ -307,6 +342,9 @@ static bool GameLoop_IsInRange(uint16 x, uint16 y, uint16 minX, uint16 minY, uin
 static uint16 GameLoop_HandleEvents(const char **strings);
 #endif
 
+/* The dedicated server has no interface, and its own main. */
+#ifndef DEDICATED_SERVER
+
 static void Window_WidgetClick_Create(void)
 {
 	WidgetInfo *wi;
@@ -495,8 +533,8 @@ static void GameLoop_GameIntroAnimationMenu(void)
 	g_paletteMapping2[0xDF] = 0xDF;
 	g_paletteMapping2[0xEF] = 0xEF;
 
-	Script_LoadFromFile("TEAM.EMC", g_scriptTeam, g_scriptFunctionsTeam, NULL);
-	Script_LoadFromFile("BUILD.EMC", g_scriptStructure, g_scriptFunctionsStructure, NULL);
+	Script_LoadFromFile("TEAM.EMC", &g_scriptTeam, g_scriptFunctionsTeam, NULL);
+	Script_LoadFromFile("BUILD.EMC", &g_scriptStructure, g_scriptFunctionsStructure, NULL);
 
 	GUI_Palette_CreateRemap(HOUSE_MERCENARY);
 
@@ -507,6 +545,7 @@ static void GameLoop_GameIntroAnimationMenu(void)
 	UnitAI_ClearSquads();
 	Team_Init();
 	House_Init();
+	Influence_Invalidate();
 	Structure_Init();
 
 	{
@@ -531,6 +570,7 @@ void GameLoop_Main(bool new_game)
 
 	Mouse_TransformFromDiv(SCREENDIV_MENU, &g_mouseX, &g_mouseY);
 
+	/* Picks up, or finishes, whatever the briefing prefetched. */
 	Sprites_UnloadTiles();
 	Sprites_LoadTiles();
 	Viewport_Init();
@@ -556,12 +596,14 @@ void GameLoop_Main(bool new_game)
 	g_gameMode = GM_NORMAL;
 	g_gameOverlay = GAMEOVERLAY_NONE;
 
+	Replay_Start();
 	Timer_SetTimer(TIMER_GAME, true);
 	Timer_RegisterSource();
 	Video_GrabCursor();
 	ChatBox_ResetTimestamps();
 
 	GameLoop_Loop();
+	Replay_Stop();
 
 	Timer_UnregisterSource();
 
@@ -628,8 +670,16 @@ static bool Unknown_25C4_000E(void)
 
 int main(int argc, char **argv)
 {
-	VARIABLE_NOT_USED(argc);
-	VARIABLE_NOT_USED(argv);
+	const char *replay = NULL;
+	bool fast_forward = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			replay = argv[++i];
+		} else if (strcmp(argv[i], "--fast-forward") == 0) {
+			fast_forward = true;
+		}
+	}
 
 	CrashLog_Init();
 	FileHash_Init();
@@ -679,6 +729,9 @@ int main(int argc, char **argv)
 
 	Net_Initialise();
 
+	if (replay != NULL)
+		Replay_SetPlaybackFile(replay, fast_forward);
+
 	GameLoop_GameIntroAnimationMenu();
 
 	printf("%s\n", String_Get_ByIndex(STR_THANK_YOU_FOR_PLAYING_DUNE_II));
@@ -687,6 +740,8 @@ int main(int argc, char **argv)
 	exit(0);
 }
 
+#endif /* DEDICATED_SERVER */
+
 /**
  * Prepare the map (after loading scenario or savegame). Does some basic
  *  sanity-check and corrects stuff all over the place.
@@ -704,17 +759,20 @@ void Game_Prepare(void)
 	Structure_Recount();
 	Unit_Recount();
 	Team_Recount();
+	Map_MarkAllDirty();
+	Unit_RebuildOccupiedTiles();
 
 	for (uint16 packed = 0; packed < MAP_SIZE_MAX * MAP_SIZE_MAX; packed++) {
 		const Structure *s = Structure_Get_ByPackedTile(packed);
 		const Unit *u = Unit_Get_ByPackedTile(packed);
-		Tile *t = &g_map[packed];
-		FogOfWarTile *f = &g_mapVisible[packed];
+		Tile *t = &g_game->map[packed];
+		FogOfWarTile *f = &g_game->mapVisible[packed];
 
 		if (u == NULL || !u->o.flags.s.used) t->hasUnit = false;
 		if (s == NULL || !s->o.flags.s.used) t->hasStructure = false;
 
-		if (Map_IsUnveiledToHouse(g_playerHouseID, packed)) {
+		if (g_playerHouseID != HOUSE_INVALID
+				&& Map_IsUnveiledToHouse(g_playerHouseID, packed)) {
 			const int64_t backup = f->timeout[g_playerHouseID];
 
 			Map_UnveilTile(g_playerHouseID, UNVEILCAUSE_INITIALISATION,
@@ -724,7 +782,9 @@ void Game_Prepare(void)
 		}
 	}
 
-	Map_Client_UpdateFogOfWar();
+	/* A dedicated server has no player of its own. */
+	if (g_playerHouseID != HOUSE_INVALID)
+		Map_Client_UpdateFogOfWar();
 
 	for (Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
 			u != NULL;
@@ -786,7 +846,7 @@ void Game_Prepare(void)
 		if (s != NULL) Map_SetSelectionSize(g_table_structureInfo[s->o.type].layout);
 	}
 
-	g_tickHousePowerMaintenance = max(g_timerGame + 70, g_tickHousePowerMaintenance);
+	g_game->tickHousePowerMaintenance = max(g_game->timerGame + 70, g_game->tickHousePowerMaintenance);
 	g_playerCredits = 0xFFFF;
 
 	g_selectionType = oldSelectionType;
@@ -799,20 +859,34 @@ void Game_Prepare(void)
  */
 void Game_Init(void)
 {
+	Arena_Reset(&g_scenarioArena);
 	Unit_Init();
 	Structure_Init();
 	UnitAI_ClearSquads();
 	Team_Init();
 	House_Init();
+	Influence_Invalidate();
 
 	Animation_Init();
 	Explosion_Init();
-	memset(g_map, 0, 64 * 64 * sizeof(Tile));
+	memset(g_game->map, 0, 64 * 64 * sizeof(Tile));
 	Map_ResetFogOfWar();
 
-	memset(g_mapSpriteID, 0, 64 * 64 * sizeof(uint16));
+	memset(g_game->mapSpriteID, 0, 64 * 64 * sizeof(uint16));
 	memset(g_starportAvailable, 0, sizeof(g_starportAvailable));
 
+	Game_ResetInterface();
+}
+
+/**
+ * @brief   Forgets the selection, the active unit and structure, and the
+ *          text line.
+ * @details Introduced.  Split out of Game_Init, for when the simulation
+ *          is replaced without it, e.g. by restoring a GameSnapshot.
+ */
+void
+Game_ResetInterface(void)
+{
 	Audio_PlayVoice(VOICE_STOP);
 
 	g_selectionState          = 0; /* Invalid. */
@@ -863,6 +937,8 @@ void Game_LoadScenario(uint8 houseID, uint16 scenarioID)
  */
 void PrepareEnd(void)
 {
+	SaveFile_WaitForBackground();
+
 	Animation_Uninit();
 	Explosion_Uninit();
 
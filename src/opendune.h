@@ -31,32 +31,46 @@ enum GameOverlay {
 	GAMEOVERLAY_CONFIRM_QUIT,
 };
 
-extern uint32 g_hintsShown1;
-extern uint32 g_hintsShown2;
-extern bool   g_inGame;
-extern enum GameMode g_gameMode;
-extern enum GameOverlay g_gameOverlay;
-extern uint16 g_campaignID;
-extern uint16 g_scenarioID;
-extern uint16 g_activeAction;
-extern bool   g_debugGame;
-extern bool   g_debugScenario;
+extern THREAD_LOCAL uint32 g_hintsShown1;
+extern THREAD_LOCAL uint32 g_hintsShown2;
+extern THREAD_LOCAL bool   g_inGame;
+extern THREAD_LOCAL enum GameMode g_gameMode;
+extern THREAD_LOCAL enum GameOverlay g_gameOverlay;
+extern THREAD_LOCAL uint16 g_campaignID;
+extern THREAD_LOCAL uint16 g_scenarioID;
+extern THREAD_LOCAL uint16 g_activeAction;
+extern THREAD_LOCAL bool   g_debugGame;
+extern THREAD_LOCAL bool   g_debugScenario;
 
-extern uint16 g_validateStrictIfZero;
-extern uint16 g_selectionType;
-extern uint16 g_selectionTypeNew;
-extern bool   g_isEnteringChat;
+/* When false, sleeping unit and structure scripts count down one
+ * script tick at a time, as in the original game, instead of waiting
+ * in a timer wheel.  Only test_determinism can switch it off; it
+ * defines the variable itself.
+ */
+#ifdef SCRIPT_WHEEL_TOGGLE
+extern bool   g_scriptWheel;
+#else
+#define g_scriptWheel true
+#endif
 
-extern int16 g_musicInBattle;
+extern THREAD_STORAGE uint16 g_validateStrictIfZero;
+extern THREAD_LOCAL uint16 g_selectionType;
+extern THREAD_LOCAL uint16 g_selectionTypeNew;
+extern THREAD_LOCAL bool   g_isEnteringChat;
 
-extern void *g_readBuffer;
-extern uint32 g_readBufferSize;
+extern THREAD_LOCAL int16 g_musicInBattle;
+
+extern THREAD_LOCAL void *g_readBuffer;
+extern THREAD_LOCAL uint32 g_readBufferSize;
 
 extern void GameLoop_LevelEnd(void);
+extern void GameLoop_Server_Logic(void);
+extern void GameLoop_Server_Step(void);
 extern void GameLoop_TweakWidgetDimensions(void);
 extern void GameLoop_Main(bool new_game);
 extern void Game_Prepare(void);
 extern void Game_Init(void);
+extern void Game_ResetInterface(void);
 extern void Game_LoadScenario(uint8 houseID, uint16 scenarioID);
 extern void GameLoop_Uninit(void);
 extern void PrepareEnd(void);
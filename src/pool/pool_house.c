@@ -5,19 +5,17 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "pool_house.h"
 
 #include "pool.h"
+#include "../gamecontext.h"
 #include "pool_structure.h"
 #include "pool_unit.h"
 #include "../house.h"
 
-enum {
-	HOUSE_INDEX_MAX = HOUSE_MAX
-};
-
 typedef struct HousePool {
 	House pool[HOUSE_INDEX_MAX];
 	House *find[HOUSE_INDEX_MAX];
@@ -25,18 +23,9 @@ typedef struct HousePool {
 	bool allocated;
 } HousePool;
 
-/** variable_35FA. */
-static House s_houseArray[HOUSE_INDEX_MAX];
-
-/** variable_87C0. */
-static House *s_houseFindArray[HOUSE_INDEX_MAX];
-
-/** variable_35FE. */
-static uint16 s_houseFindCount;
-
-static HousePool s_housePoolBackup;
-assert_compile(sizeof(s_housePoolBackup.pool) == sizeof(s_houseArray));
-assert_compile(sizeof(s_housePoolBackup.find) == sizeof(s_houseFindArray));
+static THREAD_LOCAL HousePool s_housePoolBackup;
+assert_compile(sizeof(s_housePoolBackup.pool) == sizeof(g_game->houseArray));
+assert_compile(sizeof(s_housePoolBackup.find) == sizeof(g_game->houseFindArray));
 
 /**
  * @brief   Get the House from the pool with the indicated index.
@@ -47,11 +36,11 @@ House *
 House_Get_ByIndex(uint8 index)
 {
 	assert(index < HOUSE_INDEX_MAX);
-	return &s_houseArray[index];
+	return &g_game->houseArray[index];
 }
 
 /**
- * @brief   Start finding Houses in s_houseFindArray.
+ * @brief   Start finding Houses in g_game->houseFindArray.
  * @details f__10BE_01E2_0027_6596 and f__10BE_01F5_0014_C21B.
  *          Removed global find struct for when find=NULL.
  */
@@ -69,21 +58,21 @@ House_FindFirst(PoolFindStruct *find, enum HouseType houseID)
 }
 
 /**
- * @brief   Continue finding Houses in s_houseFindArray.
+ * @brief   Continue finding Houses in g_game->houseFindArray.
  * @details f__10BE_020F_004E_633B and f__10BE_0226_0037_B108.
  *          Removed global find struct for when find=NULL.
  */
 House *
 House_FindNext(PoolFindStruct *find)
 {
-	if (find->index >= s_houseFindCount && find->index != 0xFFFF)
+	if (find->index >= g_game->houseFindCount && find->index != 0xFFFF)
 		return NULL;
 
 	/* First, go to the next index. */
 	find->index++;
 
-	for (; find->index < s_houseFindCount; find->index++) {
-		House *h = s_houseFindArray[find->index];
+	for (; find->index < g_game->houseFindCount; find->index++) {
+		House *h = g_game->houseFindArray[find->index];
 		if (h != NULL)
 			return h;
 	}
@@ -98,13 +87,13 @@ House_FindNext(PoolFindStruct *find)
 void
 House_Init(void)
 {
-	memset(s_houseArray, 0, sizeof(s_houseArray));
-	memset(s_houseFindArray, 0, sizeof(s_houseFindArray));
-	s_houseFindCount = 0;
+	memset(g_game->houseArray, 0, sizeof(g_game->houseArray));
+	memset(g_game->houseFindArray, 0, sizeof(g_game->houseFindArray));
+	g_game->houseFindCount = 0;
 
 	/* ENHANCEMENT -- Ensure the index is always valid. */
 	for (unsigned int i = 0; i < HOUSE_INDEX_MAX; i++) {
-		s_houseArray[i].index = i;
+		g_game->houseArray[i].index = i;
 	}
 }
 
@@ -130,8 +119,8 @@ House_Allocate(uint8 index)
 	h->structureActiveID= STRUCTURE_INDEX_INVALID;
 	h->houseMissileID   = UNIT_INDEX_INVALID;
 
-	s_houseFindArray[s_houseFindCount] = h;
-	s_houseFindCount++;
+	g_game->houseFindArray[g_game->houseFindCount] = h;
+	g_game->houseFindCount++;
 
 	return h;
 }
@@ -147,22 +136,22 @@ House_Free(House *h)
 	unsigned int i;
 
 	/* Find the House to remove. */
-	for (i = 0; i < s_houseFindCount; i++) {
-		if (s_houseFindArray[i] == h)
+	for (i = 0; i < g_game->houseFindCount; i++) {
+		if (g_game->houseFindArray[i] == h)
 			break;
 	}
 
 	/* We should always find an entry. */
-	assert(i < s_houseFindCount);
+	assert(i < g_game->houseFindCount);
 
 	BuildQueue_Free(&h->starportQueue);
 
-	s_houseFindCount--;
+	g_game->houseFindCount--;
 
 	/* If needed, close the gap. */
-	if (i < s_houseFindCount) {
-		memmove(&s_houseFindArray[i], &s_houseFindArray[i + 1],
-				(s_houseFindCount - i) * sizeof(s_houseFindArray[0]));
+	if (i < g_game->houseFindCount) {
+		memmove(&g_game->houseFindArray[i], &g_game->houseFindArray[i + 1],
+				(g_game->houseFindCount - i) * sizeof(g_game->houseFindArray[0]));
 	}
 }
 #endif
@@ -180,9 +169,9 @@ HousePool_Save(void)
 	HousePool *pool = &s_housePoolBackup;
 	assert(!pool->allocated);
 
-	memcpy(pool->pool, s_houseArray, sizeof(s_houseArray));
-	memcpy(pool->find, s_houseFindArray, sizeof(s_houseFindArray));
-	pool->count = s_houseFindCount;
+	memcpy(pool->pool, g_game->houseArray, sizeof(g_game->houseArray));
+	memcpy(pool->find, g_game->houseFindArray, sizeof(g_game->houseFindArray));
+	pool->count = g_game->houseFindCount;
 
 	pool->allocated = true;
 	return pool;
@@ -198,9 +187,10 @@ HousePool_Load(HousePool *pool)
 {
 	assert(pool->allocated);
 
-	memcpy(s_houseArray, pool->pool, sizeof(s_houseArray));
-	memcpy(s_houseFindArray, pool->find, sizeof(s_houseFindArray));
-	s_houseFindCount = pool->count;
+	memcpy(g_game->houseArray, pool->pool, sizeof(g_game->houseArray));
+	memcpy(g_game->houseFindArray, pool->find, sizeof(g_game->houseFindArray));
+	g_game->houseFindCount = pool->count;
 
 	pool->allocated = false;
 }
+
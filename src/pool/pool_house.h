@@ -3,9 +3,14 @@
 #ifndef POOL_HOUSE_H
 #define POOL_HOUSE_H
 
+#include <stddef.h>
 #include "enum_house.h"
 #include "types.h"
 
+enum {
+	HOUSE_INDEX_MAX = HOUSE_MAX
+};
+
 struct House;
 struct HousePool;
 struct PoolFindStruct;
@@ -17,6 +17,7 @@
 #include "pool_structure.h"
 
 #include "pool.h"
+#include "../gamecontext.h"
 #include "pool_house.h"
 #include "../house.h"
 #include "../opendune.h"
@@ -31,18 +32,9 @@ typedef struct StructurePool {
 	bool allocated;
 } StructurePool;
 
-/** variable_35F4. */
-static Structure s_structureArray[STRUCTURE_INDEX_MAX_HARD + STRUCTURE_INDEX_RAISED_AMOUNT];
-
-/** variable_8622. */
-static Structure *s_structureFindArray[STRUCTURE_INDEX_MAX_SOFT + STRUCTURE_INDEX_RAISED_AMOUNT];
-
-/** variable_35F8. */
-static uint16 s_structureFindCount;
-
-static StructurePool s_structurePoolBackup;
-assert_compile(sizeof(s_structurePoolBackup.pool) == sizeof(s_structureArray));
-assert_compile(sizeof(s_structurePoolBackup.find) == sizeof(s_structureFindArray));
+static THREAD_LOCAL StructurePool s_structurePoolBackup;
+assert_compile(sizeof(s_structurePoolBackup.pool) == sizeof(g_game->structureArray));
+assert_compile(sizeof(s_structurePoolBackup.find) == sizeof(g_game->structureFindArray));
 
 /**
  * @brief    Returns true for structure types that share pool elements.
@@ -56,6 +48,118 @@ Structure_SharesPoolElement(enum StructureType type)
 	     || type == STRUCTURE_WALL);
 }
 
+/**
+ * @brief   Remove a Structure from the house and type index.
+ * @details Introduced.  The next link is kept so that a search
+ *          positioned on this Structure can continue past it.
+ */
+static void
+StructureIndex_Unlink(uint16 index)
+{
+	const enum HouseType houseID = g_game->structureIndexHouse[index];
+	const enum StructureType type = Structure_Get_ByIndex(index)->o.type;
+
+	if (houseID == HOUSE_INVALID)
+		return;
+
+	g_game->structureIndexHouse[index] = HOUSE_INVALID;
+
+	uint16 *link = &g_game->structureIndexHead[houseID][type];
+	while (*link != STRUCTURE_INDEX_INVALID) {
+		if (*link == index) {
+			*link = g_game->structureIndexNext[index];
+			return;
+		}
+
+		link = &g_game->structureIndexNext[*link];
+	}
+
+	assert(false);
+}
+
+/**
+ * @brief   Add a Structure to the house and type index.
+ * @details Introduced.  Keeps each list in g_game->structureFindArray order.
+ */
+static void
+StructureIndex_Link(const Structure *s)
+{
+	const uint16 index = s->o.index;
+	const enum HouseType houseID = s->o.houseID;
+	const enum StructureType type = s->o.type;
+
+	assert(g_game->structureIndexHouse[index] == HOUSE_INVALID);
+
+	if (houseID >= HOUSE_NEUTRAL || type >= STRUCTURE_MAX
+			|| Structure_SharesPoolElement(type))
+		return;
+
+	uint16 *link = &g_game->structureIndexHead[houseID][type];
+	while (*link != STRUCTURE_INDEX_INVALID
+			&& g_game->structureFindOrder[*link] < g_game->structureFindOrder[index]) {
+		link = &g_game->structureIndexNext[*link];
+	}
+
+	g_game->structureIndexNext[index] = *link;
+	g_game->structureIndexHouse[index] = houseID;
+	*link = index;
+}
+
+/**
+ * @brief   Rebuild the house and type index from g_game->structureFindArray.
+ * @details Introduced.
+ */
+static void
+StructureIndex_Rebuild(void)
+{
+	for (int h = 0; h < HOUSE_NEUTRAL; h++) {
+		for (int t = 0; t < STRUCTURE_MAX; t++) {
+			g_game->structureIndexHead[h][t] = STRUCTURE_INDEX_INVALID;
+		}
+	}
+
+	memset(g_game->structureIndexHouse, HOUSE_INVALID, sizeof(g_game->structureIndexHouse));
+
+	for (g_game->structureFindOrderNext = 0;
+			g_game->structureFindOrderNext < g_game->structureFindCount;
+			g_game->structureFindOrderNext++) {
+		const Structure *s = g_game->structureFindArray[g_game->structureFindOrderNext];
+
+		g_game->structureFindOrder[s->o.index] = g_game->structureFindOrderNext;
+		StructureIndex_Link(s);
+	}
+}
+
+/**
+ * @brief   Move a Structure to its house's index after the house changed.
+ * @details Introduced.  Must be called whenever the houseID of an
+ *          allocated Structure is changed outside of the pool.
+ */
+void
+Structure_UpdateIndex(const Structure *s)
+{
+	if (Structure_SharesPoolElement(s->o.type))
+		return;
+
+	if (g_game->structureIndexHouse[s->o.index] == s->o.houseID)
+		return;
+
+	StructureIndex_Unlink(s->o.index);
+	StructureIndex_Link(s);
+}
+
+/**
+ * @brief   Returns the Structure's position in the order visited by
+ *          Structure_FindFirst/Next.
+ * @details Introduced.  Used to break ties the same way as a search
+ *          over all houses when searching one house at a time.
+ */
+uint32
+Structure_GetFindOrder(const Structure *s)
+{
+	return g_game->structureFindOrder[s->o.index];
+}
+
 /**
  * @brief   Get the Structure from the pool with the indicated index.
  * @details f__1082_03A1_0023_9F5D.
@@ -69,11 +173,11 @@ Structure_Get_ByIndex(uint16 index)
 	}
 	assert(index < StructurePool_GetIndex(STRUCTURE_INDEX_MAX_HARD));
 	
-	return &s_structureArray[index];
+	return &g_game->structureArray[index];
 }
 
 /**
- * @brief   Start finding Structures in s_structureFindArray.
+ * @brief   Start finding Structures in g_game->structureFindArray.
  * @details 1082_00FD_003A_D7E0 and f__1082_0110_0027_2707.
  *          Removed global find struct for when find=NULL.
  */
@@ -92,34 +196,70 @@ Structure_FindFirst(PoolFindStruct *find,
 }
 
 /**
- * @brief   Continue finding Structures in s_structureFindArray.
+ * @brief   Continue finding Structures of one house and type.
+ * @details Introduced.  Visits the same Structures in the same order
+ *          as the scan of g_game->structureFindArray.
+ */
+static Structure *
+Structure_FindNextInIndex(PoolFindStruct *find)
+{
+	const uint16 end = STRUCTURE_INDEX_MAX_HARD + STRUCTURE_INDEX_RAISED_AMOUNT;
+	uint16 index;
+
+	if (find->index == end)
+		return NULL;
+
+	index = (find->index == 0xFFFF)
+		? g_game->structureIndexHead[find->houseID][find->type]
+		: g_game->structureIndexNext[find->index];
+
+	for (; index != STRUCTURE_INDEX_INVALID; index = g_game->structureIndexNext[index]) {
+		Structure *s = Structure_Get_ByIndex(index);
+
+		if (s->o.flags.s.isNotOnMap && g_validateStrictIfZero == 0)
+			continue;
+
+		find->index = index;
+		return s;
+	}
+
+	find->index = end;
+	return NULL;
+}
+
+/**
+ * @brief   Continue finding Structures in g_game->structureFindArray.
  * @details f__1082_013D_0038_4AF1 and f__1082_0155_0020_8556.
  *          Removed global find struct for when find=NULL.
  */
 Structure *
 Structure_FindNext(PoolFindStruct *find)
 {
-	if (find->index >= s_structureFindCount + 3 && find->index != 0xFFFF)
+	if (find->houseID != HOUSE_INVALID && find->type != 0xFFFF
+			&& !Structure_SharesPoolElement(find->type))
+		return Structure_FindNextInIndex(find);
+
+	if (find->index >= g_game->structureFindCount + 3 && find->index != 0xFFFF)
 		return NULL;
 
 	/* First, go to the next index. */
 	find->index++;
 
-	assert(s_structureFindCount <= StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT));
-	for (; find->index < s_structureFindCount + 3; find->index++) {
+	assert(g_game->structureFindCount <= StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT));
+	for (; find->index < g_game->structureFindCount + 3; find->index++) {
 		Structure *s = NULL;
 
-		if (find->index < s_structureFindCount) {
-			s = s_structureFindArray[find->index];
-		} else if (find->index == s_structureFindCount + 0) {
+		if (find->index < g_game->structureFindCount) {
+			s = g_game->structureFindArray[find->index];
+		} else if (find->index == g_game->structureFindCount + 0) {
 			s = Structure_Get_ByIndex(StructurePool_GetIndex(STRUCTURE_INDEX_WALL));
 			assert(s->o.index == StructurePool_GetIndex(STRUCTURE_INDEX_WALL)
 			    && s->o.type == STRUCTURE_WALL);
-		} else if (find->index == s_structureFindCount + 1) {
+		} else if (find->index == g_game->structureFindCount + 1) {
 			s = Structure_Get_ByIndex(StructurePool_GetIndex(STRUCTURE_INDEX_SLAB_2x2));
 			assert(s->o.index == StructurePool_GetIndex(STRUCTURE_INDEX_SLAB_2x2)
 			    && s->o.type == STRUCTURE_SLAB_2x2);
-		} else if (find->index == s_structureFindCount + 2) {
+		} else if (find->index == g_game->structureFindCount + 2) {
 			s = Structure_Get_ByIndex(StructurePool_GetIndex(STRUCTURE_INDEX_SLAB_1x1));
 			assert(s->o.index == StructurePool_GetIndex(STRUCTURE_INDEX_SLAB_1x1)
 			    && s->o.type == STRUCTURE_SLAB_1x1);
@@ -143,6 +283,26 @@ Structure_FindNext(PoolFindStruct *find)
 	return NULL;
 }
 
+/**
+ * @brief   Returns the last Structure Structure_FindFirst/Next would
+ *          find over all houses and types, not counting walls and slabs.
+ * @details Introduced.
+ */
+Structure *
+Structure_FindLast(void)
+{
+	for (int i = g_game->structureFindCount - 1; i >= 0; i--) {
+		Structure *s = g_game->structureFindArray[i];
+
+		if (s->o.flags.s.isNotOnMap && g_validateStrictIfZero == 0)
+			continue;
+
+		return s;
+	}
+
+	return NULL;
+}
+
 /**
  * @brief   Initialise the Structure pool.
  * @details f__1082_0098_001C_39E2.
@@ -150,22 +310,25 @@ Structure_FindNext(PoolFindStruct *find)
 void
 Structure_Init(void)
 {
-	memset(s_structureArray, 0, sizeof(s_structureArray));
-	memset(s_structureFindArray, 0, sizeof(s_structureFindArray));
-	s_structureFindCount = 0;
+	memset(g_game->structureArray, 0, sizeof(g_game->structureArray));
+	memset(g_game->structureFindArray, 0, sizeof(g_game->structureFindArray));
+	g_game->structureFindCount = 0;
+	StructureIndex_Rebuild();
 
 	/* ENHANCEMENT -- Ensure the index is always valid. */
 	for (unsigned int i = 0; i < StructurePool_GetIndex(STRUCTURE_INDEX_MAX_HARD); i++) {
-		s_structureArray[i].o.index = i;
+		g_game->structureArray[i].o.index = i;
 	}
 
 	Structure_Allocate(0, STRUCTURE_SLAB_1x1);
 	Structure_Allocate(0, STRUCTURE_SLAB_2x2);
 	Structure_Allocate(0, STRUCTURE_WALL);
+
+	Structure_ResetScriptWheel();
 }
 
 /**
- * @brief   Recount all Structures, rebuilding s_structureFindArray.
+ * @brief   Recount all Structures, rebuilding g_game->structureFindArray.
  * @details f__1082_000F_0012_A3C7.
  */
 void
@@ -181,16 +344,20 @@ Structure_Recount(void)
 	}
 #endif
 
-	s_structureFindCount = 0;
+	Structure_ResetScriptWheel();
+
+	g_game->structureFindCount = 0;
 
 	for (unsigned int i = 0; i < StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT); i++) {
 		Structure *s = Structure_Get_ByIndex(i);
 
 		if (s->o.flags.s.used) {
-			s_structureFindArray[s_structureFindCount] = s;
-			s_structureFindCount++;
+			g_game->structureFindArray[g_game->structureFindCount] = s;
+			g_game->structureFindCount++;
 		}
 	}
+
+	StructureIndex_Rebuild();
 }
 
 /**
@@ -237,9 +404,12 @@ Structure_Allocate(uint16 index, enum StructureType type)
 					return NULL;
 			}
 
-			assert(s_structureFindCount < StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT));
-			s_structureFindArray[s_structureFindCount] = s;
-			s_structureFindCount++;
+			Structure_SyncScriptDelays();
+
+			assert(g_game->structureFindCount < StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT));
+			g_game->structureFindArray[g_game->structureFindCount] = s;
+			g_game->structureFindCount++;
+			g_game->structureFindOrder[index] = g_game->structureFindOrderNext++;
 			break;
 	}
 	assert(s != NULL);
@@ -252,6 +422,11 @@ Structure_Allocate(uint16 index, enum StructureType type)
 	s->o.flags.s.used      = true;
 	s->o.flags.s.allocated = true;
 
+	if (!Structure_SharesPoolElement(type)) {
+		StructureIndex_Link(s);
+		Structure_WakeScript(s);
+	}
+
 	return s;
 }
 
@@ -264,31 +439,35 @@ Structure_Free(Structure *s)
 {
 	unsigned int i;
 
+	Structure_SyncScriptDelays();
+
 	BuildQueue_Free(&s->queue);
 
 	memset(&s->o.flags, 0, sizeof(s->o.flags));
 
-	Script_Reset(&s->o.script, g_scriptStructure);
+	Script_Reset(&s->o.script, &g_scriptStructure);
 
 	if (Structure_SharesPoolElement(s->o.type))
 		return;
 
 	/* Find the Structure to remove. */
-	assert(s_structureFindCount <= StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT));
-	for (i = 0; i < s_structureFindCount; i++) {
-		if (s_structureFindArray[i] == s)
+	assert(g_game->structureFindCount <= StructurePool_GetIndex(STRUCTURE_INDEX_MAX_SOFT));
+	for (i = 0; i < g_game->structureFindCount; i++) {
+		if (g_game->structureFindArray[i] == s)
 			break;
 	}
 
 	/* We should always find an entry. */
-	assert(i < s_structureFindCount);
+	assert(i < g_game->structureFindCount);
 
-	s_structureFindCount--;
+	StructureIndex_Unlink(s->o.index);
+
+	g_game->structureFindCount--;
 
 	/* If needed, close the gap. */
-	if (i < s_structureFindCount) {
-		memmove(&s_structureFindArray[i], &s_structureFindArray[i + 1],
-				(s_structureFindCount - i) * sizeof(s_structureFindArray[0]));
+	if (i < g_game->structureFindCount) {
+		memmove(&g_game->structureFindArray[i], &g_game->structureFindArray[i + 1],
+				(g_game->structureFindCount - i) * sizeof(g_game->structureFindArray[0]));
 	}
 }
 
@@ -305,9 +484,11 @@ StructurePool_Save(void)
 	StructurePool *pool = &s_structurePoolBackup;
 	assert(!pool->allocated);
 
-	memcpy(pool->pool, s_structureArray, sizeof(s_structureArray));
-	memcpy(pool->find, s_structureFindArray, sizeof(s_structureFindArray));
-	pool->count = s_structureFindCount;
+	Structure_SyncScriptDelays();
+
+	memcpy(pool->pool, g_game->structureArray, sizeof(g_game->structureArray));
+	memcpy(pool->find, g_game->structureFindArray, sizeof(g_game->structureFindArray));
+	pool->count = g_game->structureFindCount;
 
 	pool->allocated = true;
 	return pool;
@@ -323,9 +504,12 @@ StructurePool_Load(StructurePool *pool)
 {
 	assert(pool->allocated);
 
-	memcpy(s_structureArray, pool->pool, sizeof(s_structureArray));
-	memcpy(s_structureFindArray, pool->find, sizeof(s_structureFindArray));
-	s_structureFindCount = pool->count;
+	Structure_ResetScriptWheel();
+
+	memcpy(g_game->structureArray, pool->pool, sizeof(g_game->structureArray));
+	memcpy(g_game->structureFindArray, pool->find, sizeof(g_game->structureFindArray));
+	g_game->structureFindCount = pool->count;
+	StructureIndex_Rebuild();
 
 	pool->allocated = false;
 }
@@ -3,6 +3,7 @@
 #ifndef POOL_STRUCTURE_H
 #define POOL_STRUCTURE_H
 
+#include <stddef.h>
 #include "enum_house.h"
 #include "enum_structure.h"
 #include "types.h"
@@ -31,6 +32,9 @@ extern bool Structure_SharesPoolElement(enum StructureType type);
 extern struct Structure *Structure_Get_ByIndex(uint16 index);
 extern struct Structure *Structure_FindFirst(struct PoolFindStruct *find, enum HouseType houseID, enum StructureType type);
 extern struct Structure *Structure_FindNext(struct PoolFindStruct *find);
+extern struct Structure *Structure_FindLast(void);
+extern void Structure_UpdateIndex(const struct Structure *s);
+extern uint32 Structure_GetFindOrder(const struct Structure *s);
 
 extern void Structure_Init(void);
 extern void Structure_Recount(void);
@@ -5,17 +5,15 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "pool_team.h"
 
 #include "pool.h"
+#include "../gamecontext.h"
 #include "../team.h"
 
-enum {
-	TEAM_INDEX_MAX = 16
-};
-
 typedef struct TeamPool {
 	Team pool[TEAM_INDEX_MAX];
 	Team *find[TEAM_INDEX_MAX];
@@ -23,18 +21,9 @@ typedef struct TeamPool {
 	bool allocated;
 } TeamPool;
 
-/** variable_35EE. */
-static Team s_teamArray[TEAM_INDEX_MAX];
-
-/** variable_85DC. */
-static Team *s_teamFindArray[TEAM_INDEX_MAX];
-
-/** variable_35F2. */
-static uint16 s_teamFindCount;
-
-static TeamPool s_teamPoolBackup;
-assert_compile(sizeof(s_teamPoolBackup.pool) == sizeof(s_teamArray));
-assert_compile(sizeof(s_teamPoolBackup.find) == sizeof(s_teamFindArray));
+static THREAD_LOCAL TeamPool s_teamPoolBackup;
+assert_compile(sizeof(s_teamPoolBackup.pool) == sizeof(g_game->teamArray));
+assert_compile(sizeof(s_teamPoolBackup.find) == sizeof(g_game->teamFindArray));
 
 /**
  * @brief   Get the Team from the pool with the indicated index.
@@ -44,11 +33,11 @@ Team *
 Team_Get_ByIndex(uint16 index)
 {
 	assert(index < TEAM_INDEX_MAX);
-	return &s_teamArray[index];
+	return &g_game->teamArray[index];
 }
 
 /**
- * @brief   Start finding Teams in s_teamFindArray.
+ * @brief   Start finding Teams in g_game->teamFindArray.
  * @details f__104B_00C2_0030_20A6 and f__104B_00D5_001D_2B68.
  *          Removed global find struct for when find=NULL.
  */
@@ -65,21 +54,21 @@ Team_FindFirst(PoolFindStruct *find, enum HouseType houseID)
 }
 
 /**
- * @brief   Continue finding Teams in s_teamFindArray.
+ * @brief   Continue finding Teams in g_game->teamFindArray.
  * @details 104B_00F8_002E_3820 and f__104B_0110_0016_6D19.
  *          Removed global find struct for when find=NULL.
  */
 Team *
 Team_FindNext(PoolFindStruct *find)
 {
-	if (find->index >= s_teamFindCount && find->index != 0xFFFF)
+	if (find->index >= g_game->teamFindCount && find->index != 0xFFFF)
 		return NULL;
 
 	/* First, go to the next index. */
 	find->index++;
 
-	for (; find->index < s_teamFindCount; find->index++) {
-		Team *t = s_teamFindArray[find->index];
+	for (; find->index < g_game->teamFindCount; find->index++) {
+		Team *t = g_game->teamFindArray[find->index];
 
 		if (t == NULL)
 			continue;
@@ -98,31 +87,31 @@ Team_FindNext(PoolFindStruct *find)
 void
 Team_Init(void)
 {
-	memset(s_teamArray, 0, sizeof(s_teamArray));
-	memset(s_teamFindArray, 0, sizeof(s_teamFindArray));
-	s_teamFindCount = 0;
+	memset(g_game->teamArray, 0, sizeof(g_game->teamArray));
+	memset(g_game->teamFindArray, 0, sizeof(g_game->teamFindArray));
+	g_game->teamFindCount = 0;
 
 	/* ENHANCEMENT -- Ensure the index is always valid. */
 	for (unsigned int i = 0; i < TEAM_INDEX_MAX; i++) {
-		s_teamArray[i].index = i;
+		g_game->teamArray[i].index = i;
 	}
 }
 
 /**
- * @brief   Recount all Teams, rebuilding s_teamFindArray.
+ * @brief   Recount all Teams, rebuilding g_game->teamFindArray.
  * @details f__104B_0006_0011_631B.
  */
 void
 Team_Recount(void)
 {
-	s_teamFindCount = 0;
+	g_game->teamFindCount = 0;
 
 	for (unsigned int index = 0; index < TEAM_INDEX_MAX; index++) {
 		Team *t = Team_Get_ByIndex(index);
 
 		if (t->flags.used) {
-			s_teamFindArray[s_teamFindCount] = t;
-			s_teamFindCount++;
+			g_game->teamFindArray[g_game->teamFindCount] = t;
+			g_game->teamFindCount++;
 		}
 	}
 }
@@ -160,8 +149,8 @@ Team_Allocate(uint16 index)
 	t->index      = index;
 	t->flags.used = true;
 
-	s_teamFindArray[s_teamFindCount] = t;
-	s_teamFindCount++;
+	g_game->teamFindArray[g_game->teamFindCount] = t;
+	g_game->teamFindCount++;
 
 	return t;
 }
@@ -179,20 +168,20 @@ Team_Free(Team *t)
 	memset(&t->flags, 0, sizeof(t->flags));
 
 	/* Find the Team to remove. */
-	for (i = 0; i < s_teamFindCount; i++) {
-		if (s_teamFindArray[i] == t)
+	for (i = 0; i < g_game->teamFindCount; i++) {
+		if (g_game->teamFindArray[i] == t)
 			break;
 	}
 
 	/* We should always find an entry. */
-	assert(i < s_teamFindCount);
+	assert(i < g_game->teamFindCount);
 
-	s_teamFindCount--;
+	g_game->teamFindCount--;
 
 	/* If needed, close the gap. */
-	if (i < s_teamFindCount) {
-		memmove(&s_teamFindArray[i], &s_teamFindArray[i + 1],
-				(s_teamFindCount - i) * sizeof(s_teamFindArray[0]));
+	if (i < g_game->teamFindCount) {
+		memmove(&g_game->teamFindArray[i], &g_game->teamFindArray[i + 1],
+				(g_game->teamFindCount - i) * sizeof(g_game->teamFindArray[0]));
 	}
 }
 #endif
@@ -210,9 +199,9 @@ TeamPool_Save(void)
 	TeamPool *pool = &s_teamPoolBackup;
 	assert(!pool->allocated);
 
-	memcpy(pool->pool, s_teamArray, sizeof(s_teamArray));
-	memcpy(pool->find, s_teamFindArray, sizeof(s_teamFindArray));
-	pool->count = s_teamFindCount;
+	memcpy(pool->pool, g_game->teamArray, sizeof(g_game->teamArray));
+	memcpy(pool->find, g_game->teamFindArray, sizeof(g_game->teamFindArray));
+	pool->count = g_game->teamFindCount;
 
 	pool->allocated = true;
 	return pool;
@@ -228,9 +217,10 @@ TeamPool_Load(TeamPool *pool)
 {
 	assert(pool->allocated);
 
-	memcpy(s_teamArray, pool->pool, sizeof(s_teamArray));
-	memcpy(s_teamFindArray, pool->find, sizeof(s_teamFindArray));
-	s_teamFindCount = pool->count;
+	memcpy(g_game->teamArray, pool->pool, sizeof(g_game->teamArray));
+	memcpy(g_game->teamFindArray, pool->find, sizeof(g_game->teamFindArray));
+	g_game->teamFindCount = pool->count;
 
 	pool->allocated = false;
 }
+
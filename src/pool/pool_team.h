@@ -3,10 +3,12 @@
 #ifndef POOL_TEAM_H
 #define POOL_TEAM_H
 
+#include <stddef.h>
 #include "enum_house.h"
 #include "types.h"
 
 enum {
+	TEAM_INDEX_MAX = 16,
 	TEAM_INDEX_INVALID = 0xFFFF
 };
 
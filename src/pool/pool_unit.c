@@ -5,11 +5,13 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "pool_unit.h"
 
 #include "pool.h"
+#include "../gamecontext.h"
 #include "pool_house.h"
 #include "../house.h"
 #include "../opendune.h"
@@ -23,18 +25,9 @@ typedef struct UnitPool {
 	bool allocated;
 } UnitPool;
 
-/** variable_35E8. */
-static Unit s_unitArray[UNIT_INDEX_MAX_RAISED];
-
-/** variable_843E. */
-struct Unit *g_unitFindArray[UNIT_INDEX_MAX_RAISED];
-
-/** variable_35EC. */
-uint16 g_unitFindCount;
-
-static UnitPool s_unitPoolBackup;
-assert_compile(sizeof(s_unitPoolBackup.pool) == sizeof(s_unitArray));
-assert_compile(sizeof(s_unitPoolBackup.find) == sizeof(g_unitFindArray));
+static THREAD_LOCAL UnitPool s_unitPoolBackup;
+assert_compile(sizeof(s_unitPoolBackup.pool) == sizeof(g_game->unitArray));
+assert_compile(sizeof(s_unitPoolBackup.find) == sizeof(g_game->unitFindArray));
 
 /**
  * @brief   Get the Unit from the pool with the indicated index.
@@ -44,11 +37,11 @@ Unit *
 Unit_Get_ByIndex(uint16 index)
 {
 	assert(index < UnitPool_GetMaxIndex());
-	return &s_unitArray[index];
+	return &g_game->unitArray[index];
 }
 
 /**
- * @brief   Start finding Units in g_unitFindArray.
+ * @brief   Start finding Units in g_game->unitFindArray.
  * @details f__0FE4_0243_003A_D5F2 and f__0FE4_0256_0027_2707.
  *          Removed global find struct for when find=NULL.
  */
@@ -67,21 +60,21 @@ Unit_FindFirst(PoolFindStruct *find,
 }
 
 /**
- * @brief   Continue finding Units in g_unitFindArray.
+ * @brief   Continue finding Units in g_game->unitFindArray.
  * @details f__0FE4_0283_0038_4950 and f__0FE4_029B_0020_87FE.
  *          Removed global find struct for when find=NULL.
  */
 Unit *
 Unit_FindNext(PoolFindStruct *find)
 {
-	if (find->index >= g_unitFindCount && find->index != 0xFFFF)
+	if (find->index >= g_game->unitFindCount && find->index != 0xFFFF)
 		return NULL;
 
 	/* First, go to the next index. */
 	find->index++;
 
-	for (; find->index < g_unitFindCount; find->index++) {
-		Unit *u = g_unitFindArray[find->index];
+	for (; find->index < g_game->unitFindCount; find->index++) {
+		Unit *u = g_game->unitFindArray[find->index];
 
 		if (u == NULL)
 			continue;
@@ -108,18 +101,20 @@ Unit_FindNext(PoolFindStruct *find)
 void
 Unit_Init(void)
 {
-	memset(s_unitArray, 0, sizeof(s_unitArray));
-	memset(g_unitFindArray, 0, sizeof(g_unitFindArray));
-	g_unitFindCount = 0;
+	memset(g_game->unitArray, 0, sizeof(g_game->unitArray));
+	memset(g_game->unitFindArray, 0, sizeof(g_game->unitFindArray));
+	g_game->unitFindCount = 0;
 
 	/* ENHANCEMENT -- Ensure the index is always valid. */
 	for (unsigned int i = 0; i < UnitPool_GetMaxIndex(); i++) {
-		s_unitArray[i].o.index = i;
+		g_game->unitArray[i].o.index = i;
 	}
+
+	Unit_ResetScriptWheel();
 }
 
 /**
- * @brief   Recount all Units, rebuilding g_unitFindArray.
+ * @brief   Recount all Units, rebuilding g_game->unitFindArray.
  * @details f__0FE4_018D_0012_A3C7.
  */
 void
@@ -127,13 +122,15 @@ Unit_Recount(void)
 {
 	PoolFindStruct find;
 
+	Unit_ResetScriptWheel();
+
 	for (House *h = House_FindFirst(&find, HOUSE_INVALID);
 			h != NULL;
 			h = House_FindNext(&find)) {
 		h->unitCount = 0;
 	}
 
-	g_unitFindCount = 0;
+	g_game->unitFindCount = 0;
 
 	for (unsigned int index = 0; index < UnitPool_GetMaxIndex(); index++) {
 		Unit *u = Unit_Get_ByIndex(index);
@@ -142,8 +139,8 @@ Unit_Recount(void)
 			House *h = House_Get_ByIndex(u->o.houseID);
 			h->unitCount++;
 
-			g_unitFindArray[g_unitFindCount] = u;
-			g_unitFindCount++;
+			g_game->unitFindArray[g_game->unitFindCount] = u;
+			g_game->unitFindCount++;
 		}
 	}
 }
@@ -212,8 +209,9 @@ Unit_Allocate(uint16 index, enum UnitType type, enum HouseType houseID)
 	u->squadID = SQUADID_INVALID;
 	u->aiSquad = SQUADID_INVALID;
 
-	g_unitFindArray[g_unitFindCount] = u;
-	g_unitFindCount++;
+	Unit_WakeScript(u);
+	g_game->unitFindArray[g_game->unitFindCount] = u;
+	g_game->unitFindCount++;
 
 	return u;
 }
@@ -227,28 +225,30 @@ Unit_Free(Unit *u)
 {
 	unsigned int i;
 
+	Unit_SyncScriptDelays();
+
 	memset(&u->o.flags, 0, sizeof(u->o.flags));
 
-	Script_Reset(&u->o.script, g_scriptUnit);
+	Script_Reset(&u->o.script, &g_scriptUnit);
 
 	/* Find the Unit to remove. */
-	for (i = 0; i < g_unitFindCount; i++) {
-		if (g_unitFindArray[i] == u)
+	for (i = 0; i < g_game->unitFindCount; i++) {
+		if (g_game->unitFindArray[i] == u)
 			break;
 	}
 
 	/* We should always find an entry. */
-	assert(i < g_unitFindCount);
+	assert(i < g_game->unitFindCount);
 
-	g_unitFindCount--;
+	g_game->unitFindCount--;
 
 	House *h = House_Get_ByIndex(u->o.houseID);
 	h->unitCount--;
 
 	/* If needed, close the gap. */
-	if (i < g_unitFindCount) {
-		memmove(&g_unitFindArray[i], &g_unitFindArray[i + 1],
-				(g_unitFindCount - i) * sizeof(g_unitFindArray[0]));
+	if (i < g_game->unitFindCount) {
+		memmove(&g_game->unitFindArray[i], &g_game->unitFindArray[i + 1],
+				(g_game->unitFindCount - i) * sizeof(g_game->unitFindArray[0]));
 	}
 }
 
@@ -265,9 +265,11 @@ UnitPool_Save(void)
 	UnitPool *pool = &s_unitPoolBackup;
 	assert(!pool->allocated);
 
-	memcpy(pool->pool, s_unitArray, sizeof(s_unitArray));
-	memcpy(pool->find, g_unitFindArray, sizeof(g_unitFindArray));
-	pool->count = g_unitFindCount;
+	Unit_SyncScriptDelays();
+
+	memcpy(pool->pool, g_game->unitArray, sizeof(g_game->unitArray));
+	memcpy(pool->find, g_game->unitFindArray, sizeof(g_game->unitFindArray));
+	pool->count = g_game->unitFindCount;
 
 	pool->allocated = true;
 	return pool;
@@ -283,9 +285,11 @@ UnitPool_Load(UnitPool *pool)
 {
 	assert(pool->allocated);
 
-	memcpy(s_unitArray, pool->pool, sizeof(s_unitArray));
-	memcpy(g_unitFindArray, pool->find, sizeof(g_unitFindArray));
-	g_unitFindCount = pool->count;
+	Unit_ResetScriptWheel();
+
+	memcpy(g_game->unitArray, pool->pool, sizeof(g_game->unitArray));
+	memcpy(g_game->unitFindArray, pool->find, sizeof(g_game->unitFindArray));
+	g_game->unitFindCount = pool->count;
 
 	pool->allocated = false;
 }
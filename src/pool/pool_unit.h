@@ -3,6 +3,7 @@
 #ifndef POOL_UNIT_H
 #define POOL_UNIT_H
 
+#include <stddef.h>
 #include "enum_house.h"
 #include "enum_unit.h"
 #include "types.h"
@@ -21,9 +22,6 @@ enum {
 struct PoolFindStruct;
 struct Unit;
 
-extern struct Unit *g_unitFindArray[UNIT_INDEX_MAX_RAISED];
-extern uint16 g_unitFindCount;
-
 extern struct Unit *Unit_Get_ByIndex(uint16 index);
 extern struct Unit *Unit_FindFirst(struct PoolFindStruct *find, enum HouseType houseID, enum UnitType type);
 extern struct Unit *Unit_FindNext(struct PoolFindStruct *find);
@@ -0,0 +1,166 @@
+/**
+ * @file src/profile.c
+ *
+ * Frame profiler.  Only built with WITH_PROFILER.
+ *
+ * Each zone accumulates its exclusive time, i.e. minus the time spent
+ * in zones nested inside it, so that the zones of a frame add up to
+ * the time spent in instrumented code.  The last PROFILE_HISTORY
+ * frames are kept for the overlay, and the last PROFILE_EVENTS_MAX
+ * zones are kept for the trace.
+ */
+
+#include <allegro5/allegro.h>
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "os/common.h"
+
+#include "profile.h"
+
+#include "file.h"
+#include "types.h"
+
+enum {
+	PROFILE_STACK_MAX = 16,
+	PROFILE_EVENTS_MAX = 65536
+};
+
+typedef struct ProfileEvent {
+	uint8 zone;
+	double start;
+	double duration;
+} ProfileEvent;
+
+static const char * const s_profile_zone_name[PROFILE_ZONE_MAX] = {
+	"Squads", "Teams", "Units", "Structures", "Houses", "Explosions",
+	"Animations", "Unit sort", "Net send",
+	"Interface", "Tiles", "Units", "Explosions", "Fog", "Air units",
+	"Minimap", "Flip",
+};
+
+static struct {
+	enum ProfileZone zone;
+	double start;
+	double child;
+} s_profile_stack[PROFILE_STACK_MAX];
+
+static int s_profile_depth;
+static double s_profile_frame[PROFILE_ZONE_MAX];
+static double s_profile_history[PROFILE_HISTORY][PROFILE_ZONE_MAX];
+static int s_profile_history_head;
+
+static ProfileEvent s_profile_event[PROFILE_EVENTS_MAX];
+static unsigned int s_profile_event_count;
+
+/*--------------------------------------------------------------*/
+
+void
+Profile_Begin(enum ProfileZone zone)
+{
+	if (s_profile_depth < PROFILE_STACK_MAX) {
+		s_profile_stack[s_profile_depth].zone = zone;
+		s_profile_stack[s_profile_depth].start = al_get_time();
+		s_profile_stack[s_profile_depth].child = 0.0;
+	}
+
+	s_profile_depth++;
+}
+
+void
+Profile_End(enum ProfileZone zone)
+{
+	s_profile_depth--;
+	assert(s_profile_depth >= 0);
+
+	if (s_profile_depth >= PROFILE_STACK_MAX)
+		return;
+
+	assert(s_profile_stack[s_profile_depth].zone == zone);
+
+	const double start = s_profile_stack[s_profile_depth].start;
+	const double duration = al_get_time() - start;
+
+	s_profile_frame[zone] += duration - s_profile_stack[s_profile_depth].child;
+
+	if (s_profile_depth > 0)
+		s_profile_stack[s_profile_depth - 1].child += duration;
+
+	ProfileEvent *e = &s_profile_event[s_profile_event_count % PROFILE_EVENTS_MAX];
+	e->zone = zone;
+	e->start = start;
+	e->duration = duration;
+	s_profile_event_count++;
+}
+
+void
+Profile_EndFrame(void)
+{
+	memcpy(s_profile_history[s_profile_history_head], s_profile_frame, sizeof(s_profile_frame));
+	memset(s_profile_frame, 0, sizeof(s_profile_frame));
+
+	s_profile_history_head = (s_profile_history_head + 1) % PROFILE_HISTORY;
+}
+
+/**
+ * @brief   Exclusive time spent in a zone during a past frame.
+ * @param   frame 0 for the oldest frame, PROFILE_HISTORY - 1 for the latest.
+ * @return  Time in seconds.
+ */
+double
+Profile_GetFrameTime(int frame, enum ProfileZone zone)
+{
+	assert(0 <= frame && frame < PROFILE_HISTORY);
+
+	return s_profile_history[(s_profile_history_head + frame) % PROFILE_HISTORY][zone];
+}
+
+const char *
+Profile_GetZoneName(enum ProfileZone zone)
+{
+	return s_profile_zone_name[zone];
+}
+
+/**
+ * @brief   Writes the recorded zones as Chrome trace JSON.
+ * @details The file is written to the personal data directory, and can
+ *          be opened in chrome://tracing or Perfetto.
+ */
+bool
+Profile_WriteTrace(void)
+{
+	char filename[64];
+	char filepath[PATH_MAX];
+	const time_t timep = time(NULL);
+	const struct tm *tm = localtime(&timep);
+
+	strftime(filename, sizeof(filename), "trace_%Y%m%d_%H%M%S.json", tm);
+	snprintf(filepath, sizeof(filepath), "%s/%s", g_personal_data_dir, filename);
+
+	FILE *fp = fopen(filepath, "w");
+	if (fp == NULL)
+		return false;
+
+	const unsigned int count = (s_profile_event_count < PROFILE_EVENTS_MAX)
+		? s_profile_event_count : PROFILE_EVENTS_MAX;
+	const unsigned int first = s_profile_event_count - count;
+
+	fprintf(fp, "{\"traceEvents\":[\n");
+
+	for (unsigned int i = 0; i < count; i++) {
+		const ProfileEvent *e = &s_profile_event[(first + i) % PROFILE_EVENTS_MAX];
+
+		fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.1f,\"dur\":%.1f}\n",
+				(i == 0) ? "" : ",",
+				s_profile_zone_name[e->zone],
+				(e->zone < PROFILE_DRAW_INTERFACE) ? "logic" : "draw",
+				1e6 * e->start, 1e6 * e->duration);
+	}
+
+	fprintf(fp, "]}\n");
+	fclose(fp);
+
+	fprintf(stdout, "trace: %s\n", filepath);
+	return true;
+}
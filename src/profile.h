@@ -0,0 +1,67 @@
+/** @file src/profile.h Frame profiler definitions. */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include "buildcfg.h"
+
+enum ProfileZone {
+	PROFILE_LOGIC_SQUADS,
+	PROFILE_LOGIC_TEAMS,
+	PROFILE_LOGIC_UNITS,
+	PROFILE_LOGIC_STRUCTURES,
+	PROFILE_LOGIC_HOUSES,
+	PROFILE_LOGIC_EXPLOSIONS,
+	PROFILE_LOGIC_ANIMATIONS,
+	PROFILE_LOGIC_UNIT_SORT,
+	PROFILE_NET_SEND,
+
+	PROFILE_DRAW_INTERFACE,
+	PROFILE_DRAW_TILES,
+	PROFILE_DRAW_UNITS,
+	PROFILE_DRAW_EXPLOSIONS,
+	PROFILE_DRAW_FOG,
+	PROFILE_DRAW_AIR_UNITS,
+	PROFILE_DRAW_MINIMAP,
+	PROFILE_DRAW_FLIP,
+
+	PROFILE_ZONE_MAX
+};
+
+enum {
+	PROFILE_HISTORY = 120
+};
+
+/* PROFILE(ZONE, STATEMENT) times STATEMENT as ZONE, and
+ * PROFILE_BEGIN/PROFILE_END time a block.  Without WITH_PROFILER, or
+ * in the dedicated server, they leave nothing but the statement behind.
+ */
+#if defined(WITH_PROFILER) && !defined(DEDICATED_SERVER)
+
+#define PROFILE(ZONE, ...)	\
+	do { Profile_Begin(ZONE); __VA_ARGS__; Profile_End(ZONE); } while (false)
+
+#define PROFILE_BEGIN(ZONE)	Profile_Begin(ZONE)
+#define PROFILE_END(ZONE)	Profile_End(ZONE)
+#define PROFILE_END_FRAME()	Profile_EndFrame()
+
+extern void Profile_Begin(enum ProfileZone zone);
+extern void Profile_End(enum ProfileZone zone);
+extern void Profile_EndFrame(void);
+extern double Profile_GetFrameTime(int frame, enum ProfileZone zone);
+extern const char *Profile_GetZoneName(enum ProfileZone zone);
+extern bool Profile_WriteTrace(void);
+
+#else
+
+#define PROFILE(ZONE, ...)	\
+	do { __VA_ARGS__; } while (false)
+
+#define PROFILE_BEGIN(ZONE)	do {} while (false)
+#define PROFILE_END(ZONE)	do {} while (false)
+#define PROFILE_END_FRAME()	do {} while (false)
+
+#endif /* WITH_PROFILER && !DEDICATED_SERVER */
+
+#endif /* PROFILE_H */
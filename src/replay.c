@@ -0,0 +1,705 @@
+/**
+ * @file src/replay.c
+ *
+ * Replay recording and playback.
+ *
+ * A replay is an ordinary savegame of the state at the start of the
+ * game loop, followed by a 'DDRP' chunk.  The chunk holds the timers,
+ * RNG state and host settings needed to resume the simulation exactly,
+ * then a stream of records describing every server step:
+ *
+ *   STEP n          One step, n ticks after the previous one.
+ *   RUN n           n consecutive steps, one tick apart.
+ *   RANDOM ...      RNG state at the start of the step.
+ *   SPEED s         Game speed from the start of the step.
+ *   MESSAGE h n ... Client-server message from house h.
+ *   END             End of the replay.
+ *
+ * RANDOM, SPEED and MESSAGE records apply to the step (or the last
+ * step of the run) before them.  The stream is consumed while playing,
+ * so playback only ever buffers a single message.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "errorlog.h"
+#include "gamecontext.h"
+#include "multichar.h"
+#include "types.h"
+#include "os/common.h"
+#include "os/endian.h"
+
+#include "replay.h"
+
+#include "config.h"
+#include "file.h"
+#include "load.h"
+#include "mods/multiplayer.h"
+#include "net/net.h"
+#include "net/server.h"
+#include "opendune.h"
+#include "save.h"
+#include "scenario.h"
+#include "timer/timer.h"
+#include "tools/random_general.h"
+#include "tools/random_lcg.h"
+#include "tools/random_starport.h"
+
+#define REPLAY_FILENAME         "replay.rpl"
+#define REPLAY_VERSION          1
+
+/* Chunk length written while recording.  It is patched when the
+ * recording stops, and keeps Load_Main from reading the records as
+ * chunks if it never was.
+ */
+#define REPLAY_PROVISIONAL_LEN  0x7FFFFFFE
+
+enum ReplayRecord {
+	REPLAY_RECORD_END       = 0x00,
+	REPLAY_RECORD_STEP      = 0x01,
+	REPLAY_RECORD_RUN       = 0x02,
+	REPLAY_RECORD_RANDOM    = 0x03,
+	REPLAY_RECORD_SPEED     = 0x04,
+	REPLAY_RECORD_MESSAGE   = 0x05
+};
+
+typedef struct ReplayRandom {
+	uint32 general;
+	uint32 lcg;
+	uint16 starportInitialSeed;
+	uint32 starport;
+} ReplayRandom;
+
+THREAD_LOCAL bool g_record_replay = false;
+
+/* The game timers, as offsets into the game context. */
+static const size_t s_replay_timer[] = {
+	offsetof(GameContext, timerGame),
+	offsetof(GameContext, tickScenarioStart),
+	offsetof(GameContext, tickHousePowerMaintenance),
+	offsetof(GameContext, tickHouseHouse),
+	offsetof(GameContext, tickHouseStarport),
+	offsetof(GameContext, tickHouseReinforcement),
+	offsetof(GameContext, tickHouseMissileCountdown),
+	offsetof(GameContext, tickHouseStarportAvailability),
+	offsetof(GameContext, tickHouseStarportRecalculatePrices),
+	offsetof(GameContext, tickStructureDegrade),
+	offsetof(GameContext, tickStructureStructure),
+	offsetof(GameContext, tickStructureScript),
+	offsetof(GameContext, tickStructurePalace),
+	offsetof(GameContext, tickTeamGameLoop),
+	offsetof(GameContext, tickUnitMovement),
+	offsetof(GameContext, tickUnitRotation),
+	offsetof(GameContext, tickUnitBlinking),
+	offsetof(GameContext, tickUnitUnknown4),
+	offsetof(GameContext, tickUnitScript),
+	offsetof(GameContext, tickUnitUnknown5),
+	offsetof(GameContext, tickUnitDeviation)
+};
+
+static THREAD_LOCAL struct {
+	FILE *fp;
+	long chunk_start;
+
+	bool recording;
+	bool playing;
+	bool fast_forward;
+	char filename[1024];
+
+	int64_t last_tick;
+	uint32 pending_run;
+	uint32 run_remaining;
+	ReplayRandom random;
+	int game_speed;
+
+	/* Settings of the recorded game, emulated during playback. */
+	enum NetHostType host_type;
+	enum HouseFlag client_houses;
+	uint32 curr_seed;
+	enum MapLoseCondition lose_condition;
+	enum MultiplayerHouseState state[HOUSE_NEUTRAL];
+	int saved_game_speed;
+} s_replay;
+
+/*--------------------------------------------------------------*/
+
+static int64_t *
+Replay_Timer(unsigned int i)
+{
+	return (int64_t *)((char *)g_game + s_replay_timer[i]);
+}
+
+static void
+Replay_GetRandom(ReplayRandom *r)
+{
+	r->general = Tools_Random_GetState();
+	r->lcg = Tools_RandomLCG_GetState();
+	r->starportInitialSeed = Random_Starport_GetInitialSeed();
+	r->starport = Random_Starport_GetState();
+}
+
+static void
+Replay_SetRandom(const ReplayRandom *r)
+{
+	Tools_Random_Seed(r->general);
+	Tools_RandomLCG_SetState(r->lcg);
+	Random_Starport_SetState(r->starportInitialSeed, r->starport);
+}
+
+static bool
+Replay_RandomEquals(const ReplayRandom *a, const ReplayRandom *b)
+{
+	return (a->general == b->general)
+		&& (a->lcg == b->lcg)
+		&& (a->starportInitialSeed == b->starportInitialSeed)
+		&& (a->starport == b->starport);
+}
+
+/*--------------------------------------------------------------*/
+
+static void
+Replay_WriteVarint(uint32 value, FILE *fp)
+{
+	while (value >= 0x80) {
+		fputc(0x80 | (value & 0x7F), fp);
+		value >>= 7;
+	}
+
+	fputc(value, fp);
+}
+
+static bool
+Replay_ReadVarint(uint32 *value, FILE *fp)
+{
+	*value = 0;
+
+	for (int shift = 0; shift < 32; shift += 7) {
+		const int c = fgetc(fp);
+		if (c == EOF)
+			return false;
+
+		*value |= (uint32)(c & 0x7F) << shift;
+		if ((c & 0x80) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+static void
+Replay_WriteInt64(int64_t value, FILE *fp)
+{
+	fwrite_le_uint32((uint32)value, fp);
+	fwrite_le_uint32((uint32)((uint64_t)value >> 32), fp);
+}
+
+static bool
+Replay_ReadInt64(int64_t *value, FILE *fp)
+{
+	uint32 lo, hi;
+
+	if (!fread_le_uint32(&lo, fp)) return false;
+	if (!fread_le_uint32(&hi, fp)) return false;
+
+	*value = (int64_t)(((uint64_t)hi << 32) | lo);
+	return true;
+}
+
+static void
+Replay_WriteRandom(const ReplayRandom *r, FILE *fp)
+{
+	fwrite_le_uint32(r->general, fp);
+	fwrite_le_uint32(r->lcg, fp);
+	fwrite_le_uint16(r->starportInitialSeed, fp);
+	fwrite_le_uint32(r->starport, fp);
+}
+
+static bool
+Replay_ReadRandom(ReplayRandom *r, FILE *fp)
+{
+	return fread_le_uint32(&r->general, fp)
+		&& fread_le_uint32(&r->lcg, fp)
+		&& fread_le_uint16(&r->starportInitialSeed, fp)
+		&& fread_le_uint32(&r->starport, fp);
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Writes the state that a savegame does not capture.
+ * @details Campaign must come first, as it is needed before the
+ *          savegame part of the replay can be loaded.
+ */
+static void
+Replay_WriteHeader(FILE *fp)
+{
+	fwrite_le_uint16(REPLAY_VERSION, fp);
+	fputc(g_campaign_selected, fp);
+	fputc(g_host_type, fp);
+	fputc(g_client_houses, fp);
+	fputc(g_gameConfig.gameSpeed, fp);
+	fwrite_le_uint32(g_multiplayer.curr_seed, fp);
+	fputc(g_multiplayer.lose_condition, fp);
+
+	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++) {
+		fputc(g_multiplayer.state[h], fp);
+	}
+
+	fputc(lengthof(s_replay_timer), fp);
+	for (unsigned int i = 0; i < lengthof(s_replay_timer); i++) {
+		Replay_WriteInt64(*Replay_Timer(i), fp);
+	}
+
+	Replay_GetRandom(&s_replay.random);
+	Replay_WriteRandom(&s_replay.random, fp);
+}
+
+static bool
+Replay_ReadHeader(FILE *fp)
+{
+	uint16 version;
+	int c;
+
+	if (!fread_le_uint16(&version, fp)) return false;
+	if (version != REPLAY_VERSION) {
+		Error("Unsupported replay version %d.\n", version);
+		return false;
+	}
+
+	c = fgetc(fp);
+	if (c == EOF || c >= g_campaign_total) return false;
+	g_campaign_selected = c;
+
+	if ((c = fgetc(fp)) == EOF) return false;
+	s_replay.host_type = c;
+
+	if ((c = fgetc(fp)) == EOF) return false;
+	s_replay.client_houses = c;
+
+	if ((c = fgetc(fp)) == EOF) return false;
+	s_replay.game_speed = c;
+
+	if (!fread_le_uint32(&s_replay.curr_seed, fp)) return false;
+
+	if ((c = fgetc(fp)) == EOF) return false;
+	s_replay.lose_condition = c;
+
+	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++) {
+		if ((c = fgetc(fp)) == EOF) return false;
+		s_replay.state[h] = c;
+	}
+
+	return true;
+}
+
+/**
+ * @brief   Reads the timers and RNG state following the header.
+ * @details These are read only once the savegame has been loaded and
+ *          the scenario started, since both reset them.
+ */
+static bool
+Replay_ReadTimers(FILE *fp)
+{
+	const int count = fgetc(fp);
+
+	if (count != lengthof(s_replay_timer))
+		return false;
+
+	for (int i = 0; i < count; i++) {
+		if (!Replay_ReadInt64(Replay_Timer(i), fp))
+			return false;
+	}
+
+	return Replay_ReadRandom(&s_replay.random, fp);
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Plays back the replay instead of entering the menu.
+ * @details The filename is relative to the personal data directory,
+ *          like savegames.
+ */
+void
+Replay_SetPlaybackFile(const char *filename, bool fast_forward)
+{
+	snprintf(s_replay.filename, sizeof(s_replay.filename), "%s", filename);
+	s_replay.fast_forward = fast_forward;
+}
+
+bool
+Replay_IsPlaybackPending(void)
+{
+	return (s_replay.filename[0] != '\0');
+}
+
+/**
+ * @brief   Loads the savegame part of the replay, and leaves the file
+ *          open at the start of the timers.
+ */
+bool
+Replay_LoadPlayback(void)
+{
+	char filename[sizeof(s_replay.filename)];
+	uint32 header;
+	uint32 length;
+	bool found = false;
+
+	snprintf(filename, sizeof(filename), "%s", s_replay.filename);
+	s_replay.filename[0] = '\0';
+
+	FILE *fp = File_Open_CaseInsensitive(SEARCHDIR_PERSONAL_DATA_DIR, filename, "rb");
+	if (fp == NULL) {
+		Error("Failed to open replay.\n");
+		return false;
+	}
+
+	/* Skip 'FORM', its length, and 'SCEN', then walk the chunks. */
+	fseek(fp, 12, SEEK_SET);
+	while (fread(&header, sizeof(uint32), 1, fp) == 1) {
+		if (fread(&length, sizeof(uint32), 1, fp) != 1)
+			break;
+
+		length = BETOH32(length);
+		if (BETOH32(header) == CC_DDRP) {
+			found = true;
+			break;
+		}
+
+		fseek(fp, length + (length & 1), SEEK_CUR);
+	}
+
+	if (!found || !Replay_ReadHeader(fp)) {
+		Error("Invalid replay.\n");
+		fclose(fp);
+		return false;
+	}
+
+	LoadFile(filename);
+
+	if (g_gameMode == GM_RESTART) {
+		fclose(fp);
+		return false;
+	}
+
+	g_multiplayer.curr_seed = s_replay.curr_seed;
+	g_multiplayer.lose_condition = s_replay.lose_condition;
+	memcpy(g_multiplayer.state, s_replay.state, sizeof(g_multiplayer.state));
+
+	s_replay.fp = fp;
+	return true;
+}
+
+bool
+Replay_IsPlaying(void)
+{
+	return s_replay.playing;
+}
+
+bool
+Replay_IsFastForward(void)
+{
+	return s_replay.fast_forward;
+}
+
+/**
+ * @brief   Starts recording, or playing back a loaded replay.
+ * @details Called once the scenario is set up, just before the game
+ *          loop.  Recording is not done by dedicated clients since
+ *          they do not run the simulation.
+ */
+void
+Replay_Start(void)
+{
+	if (s_replay.fp != NULL) {
+		if (!Replay_ReadTimers(s_replay.fp)) {
+			Error("Invalid replay.\n");
+			fclose(s_replay.fp);
+			s_replay.fp = NULL;
+			g_gameMode = GM_QUITGAME;
+			return;
+		}
+
+		Replay_SetRandom(&s_replay.random);
+		s_replay.saved_game_speed = g_gameConfig.gameSpeed;
+		g_gameConfig.gameSpeed = s_replay.game_speed;
+		s_replay.last_tick = g_game->timerGame;
+		s_replay.run_remaining = 0;
+		s_replay.playing = true;
+		return;
+	}
+
+	if (!g_record_replay || g_host_type == HOSTTYPE_DEDICATED_CLIENT)
+		return;
+
+	if (!SaveFile(REPLAY_FILENAME, "Replay"))
+		return;
+
+	FILE *fp = File_Open_CaseInsensitive(SEARCHDIR_PERSONAL_DATA_DIR, REPLAY_FILENAME, "r+b");
+	if (fp == NULL)
+		return;
+
+	fseek(fp, 0, SEEK_END);
+	s_replay.chunk_start = ftell(fp);
+
+	const uint32 lengthSwapped = HTOBE32(REPLAY_PROVISIONAL_LEN);
+	fwrite("DDRP", 4, 1, fp);
+	fwrite(&lengthSwapped, 4, 1, fp);
+	Replay_WriteHeader(fp);
+
+	s_replay.fp = fp;
+	s_replay.last_tick = g_game->timerGame;
+	s_replay.pending_run = 0;
+	s_replay.game_speed = g_gameConfig.gameSpeed;
+	s_replay.recording = true;
+}
+
+static void
+Replay_FlushRun(void)
+{
+	if (s_replay.pending_run == 0)
+		return;
+
+	fputc(REPLAY_RECORD_RUN, s_replay.fp);
+	Replay_WriteVarint(s_replay.pending_run, s_replay.fp);
+	s_replay.pending_run = 0;
+}
+
+void
+Replay_Stop(void)
+{
+	if (s_replay.recording) {
+		FILE *fp = s_replay.fp;
+
+		Replay_FlushRun();
+		fputc(REPLAY_RECORD_END, fp);
+
+		/* Patch the chunk and FORM lengths, keeping word alignment. */
+		uint32 length = ftell(fp) - s_replay.chunk_start - 8;
+		if (length & 1)
+			fputc(0, fp);
+
+		const uint32 form_length = ftell(fp) - 8;
+		uint32 lengthSwapped;
+
+		fseek(fp, s_replay.chunk_start + 4, SEEK_SET);
+		lengthSwapped = HTOBE32(length);
+		fwrite(&lengthSwapped, 4, 1, fp);
+
+		fseek(fp, 4, SEEK_SET);
+		lengthSwapped = HTOBE32(form_length);
+		fwrite(&lengthSwapped, 4, 1, fp);
+
+		s_replay.recording = false;
+	} else if (s_replay.playing) {
+		g_gameConfig.gameSpeed = s_replay.saved_game_speed;
+		s_replay.playing = false;
+	}
+
+	if (s_replay.fp != NULL) {
+		fclose(s_replay.fp);
+		s_replay.fp = NULL;
+	}
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Records the start of a server step.
+ * @details Called after g_game->timerGame has advanced, before any client
+ *          messages are processed.  The RNG is only recorded when
+ *          something other than the simulation has used it since
+ *          the last step.
+ */
+void
+Replay_RecordStep(void)
+{
+	if (!s_replay.recording)
+		return;
+
+	FILE *fp = s_replay.fp;
+	const int64_t delta = g_game->timerGame - s_replay.last_tick;
+	s_replay.last_tick = g_game->timerGame;
+
+	if (delta == 1) {
+		s_replay.pending_run++;
+	} else {
+		Replay_FlushRun();
+		fputc(REPLAY_RECORD_STEP, fp);
+		Replay_WriteVarint(delta, fp);
+	}
+
+	ReplayRandom curr;
+	Replay_GetRandom(&curr);
+	if (!Replay_RandomEquals(&curr, &s_replay.random)) {
+		Replay_FlushRun();
+		fputc(REPLAY_RECORD_RANDOM, fp);
+		Replay_WriteRandom(&curr, fp);
+	}
+
+	if (g_gameConfig.gameSpeed != s_replay.game_speed) {
+		s_replay.game_speed = g_gameConfig.gameSpeed;
+
+		Replay_FlushRun();
+		fputc(REPLAY_RECORD_SPEED, fp);
+		fputc(s_replay.game_speed, fp);
+	}
+}
+
+/**
+ * @brief   Records a client-server message.
+ * @details buf includes the message type.  Lobby messages are bound
+ *          to the peer rather than the house and do not affect the
+ *          simulation, so they are left out.
+ */
+void
+Replay_RecordMessage(enum HouseType houseID, enum ClientServerMsg msg,
+		const unsigned char *buf, int len)
+{
+	if (!s_replay.recording)
+		return;
+
+	if (msg == CSMSG_PREFERRED_NAME
+	 || msg == CSMSG_PREFERRED_HOUSE
+	 || msg == CSMSG_CHAT)
+		return;
+
+	Replay_FlushRun();
+	fputc(REPLAY_RECORD_MESSAGE, s_replay.fp);
+	fputc(houseID, s_replay.fp);
+	Replay_WriteVarint(len, s_replay.fp);
+	fwrite(buf, len, 1, s_replay.fp);
+}
+
+/**
+ * @brief   Marks the end of a server step.
+ * @details Playback also restores the local host settings here, so
+ *          that nothing is sent and the UI behaves as in single player.
+ */
+void
+Replay_EndStep(void)
+{
+	if (s_replay.recording) {
+		Replay_GetRandom(&s_replay.random);
+	} else if (s_replay.playing) {
+		Replay_GetRandom(&s_replay.random);
+		s_replay.client_houses = g_client_houses;
+
+		g_host_type = HOSTTYPE_NONE;
+		g_client_houses = 0;
+		memset(g_server2client_message_len, 0, sizeof(g_server2client_message_len));
+	}
+}
+
+static bool
+Replay_PlaybackRecord(int c)
+{
+	FILE *fp = s_replay.fp;
+
+	switch (c) {
+		case REPLAY_RECORD_RANDOM:
+			if (!Replay_ReadRandom(&s_replay.random, fp))
+				return false;
+
+			Replay_SetRandom(&s_replay.random);
+			return true;
+
+		case REPLAY_RECORD_SPEED:
+			if ((c = fgetc(fp)) == EOF)
+				return false;
+
+			s_replay.game_speed = c;
+			g_gameConfig.gameSpeed = c;
+			return true;
+
+		case REPLAY_RECORD_MESSAGE:
+			{
+				unsigned char buf[256];
+				const int houseID = fgetc(fp);
+				uint32 len;
+
+				if (houseID == EOF || houseID >= HOUSE_NEUTRAL)
+					return false;
+
+				if (!Replay_ReadVarint(&len, fp) || len > sizeof(buf))
+					return false;
+
+				if (fread(buf, len, 1, fp) != 1)
+					return false;
+
+				Server_ProcessMessage(0, houseID, buf, len);
+			}
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief   Starts the next recorded server step.
+ * @details Restores the timer, RNG, game speed and host settings, then
+ *          feeds the step's client messages to the server.  The caller
+ *          runs the server logic and then calls Replay_EndStep.
+ * @return  False at the end of the replay.
+ */
+bool
+Replay_PlaybackStep(void)
+{
+	FILE *fp = s_replay.fp;
+	uint32 delta = 1;
+
+	if (!s_replay.playing)
+		return false;
+
+	/* Commands issued while watching are ignored. */
+	g_client2server_message_len = 0;
+
+	if (s_replay.run_remaining > 0) {
+		s_replay.run_remaining--;
+	} else {
+		const int c = fgetc(fp);
+
+		if (c == REPLAY_RECORD_STEP) {
+			if (!Replay_ReadVarint(&delta, fp))
+				return false;
+		} else if (c == REPLAY_RECORD_RUN) {
+			if (!Replay_ReadVarint(&s_replay.run_remaining, fp) || s_replay.run_remaining == 0)
+				return false;
+
+			s_replay.run_remaining--;
+		} else {
+			return false;
+		}
+	}
+
+	g_game->timerGame = s_replay.last_tick + delta;
+	s_replay.last_tick = g_game->timerGame;
+
+	Replay_SetRandom(&s_replay.random);
+	g_gameConfig.gameSpeed = s_replay.game_speed;
+	g_host_type = s_replay.host_type;
+	g_client_houses = s_replay.client_houses;
+
+	if (s_replay.run_remaining == 0) {
+		int c;
+
+		while ((c = fgetc(fp)) != EOF) {
+			if (c == REPLAY_RECORD_END
+			 || c == REPLAY_RECORD_STEP
+			 || c == REPLAY_RECORD_RUN) {
+				ungetc(c, fp);
+				break;
+			}
+
+			if (!Replay_PlaybackRecord(c)) {
+				Error("Faulty record in replay.\n");
+				Replay_EndStep();
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,25 @@
+/** @file src/replay.h Replay recording and playback definitions. */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "enumeration.h"
+#include "types.h"
+#include "net/message.h"
+
+extern THREAD_LOCAL bool g_record_replay;
+
+extern void Replay_SetPlaybackFile(const char *filename, bool fast_forward);
+extern bool Replay_IsPlaybackPending(void);
+extern bool Replay_LoadPlayback(void);
+extern bool Replay_IsPlaying(void);
+extern bool Replay_IsFastForward(void);
+extern void Replay_Start(void);
+extern void Replay_Stop(void);
+
+extern void Replay_RecordStep(void);
+extern void Replay_RecordMessage(enum HouseType houseID, enum ClientServerMsg msg, const unsigned char *buf, int len);
+extern void Replay_EndStep(void);
+extern bool Replay_PlaybackStep(void);
+
+#endif /* REPLAY_H */
@@ -1,5 +1,6 @@
 /** @file src/save.c Save routines. */
 
+#include <allegro5/allegro.h>
 #include <stdio.h>
 #include <string.h>
 #include "errorlog.h"
@@ -8,7 +9,9 @@
 #include "save.h"
 
 #include "ai.h"
+#include "buildqueue.h"
 #include "file.h"
+#include "gamecontext.h"
 #include "house.h"
 #include "map.h"
 #include "newui/menubar.h"
@@ -27,6 +30,25 @@
 #include "team.h"
 #include "unit.h"
 
+typedef struct SaveJob {
+	char filepath[1024];
+	char description[256];
+	bool skirmish;
+
+	/* A copy of the game, with build queues of its own. */
+	GameContext *context;
+	BuildQueueItem *queue_item;
+	int max_queue_items;
+
+	bool ok;
+} SaveJob;
+
+/* Minutes of game time between autosaves, or 0 to disable. */
+int g_autosave_interval = 0;
+
+static ALLEGRO_THREAD *s_save_thread;
+static SaveJob s_save_job;
+
 /**
  * Save a chunk of data.
  * @param fp The file to save to.
@@ -66,16 +88,34 @@ static bool Save_Chunk(FILE *fp, const char *header, bool (*saveProc)(FILE *fp))
 	return true;
 }
 
+/**
+ * Gather the state that is saved from outside the game context.  Runs on
+ *  the game's thread, before Save_Main.
+ */
+static void
+Save_Prepare(void)
+{
+	/* Sleeping scripts keep their delays in the timer wheels. */
+	Unit_SyncScriptDelays();
+	Structure_SyncScriptDelays();
+
+	Info_Save_Prepare();
+	Map_Save_Prepare();
+	Scenario_Save_Prepare();
+}
+
 /**
  * Save the game for real. It creates all the required chunks and stores them
- *  to the file. It updates the field lengths where needed.
+ *  to the file. It updates the field lengths where needed.  Reads only the
+ *  game context and what Save_Prepare gathered.
  *
  * @param fp The file to save to.
  * @param description The description of the savegame.
+ * @param skirmish Whether the game is a skirmish.
  * @return True if and only if all bytes were written successful.
  */
 static bool
-Save_Main(FILE *fp, const char *description)
+Save_Main(FILE *fp, const char *description, bool skirmish)
 {
 	uint32 length;
 	uint32 lengthSwapped;
@@ -111,7 +151,7 @@ Save_Main(FILE *fp, const char *description)
 	if (!Save_Chunk(fp, "ODUN", &UnitNew_Save)) return false;
 
 	/* Store Dune Dynasty extensions. */
-	if (g_campaign_selected == CAMPAIGNID_SKIRMISH) {
+	if (skirmish) {
 		if (!Save_Chunk(fp, "DDS2", &Scenario_Save2)) return false;
 	}
 
@@ -132,19 +172,9 @@ Save_Main(FILE *fp, const char *description)
 	return true;
 }
 
-/**
- * Save the game to a filename
- *
- * @param fp The filename of the savegame.
- * @param description The description of the savegame.
- * @return True if and only if all bytes were written successful.
- */
-bool
-SaveFile(const char *filename, const char *description)
+static void
+Save_CoverDebugScenario(void)
 {
-	FILE *fp;
-	bool res;
-
 	/* In debug-scenario mode, the whole map is uncovered. Cover it now in
 	 *  the savegame based on the current position of the units and
 	 *  structures. */
@@ -154,7 +184,7 @@ SaveFile(const char *filename, const char *description)
 
 		/* Add fog of war for all tiles on the map */
 		for (i = 0; i < 0x1000; i++) {
-			Tile *tile = &g_map[i];
+			Tile *tile = &g_game->map[i];
 			tile->isUnveiled_ = false;
 			tile->overlaySpriteID = g_veiledSpriteID;
 		}
@@ -176,6 +206,23 @@ SaveFile(const char *filename, const char *description)
 			Structure_RemoveFog(UNVEILCAUSE_INITIALISATION, s);
 		}
 	}
+}
+
+/**
+ * Save the game to a filename
+ *
+ * @param fp The filename of the savegame.
+ * @param description The description of the savegame.
+ * @return True if and only if all bytes were written successful.
+ */
+bool
+SaveFile(const char *filename, const char *description)
+{
+	FILE *fp;
+	bool res;
+
+	SaveFile_WaitForBackground();
+	Save_CoverDebugScenario();
 
 	fp = File_Open_CaseInsensitive(SEARCHDIR_PERSONAL_DATA_DIR, filename, "wb");
 	if (fp == NULL) {
@@ -183,8 +230,10 @@ SaveFile(const char *filename, const char *description)
 		return false;
 	}
 
+	Save_Prepare();
+
 	g_validateStrictIfZero++;
-	res = Save_Main(fp, description);
+	res = Save_Main(fp, description, g_campaign_selected == CAMPAIGNID_SKIRMISH);
 	g_validateStrictIfZero--;
 
 	fclose(fp);
@@ -198,3 +247,96 @@ SaveFile(const char *filename, const char *description)
 
 	return true;
 }
+
+static void *
+Save_BackgroundThreadProc(ALLEGRO_THREAD *thread, void *arg)
+{
+	SaveJob *job = arg;
+	GameContext *game = g_game;
+	char tmppath[sizeof(job->filepath) + 4];
+	VARIABLE_NOT_USED(thread);
+
+	/* Write to a temporary file first so that a crash part way
+	 * through does not destroy the previous save.
+	 */
+	snprintf(tmppath, sizeof(tmppath), "%s.tmp", job->filepath);
+
+	g_game = job->context;
+	g_validateStrictIfZero++;
+
+	FILE *fp = fopen(tmppath, "wb");
+	if (fp != NULL) {
+		job->ok = Save_Main(fp, job->description, job->skirmish);
+		job->ok = (fclose(fp) == 0) && job->ok;
+		job->ok = job->ok && (rename(tmppath, job->filepath) == 0);
+	} else {
+		job->ok = false;
+	}
+
+	g_validateStrictIfZero--;
+	g_game = game;
+	return NULL;
+}
+
+/**
+ * Wait for a background save to finish writing.
+ */
+void
+SaveFile_WaitForBackground(void)
+{
+	if (s_save_thread == NULL)
+		return;
+
+	al_join_thread(s_save_thread, NULL);
+	al_destroy_thread(s_save_thread);
+	s_save_thread = NULL;
+
+	if (!s_save_job.ok)
+		Error("Error while writing savegame '%s'.\n", s_save_job.filepath);
+}
+
+/**
+ * Save the game to a filename without blocking on serialisation or disk I/O.
+ *
+ * The calling thread gathers the globals that are saved and copies the
+ *  game context and build queues, which is quick.  A worker thread then
+ *  serialises the copy and writes it to disk.
+ *
+ * @param fp The filename of the savegame.
+ * @param description The description of the savegame.
+ * @return True if and only if the save was started successfully.
+ */
+bool
+SaveFile_Background(const char *filename, const char *description)
+{
+	char dirname[sizeof(s_save_job.filepath)];
+
+	SaveFile_WaitForBackground();
+	Save_CoverDebugScenario();
+
+	File_MakeCompleteFilename(dirname, sizeof(dirname), SEARCHDIR_PERSONAL_DATA_DIR, "", false);
+	if (!al_make_directory(dirname))
+		return false;
+
+	if (s_save_job.context == NULL)
+		s_save_job.context = GameContext_Create();
+
+	File_MakeCompleteFilename(s_save_job.filepath, sizeof(s_save_job.filepath),
+			SEARCHDIR_PERSONAL_DATA_DIR, filename, false);
+	snprintf(s_save_job.description, sizeof(s_save_job.description), "%s", description);
+	s_save_job.skirmish = (g_campaign_selected == CAMPAIGNID_SKIRMISH);
+	s_save_job.ok = false;
+
+	Save_Prepare();
+	GameContext_Copy(s_save_job.context, g_game);
+	GameContext_CopyQueues(s_save_job.context, &s_save_job.queue_item, &s_save_job.max_queue_items);
+
+	s_save_thread = al_create_thread(Save_BackgroundThreadProc, &s_save_job);
+	if (s_save_thread == NULL) {
+		Save_BackgroundThreadProc(NULL, &s_save_job);
+		return s_save_job.ok;
+	}
+
+	al_start_thread(s_save_thread);
+	return true;
+}
@@ -3,6 +3,10 @@
 #ifndef SAVE_H
 #define SAVE_H
 
+extern int g_autosave_interval;
+
 extern bool SaveFile(const char *filename, const char *description);
+extern void SaveFile_WaitForBackground(void);
+extern bool SaveFile_Background(const char *filename, const char *description);
 
 #endif /* SAVE_H */
@@ -87,7 +87,7 @@ bool House_Load(FILE *fp, uint32 length)
 		}
 	}
 
-	Scenario_Load_OldStats();
+	Info_Load_OldStats();
 
 	if (length != 0) return false;
 
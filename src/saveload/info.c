@@ -1,8 +1,10 @@
 /** @file src/saveload/info.c Load/save routines for Info. */
 
+#include <string.h>
 #include "saveload.h"
 #include "../file.h"
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../map.h"
 #include "../mods/landscape.h"
@@ -15,110 +17,72 @@
 #include "../structure.h"
 #include "../timer/timer.h"
 
-/* These were originally global variables. */
-static uint16 s_playerCreditsNoSilo;
-static uint16 s_structureActiveID;
-static uint16 s_houseMissileCountdown;
-static uint16 s_houseMissileID;
-static uint16 s_starportID;
-
-static uint32 SaveLoad_SelectionType(void *object, uint32 value, bool loading)
-{
-	VARIABLE_NOT_USED(object);
-
-	if (loading) {
-		g_selectionTypeNew = (uint16)value;
-		return 0;
-	}
-
-	return g_selectionType;
-}
-
-#if 0
-static uint32 SaveLoad_UnitSelected(void *object, uint32 value, bool loading)
-{
-	VARIABLE_NOT_USED(object);
-
-	Unit_UnselectAll();
-
-	if (loading) {
-		if ((uint16)value != 0xFFFF && value < UNIT_INDEX_MAX) {
-			Unit_AddSelected(Unit_Get_ByIndex((uint16)value));
-		}
-		return 0;
-	}
-
-	if (Unit_AnySelected()) {
-		const Unit *u = Unit_FirstSelected(NULL);
-		return u->o.index;
-	} else {
-		return 0xFFFF;
-	}
-}
-#endif
-
-static uint32 SaveLoad_UnitActive(void *object, uint32 value, bool loading)
-{
-	VARIABLE_NOT_USED(object);
-
-	if (loading) {
-		if ((uint16)value != 0xFFFF && value < UnitPool_GetMaxIndex()) {
-			g_unitActive = Unit_Get_ByIndex((uint16)value);
-		} else {
-			g_unitActive = NULL;
-		}
-		return 0;
-	}
-
-	if (g_unitActive != NULL) {
-		return g_unitActive->o.index;
-	} else {
-		return 0xFFFF;
-	}
-}
-
-static uint32 SaveLoad_TickScenarioStart(void *object, uint32 value, bool loading)
-{
-	VARIABLE_NOT_USED(object);
-
-	if (loading) {
-		g_tickScenarioStart = g_timerGame - value;
-		return 0;
-	}
-
-	return g_timerGame - g_tickScenarioStart;
-}
+/* The info chunk is gathered here before saving, and spread out over
+ * the globals after loading.  The selected units are gathered too, for
+ * the DDI2 chunk.  The dedicated server keeps those globals
+ * per thread, so a table cannot hold their addresses.
+ */
+typedef struct SaveInfo {
+	SaveScenario scenario;
+	uint16 viewportPosition;
+	uint16 selectionRectanglePosition;
+	uint16 selectionType;
+	uint16 structureActiveType;
+	uint16 structureActivePosition;
+	uint16 unitActive;
+	uint16 activeAction;
+	uint32 strategicRegionBits;
+	uint16 scenarioID;
+	uint16 campaignID;
+	uint32 hintsShown1;
+	uint32 hintsShown2;
+	uint32 tickScenarioStart;
+	int16  starportAvailable[UNIT_MAX];
+
+	/* These were originally global variables. */
+	uint16 playerCreditsNoSilo;
+	uint16 structureActiveID;
+	uint16 houseMissileCountdown;
+	uint16 houseMissileID;
+	uint16 starportID;
+
+	/* Not part of the info chunk. */
+	uint16 unitSelected[MAX_SELECTABLE_UNITS];
+	int unitSelectedCount;
+} SaveInfo;
+
+static THREAD_LOCAL SaveInfo s_info;
 
 static const SaveLoadDesc s_saveInfo[] = {
-	SLD_GSLD   (g_scenario,  g_saveScenario),
-	SLD_GENTRY (SLDT_UINT16, s_playerCreditsNoSilo),
-	SLD_GENTRY (SLDT_UINT16, g_viewportPosition),
-	SLD_GENTRY (SLDT_UINT16, g_selectionRectanglePosition),
-	SLD_GCALLB (SLDT_INT8,   g_selectionType, &SaveLoad_SelectionType),
-	SLD_GENTRY2(SLDT_INT8,   g_structureActiveType, SLDT_UINT16),
-	SLD_GENTRY (SLDT_UINT16, g_structureActivePosition),
-	SLD_GENTRY (SLDT_UINT16, s_structureActiveID),
+	SLD_SLD    (SaveInfo,              scenario, g_saveScenario),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, playerCreditsNoSilo),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, viewportPosition),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, selectionRectanglePosition),
+	SLD_ENTRY2 (SaveInfo, SLDT_INT8,   selectionType, SLDT_UINT16),
+	SLD_ENTRY2 (SaveInfo, SLDT_INT8,   structureActiveType, SLDT_UINT16),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, structureActivePosition),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, structureActiveID),
 	SLD_EMPTY  (SLDT_UINT16), /* was SaveLoad_UnitSelected. */
-	SLD_GCALLB (SLDT_UINT16, g_unitActive, &SaveLoad_UnitActive),
-	SLD_GENTRY (SLDT_UINT16, g_activeAction),
-	SLD_GENTRY (SLDT_UINT32, g_strategicRegionBits),
-	SLD_GENTRY (SLDT_UINT16, g_scenarioID),
-	SLD_GENTRY (SLDT_UINT16, g_campaignID),
-	SLD_GENTRY (SLDT_UINT32, g_hintsShown1),
-	SLD_GENTRY (SLDT_UINT32, g_hintsShown2),
-	SLD_GCALLB (SLDT_UINT32, g_tickScenarioStart, &SaveLoad_TickScenarioStart),
-	SLD_GENTRY (SLDT_UINT16, s_playerCreditsNoSilo),
-	SLD_GARRAY (SLDT_INT16,  g_starportAvailable, UNIT_MAX),
-	SLD_GENTRY (SLDT_UINT16, s_houseMissileCountdown),
-	SLD_GENTRY (SLDT_UINT16, s_houseMissileID),
-	SLD_GENTRY (SLDT_UINT16, s_starportID),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, unitActive),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, activeAction),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT32, strategicRegionBits),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, scenarioID),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, campaignID),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT32, hintsShown1),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT32, hintsShown2),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT32, tickScenarioStart),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, playerCreditsNoSilo),
+	SLD_ARRAY  (SaveInfo, SLDT_INT16,  starportAvailable, UNIT_MAX),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, houseMissileCountdown),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, houseMissileID),
+	SLD_ENTRY  (SaveInfo, SLDT_UINT16, starportID),
 	SLD_END
 };
 
 static const SaveLoadDesc s_saveInfoOld[] = {
 	SLD_EMPTY2(SLDT_UINT8,  250),
-	SLD_GENTRY(SLDT_UINT16, g_scenarioID),
-	SLD_GENTRY(SLDT_UINT16, g_campaignID),
+	SLD_ENTRY (SaveInfo, SLDT_UINT16, scenarioID),
+	SLD_ENTRY (SaveInfo, SLDT_UINT16, campaignID),
 	SLD_END
 };
 
@@ -136,14 +100,36 @@ static const SaveLoadDesc s_saveInfo2[] = {
 bool Info_Load(FILE *fp, uint32 length)
 {
 	if (SaveLoad_GetLength(s_saveInfo) != length) return false;
-	if (!SaveLoad_Load(s_saveInfo, fp, NULL)) return false;
+	if (!SaveLoad_Load(s_saveInfo, fp, &s_info)) return false;
+
+	g_game->scenario = s_info.scenario.scenario;
+	g_viewportPosition = s_info.viewportPosition;
+	g_selectionRectanglePosition = s_info.selectionRectanglePosition;
+	g_selectionTypeNew = s_info.selectionType;
+	g_structureActiveType = s_info.structureActiveType;
+	g_structureActivePosition = s_info.structureActivePosition;
+
+	if (s_info.unitActive != 0xFFFF && s_info.unitActive < UnitPool_GetMaxIndex()) {
+		g_unitActive = Unit_Get_ByIndex(s_info.unitActive);
+	} else {
+		g_unitActive = NULL;
+	}
+
+	g_activeAction = s_info.activeAction;
+	g_strategicRegionBits = s_info.strategicRegionBits;
+	g_scenarioID = s_info.scenarioID;
+	g_campaignID = s_info.campaignID;
+	g_hintsShown1 = s_info.hintsShown1;
+	g_hintsShown2 = s_info.hintsShown2;
+	g_game->tickScenarioStart = g_game->timerGame - s_info.tickScenarioStart;
+	memcpy(g_starportAvailable, s_info.starportAvailable, sizeof(g_starportAvailable));
 
 	g_selectionPosition = g_selectionRectanglePosition;
 	Map_MoveDirection(0, 0);
 
 	Sprites_LoadTiles();
 
-	Map_CreateLandscape(g_scenario.mapSeed, NULL, g_map);
+	Map_CreateLandscape(g_game->scenario.mapSeed, NULL, g_game->map);
 
 	return true;
 }
@@ -158,7 +144,10 @@ bool Info_LoadOld(FILE *fp, uint32 length)
 {
 	VARIABLE_NOT_USED(length);
 
-	if (!SaveLoad_Load(s_saveInfoOld, fp, NULL)) return false;
+	if (!SaveLoad_Load(s_saveInfoOld, fp, &s_info)) return false;
+
+	g_scenarioID = s_info.scenarioID;
+	g_campaignID = s_info.campaignID;
 
 	return true;
 }
@@ -166,15 +155,71 @@ bool Info_LoadOld(FILE *fp, uint32 length)
 void
 Info_Load_PlayerHouseGlobals(House *h)
 {
-	h->creditsStorageNoSilo  = s_playerCreditsNoSilo;
-	h->structureActiveID     = s_structureActiveID;
-	h->houseMissileCountdown = s_houseMissileCountdown;
-	h->houseMissileID        = s_houseMissileID;
-	h->starportID            = s_starportID;
+	h->creditsStorageNoSilo  = s_info.playerCreditsNoSilo;
+	h->structureActiveID     = s_info.structureActiveID;
+	h->houseMissileCountdown = s_info.houseMissileCountdown;
+	h->houseMissileID        = s_info.houseMissileID;
+	h->starportID            = s_info.starportID;
 
 	g_structureActive
-		= (s_structureActiveID != STRUCTURE_INDEX_INVALID)
-		? Structure_Get_ByIndex(s_structureActiveID) : NULL;
+		= (s_info.structureActiveID != STRUCTURE_INDEX_INVALID)
+		? Structure_Get_ByIndex(s_info.structureActiveID) : NULL;
+}
+
+/**
+ * Puts the stats of an old savegame in the scenario, once the houses
+ * are loaded.
+ */
+void
+Info_Load_OldStats(void)
+{
+	Scenario_Load_OldStats(&s_info.scenario.oldStats);
+}
+
+/**
+ * Gather the info to save from the globals.  Called on the game's
+ *  thread, so that Info_Save and Info_Save2 can run on another.
+ */
+void
+Info_Save_Prepare(void)
+{
+	int iter;
+
+	s_info.scenario.scenario = g_game->scenario;
+	Scenario_GetOldStats(g_playerHouseID, &s_info.scenario.oldStats);
+	s_info.viewportPosition = g_viewportPosition;
+	s_info.selectionRectanglePosition = g_selectionRectanglePosition;
+	s_info.selectionType = g_selectionType;
+	s_info.structureActiveType = g_structureActiveType;
+	s_info.structureActivePosition = g_structureActivePosition;
+	s_info.unitActive = (g_unitActive != NULL) ? g_unitActive->o.index : 0xFFFF;
+	s_info.activeAction = g_activeAction;
+	s_info.strategicRegionBits = g_strategicRegionBits;
+	s_info.scenarioID = g_scenarioID;
+	s_info.campaignID = g_campaignID;
+	s_info.hintsShown1 = g_hintsShown1;
+	s_info.hintsShown2 = g_hintsShown2;
+	s_info.tickScenarioStart = g_game->timerGame - g_game->tickScenarioStart;
+	memcpy(s_info.starportAvailable, g_starportAvailable, sizeof(s_info.starportAvailable));
+
+	if (g_playerHouse != NULL) {
+		s_info.playerCreditsNoSilo   = g_playerHouse->creditsStorageNoSilo;
+		s_info.structureActiveID     = g_playerHouse->structureActiveID;
+		s_info.houseMissileCountdown = g_playerHouse->houseMissileCountdown;
+		s_info.houseMissileID        = g_playerHouse->houseMissileID;
+		s_info.starportID            = g_playerHouse->starportID;
+	} else {
+		s_info.playerCreditsNoSilo   = 0;
+		s_info.structureActiveID     = STRUCTURE_INDEX_INVALID;
+		s_info.houseMissileCountdown = 0;
+		s_info.houseMissileID        = UNIT_INDEX_INVALID;
+		s_info.starportID            = STRUCTURE_INDEX_INVALID;
+	}
+
+	s_info.unitSelectedCount = 0;
+	for (const Unit *u = Unit_FirstSelected(&iter); u != NULL; u = Unit_NextSelected(&iter)) {
+		s_info.unitSelected[s_info.unitSelectedCount++] = u->o.index;
+	}
 }
 
 /**
@@ -186,24 +231,9 @@ bool Info_Save(FILE *fp)
 {
 	const uint16 savegameVersion = 0x0290;
 
-	if (g_playerHouse != NULL) {
-		s_playerCreditsNoSilo   = g_playerHouse->creditsStorageNoSilo;
-		s_structureActiveID     = g_playerHouse->structureActiveID;
-		s_houseMissileCountdown = g_playerHouse->houseMissileCountdown;
-		s_houseMissileID        = g_playerHouse->houseMissileID;
-		s_starportID            = g_playerHouse->starportID;
-	} else {
-		s_playerCreditsNoSilo   = 0;
-		s_structureActiveID     = STRUCTURE_INDEX_INVALID;
-		s_houseMissileCountdown = 0;
-		s_houseMissileID        = UNIT_INDEX_INVALID;
-		s_starportID            = STRUCTURE_INDEX_INVALID;
-	}
-
 	if (!fwrite_le_uint16(savegameVersion, fp)) return false;
 
-	Scenario_Save_OldStats();
-	if (!SaveLoad_Save(s_saveInfo, fp, NULL)) return false;
+	if (!SaveLoad_Save(s_saveInfo, fp, &s_info)) return false;
 
 	return true;
 }
@@ -235,14 +265,9 @@ Info_Load2(FILE *fp, uint32 length)
 bool
 Info_Save2(FILE *fp)
 {
-	int iter;
-
-	Unit *u = Unit_FirstSelected(&iter);
-	while (u != NULL) {
-		if (!SaveLoad_Save(s_saveInfo2, fp, u))
+	for (int i = 0; i < s_info.unitSelectedCount; i++) {
+		if (!fwrite_le_uint16(s_info.unitSelected[i], fp))
 			return false;
-
-		u = Unit_NextSelected(&iter);
 	}
 
 	return true;
@@ -3,10 +3,14 @@
 #include <string.h>
 
 #include "saveload.h"
+#include "../gamecontext.h"
 #include "../map.h"
 #include "../sprites.h"
 #include "../timer/timer.h"
 
+/* The house whose fog of war goes in the DDM2 chunk. */
+static THREAD_LOCAL enum HouseType s_savePlayerHouseID;
+
 /**
  * Load a Tile structure to a file (Little endian)
  *
@@ -67,7 +71,7 @@ bool Map_Load(FILE *fp, uint32 length)
 	uint16 i;
 
 	for (i = 0; i < 0x1000; i++) {
-		Tile *t = &g_map[i];
+		Tile *t = &g_game->map[i];
 
 		t->isUnveiled_ = false;
 		t->overlaySpriteID = g_veiledSpriteID;
@@ -81,11 +85,11 @@ bool Map_Load(FILE *fp, uint32 length)
 		if (!fread_le_uint16(&i, fp)) return false;
 		if (i >= 0x1000) return false;
 
-		t = &g_map[i];
+		t = &g_game->map[i];
 		if (!fread_tile(t, fp)) return false;
 
-		if (g_mapSpriteID[i] != t->groundSpriteID) {
-			g_mapSpriteID[i] |= 0x8000;
+		if (g_game->mapSpriteID[i] != t->groundSpriteID) {
+			g_game->mapSpriteID[i] |= 0x8000;
 		}
 	}
 	if (length != 0) return false;
@@ -103,11 +107,11 @@ bool Map_Save(FILE *fp)
 	uint16 i;
 
 	for (i = 0; i < 0x1000; i++) {
-		Tile *tile = &g_map[i];
+		Tile *tile = &g_game->map[i];
 
 		/* Store the index, then the tile itself */
 		if (!fwrite_le_uint16(i, fp)) return false;
-		if (!fwrite_tile(tile, &g_mapVisible[i], fp)) return false;
+		if (!fwrite_tile(tile, &g_game->mapVisible[i], fp)) return false;
 	}
 
 	return true;
@@ -120,8 +124,8 @@ void
 Map_Load2Fallback(void)
 {
 	for (uint16 packed = 0; packed < MAP_SIZE_MAX * MAP_SIZE_MAX; packed++) {
-		Tile *t = &g_map[packed];
-		FogOfWarTile *f = &g_mapVisible[packed];
+		Tile *t = &g_game->map[packed];
+		FogOfWarTile *f = &g_game->mapVisible[packed];
 
 		memset(f->timeout, 0, sizeof(f->timeout));
 		f->groundSpriteID   = t->groundSpriteID;
@@ -157,10 +161,10 @@ Map_Load2(FILE *fp, uint32 length)
 		if (fread(&houseID,     sizeof(uint8),  1, fp) != 1) return false;
 		if (fread(&hasStructure,sizeof(uint8),  1, fp) != 1) return false;
 
-		FogOfWarTile *f = &g_mapVisible[packed];
+		FogOfWarTile *f = &g_game->mapVisible[packed];
 
 		for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++)
-			f->timeout[h]   = (timeout == 0) ? 0 : (g_timerGame + timeout);
+			f->timeout[h]   = (timeout == 0) ? 0 : (g_game->timerGame + timeout);
 
 		f->groundSpriteID   = (spriteID & 0x1FF);
 		f->houseID          = houseID;
@@ -179,12 +183,24 @@ Map_Load2(FILE *fp, uint32 length)
 	return true;
 }
 
+/**
+ * Gather the player's house.  Called on the game's thread, so that
+ *  Map_Save2 can run on another.
+ */
+void
+Map_Save_Prepare(void)
+{
+	s_savePlayerHouseID = g_playerHouseID;
+}
+
 bool
 Map_Save2(FILE *fp)
 {
+	const enum HouseType playerHouseID = s_savePlayerHouseID;
+
 	for (uint16 packed = 0; packed < MAP_SIZE_MAX * MAP_SIZE_MAX; packed++) {
-		const FogOfWarTile *f = &g_mapVisible[packed];
-		uint16 timeout      = (f->timeout[g_playerHouseID] <= g_timerGame) ? 0 : (f->timeout[g_playerHouseID] - g_timerGame);
+		const FogOfWarTile *f = &g_game->mapVisible[packed];
+		uint16 timeout      = (f->timeout[playerHouseID] <= g_game->timerGame) ? 0 : (f->timeout[playerHouseID] - g_game->timerGame);
 		uint8  overlay      = f->fogSpriteID ? f->fogSpriteID : f->overlaySpriteID;
 		uint16 spriteID     = ((overlay & 0x7F) << 9) | (f->groundSpriteID & 0x1FF);
 		uint8 houseID       = f->houseID;
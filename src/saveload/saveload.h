@@ -144,6 +144,7 @@ typedef struct SaveLoad_CustomCallbackData {
 } SaveLoad_CustomCallbackData;
 
 struct House;
+struct OldScenarioStats;
 
 extern const SaveLoadDesc g_saveObject[];
 extern const SaveLoadDesc g_saveScriptEngine[];
@@ -161,17 +162,20 @@ extern bool House_Save2(FILE *fp);
 extern bool Info_Load(FILE *fp, uint32 length);
 extern bool Info_LoadOld(FILE *fp, uint32 length);
 extern void Info_Load_PlayerHouseGlobals(struct House *h);
+extern void Info_Load_OldStats(void);
+extern void Info_Save_Prepare(void);
 extern bool Info_Save(FILE *fp);
 extern bool Info_Load2(FILE *fp, uint32 length);
 extern bool Info_Save2(FILE *fp);
 extern bool Map_Load(FILE *fp, uint32 length);
 extern bool Map_Save(FILE *fp);
+extern void Map_Save_Prepare(void);
 extern void Map_Load2Fallback(void);
 extern bool Map_Load2(FILE *fp, uint32 length);
 extern bool Map_Save2(FILE *fp);
-extern void Scenario_Load_OldStats(void);
-extern void Scenario_Save_OldStats(void);
+extern void Scenario_Load_OldStats(const struct OldScenarioStats *stats);
 extern bool Scenario_Load2(FILE *fp, uint32 length);
+extern void Scenario_Save_Prepare(void);
 extern bool Scenario_Save2(FILE *fp);
 extern bool Scenario_Load3(FILE *fp, uint32 length);
 extern bool Scenario_Save3(FILE *fp);
@@ -2,11 +2,13 @@
 
 #include <assert.h>
 #include "saveload.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../mods/skirmish.h"
 #include "../scenario.h"
 
-static OldScenarioStats s_oldStats;
+/* The brains of the skirmish houses, gathered for the DDS2 chunk. */
+static THREAD_LOCAL char s_saveBrain[HOUSE_NEUTRAL];
 
 static const SaveLoadDesc s_saveReinforcement[] = {
 	SLD_ENTRY (Reinforcement, SLDT_UINT16, unitID),
@@ -18,22 +20,22 @@ static const SaveLoadDesc s_saveReinforcement[] = {
 };
 
 const SaveLoadDesc g_saveScenario[] = {
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.score),
-	SLD_ENTRY (Scenario, SLDT_UINT16, winFlags),
-	SLD_ENTRY (Scenario, SLDT_UINT16, loseFlags),
-	SLD_ENTRY (Scenario, SLDT_UINT32, mapSeed),
-	SLD_ENTRY (Scenario, SLDT_UINT16, mapScale),
-	SLD_ENTRY (Scenario, SLDT_UINT16, timeOut),
-	SLD_ARRAY (Scenario, SLDT_UINT8,  pictureBriefing, 14),
-	SLD_ARRAY (Scenario, SLDT_UINT8,  pictureWin,      14),
-	SLD_ARRAY (Scenario, SLDT_UINT8,  pictureLose,     14),
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.killedAllied),
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.killedEnemy),
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.destroyedAllied),
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.destroyedEnemy),
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.harvestedAllied),
-	SLD_GENTRY(SLDT_UINT16, s_oldStats.harvestedEnemy),
-	SLD_SLD2  (Scenario,              reinforcement, s_saveReinforcement, 16),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.score),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, scenario.winFlags),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, scenario.loseFlags),
+	SLD_ENTRY (SaveScenario, SLDT_UINT32, scenario.mapSeed),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, scenario.mapScale),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, scenario.timeOut),
+	SLD_ARRAY (SaveScenario, SLDT_UINT8,  scenario.pictureBriefing, 14),
+	SLD_ARRAY (SaveScenario, SLDT_UINT8,  scenario.pictureWin, 14),
+	SLD_ARRAY (SaveScenario, SLDT_UINT8,  scenario.pictureLose, 14),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.killedAllied),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.killedEnemy),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.destroyedAllied),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.destroyedEnemy),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.harvestedAllied),
+	SLD_ENTRY (SaveScenario, SLDT_UINT16, oldStats.harvestedEnemy),
+	SLD_SLD2  (SaveScenario, scenario.reinforcement, s_saveReinforcement, 16),
 	SLD_END
 };
 
@@ -47,8 +49,12 @@ static const SaveLoadDesc s_saveScenario3[] = {
 
 /*--------------------------------------------------------------*/
 
+/**
+ * Puts the stats of an old savegame in g_game->scenario.
+ * @param stats The stats of the player and the enemy.
+ */
 void
-Scenario_Load_OldStats(void)
+Scenario_Load_OldStats(const OldScenarioStats *stats)
 {
 	enum HouseType human = g_playerHouseID;
 	enum HouseType enemy = HOUSE_INVALID;
@@ -61,19 +67,13 @@ Scenario_Load_OldStats(void)
 	}
 	assert(enemy != HOUSE_INVALID);
 
-	g_scenario.score[human] = s_oldStats.score;
-	g_scenario.unitsLost[human] = s_oldStats.killedAllied;
-	g_scenario.unitsLost[enemy] = s_oldStats.killedEnemy;
-	g_scenario.structuresLost[human] = s_oldStats.destroyedAllied;
-	g_scenario.structuresLost[enemy] = s_oldStats.destroyedEnemy;
-	g_scenario.spiceHarvested[human] = s_oldStats.harvestedAllied;
-	g_scenario.spiceHarvested[enemy] = s_oldStats.harvestedEnemy;
-}
-
-void
-Scenario_Save_OldStats(void)
-{
-	Scenario_GetOldStats(g_playerHouseID, &s_oldStats);
+	g_game->scenario.score[human] = stats->score;
+	g_game->scenario.unitsLost[human] = stats->killedAllied;
+	g_game->scenario.unitsLost[enemy] = stats->killedEnemy;
+	g_game->scenario.structuresLost[human] = stats->destroyedAllied;
+	g_game->scenario.structuresLost[enemy] = stats->destroyedEnemy;
+	g_game->scenario.spiceHarvested[human] = stats->harvestedAllied;
+	g_game->scenario.spiceHarvested[enemy] = stats->harvestedEnemy;
 }
 
 /*--------------------------------------------------------------*/
@@ -96,14 +96,25 @@ Scenario_Load2(FILE *fp, uint32 length)
 	return true;
 }
 
-bool
-Scenario_Save2(FILE *fp)
+/**
+ * Gather the brains of the skirmish houses.  Called on the game's
+ *  thread, so that Scenario_Save2 can run on another.
+ */
+void
+Scenario_Save_Prepare(void)
 {
 	const char brain_char[3] = { ' ', 'H', 'C' };
 
 	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++) {
-		char c = brain_char[g_skirmish.player_config[h].brain];
-		fwrite(&c, sizeof(char), 1, fp);
+		s_saveBrain[h] = brain_char[g_skirmish.player_config[h].brain];
+	}
+}
+
+bool
+Scenario_Save2(FILE *fp)
+{
+	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++) {
+		fwrite(&s_saveBrain[h], sizeof(char), 1, fp);
 	}
 
 	return true;
@@ -115,11 +126,11 @@ Scenario_Load3(FILE *fp, uint32 length)
 	if (SaveLoad_GetLength(s_saveScenario3) != length)
 		return false;
 
-	return SaveLoad_Load(s_saveScenario3, fp, &g_scenario);
+	return SaveLoad_Load(s_saveScenario3, fp, &g_game->scenario);
 }
 
 bool
 Scenario_Save3(FILE *fp)
 {
-	return SaveLoad_Save(s_saveScenario3, fp, &g_scenario);
+	return SaveLoad_Save(s_saveScenario3, fp, &g_game->scenario);
 }
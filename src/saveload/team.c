@@ -47,8 +47,8 @@ bool Team_Load(FILE *fp, uint32 length)
 
 		length -= SaveLoad_GetLength(s_saveTeam);
 
-		tl.script.scriptInfo = g_scriptTeam;
-		tl.script.script = g_scriptTeam->start + (size_t)tl.script.script;
+		tl.script.scriptInfo = &g_scriptTeam;
+		tl.script.script = g_scriptTeam.start + (size_t)tl.script.script;
 
 		/* Get the Structure from the pool */
 		t = Team_Get_ByIndex(tl.index);
@@ -90,8 +90,8 @@ bool Unit_Load(FILE *fp, uint32 length)
 
 		length -= SaveLoad_GetLength(s_saveUnit);
 
-		ul.o.script.scriptInfo = g_scriptUnit;
-		ul.o.script.script = g_scriptUnit->start + (size_t)ul.o.script.script;
+		ul.o.script.scriptInfo = &g_scriptUnit;
+		ul.o.script.script = g_scriptUnit.start + (size_t)ul.o.script.script;
 		ul.o.script.delay = 0;
 		ul.timer = 0;
 		ul.o.seenByHouses |= 1 << ul.o.houseID;
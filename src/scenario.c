@@ -17,6 +17,7 @@
 
 #include "enhancement.h"
 #include "file.h"
+#include "gamecontext.h"
 #include "gfx.h"
 #include "house.h"
 #include "ini.h"
@@ -39,12 +40,11 @@
 #include "unit.h"
 #include "gui/gui.h"
 
-Campaign *g_campaign_list;
-int g_campaign_total;
-int g_campaign_selected;
-Scenario g_scenario;
+THREAD_LOCAL Campaign *g_campaign_list;
+THREAD_LOCAL int g_campaign_total;
+THREAD_LOCAL int g_campaign_selected;
 
-static void *s_scenarioBuffer = NULL;
+static THREAD_LOCAL void *s_scenarioBuffer = NULL;
 
 /*--------------------------------------------------------------*/
 
@@ -1003,7 +1003,7 @@ Campaign_ReadProfileIni(void)
 void
 Campaign_Load(void)
 {
-	static int l_campaign_selected = -1;
+	static THREAD_LOCAL int l_campaign_selected = -1;
 
 	if (g_campaign_selected == l_campaign_selected
 	 && g_campaign_selected != CAMPAIGNID_SKIRMISH
@@ -1030,17 +1030,17 @@ Campaign_Load(void)
 
 static void Scenario_Load_General(void)
 {
-	g_scenario.winFlags          = Ini_GetInteger("BASIC", "WinFlags",    0,                            s_scenarioBuffer);
-	g_scenario.loseFlags         = Ini_GetInteger("BASIC", "LoseFlags",   0,                            s_scenarioBuffer);
-	g_scenario.mapSeed           = Ini_GetInteger("MAP",   "Seed",        0,                            s_scenarioBuffer);
-	g_scenario.timeOut           = Ini_GetInteger("BASIC", "TimeOut",     0,                            s_scenarioBuffer);
+	g_game->scenario.winFlags          = Ini_GetInteger("BASIC", "WinFlags",    0,                            s_scenarioBuffer);
+	g_game->scenario.loseFlags         = Ini_GetInteger("BASIC", "LoseFlags",   0,                            s_scenarioBuffer);
+	g_game->scenario.mapSeed           = Ini_GetInteger("MAP",   "Seed",        0,                            s_scenarioBuffer);
+	g_game->scenario.timeOut           = Ini_GetInteger("BASIC", "TimeOut",     0,                            s_scenarioBuffer);
 	g_viewportPosition           = Ini_GetInteger("BASIC", "TacticalPos", g_viewportPosition,           s_scenarioBuffer);
 	g_selectionRectanglePosition = Ini_GetInteger("BASIC", "CursorPos",   g_selectionRectanglePosition, s_scenarioBuffer);
-	g_scenario.mapScale          = Ini_GetInteger("BASIC", "MapScale",    0,                            s_scenarioBuffer);
+	g_game->scenario.mapScale          = Ini_GetInteger("BASIC", "MapScale",    0,                            s_scenarioBuffer);
 
-	Ini_GetString("BASIC", "BriefPicture", "HARVEST.WSA",  g_scenario.pictureBriefing, 14, s_scenarioBuffer);
-	Ini_GetString("BASIC", "WinPicture",   "WIN1.WSA",     g_scenario.pictureWin,      14, s_scenarioBuffer);
-	Ini_GetString("BASIC", "LosePicture",  "LOSTBILD.WSA", g_scenario.pictureLose,     14, s_scenarioBuffer);
+	Ini_GetString("BASIC", "BriefPicture", "HARVEST.WSA",  g_game->scenario.pictureBriefing, 14, s_scenarioBuffer);
+	Ini_GetString("BASIC", "WinPicture",   "WIN1.WSA",     g_game->scenario.pictureWin,      14, s_scenarioBuffer);
+	Ini_GetString("BASIC", "LosePicture",  "LOSTBILD.WSA", g_game->scenario.pictureLose,     14, s_scenarioBuffer);
 
 	g_selectionPosition = g_selectionRectanglePosition;
 	Map_MoveDirection(0, 0);
@@ -1335,6 +1335,27 @@ static void Scenario_Load_Structure(const char *key, char *settings)
 	}
 }
 
+/**
+ * @brief   Splits the next field off a comma separated list.
+ * @details Introduced.  Like strtok, but the caller keeps the position,
+ *          as the dedicated server loads scenarios on several threads.
+ */
+static char *
+Scenario_NextToken(char **next)
+{
+	static const char delim[] = ",\r\n";
+	char *s = *next + strspn(*next, delim);
+
+	if (*s == '\0')
+		return NULL;
+
+	*next = s + strcspn(s, delim);
+	if (**next != '\0')
+		*(*next)++ = '\0';
+
+	return s;
+}
+
 static void Scenario_Load_Map(const char *key, char *settings)
 {
 	Tile *t;
@@ -1349,10 +1370,10 @@ static void Scenario_Load_Map(const char *key, char *settings)
 	posY[2] = '\0';
 
 	packed = Tile_PackXY(atoi(posY), atoi(key + 6)) & 0xFFF;
-	t = &g_map[packed];
-	FogOfWarTile *f = &g_mapVisible[packed];
+	t = &g_game->map[packed];
+	FogOfWarTile *f = &g_game->mapVisible[packed];
 
-	s = strtok(settings, ",\r\n");
+	s = Scenario_NextToken(&settings);
 	value = atoi(s);
 	t->houseID        = value & 0x07;
 	bool isUnveiled   = (value & 0x08) != 0 ? true : false;
@@ -1362,9 +1383,9 @@ static void Scenario_Load_Map(const char *key, char *settings)
 	t->hasAnimation   = (value & 0x40) != 0 ? true : false;
 	t->hasExplosion = (value & 0x80) != 0 ? true : false;
 
-	s = strtok(NULL, ",\r\n");
+	s = Scenario_NextToken(&settings);
 	t->groundSpriteID = atoi(s) & 0x01FF;
-	if (g_mapSpriteID[packed] != t->groundSpriteID) g_mapSpriteID[packed] |= 0x8000;
+	if (g_game->mapSpriteID[packed] != t->groundSpriteID) g_game->mapSpriteID[packed] |= 0x8000;
 
 	if (isUnveiled) {
 		f->isUnveiled = (1 << g_playerHouseID);
@@ -1380,12 +1401,12 @@ void Scenario_Load_Map_Bloom(uint16 packed, Tile *t)
 		/* SCENA005: spice bloom is found in rock. */
 		if (packed == 1364 && Map_GetLandscapeType(packed) == LST_ENTIRELY_ROCK) {
 			packed = 1360;
-			t = &g_map[packed];
+			t = &g_game->map[packed];
 		}
 	}
 
 	t->groundSpriteID = g_bloomSpriteID;
-	g_mapSpriteID[packed] |= 0x8000;
+	g_game->mapSpriteID[packed] |= 0x8000;
 }
 
 void Scenario_Load_Map_Field(uint16 packed, Tile *t)
@@ -1401,7 +1422,7 @@ void Scenario_Load_Map_Field(uint16 packed, Tile *t)
 void Scenario_Load_Map_Special(uint16 packed, Tile *t)
 {
 	t->groundSpriteID = g_bloomSpriteID + 1;
-	g_mapSpriteID[packed] |= 0x8000;
+	g_game->mapSpriteID[packed] |= 0x8000;
 }
 
 static void Scenario_Load_Reinforcement(const char *key, char *settings)
@@ -1476,11 +1497,11 @@ Scenario_Create_Reinforcement(uint8 index, enum HouseType houseType,
 	u = Unit_Create(UNIT_INDEX_INVALID, unitType, houseType, position, 0);
 	if (u == NULL) return;
 
-	g_scenario.reinforcement[index].unitID      = u->o.index;
-	g_scenario.reinforcement[index].locationID  = locationID;
-	g_scenario.reinforcement[index].timeLeft    = timeBetween;
-	g_scenario.reinforcement[index].timeBetween = timeBetween;
-	g_scenario.reinforcement[index].repeat      = repeat ? 1 : 0;
+	g_game->scenario.reinforcement[index].unitID      = u->o.index;
+	g_game->scenario.reinforcement[index].locationID  = locationID;
+	g_game->scenario.reinforcement[index].timeLeft    = timeBetween;
+	g_game->scenario.reinforcement[index].timeBetween = timeBetween;
+	g_game->scenario.reinforcement[index].repeat      = repeat ? 1 : 0;
 }
 
 static void Scenario_Load_Team(const char *key, char *settings)
@@ -1559,21 +1580,23 @@ static void Scenario_Load_Choam(const char *key, char *settings)
 static void Scenario_Load_MapParts(const char *key, void (*ptr)(uint16 packed, Tile *t))
 {
 	char *s;
+	char *next;
 	char buf[128];
 
 	Ini_GetString("MAP", key, '\0', buf, 127, s_scenarioBuffer);
 
-	s = strtok(buf, ",\r\n");
+	next = buf;
+	s = Scenario_NextToken(&next);
 	while (s != NULL) {
 		uint16 packed;
 		Tile *t;
 
 		packed = atoi(s);
-		t = &g_map[packed];
+		t = &g_game->map[packed];
 
 		(*ptr)(packed, t);
 
-		s = strtok(NULL, ",\r\n");
+		s = Scenario_NextToken(&next);
 	}
 }
 
@@ -1627,14 +1650,14 @@ bool Scenario_Load(uint16 scenarioID, uint8 houseID)
 
 	s_scenarioBuffer = File_ReadWholeFile_Ex(SEARCHDIR_CAMPAIGN_DIR, filename);
 
-	memset(&g_scenario, 0, sizeof(Scenario));
+	memset(&g_game->scenario, 0, sizeof(Scenario));
 
 	Scenario_Load_General();
 	Sprites_LoadTiles();
-	Map_CreateLandscape(g_scenario.mapSeed, NULL, g_map);
+	Map_CreateLandscape(g_game->scenario.mapSeed, NULL, g_game->map);
 
 	for (i = 0; i < 16; i++) {
-		g_scenario.reinforcement[i].unitID = UNIT_INDEX_INVALID;
+		g_game->scenario.reinforcement[i].unitID = UNIT_INDEX_INVALID;
 	}
 
 	Scenario_Load_Houses();
@@ -1651,7 +1674,7 @@ bool Scenario_Load(uint16 scenarioID, uint8 houseID)
 	Scenario_Load_MapParts("Special", Scenario_Load_Map_Special);
 
 	Scenario_CentreViewport(houseID);
-	g_tickScenarioStart = g_timerGame;
+	g_game->tickScenarioStart = g_game->timerGame;
 
 	free(s_scenarioBuffer); s_scenarioBuffer = NULL;
 	return true;
@@ -1672,15 +1695,15 @@ Scenario_GetOldStats(enum HouseType houseID, OldScenarioStats *stats)
 
 	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_NEUTRAL; h++) {
 		if (House_AreAllied(houseID, h)) {
-			stats->score += g_scenario.score[h];
-			stats->killedAllied += g_scenario.unitsLost[h];
-			stats->destroyedAllied += g_scenario.structuresLost[h];
-			stats->harvestedAllied = min(65000, stats->harvestedAllied + g_scenario.spiceHarvested[h]);
+			stats->score += g_game->scenario.score[h];
+			stats->killedAllied += g_game->scenario.unitsLost[h];
+			stats->destroyedAllied += g_game->scenario.structuresLost[h];
+			stats->harvestedAllied = min(65000, stats->harvestedAllied + g_game->scenario.spiceHarvested[h]);
 		} else {
-			stats->score -= g_scenario.score[h];
-			stats->killedEnemy += g_scenario.unitsLost[h];
-			stats->destroyedEnemy += g_scenario.structuresLost[h];
-			stats->harvestedEnemy = min(65000, stats->harvestedEnemy + g_scenario.spiceHarvested[h]);
+			stats->score -= g_game->scenario.score[h];
+			stats->killedEnemy += g_game->scenario.unitsLost[h];
+			stats->destroyedEnemy += g_game->scenario.structuresLost[h];
+			stats->harvestedEnemy = min(65000, stats->harvestedEnemy + g_game->scenario.spiceHarvested[h]);
 		}
 	}
 }
@@ -68,14 +68,20 @@ typedef struct OldScenarioStats {
 	uint16 harvestedEnemy;                                  /*!< Total amount of spice harvested by "Enemy". */
 } OldScenarioStats;
 
+/**
+ * A Scenario as savegames hold it, with the stats of the old format.
+ */
+typedef struct SaveScenario {
+	Scenario scenario;
+	OldScenarioStats oldStats;
+} SaveScenario;
+
 struct House;
 struct Tile;
 
-extern Campaign *g_campaign_list;
-extern int g_campaign_total;
-extern int g_campaign_selected;
-
-extern Scenario g_scenario;
+extern THREAD_LOCAL Campaign *g_campaign_list;
+extern THREAD_LOCAL int g_campaign_total;
+extern THREAD_LOCAL int g_campaign_selected;
 
 extern Campaign *Campaign_Alloc(const char *dir_name);
 extern void Campaign_Load(void);
@@ -7,6 +7,7 @@
 #include "script.h"
 
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../map.h"
 #include "../net/server.h"
@@ -79,7 +80,7 @@ uint16 Script_General_GetDistanceToTile(ScriptEngine *script)
 	uint16 encoded;
 
 	encoded = STACK_PEEK(1);
-	o = g_scriptCurrentObject;
+	o = g_game->scriptCurrentObject;
 
 	if (!Tools_Index_IsValid(encoded)) return 0xFFFF;
 
@@ -172,7 +173,7 @@ uint16 Script_General_GetDistanceToObject(ScriptEngine *script)
 
 	if (!Tools_Index_IsValid(index)) return 0xFFFF;
 
-	return Object_GetDistanceToEncoded(g_scriptCurrentObject, index);
+	return Object_GetDistanceToEncoded(g_game->scriptCurrentObject, index);
 }
 
 /**
@@ -228,7 +229,7 @@ uint16 Script_General_UnitCount(ScriptEngine *script)
 	uint16 count = 0;
 	PoolFindStruct find;
 
-	for (const Unit *u = Unit_FindFirst(&find, g_scriptCurrentObject->houseID, STACK_PEEK(1));
+	for (const Unit *u = Unit_FindFirst(&find, g_game->scriptCurrentObject->houseID, STACK_PEEK(1));
 			u != NULL;
 			u = Unit_FindNext(&find)) {
 		count++;
@@ -289,7 +290,7 @@ uint16 Script_General_GetLinkedUnitType(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	linkedID = g_scriptCurrentObject->linkedID;
+	linkedID = g_game->scriptCurrentObject->linkedID;
 
 	if (linkedID == 0xFF) return 0xFFFF;
 
@@ -308,7 +309,7 @@ uint16 Script_General_VoicePlay(ScriptEngine *script)
 {
 	tile32 position;
 
-	position = g_scriptCurrentObject->position;
+	position = g_game->scriptCurrentObject->position;
 
 	Server_Send_PlaySoundAtTile(FLAG_HOUSE_ALL, STACK_PEEK(1), position);
 
@@ -328,7 +329,7 @@ uint16 Script_General_SearchSpice(ScriptEngine *script)
 	tile32 position;
 	uint16 packedSpicePos;
 
-	position = g_scriptCurrentObject->position;
+	position = g_game->scriptCurrentObject->position;
 
 	packedSpicePos = Map_SearchSpice(Tile_PackTile(position), STACK_PEEK(1));
 
@@ -379,7 +380,7 @@ uint16 Script_General_IsEnemy(ScriptEngine *script)
 
 	if (!Tools_Index_IsValid(index)) return 0;
 
-	houseID = (g_scriptCurrentUnit != NULL) ? Unit_GetHouseID(g_scriptCurrentUnit) : g_scriptCurrentObject->houseID;
+	houseID = (g_game->scriptCurrentUnit != NULL) ? Unit_GetHouseID(g_game->scriptCurrentUnit) : g_game->scriptCurrentObject->houseID;
 
 	switch (Tools_Index_GetType(index)) {
 		case IT_UNIT:      h2 = Unit_GetHouseID(Tools_Index_GetUnit(index)); break;
@@ -409,7 +410,7 @@ uint16 Script_General_FindIdle(ScriptEngine *script)
 
 	index = STACK_PEEK(1);
 
-	houseID = g_scriptCurrentObject->houseID;
+	houseID = g_game->scriptCurrentObject->houseID;
 
 	if (Tools_Index_GetType(index) == IT_UNIT) return 0;
 	if (Tools_Index_GetType(index) == IT_TILE) return 0;
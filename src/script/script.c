@@ -13,19 +13,12 @@
 #include "script.h"
 
 #include "../file.h"
+#include "../gamecontext.h"
 #include "../object.h"
 
-struct Object *g_scriptCurrentObject;
-struct Structure *g_scriptCurrentStructure;
-struct Unit *g_scriptCurrentUnit;
-struct Team *g_scriptCurrentTeam;
-
-static ScriptInfo s_scriptStructure;
-static ScriptInfo s_scriptTeam;
-static ScriptInfo s_scriptUnit;
-ScriptInfo *g_scriptStructure = &s_scriptStructure;
-ScriptInfo *g_scriptTeam = &s_scriptTeam;
-ScriptInfo *g_scriptUnit = &s_scriptUnit;
+THREAD_LOCAL ScriptInfo g_scriptStructure;
+THREAD_LOCAL ScriptInfo g_scriptTeam;
+THREAD_LOCAL ScriptInfo g_scriptUnit;
 
 /**
  * Converted script functions for Structures.
@@ -160,16 +153,16 @@ static void Script_Error(const char *error, ...)
 	char buffer[256];
 	va_list va;
 
-	if (g_scriptCurrentUnit      != NULL) type = l_types[0];
-	if (g_scriptCurrentStructure != NULL) type = l_types[1];
-	if (g_scriptCurrentTeam      != NULL) type = l_types[2];
+	if (g_game->scriptCurrentUnit      != NULL) type = l_types[0];
+	if (g_game->scriptCurrentStructure != NULL) type = l_types[1];
+	if (g_game->scriptCurrentTeam      != NULL) type = l_types[2];
 
 	va_start(va, error);
 	vsnprintf(buffer, sizeof(buffer), error, va);
 	va_end(va);
 
 	Warning("[SCRIPT] %s; Type: %s; Index: %d; Type: %d;\n",
-			buffer, type, g_scriptCurrentObject->index, g_scriptCurrentObject->type);
+			buffer, type, g_game->scriptCurrentObject->index, g_game->scriptCurrentObject->type);
 }
 
 /**
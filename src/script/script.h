@@ -3,6 +3,8 @@
 #ifndef SCRIPT_H
 #define SCRIPT_H
 
+#include "types.h"
+
 enum {
 	SCRIPT_UNIT_OPCODES_PER_TICK = 50,                      /*!< The amount of opcodes a unit can execute per tick. */
 
@@ -68,14 +70,9 @@ typedef struct ScriptInfo {
 #define STACK_POP() Script_Stack_Pop(script, __FILE__, __LINE__)
 #define STACK_PEEK(position) Script_Stack_Peek(script, position, __FILE__, __LINE__)
 
-extern struct Object *g_scriptCurrentObject;
-extern struct Structure *g_scriptCurrentStructure;
-extern struct Unit *g_scriptCurrentUnit;
-extern struct Team *g_scriptCurrentTeam;
-
-extern ScriptInfo *g_scriptStructure;
-extern ScriptInfo *g_scriptTeam;
-extern ScriptInfo *g_scriptUnit;
+extern THREAD_LOCAL ScriptInfo g_scriptStructure;
+extern THREAD_LOCAL ScriptInfo g_scriptTeam;
+extern THREAD_LOCAL ScriptInfo g_scriptUnit;
 
 extern const ScriptFunction g_scriptFunctionsStructure[SCRIPT_FUNCTIONS_COUNT];
 extern const ScriptFunction g_scriptFunctionsTeam[SCRIPT_FUNCTIONS_COUNT];
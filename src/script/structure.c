@@ -11,6 +11,7 @@
 #include "../config.h"
 #include "../enhancement.h"
 #include "../explosion.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../map.h"
 #include "../net/server.h"
@@ -47,7 +48,7 @@ uint16 Script_Structure_GetState(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 	return s->state;
 }
 
@@ -64,7 +65,7 @@ uint16 Script_Structure_SetState(ScriptEngine *script)
 	Structure *s;
 	int16 state;
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 	state = STACK_PEEK(1);
 
 	if (state == STRUCTURE_STATE_DETECT) {
@@ -97,7 +98,7 @@ uint16 Script_Structure_RemoveFogAroundTile(ScriptEngine *script)
 {
 	VARIABLE_NOT_USED(script);
 
-	Structure_RemoveFog(UNVEILCAUSE_STRUCTURE_SCRIPT, g_scriptCurrentStructure);
+	Structure_RemoveFog(UNVEILCAUSE_STRUCTURE_SCRIPT, g_game->scriptCurrentStructure);
 
 	return 0;
 }
@@ -120,7 +121,7 @@ uint16 Script_Structure_RefineSpice(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 
 	if (s->o.linkedID == 0xFF) {
 		Structure_Server_SetState(s, STRUCTURE_STATE_IDLE);
@@ -146,9 +147,9 @@ uint16 Script_Structure_RefineSpice(ScriptEngine *script)
 
 	creditsStep *= harvesterStep;
 
-	g_scenario.spiceHarvested[s->o.houseID] += creditsStep;
-	if (g_scenario.spiceHarvested[s->o.houseID] > 65000)
-		g_scenario.spiceHarvested[s->o.houseID] = 65000;
+	g_game->scenario.spiceHarvested[s->o.houseID] += creditsStep;
+	if (g_game->scenario.spiceHarvested[s->o.houseID] > 65000)
+		g_game->scenario.spiceHarvested[s->o.houseID] = 65000;
 
 	h = House_Get_ByIndex(s->o.houseID);
 	h->credits += creditsStep;
@@ -175,7 +176,7 @@ uint16 Script_Structure_Unknown0A81(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 
 	structureIndex = Tools_Index_Encode(s->o.index, IT_STRUCTURE);
 
@@ -208,7 +209,7 @@ uint16 Script_Structure_FindUnitByType(ScriptEngine *script)
 	uint16 position;
 	uint16 carryallIndex;
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 
 	if (s->state != STRUCTURE_STATE_READY) return IT_NONE;
 	if (s->o.linkedID == 0xFF) return IT_NONE;
@@ -257,7 +258,7 @@ uint16 Script_Structure_Unknown0C5A(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 
 	if (s->o.linkedID == 0xFF) return 0;
 
@@ -367,7 +368,7 @@ uint16 Script_Structure_FindTargetUnit(ScriptEngine *script)
 	uint32 targetRange;
 	tile32 position;
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 	targetRange = STACK_PEEK(1);
 	distanceCurrent = 32000;
 	u = NULL;
@@ -439,9 +440,9 @@ uint16 Script_Structure_RotateTurret(ScriptEngine *script)
 
 	if (encoded == 0) return 0;
 
-	s      = g_scriptCurrentStructure;
+	s      = g_game->scriptCurrentStructure;
 	lookAt = Tools_Index_GetTile(encoded);
-	tile   = &g_map[Tile_PackTile(s->o.position)];
+	tile   = &g_game->map[Tile_PackTile(s->o.position)];
 
 	/* Find the base sprite of the structure */
 	if (s->o.type == STRUCTURE_ROCKET_TURRET) {
@@ -473,6 +474,7 @@ uint16 Script_Structure_RotateTurret(ScriptEngine *script)
 	/* Set the new sprites */
 	tile->groundSpriteID = baseSpriteID + rotation;
 	s->rotationSpriteDiff = rotation;
+	Map_MarkDirty(Tile_PackTile(s->o.position));
 
 	return 1;
 }
@@ -493,7 +495,7 @@ uint16 Script_Structure_GetDirection(ScriptEngine *script)
 	tile32 tile;
 	uint16 encoded;
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 	encoded = STACK_PEEK(1);
 
 	if (!Tools_Index_IsValid(encoded)) return s->rotationSpriteDiff << 5;
@@ -542,7 +544,7 @@ uint16 Script_Structure_VoicePlay(ScriptEngine *script)
 {
 	Structure *s;
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 
 	Server_Send_PlaySoundAtTile(1 << s->o.houseID,
 			STACK_PEEK(1), s->o.position);
@@ -569,7 +571,7 @@ uint16 Script_Structure_Fire(ScriptEngine *script)
 	uint16 fireDelay;
 	uint16 type;
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 
 	target = script->variables[2];
 	if (target == 0) return 0;
@@ -617,7 +619,7 @@ uint16 Script_Structure_Explode(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 	layout = g_table_structureInfo[s->o.type].layout;
 	position = Tile_PackTile(s->o.position);
 
@@ -649,7 +651,7 @@ uint16 Script_Structure_Destroy(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	s = g_scriptCurrentStructure;
+	s = g_game->scriptCurrentStructure;
 	layout = g_table_structureInfo[s->o.type].layout;
 	position = Tile_PackTile(s->o.position);
 
@@ -7,6 +7,7 @@
 #include "script.h"
 
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../pool/pool.h"
 #include "../pool/pool_team.h"
@@ -30,7 +31,7 @@
 uint16 Script_Team_GetMembers(ScriptEngine *script)
 {
 	VARIABLE_NOT_USED(script);
-	return g_scriptCurrentTeam->members;
+	return g_game->scriptCurrentTeam->members;
 }
 
 /**
@@ -44,7 +45,7 @@ uint16 Script_Team_GetMembers(ScriptEngine *script)
 uint16 Script_Team_GetVariable6(ScriptEngine *script)
 {
 	VARIABLE_NOT_USED(script);
-	return g_scriptCurrentTeam->minMembers;
+	return g_game->scriptCurrentTeam->minMembers;
 }
 
 /**
@@ -58,7 +59,7 @@ uint16 Script_Team_GetVariable6(ScriptEngine *script)
 uint16 Script_Team_GetTarget(ScriptEngine *script)
 {
 	VARIABLE_NOT_USED(script);
-	return g_scriptCurrentTeam->target;
+	return g_game->scriptCurrentTeam->target;
 }
 
 /**
@@ -80,7 +81,7 @@ uint16 Script_Team_AddClosestUnit(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 
 	if (t->members >= t->maxMembers) return 0;
 
@@ -136,7 +137,7 @@ uint16 Script_Team_GetAverageDistance(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 
 	for (const Unit *u = Unit_FindFirst(&find, t->houseID, UNIT_INVALID);
 			u != NULL;
@@ -184,7 +185,7 @@ uint16 Script_Team_Unknown0543(ScriptEngine *script)
 	uint16 distance;
 	PoolFindStruct find;
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 	distance = STACK_PEEK(1);
 
 	for (Unit *u = Unit_FindFirst(&find, t->houseID, UNIT_INVALID);
@@ -239,7 +240,7 @@ uint16 Script_Team_FindBestTarget(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 
 	for (Unit *u = Unit_FindFirst(&find, t->houseID, UNIT_INVALID);
 			u != NULL;
@@ -270,14 +271,14 @@ uint16 Script_Team_Load(ScriptEngine *script)
 	Team *t;
 	uint16 type;
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 	type = STACK_PEEK(1);
 
 	if (t->action == type) return 0;
 
 	t->action = type;
 
-	Script_Reset(&t->script, g_scriptTeam);
+	Script_Reset(&t->script, &g_scriptTeam);
 	Script_Load(&t->script, type & 0xFF);
 
 	return 0;
@@ -298,14 +299,14 @@ uint16 Script_Team_Load2(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 	type = t->actionStart;
 
 	if (t->action == type) return 0;
 
 	t->action = type;
 
-	Script_Reset(&t->script, g_scriptTeam);
+	Script_Reset(&t->script, &g_scriptTeam);
 	Script_Load(&t->script, type & 0xFF);
 
 	return 0;
@@ -327,7 +328,7 @@ uint16 Script_Team_Unknown0788(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 	if (t->target == 0) return 0;
 
 	tile = Tools_Index_GetTile(t->target);
@@ -386,7 +387,7 @@ uint16 Script_Team_DisplayText(ScriptEngine *script)
 	char *text;
 	uint16 offset;
 
-	t = g_scriptCurrentTeam;
+	t = g_game->scriptCurrentTeam;
 	if (House_IsHuman(t->houseID))
 		return 0;
 
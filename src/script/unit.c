@@ -18,6 +18,7 @@
 #include "../enhancement.h"
 #include "../explosion.h"
 #include "../gui/gui.h"
+#include "../gamecontext.h"
 #include "../house.h"
 #include "../map.h"
 #include "../net/server.h"
@@ -61,7 +62,7 @@ uint16 Script_Unit_RandomSoldier(ScriptEngine *script)
 	Unit *nu;
 	tile32 position;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (Tools_Random_256() >= g_table_unitInfo[u->o.type].o.spawnChance) return 0;
 
@@ -90,7 +91,7 @@ uint16 Script_Unit_FindBestTarget(ScriptEngine *script)
 {
 	Unit *u;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	return Unit_FindBestTargetEncoded(u, STACK_PEEK(1));
 }
@@ -110,7 +111,7 @@ uint16 Script_Unit_GetTargetPriority(ScriptEngine *script)
 	Structure *s;
 	uint16 encoded;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	encoded = STACK_PEEK(1);
 
 	target = Tools_Index_GetUnit(encoded);
@@ -137,7 +138,7 @@ uint16 Script_Unit_TransportDeliver(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (u->o.linkedID == 0xFF) return 0;
 	if (Tools_Index_GetType(u->targetMove) == IT_UNIT) return 0;
@@ -239,7 +240,7 @@ uint16 Script_Unit_Pickup(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (u->o.linkedID != 0xFF) return 0;
 
@@ -377,7 +378,7 @@ uint16 Script_Unit_Stop(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	Unit_SetSpeed(u, 0);
 
@@ -399,7 +400,7 @@ uint16 Script_Unit_SetSpeed(ScriptEngine *script)
 	Unit *u;
 	uint16 speed;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	speed = clamp(STACK_PEEK(1), 0, 255);
 
 	if (!u->o.flags.s.byScenario) speed = speed * 192 / 256;
@@ -423,7 +424,7 @@ uint16 Script_Unit_SetSprite(ScriptEngine *script)
 {
 	Unit *u;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	u->spriteOffset = -(STACK_PEEK(1) & 0xFF);
 
@@ -451,7 +452,7 @@ uint16 Script_Unit_MoveToTarget(ScriptEngine *script)
 	int8 orientation;
 	int16 diff;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (u->targetMove == 0) return 0;
 
@@ -507,15 +508,15 @@ uint16 Script_Unit_MoveToTarget(ScriptEngine *script)
  */
 uint16 Script_Unit_Die(ScriptEngine *script)
 {
-	Unit *u = g_scriptCurrentUnit;
+	Unit *u = g_game->scriptCurrentUnit;
 	const enum UnitType type = u->o.type;
 	const tile32 position = u->o.position;
 	const UnitInfo *ui = &g_table_unitInfo[type];
 	VARIABLE_NOT_USED(script);
 
 	if (ui->movementType != MOVEMENT_WINGER) {
-		g_scenario.unitsLost[u->o.houseID]++;
-		g_scenario.score[u->o.houseID] -= max(ui->o.buildCredits / 100, 1);
+		g_game->scenario.unitsLost[u->o.houseID]++;
+		g_game->scenario.score[u->o.houseID] -= max(ui->o.buildCredits / 100, 1);
 	}
 
 	Unit_Remove(u);
@@ -540,7 +541,7 @@ uint16 Script_Unit_ExplosionSingle(ScriptEngine *script)
 {
 	Unit *u;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	Map_MakeExplosion(STACK_PEEK(1), u->o.position, g_table_unitInfo[u->o.type].o.hitpoints, Tools_Index_Encode(u->o.index, IT_UNIT));
 	return 0;
@@ -561,7 +562,7 @@ uint16 Script_Unit_ExplosionMultiple(ScriptEngine *script)
 	Unit *u;
 	uint8 i;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	Map_MakeExplosion(EXPLOSION_DEATH_HAND, u->o.position, Tools_RandomLCG_Range(25, 50), 0);
 
@@ -590,7 +591,7 @@ uint16 Script_Unit_Fire(ScriptEngine *script)
 	bool fireTwice;
 	uint16 damage;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	target = u->targetAttack;
 	if (target == 0 || !Tools_Index_IsValid(target)) return 0;
@@ -731,7 +732,7 @@ uint16 Script_Unit_SetOrientation(ScriptEngine *script)
 {
 	Unit *u;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	Unit_SetOrientation(u, (int8)STACK_PEEK(1), false, 0);
 
@@ -757,7 +758,7 @@ uint16 Script_Unit_Rotate(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	ui = &g_table_unitInfo[u->o.type];
 
 	if (ui->movementType != MOVEMENT_WINGER && Unit_IsMoving(u)) return 1;
@@ -794,7 +795,7 @@ uint16 Script_Unit_GetOrientation(ScriptEngine *script)
 	Unit *u;
 	uint16 encoded;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	encoded = STACK_PEEK(1);
 
 	if (Tools_Index_IsValid(encoded)) {
@@ -821,7 +822,7 @@ uint16 Script_Unit_SetDestination(ScriptEngine *script)
 	Unit *u;
 	uint16 encoded;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	encoded = STACK_PEEK(1);
 
 	if (encoded == 0 || !Tools_Index_IsValid(encoded)) {
@@ -861,7 +862,7 @@ uint16 Script_Unit_SetTarget(ScriptEngine *script)
 	tile32 tile;
 	int8 orientation;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	target = STACK_PEEK(1);
 
@@ -897,7 +898,7 @@ uint16 Script_Unit_SetAction(ScriptEngine *script)
 	Unit *u;
 	enum UnitActionType action;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	action = STACK_PEEK(1);
 
@@ -925,7 +926,7 @@ uint16 Script_Unit_SetActionDefault(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	/* ENHANCEMENT -- Follow mode similar to Sega Mega Drive version of Dune II. */
 	if (!(u->actionID == ACTION_MOVE && u->permanentFollow) || (Tools_Index_GetUnit(u->targetMove) == NULL))
@@ -952,7 +953,7 @@ uint16 Script_Unit_SetDestinationDirect(ScriptEngine *script)
 
 	if (!Tools_Index_IsValid(encoded)) return 0;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (!Unit_IsMoving(u) || g_table_unitInfo[u->o.type].flags.isNormalUnit) {
 		u->currentDestination = Tools_Index_GetTile(encoded);
@@ -976,7 +977,7 @@ uint16 Script_Unit_GetInfo(ScriptEngine *script)
 	const UnitInfo *ui;
 	Unit *u;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	ui = &g_table_unitInfo[u->o.type];
 
 	switch (STACK_PEEK(1)) {
@@ -1027,9 +1028,9 @@ static int16 Script_Unit_Pathfind_GetScore(uint16 packed, uint8 orient8)
 	int16 res;
 	Unit *u;
 
-	if (g_scriptCurrentUnit == NULL) return 0;
+	if (g_game->scriptCurrentUnit == NULL) return 0;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (g_dune2_enhanced) {
 		res = Unit_GetTileEnterScore(u, packed, orient8);
@@ -1406,7 +1407,7 @@ uint16 Script_Unit_CalculateRoute(ScriptEngine *script)
 	uint16 packedSrc;
 	uint16 packedDst;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	encoded = STACK_PEEK(1);
 
 	if (Unit_IsMoving(u) || !Tools_Index_IsValid(encoded)) return 1;
@@ -1487,7 +1488,7 @@ uint16 Script_Unit_MoveToStructure(ScriptEngine *script)
 	Unit *u;
 	PoolFindStruct find;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (u->o.linkedID != 0xFF) {
 		Structure *s;
@@ -1539,7 +1540,7 @@ uint16 Script_Unit_GetAmount(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (u->o.linkedID == 0xFF) return u->amount;
 
@@ -1560,7 +1561,7 @@ uint16 Script_Unit_IsInTransport(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	return u->o.flags.s.inTransport ? 1 : 0;
 }
@@ -1581,7 +1582,7 @@ uint16 Script_Unit_StartAnimation(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	position = Tile_PackTile(Tile_Center(u->o.position));
 	Animation_Stop_ByTile(position);
@@ -1589,7 +1590,8 @@ uint16 Script_Unit_StartAnimation(ScriptEngine *script)
 	animationUnitID = g_table_landscapeInfo[Map_GetLandscapeType(Tile_PackTile(u->o.position))].isSand ? 0 : 1;
 	if (u->o.script.variables[1] == 1) animationUnitID += 2;
 
-	g_map[position].houseID = Unit_GetHouseID(u);
+	g_game->map[position].houseID = Unit_GetHouseID(u);
+	Map_MarkDirty(position);
 
 	assert(animationUnitID < 4);
 	if (g_table_unitInfo[u->o.type].displayMode == DISPLAYMODE_INFANTRY_3_FRAMES) {
@@ -1617,7 +1619,7 @@ uint16 Script_Unit_CallUnitByType(ScriptEngine *script)
 	uint16 encoded;
 	uint16 encoded2;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (u->o.script.variables[4] != 0) return u->o.script.variables[4];
 	if (!g_table_unitInfo[u->o.type].o.flags.canBePickedUp || u->deviated != 0) return 0;
@@ -1650,7 +1652,7 @@ uint16 Script_Unit_Unknown2552(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	if (u->o.script.variables[4] == 0) return 0;
 
 	u2 = Tools_Index_GetUnit(u->o.script.variables[4]);
@@ -1675,7 +1677,7 @@ uint16 Script_Unit_FindStructure(ScriptEngine *script)
 	Unit *u;
 	PoolFindStruct find;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	for (const Structure *s = Structure_FindFirst(&find, Unit_GetHouseID(u), STACK_PEEK(1));
 			s != NULL;
@@ -1700,7 +1702,7 @@ uint16 Script_Unit_FindStructure(ScriptEngine *script)
  */
 uint16 Script_Unit_DisplayDestroyedText(ScriptEngine *script)
 {
-	const Unit *u = g_scriptCurrentUnit;
+	const Unit *u = g_game->scriptCurrentUnit;
 	const enum HouseType houseID = Unit_GetHouseID(u);
 	VARIABLE_NOT_USED(script);
 
@@ -1726,7 +1728,7 @@ uint16 Script_Unit_RemoveFog(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	Unit_RemoveFog(UNVEILCAUSE_UNIT_SCRIPT, u);
 	return 0;
 }
@@ -1747,7 +1749,7 @@ uint16 Script_Unit_Harvest(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (AI_IsBrutalAI(Unit_GetHouseID(u))) {
 		/* In brutal AI, call for a carryall if a worm attack is imminent. */
@@ -1796,7 +1798,7 @@ uint16 Script_Unit_IsValidDestination(ScriptEngine *script)
 	uint16 encoded;
 	uint16 index;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	encoded = STACK_PEEK(1);
 	index = Tools_Index_Decode(encoded);
 
@@ -1838,7 +1840,7 @@ uint16 Script_Unit_GetRandomTile(ScriptEngine *script)
 	Unit *u;
 	tile32 tile;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	if (Tools_Index_GetType(STACK_PEEK(1)) != IT_TILE) return 0;
 
@@ -1864,7 +1866,7 @@ uint16 Script_Unit_IdleAction(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	random = Tools_RandomLCG_Range(0, 10);
 	movementType = g_table_unitInfo[u->o.type].movementType;
@@ -1900,7 +1902,7 @@ uint16 Script_Unit_GoToClosestStructure(ScriptEngine *script)
 	PoolFindStruct find;
 	uint16 distanceMin =0;
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	for (const Structure *s2 = Structure_FindFirst(&find, Unit_GetHouseID(u), STACK_PEEK(1));
 			s2 != NULL;
@@ -1941,7 +1943,7 @@ uint16 Script_Unit_MCVDeploy(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	Unit_UpdateMap(0, u);
 
@@ -1984,7 +1986,7 @@ uint16 Script_Unit_Sandworm_GetBestTarget(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	u2 = Unit_Sandworm_FindBestTarget(u);
 	if (u2 == NULL) return 0;
@@ -2006,7 +2008,7 @@ uint16 Script_Unit_Unknown2BD5(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 
 	switch (Tools_Index_GetType(u->o.script.variables[4])) {
 		case IT_UNIT: {
@@ -2047,7 +2049,7 @@ uint16 Script_Unit_Blink(ScriptEngine *script)
 
 	VARIABLE_NOT_USED(script);
 
-	u = g_scriptCurrentUnit;
+	u = g_game->scriptCurrentUnit;
 	u->blinkCounter = 32;
 	return 0;
 }
@@ -25,12 +25,18 @@
 #include "timer/timer.h"
 #include "video/video.h"
 
+#if defined(WITH_SOFTWARE_VIDEO) && !defined(DEDICATED_SERVER)
+#define Video_DrawShape             VideoSoftA5_DrawShape
+#define Video_DrawShapeRotate       VideoSoftA5_DrawShapeRotate
+#define Video_DrawShapeTint         VideoSoftA5_DrawShapeTint
+#else
 #define Video_DrawShape             VideoA5_DrawShape
 #define Video_DrawShapeRotate       VideoA5_DrawShapeRotate
+#define Video_DrawShapeTint         VideoA5_DrawShapeTint
+#endif
 #define Video_DrawShapeScale        VideoA5_DrawShapeScale
 #define Video_DrawShapeGrey         VideoA5_DrawShapeGrey
 #define Video_DrawShapeGreyScale    VideoA5_DrawShapeGreyScale
-#define Video_DrawShapeTint         VideoA5_DrawShapeTint
 
 int
 Shape_Width(enum ShapeID shapeID)
@@ -0,0 +1,275 @@
+/**
+ * @file src/snapshot.c
+ *
+ * Simulation snapshots.
+ *
+ * A snapshot is a copy of the simulation state: the game context,
+ * the simulation globals outside it, the explosion and animation
+ * heaps, the build queues and the random generators.
+ * Taking a snapshot leaves the live state alone, and a snapshot can be
+ * restored any number of times.  This is meant for restarting from a
+ * checkpoint, trying moves ahead, or rolling the game back.
+ *
+ * Interface state (selection, viewport, active structure) belongs to
+ * the local player and is left alone.  Loaded data such as sprites,
+ * scripts and strings is not part of the simulation.
+ *
+ * Every part is copied whole, both ways.  Nothing tracks which parts
+ * of the simulation state were written since the last copy: objects,
+ * tiles and houses are written in place all over the game code.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+#include "os/math.h"
+
+#include "snapshot.h"
+
+#include "animation.h"
+#include "arena.h"
+#include "binheap.h"
+#include "buildqueue.h"
+#include "explosion.h"
+#include "gamecontext.h"
+#include "house.h"
+#include "influence.h"
+#include "map.h"
+#include "mods/multiplayer.h"
+#include "net/net.h"
+#include "opendune.h"
+#include "pool/pool_house.h"
+#include "pool/pool_structure.h"
+#include "pool/pool_unit.h"
+#include "structure.h"
+#include "tools/random_general.h"
+#include "tools/random_lcg.h"
+#include "tools/random_starport.h"
+#include "unit.h"
+
+enum {
+	/* Build queues: one per structure, then one per house. */
+	SNAPSHOT_MAX_QUEUES = STRUCTURE_INDEX_MAX_HARD + STRUCTURE_INDEX_RAISED_AMOUNT + HOUSE_MAX
+};
+
+struct GameSnapshot {
+	/* The map, pools, timers, scenario and AI squads. */
+	GameContext *context;
+
+	/* Simulation state kept outside the game context. */
+	Multiplayer multiplayer;
+	enum HouseFlag client_houses;
+	enum HouseType playerHouseID;
+	House *playerHouse;
+	uint16 campaignID;
+	uint16 scenarioID;
+	int16 starportAvailable[UNIT_MAX];
+
+	BinHeap explosions;
+	BinHeap animations;
+
+	/* The queue items live in the scenario arena, so they are copied
+	 * out as plain lists.
+	 */
+	int num_structure_queues;
+	uint16 queue_len[SNAPSHOT_MAX_QUEUES];
+	BuildQueueItem *queue_item;
+	int num_queue_items;
+	int max_queue_items;
+
+	uint32 random_general;
+	uint32 random_lcg;
+	uint16 random_starport_seed;
+	uint32 random_starport;
+
+	/* False until the snapshot has been taken once. */
+	bool taken;
+};
+
+/*--------------------------------------------------------------*/
+
+static void
+GameSnapshot_CopyHeap(BinHeap *dst, BinHeap *src)
+{
+	if (dst->elem == NULL || dst->elem_size != src->elem_size)
+		BinHeap_Init(dst, src->elem_size);
+
+	if (dst->max_elem < src->num_elem) {
+		const bool resized = BinHeap_Resize(dst, src->max_elem);
+		assert(resized);
+		VARIABLE_NOT_USED(resized);
+	}
+
+	if (src->num_elem > 0)
+		memcpy(dst->elem, src->elem, src->num_elem * src->elem_size);
+
+	dst->num_elem = src->num_elem;
+}
+
+static BuildQueue *
+GameSnapshot_GetQueue(int i, int num_structure_queues)
+{
+	if (i < num_structure_queues)
+		return &Structure_Get_ByIndex(i)->queue;
+
+	return &House_Get_ByIndex(i - num_structure_queues)->starportQueue;
+}
+
+static void
+GameSnapshot_SaveQueues(GameSnapshot *snap)
+{
+	snap->num_structure_queues = StructurePool_GetIndex(STRUCTURE_INDEX_MAX_HARD);
+	snap->num_queue_items = 0;
+
+	for (int i = 0; i < snap->num_structure_queues + HOUSE_MAX; i++) {
+		const BuildQueue *queue = GameSnapshot_GetQueue(i, snap->num_structure_queues);
+		uint16 len = 0;
+
+		for (const BuildQueueItem *e = queue->first; e != NULL; e = e->next) {
+			if (snap->num_queue_items >= snap->max_queue_items) {
+				snap->max_queue_items = max(2 * snap->max_queue_items, 64);
+				snap->queue_item = realloc(snap->queue_item,
+						snap->max_queue_items * sizeof(snap->queue_item[0]));
+				assert(snap->queue_item != NULL);
+			}
+
+			snap->queue_item[snap->num_queue_items++] = *e;
+			len++;
+		}
+
+		snap->queue_len[i] = len;
+	}
+}
+
+/**
+ * @brief   Rebuilds the build queues from their lists.
+ * @details The restored pools point at the items of the live arena,
+ *          which are thrown away.  The counts came back with the pools.
+ */
+static void
+GameSnapshot_LoadQueues(const GameSnapshot *snap)
+{
+	const int num_structure_queues
+		= min(snap->num_structure_queues, (int)StructurePool_GetIndex(STRUCTURE_INDEX_MAX_HARD));
+	const BuildQueueItem *e = snap->queue_item;
+
+	Arena_Reset(&g_scenarioArena);
+
+	for (int i = 0; i < snap->num_structure_queues + HOUSE_MAX; i++) {
+		const bool live
+			= (i < num_structure_queues) || (i >= snap->num_structure_queues);
+
+		if (!live) {
+			e += snap->queue_len[i];
+			continue;
+		}
+
+		BuildQueue *queue = GameSnapshot_GetQueue(i, snap->num_structure_queues);
+
+		queue->first = NULL;
+		queue->last = NULL;
+
+		for (int j = 0; j < snap->queue_len[i]; j++, e++) {
+			BuildQueue_Append(queue, e->objectType, e->credits);
+		}
+	}
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Creates an empty snapshot.
+ * @details Take it before restoring it.
+ */
+GameSnapshot *
+GameSnapshot_Create(void)
+{
+	GameSnapshot *snap = calloc(1, sizeof(GameSnapshot));
+	assert(snap != NULL);
+
+	snap->context = GameContext_Create();
+
+	return snap;
+}
+
+void
+GameSnapshot_Free(GameSnapshot *snap)
+{
+	if (snap == NULL)
+		return;
+
+	GameContext_Free(snap->context);
+	BinHeap_Free(&snap->explosions);
+	BinHeap_Free(&snap->animations);
+	free(snap->queue_item);
+	free(snap);
+}
+
+/**
+ * @brief   Copies the live simulation state into snap.
+ * @details Must not be called in the middle of a game tick.
+ */
+void
+GameSnapshot_Take(GameSnapshot *snap)
+{
+	Unit_SyncScriptDelays();
+	Structure_SyncScriptDelays();
+
+	GameContext_Copy(snap->context, g_game);
+
+	snap->multiplayer = g_multiplayer;
+	snap->client_houses = g_client_houses;
+	snap->playerHouseID = g_playerHouseID;
+	snap->playerHouse = g_playerHouse;
+	snap->campaignID = g_campaignID;
+	snap->scenarioID = g_scenarioID;
+	memcpy(snap->starportAvailable, g_starportAvailable, sizeof(g_starportAvailable));
+
+	GameSnapshot_CopyHeap(&snap->explosions, Explosion_GetHeap());
+	GameSnapshot_CopyHeap(&snap->animations, Animation_GetHeap());
+	GameSnapshot_SaveQueues(snap);
+
+	snap->random_general = Tools_Random_GetState();
+	snap->random_lcg = Tools_RandomLCG_GetState();
+	snap->random_starport_seed = Random_Starport_GetInitialSeed();
+	snap->random_starport = Random_Starport_GetState();
+	snap->taken = true;
+}
+
+/**
+ * @brief   Makes the state in snap live again.
+ * @details Must not be called in the middle of a game tick.  The
+ *          snapshot is left intact.
+ * @return  False if the snapshot was never taken.
+ */
+bool
+GameSnapshot_Restore(const GameSnapshot *snap)
+{
+	if (!snap->taken)
+		return false;
+
+	GameContext_Copy(g_game, snap->context);
+	Unit_ResetScriptWheel();
+	Structure_ResetScriptWheel();
+
+	g_multiplayer = snap->multiplayer;
+	g_client_houses = snap->client_houses;
+	g_playerHouseID = snap->playerHouseID;
+	g_playerHouse = snap->playerHouse;
+	g_campaignID = snap->campaignID;
+	g_scenarioID = snap->scenarioID;
+	memcpy(g_starportAvailable, snap->starportAvailable, sizeof(g_starportAvailable));
+
+	GameSnapshot_CopyHeap(Explosion_GetHeap(), (BinHeap *)&snap->explosions);
+	GameSnapshot_CopyHeap(Animation_GetHeap(), (BinHeap *)&snap->animations);
+	GameSnapshot_LoadQueues(snap);
+
+	Tools_Random_Seed(snap->random_general);
+	Tools_RandomLCG_SetState(snap->random_lcg);
+	Random_Starport_SetState(snap->random_starport_seed, snap->random_starport);
+	Influence_Invalidate();
+	Map_MarkAllDirty();
+
+	return true;
+}
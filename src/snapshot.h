@@ -0,0 +1,15 @@
+/** @file src/snapshot.h Simulation snapshot definitions. */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+
+typedef struct GameSnapshot GameSnapshot;
+
+extern GameSnapshot *GameSnapshot_Create(void);
+extern void GameSnapshot_Free(GameSnapshot *snap);
+extern void GameSnapshot_Take(GameSnapshot *snap);
+extern bool GameSnapshot_Restore(const GameSnapshot *snap);
+
+#endif /* SNAPSHOT_H */
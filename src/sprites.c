@@ -13,7 +13,7 @@
 
 #include "sprites.h"
 
-#include "codec/format80.h"
+#include "codec/image.h"
 #include "file.h"
 #include "gfx.h"
 #include "gui/gui.h"
@@ -25,24 +25,25 @@
 #include "video/video.h"
 
 
-uint8 *g_sprites[SHAPE_MAX];
-uint8 *g_spriteBuffer;
-uint8 *g_iconRTBL = NULL;
-uint8 *g_iconRPAL = NULL;
-uint8 *g_spriteInfo = NULL;
-uint16 *g_iconMap = NULL;
+THREAD_LOCAL uint8 *g_sprites[SHAPE_MAX];
+THREAD_LOCAL uint8 *g_spriteBuffer;
+THREAD_LOCAL uint8 *g_iconRTBL = NULL;
+THREAD_LOCAL uint8 *g_iconRPAL = NULL;
+THREAD_LOCAL uint8 *g_spriteInfo = NULL;
+THREAD_LOCAL uint16 *g_iconMap = NULL;
 
-uint8 *g_fileRgnclkCPS = NULL;
-void *g_fileRegionINI = NULL;
-uint16 *g_regions = NULL;
+THREAD_LOCAL uint8 *g_fileRgnclkCPS = NULL;
+THREAD_LOCAL void *g_fileRegionINI = NULL;
+THREAD_LOCAL uint16 *g_regions = NULL;
 
-uint16 g_veiledSpriteID;
-uint16 g_bloomSpriteID;
-uint16 g_landscapeSpriteID;
-uint16 g_builtSlabSpriteID;
-uint16 g_wallSpriteID;
+THREAD_LOCAL uint16 g_veiledSpriteID;
+THREAD_LOCAL uint16 g_bloomSpriteID;
+THREAD_LOCAL uint16 g_landscapeSpriteID;
+THREAD_LOCAL uint16 g_builtSlabSpriteID;
+THREAD_LOCAL uint16 g_wallSpriteID;
 
-static bool s_iconLoaded = false;
+static THREAD_LOCAL bool s_iconLoaded = false;
+static THREAD_LOCAL int s_iconPrefetchCampaign = -1;
 
 /**
  * Gets the given sprite inside the given buffer.
@@ -133,40 +134,6 @@ uint8 Sprite_GetHeight(const uint8 *sprite)
 extern uint16 Sprites_GetType(uint8 *sprite);
 #endif
 
-/**
- * Decodes an image.
- *
- * @param source The encoded image.
- * @param dest The place the decoded image will be.
- * @return The size of the decoded image.
- */
-static uint32 Sprites_Decode(const uint8 *source, uint8 *dest)
-{
-	uint32 size = 0;
-
-	switch(*source) {
-		case 0x0:
-			source += 2;
-			size = READ_LE_UINT32(source);
-			source += 4;
-			source += READ_LE_UINT16(source);
-			source += 2;
-			memmove(dest, source, size);
-			break;
-
-		case 0x4:
-			source += 6;
-			source += READ_LE_UINT16(source);
-			source += 2;
-			size = Format80_Decode(dest, source, 0xFFFF);
-			break;
-
-		default: break;
-	}
-
-	return size;
-}
-
 /**
  * Loads an ICN file.
  *
@@ -197,7 +164,7 @@ static void Sprites_LoadICNFile(const char *filename)
 	free(g_spriteInfo);
 	g_spriteInfo = calloc(1, spriteInfoLength);
 	ChunkFile_Read(fileIndex, HTOBE32(CC_SSET), g_spriteInfo, spriteInfoLength);
-	Sprites_Decode(g_spriteInfo, g_spriteInfo);
+	Image_Decode(g_spriteInfo, g_spriteInfo);
 
 	/* Get the Table chunk */
 	free(g_iconRTBL);
@@ -213,14 +180,10 @@ static void Sprites_LoadICNFile(const char *filename)
 }
 
 /**
- * Loads the sprites for tiles.
+ * Loads ICON.ICN and ICON.MAP.
  */
-void Sprites_LoadTiles(void)
+static void Sprites_LoadIconData(void)
 {
-	if (s_iconLoaded) return;
-
-	s_iconLoaded = true;
-
 	Sprites_LoadICNFile("ICON.ICN");
 
 	free(g_iconMap);
@@ -231,8 +194,37 @@ void Sprites_LoadTiles(void)
 	g_builtSlabSpriteID = g_iconMap[g_iconMap[ICM_ICONGROUP_CONCRETE_SLAB] + 2];
 	g_landscapeSpriteID = g_iconMap[g_iconMap[ICM_ICONGROUP_LANDSCAPE]];
 	g_wallSpriteID      = g_iconMap[g_iconMap[ICM_ICONGROUP_WALLS]];
+}
+
+/**
+ * Loads the sprites for tiles.
+ */
+void Sprites_LoadTiles(void)
+{
+	if (s_iconLoaded) return;
+
+	s_iconLoaded = true;
+
+	if (s_iconPrefetchCampaign != g_campaign_selected)
+		Sprites_LoadIconData();
+
+	s_iconPrefetchCampaign = -1;
+
+	Script_LoadFromFile("UNIT.EMC", &g_scriptUnit, g_scriptFunctionsUnit, GFX_Screen_Get_ByIndex(SCREEN_2));
+}
+
+/**
+ * @brief   Loads the tile sprites ahead of the next Sprites_LoadTiles.
+ * @details Introduced.  Called during the briefing.  UNIT.EMC is not
+ *          prefetched because it is loaded into SCREEN_2, which holds
+ *          the mentat's WSA.
+ */
+void Sprites_PrefetchTiles(void)
+{
+	if (s_iconPrefetchCampaign == g_campaign_selected) return;
 
-	Script_LoadFromFile("UNIT.EMC", g_scriptUnit, g_scriptFunctionsUnit, GFX_Screen_Get_ByIndex(SCREEN_2));
+	Sprites_LoadIconData();
+	s_iconPrefetchCampaign = g_campaign_selected;
 }
 
 /**
@@ -290,7 +282,7 @@ Sprites_LoadCPSFile(enum SearchDirectory dir, const char *filename,
 
 	File_Close(index);
 
-	return Sprites_Decode(buffer2, buffer);
+	return Image_Decode(buffer2, buffer);
 }
 
 /**
@@ -386,9 +378,9 @@ Sprites_InitCHOAM(const char *bttn, const char *choam)
 void
 Sprites_InitMentat(enum MentatID mentatID)
 {
-	static enum MentatID l_mentatID = MENTAT_MAX;
-	static enum HouseType l_houseID = HOUSE_INVALID;
-	static int l_campaign_selected = -1;
+	static THREAD_LOCAL enum MentatID l_mentatID = MENTAT_MAX;
+	static THREAD_LOCAL enum HouseType l_houseID = HOUSE_INVALID;
+	static THREAD_LOCAL int l_campaign_selected = -1;
 
 	const char *shapes[HOUSE_NEUTRAL] = {
 		"MENSHPH.SHP", "MENSHPA.SHP", "MENSHPO.SHP",
@@ -418,7 +410,7 @@ Sprites_InitMentat(enum MentatID mentatID)
 void
 Sprites_InitCredits(void)
 {
-	static bool l_loaded = false;
+	static THREAD_LOCAL bool l_loaded = false;
 
 	if (l_loaded)
 		return;
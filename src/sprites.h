@@ -54,22 +54,22 @@ enum IconMapEntries {
 	ICM_ICONGROUP_EOF                    = 27  /*!< End of file spriteIDs. */
 };
 
-extern uint8 *g_sprites[SHAPE_MAX];
-extern uint8 *g_spriteBuffer;
-extern uint8 *g_iconRTBL;
-extern uint8 *g_iconRPAL;
-extern uint8 *g_spriteInfo;
-extern uint16 *g_iconMap;
+extern THREAD_LOCAL uint8 *g_sprites[SHAPE_MAX];
+extern THREAD_LOCAL uint8 *g_spriteBuffer;
+extern THREAD_LOCAL uint8 *g_iconRTBL;
+extern THREAD_LOCAL uint8 *g_iconRPAL;
+extern THREAD_LOCAL uint8 *g_spriteInfo;
+extern THREAD_LOCAL uint16 *g_iconMap;
 
-extern uint8 *g_fileRgnclkCPS;
-extern void *g_fileRegionINI;
-extern uint16 *g_regions;
+extern THREAD_LOCAL uint8 *g_fileRgnclkCPS;
+extern THREAD_LOCAL void *g_fileRegionINI;
+extern THREAD_LOCAL uint16 *g_regions;
 
-extern uint16 g_veiledSpriteID;                             /*!< SpriteID of the veiled sprite, at the end of the partily veiled sprites. */
-extern uint16 g_bloomSpriteID;                              /*!< First bloom field spriteID. */
-extern uint16 g_landscapeSpriteID;                          /*!< First landscape spriteID. */
-extern uint16 g_builtSlabSpriteID;                          /*!< SpriteID of the built concrete slab. */
-extern uint16 g_wallSpriteID;                               /*!< First wall spriteID. */
+extern THREAD_LOCAL uint16 g_veiledSpriteID;                             /*!< SpriteID of the veiled sprite, at the end of the partily veiled sprites. */
+extern THREAD_LOCAL uint16 g_bloomSpriteID;                              /*!< First bloom field spriteID. */
+extern THREAD_LOCAL uint16 g_landscapeSpriteID;                          /*!< First landscape spriteID. */
+extern THREAD_LOCAL uint16 g_builtSlabSpriteID;                          /*!< SpriteID of the built concrete slab. */
+extern THREAD_LOCAL uint16 g_wallSpriteID;                               /*!< First wall spriteID. */
 
 extern void Sprites_Init(void);
 extern void Sprites_InitCHOAM(const char *bttn, const char *choam);
@@ -80,6 +80,7 @@ extern uint8 Sprite_GetWidth(const uint8 *sprite);
 extern uint8 Sprite_GetHeight(const uint8 *sprite);
 extern void Sprites_LoadTiles(void);
 extern void Sprites_UnloadTiles(void);
+extern void Sprites_PrefetchTiles(void);
 extern uint16 Sprites_LoadImage(enum SearchDirectory dir, const char *filename, Screen screenID, uint8 *palette);
 extern void Sprites_CPS_LoadRegionClick(void);
 
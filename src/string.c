@@ -16,6 +16,7 @@
 
 #include "string.h"
 
+#include "codec/digram.h"
 #include "config.h"
 #include "enhancement.h"
 #include "file.h"
@@ -24,9 +25,9 @@
 #include "scenario.h"
 #include "table/locale.h"
 
-static char **s_strings = NULL;
-static uint16 s_stringsCount = 0;
-static char *s_strings_mentat[HOUSE_NEUTRAL][40];
+static THREAD_LOCAL char **s_strings = NULL;
+static THREAD_LOCAL uint16 s_stringsCount = 0;
+static THREAD_LOCAL char *s_strings_mentat[HOUSE_NEUTRAL][40];
 
 const char * const g_gameSubtitle[] = {
 	"The Battle for Arrakis",
@@ -34,35 +35,6 @@ const char * const g_gameSubtitle[] = {
 	"The Building of a Dynasty"
 };
 
-static const char * const s_stringDecompress = " etainosrlhcdupmtasio wb rnsdalmh ieorasnrtlc synstcloer dtgesionr ufmsw tep.icae oiadur laeiyodeia otruetoakhlr eiu,.oansrctlaileoiratpeaoip bm";
-
-/**
- * Decompress a string.
- *
- * @param source The compressed string.
- * @param dest The decompressed string.
- * @return The length of decompressed string.
- */
-uint16 String_Decompress(const char *source, char *dest)
-{
-	uint16 count;
-	const char *s;
-
-	count = 0;
-
-	for (s = source; *s != '\0'; s++) {
-		uint8 c = *s;
-		if ((c & 0x80) != 0) {
-			c &= 0x7F;
-			dest[count++] = s_stringDecompress[c >> 3];
-			c = s_stringDecompress[c + 16];
-		}
-		dest[count++] = c;
-	}
-	dest[count] = '\0';
-	return count;
-}
-
 /**
  * Appends ".(ENG|FRE|...)" to the given string.
  *
@@ -71,7 +43,7 @@ uint16 String_Decompress(const char *source, char *dest)
  */
 const char *String_GenerateFilename(const char *name)
 {
-	static char filename[14];
+	static THREAD_LOCAL char filename[14];
 
 	snprintf(filename, sizeof(filename), "%s.%s",
 			name, g_table_languageInfo[g_gameConfig.language].suffix);
@@ -185,7 +157,7 @@ String_Load(enum SearchDirectory dir, const char *filename, bool compressed, int
 		char *dst;
 		if (compressed) {
 			dst = (char *)calloc(strlen(src) * 2 + 1, sizeof(char));
-			String_Decompress(src, dst);
+			Digram_Decode(src, dst);
 			String_TranslateSpecial(dst, dst);
 		} else {
 			dst = strdup(src);
@@ -253,7 +225,7 @@ String_ReloadCampaignStrings(void)
 
 			if (compressed) {
 				dst = (char *)calloc(strlen(src) * 2 + 1, sizeof(char));
-				String_Decompress(src, dst);
+				Digram_Decode(src, dst);
 				String_TranslateSpecial(dst, dst);
 			} else {
 				dst = strdup(src);
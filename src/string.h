@@ -8,7 +8,6 @@
 
 extern const char * const g_gameSubtitle[3];
 
-extern uint16 String_Decompress(const char *source, char *dest);
 extern const char *String_GenerateFilename(const char *name);
 extern char *String_Get_ByIndex(uint16 stringID);
 extern const char *String_GetMentatString(enum HouseType houseID, int stringID);
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "enum_string.h"
+#include "errorlog.h"
 #include "types.h"
 #include "os/math.h"
 #include "os/strings.h"
@@ -16,6 +17,7 @@
 #include "audio/audio.h"
 #include "enhancement.h"
 #include "explosion.h"
+#include "gamecontext.h"
 #include "gfx.h"
 #include "gui/widget.h"
 #include "house.h"
@@ -36,6 +38,7 @@
 #include "team.h"
 #include "tile.h"
 #include "timer/timer.h"
+#include "timer/timerwheel.h"
 #include "tools/coord.h"
 #include "tools/encoded_index.h"
 #include "tools/random_general.h"
@@ -44,14 +47,138 @@
 #include "unit.h"
 
 
-Structure *g_structureActive = NULL;
-uint16 g_structureActivePosition = 0;
-uint16 g_structureActiveType = 0;
+THREAD_LOCAL Structure *g_structureActive = NULL;
+THREAD_LOCAL uint16 g_structureActivePosition = 0;
+THREAD_LOCAL uint16 g_structureActiveType = 0;
 
 static bool s_debugInstantBuild = false; /*!< When non-zero, constructions are almost instant. */
 
 static bool Structure_SkipUpgradeLevel(const Structure *s, int level);
 
+/* Structure scripts sleep in a timer wheel the same way as Unit scripts;
+ * see s_unitScriptWheel.  Structures have nothing else to do between
+ * their slower ticks, so a script tick with no Structure due does not
+ * visit them at all unless fog of war needs refreshing.
+ */
+static THREAD_LOCAL TimerWheel s_structureScriptWheel;
+static THREAD_LOCAL uint32 s_structureScriptTicksOwed;       /*!< Script ticks not yet taken off the delays. */
+static THREAD_LOCAL uint32 s_structureScriptTick;            /*!< The script tick being run. */
+static THREAD_LOCAL bool   s_structureScriptLazy;            /*!< The script tick being run has no Structure due. */
+static THREAD_LOCAL uint16 s_structureScriptPassed;          /*!< Find positions before this one have had the script tick being run. */
+static THREAD_LOCAL bool   s_structureScriptReset = true;    /*!< The wheel does not know the Structures yet. */
+
+/**
+ * @brief   Takes the script ticks that had no Structure due off the
+ *          delays of the Structures on the map.
+ * @details Introduced.  script.delay is only up to date after this.
+ */
+void
+Structure_SyncScriptDelays(void)
+{
+	PoolFindStruct find;
+
+	if (s_structureScriptTicksOwed == 0 && !s_structureScriptLazy)
+		return;
+
+	for (Structure *s = Structure_FindFirst(&find, HOUSE_INVALID, STRUCTURE_INVALID);
+			s != NULL;
+			s = Structure_FindNext(&find)) {
+		uint32 owed = s_structureScriptTicksOwed;
+
+		if (s->o.flags.s.isNotOnMap || Structure_SharesPoolElement(s->o.type))
+			continue;
+
+		if (s_structureScriptLazy && find.index < s_structureScriptPassed)
+			owed++;
+
+		/* A delay set without waking the script first; it should have
+		 * run already, so run it on the next script tick. */
+		if (s->o.script.delay < owed) {
+			Warning("Structure %d: script delay %d is behind by %d script ticks.\n",
+					s->o.index, s->o.script.delay, (int)(owed - s->o.script.delay));
+			s->o.script.delay = 0;
+			if (!s_structureScriptReset)
+				TimerWheel_Schedule(&s_structureScriptWheel, s->o.index, TimerWheel_GetNow(&s_structureScriptWheel));
+			continue;
+		}
+
+		s->o.script.delay -= owed;
+	}
+
+	/* The rest of the script tick being run counts down as usual. */
+	s_structureScriptTicksOwed = 0;
+	s_structureScriptLazy = false;
+}
+
+/**
+ * @brief   Makes the Structure's script due on the next script tick.
+ * @details Introduced.  Must be called before anything but the
+ *          Structure's own script sets its script.delay, or before the
+ *          Structure is put on the map.
+ */
+void
+Structure_WakeScript(const Structure *s)
+{
+	Structure_SyncScriptDelays();
+
+	if (!s_structureScriptReset && !Structure_SharesPoolElement(s->o.type)) {
+		TimerWheel_Schedule(&s_structureScriptWheel, s->o.index,
+				TimerWheel_GetNow(&s_structureScriptWheel));
+	}
+}
+
+/**
+ * @brief   Makes every Structure's script due on the next script tick.
+ * @details Introduced.  For when the Structure pool is loaded or rebuilt.
+ */
+void
+Structure_ResetScriptWheel(void)
+{
+	Structure_SyncScriptDelays();
+	s_structureScriptReset = true;
+}
+
+static void
+Structure_BeginScriptTick(void)
+{
+	if (s_structureScriptReset)
+		TimerWheel_Init(&s_structureScriptWheel, 0);
+
+	s_structureScriptTick = TimerWheel_GetNow(&s_structureScriptWheel);
+
+	const bool due = (TimerWheel_Advance(&s_structureScriptWheel) != 0);
+
+	s_structureScriptLazy = g_scriptWheel && !due && !s_structureScriptReset;
+	s_structureScriptPassed = 0;
+	s_structureScriptReset = false;
+
+	if (!s_structureScriptLazy)
+		Structure_SyncScriptDelays();
+}
+
+static void
+Structure_EndScriptTick(void)
+{
+	PoolFindStruct find;
+
+	if (s_structureScriptLazy) {
+		s_structureScriptLazy = false;
+		s_structureScriptTicksOwed++;
+		return;
+	}
+
+	/* Structures the loop did not get to look again next script tick. */
+	for (const Structure *s = Structure_FindFirst(&find, HOUSE_INVALID, STRUCTURE_INVALID);
+			s != NULL;
+			s = Structure_FindNext(&find)) {
+		if (!s->o.flags.s.isNotOnMap
+				&& !Structure_SharesPoolElement(s->o.type)
+				&& !TimerWheel_IsScheduled(&s_structureScriptWheel, s->o.index)) {
+			TimerWheel_Schedule(&s_structureScriptWheel, s->o.index, s_structureScriptTick + 1);
+		}
+	}
+}
+
 /**
  * Loop over all structures, preforming various of tasks.
  */
@@ -63,28 +190,53 @@ void GameLoop_Structure(void)
 	bool tickScript    = false;
 	bool tickPalace    = false;
 
-	if (g_tickStructureDegrade <= g_timerGame && g_campaignID > 1) {
+	if (g_game->tickStructureDegrade <= g_game->timerGame && g_campaignID > 1) {
 		tickDegrade = true;
-		g_tickStructureDegrade = g_timerGame + Tools_AdjustToGameSpeed(10800, 5400, 21600, true);
+		g_game->tickStructureDegrade = g_game->timerGame + Tools_AdjustToGameSpeed(10800, 5400, 21600, true);
 	}
 
-	if (g_tickStructureStructure <= g_timerGame || s_debugInstantBuild) {
+	if (g_game->tickStructureStructure <= g_game->timerGame || s_debugInstantBuild) {
 		tickStructure = true;
-		g_tickStructureStructure = g_timerGame + Tools_AdjustToGameSpeed(30, 15, 60, true);
+		g_game->tickStructureStructure = g_game->timerGame + Tools_AdjustToGameSpeed(30, 15, 60, true);
 	}
 
-	if (g_tickStructureScript <= g_timerGame) {
+	if (g_game->tickStructureScript <= g_game->timerGame) {
 		tickScript = true;
-		g_tickStructureScript = g_timerGame + 5;
+		g_game->tickStructureScript = g_game->timerGame + 5;
 	}
 
-	if (g_tickStructurePalace <= g_timerGame) {
+	if (g_game->tickStructurePalace <= g_game->timerGame) {
 		tickPalace = true;
-		g_tickStructurePalace = g_timerGame + 60;
+		g_game->tickStructurePalace = g_game->timerGame + 60;
 	}
 
 	if (g_debugScenario) return;
 
+	if (tickScript)
+		Structure_BeginScriptTick();
+
+	/* Without fog of war to refresh, structures have nothing to do
+	 * between the ticks above, or on script ticks with no script due,
+	 * so do not walk them.  The last one walked would have been left
+	 * as the current object.
+	 */
+	if (!enhancement_fog_of_war && !tickDegrade && !tickStructure && !tickPalace
+			&& (!tickScript || s_structureScriptLazy)) {
+		Structure *s = Structure_FindLast();
+
+		if (s != NULL) {
+			g_game->scriptCurrentObject    = &s->o;
+			g_game->scriptCurrentStructure = s;
+			g_game->scriptCurrentUnit      = NULL;
+			g_game->scriptCurrentTeam      = NULL;
+		}
+
+		if (tickScript)
+			Structure_EndScriptTick();
+
+		return;
+	}
+
 	for (Structure *s = Structure_FindFirst(&find, HOUSE_INVALID, STRUCTURE_INVALID);
 			s != NULL;
 			s = Structure_FindNext(&find)) {
@@ -98,10 +250,10 @@ void GameLoop_Structure(void)
 		h  = House_Get_ByIndex(s->o.houseID);
 		hi = &g_table_houseInfo[h->index];
 
-		g_scriptCurrentObject    = &s->o;
-		g_scriptCurrentStructure = s;
-		g_scriptCurrentUnit      = NULL;
-		g_scriptCurrentTeam      = NULL;
+		g_game->scriptCurrentObject    = &s->o;
+		g_game->scriptCurrentStructure = s;
+		g_game->scriptCurrentUnit      = NULL;
+		g_game->scriptCurrentTeam      = NULL;
 
 		if (enhancement_fog_of_war)
 			Structure_RemoveFog(UNVEILCAUSE_STRUCTURE_VISION, s);
@@ -415,7 +567,9 @@ void GameLoop_Structure(void)
 			}
 		}
 
-		if (tickScript) {
+		if (tickScript && s_structureScriptLazy) {
+			s_structureScriptPassed = find.index + 1;
+		} else if (tickScript) {
 			if (s->o.script.delay != 0) {
 				s->o.script.delay--;
 			} else {
@@ -428,14 +582,23 @@ void GameLoop_Structure(void)
 					}
 
 					/* ENHANCEMENT -- Dune2 aborts all other structures if one gives a script error. This doesn't seem correct */
-					if (!g_dune2_enhanced && i != 3) return;
+					if (!g_dune2_enhanced && i != 3) {
+						Structure_EndScriptTick();
+						return;
+					}
 				} else {
 					Script_Reset(&s->o.script, s->o.script.scriptInfo);
 					Script_Load(&s->o.script, s->o.type);
 				}
 			}
+
+			TimerWheel_Schedule(&s_structureScriptWheel, s->o.index,
+					s_structureScriptTick + 1 + s->o.script.delay);
 		}
 	}
+
+	if (tickScript)
+		Structure_EndScriptTick();
 }
 
 /**
@@ -478,6 +641,7 @@ Structure *Structure_Create(uint16 index, uint8 typeID, uint8 houseID, uint16 po
 	s->o.houseID            = houseID;
 	s->creatorHouseID       = houseID;
 	s->o.flags.s.isNotOnMap = true;
+	Structure_UpdateIndex(s);
 	s->o.position.x         = 0;
 	s->o.position.y         = 0;
 	s->o.linkedID           = 0xFF;
@@ -535,6 +699,7 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 	 * Also, upgrade the factory when it is placed so the player doesn't get the AI's free upgrades.
 	 */
 	s->o.houseID = houseID;
+	Structure_UpdateIndex(s);
 	if (!House_IsHuman(houseID)) {
 		while (true) {
 			if (!Structure_IsUpgradable(s)) break;
@@ -555,13 +720,14 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 			if (Structure_IsValidBuildLocation(houseID, position, STRUCTURE_WALL) == 0)
 				return false;
 
-			t = &g_map[position];
+			t = &g_game->map[position];
 			t->groundSpriteID = g_wallSpriteID + 1;
 			t->overlaySpriteID = 0;
 			/* ENHANCEMENT -- Dune2 wrongfully only removes the lower 2 bits, where the lower 3 bits are the owner. This is no longer visible. */
 			t->houseID  = s->o.houseID;
+			Map_MarkDirty(position);
 
-			g_mapSpriteID[position] |= 0x8000;
+			g_game->mapSpriteID[position] |= 0x8000;
 
 			Tile_RemoveFogInRadius(1 << s->o.houseID, UNVEILCAUSE_STRUCTURE_PLACED,
 					Tile_UnpackTile(position), 1);
@@ -579,7 +745,7 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 
 			for (i = 0; i < g_table_structure_layoutTileCount[si->layout]; i++) {
 				uint16 curPos = position + g_table_structure_layoutTiles[si->layout][i];
-				Tile *t = &g_map[curPos];
+				Tile *t = &g_game->map[curPos];
 
 				if (Structure_IsValidBuildLocation(houseID, curPos, STRUCTURE_SLAB_1x1) == 0)
 					continue;
@@ -587,8 +753,9 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 				t->groundSpriteID = g_builtSlabSpriteID;
 				t->overlaySpriteID = 0;
 				t->houseID = s->o.houseID;
+				Map_MarkDirty(curPos);
 
-				g_mapSpriteID[curPos] |= 0x8000;
+				g_game->mapSpriteID[curPos] |= 0x8000;
 
 				Tile_RemoveFogInRadius(1 << s->o.houseID, UNVEILCAUSE_STRUCTURE_PLACED,
 						Tile_UnpackTile(curPos), 1);
@@ -600,7 +767,7 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 			if (s->o.type == STRUCTURE_SLAB_2x2) {
 				for (i = 0; i < g_table_structure_layoutTileCount[si->layout]; i++) {
 					uint16 curPos = position + g_table_structure_layoutTiles[si->layout][i];
-					Tile *t = &g_map[curPos];
+					Tile *t = &g_game->map[curPos];
 
 					if (Structure_IsValidBuildLocation(houseID, curPos, STRUCTURE_SLAB_1x1) == 0)
 						continue;
@@ -608,8 +775,9 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 					t->groundSpriteID = g_builtSlabSpriteID;
 					t->overlaySpriteID = 0;
 					t->houseID = s->o.houseID;
+					Map_MarkDirty(curPos);
 
-					g_mapSpriteID[curPos] |= 0x8000;
+					g_game->mapSpriteID[curPos] |= 0x8000;
 
 					Tile_RemoveFogInRadius(1 << s->o.houseID, UNVEILCAUSE_STRUCTURE_PLACED,
 							Tile_UnpackTile(curPos), 1);
@@ -652,6 +820,7 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 		s->o.seenByHouses |= House_GetAllies(houseID) | House_GetAIs();
 	}
 
+	Structure_WakeScript(s);
 	s->o.flags.s.isNotOnMap = false;
 
 	s->o.position = Tile_UnpackTile(position);
@@ -676,7 +845,7 @@ bool Structure_Place(Structure *s, uint16 position, enum HouseType houseID)
 		}
 	}
 
-	Script_Reset(&s->o.script, g_scriptStructure);
+	Script_Reset(&s->o.script, &g_scriptStructure);
 
 	s->o.script.variables[0] = 0;
 	s->o.script.variables[4] = 0;
@@ -835,7 +1004,7 @@ Structure *Structure_Get_ByPackedTile(uint16 packed)
 
 	if (Tile_IsOutOfMap(packed)) return NULL;
 
-	tile = &g_map[packed];
+	tile = &g_game->map[packed];
 	if (!tile->hasStructure) return NULL;
 	return Structure_Get_ByIndex(tile->index - 1);
 }
@@ -958,7 +1127,7 @@ Structure_IsValidBuildLocation(enum HouseType houseID,
 			}
 
 			enum LandscapeType lst = Map_GetLandscapeType(curPos);
-			if (g_map[curPos].houseID == houseID
+			if (g_game->map[curPos].houseID == houseID
 					&& (lst == LST_CONCRETE_SLAB || lst == LST_WALL)) {
 				isValid = true;
 				break;
@@ -1148,9 +1317,10 @@ static void Structure_Destroy(Structure *s)
 	s->o.script.variables[0] = 1;
 	s->o.flags.s.allocated = false;
 	s->o.flags.s.repairing = false;
+	Structure_WakeScript(s);
 	s->o.script.delay = 0;
 
-	Script_Reset(&s->o.script, g_scriptStructure);
+	Script_Reset(&s->o.script, &g_scriptStructure);
 	Script_Load(&s->o.script, s->o.type);
 
 	Server_Send_PlaySoundAtTile(FLAG_HOUSE_ALL,
@@ -1244,8 +1414,8 @@ bool Structure_Damage(Structure *s, uint16 damage, uint16 range)
 	}
 
 	if (s->o.hitpoints == 0) {
-		g_scenario.structuresLost[s->o.houseID]++;
-		g_scenario.score[s->o.houseID] -= max(si->o.buildCredits / 100, 1);
+		g_game->scenario.structuresLost[s->o.houseID]++;
+		g_game->scenario.score[s->o.houseID] -= max(si->o.buildCredits / 100, 1);
 
 		Structure_Destroy(s);
 
@@ -1441,11 +1611,12 @@ bool Structure_ConnectWall(uint16 position, bool recurse)
 
 	spriteID = g_wallSpriteID + wall[bits] + 1;
 
-	tile = &g_map[position];
+	tile = &g_game->map[position];
 	if (tile->groundSpriteID == spriteID) return false;
 
 	tile->groundSpriteID = spriteID;
-	g_mapSpriteID[position] |= 0x8000;
+	g_game->mapSpriteID[position] |= 0x8000;
+	Map_MarkDirty(position);
 
 	return true;
 }
@@ -1531,7 +1702,7 @@ uint16 Structure_FindFreePosition(Structure *s, bool checkForSpice)
 		type = Map_GetLandscapeType(curPacked);
 		if (type == LST_WALL || type == LST_ENTIRELY_MOUNTAIN || type == LST_PARTIAL_MOUNTAIN) continue;
 
-		t = &g_map[curPacked];
+		t = &g_game->map[curPacked];
 		if (t->hasUnit || t->hasStructure) continue;
 
 		if (!checkForSpice) return curPacked;
@@ -1567,11 +1738,12 @@ void Structure_Remove(Structure *s)
 
 		Animation_Stop_ByTile(curPacked);
 
-		t = &g_map[curPacked];
+		t = &g_game->map[curPacked];
 		t->hasStructure = false;
+		Map_MarkDirty(curPacked);
 
 		if (g_debugScenario) {
-			t->groundSpriteID = g_mapSpriteID[curPacked] & 0x1FF;
+			t->groundSpriteID = g_game->mapSpriteID[curPacked] & 0x1FF;
 			t->overlaySpriteID = 0;
 		}
 	}
@@ -1631,7 +1803,7 @@ static bool Structure_CheckAvailableConcrete(uint16 structureType, uint8 houseID
 			uint16 packed = i + g_table_structure_layoutTiles[si->layout][j];
 			/* XXX -- This can overflow, and we should check for that */
 
-			if (Map_GetLandscapeType(packed) == LST_CONCRETE_SLAB && g_map[packed].houseID == houseID) continue;
+			if (Map_GetLandscapeType(packed) == LST_CONCRETE_SLAB && g_game->map[packed].houseID == houseID) continue;
 
 			stop = false;
 			break;
@@ -1896,13 +2068,14 @@ void Structure_UpdateMap(Structure *s)
 
 		position = Tile_PackTile(s->o.position) + layout[i];
 
-		t = &g_map[position];
+		t = &g_game->map[position];
 		t->houseID = s->o.houseID;
 		t->hasStructure = true;
 		t->index = s->o.index + 1;
 
 		t->groundSpriteID = iconMap[i] + s->rotationSpriteDiff;
 		t->overlaySpriteID = 0;
+		Map_MarkDirty(position);
 	}
 
 	if (s->state >= STRUCTURE_STATE_IDLE) {
@@ -77,7 +77,7 @@ struct House;
 struct Widget;
 
 extern const StructureInfo g_table_structureInfo_original[STRUCTURE_MAX];
-extern StructureInfo g_table_structureInfo[STRUCTURE_MAX];
+extern THREAD_LOCAL StructureInfo g_table_structureInfo[STRUCTURE_MAX];
 extern const uint16  g_table_structure_layoutTiles[STRUCTURE_LAYOUT_MAX][9];
 extern const uint16  g_table_structure_layoutEdgeTiles[STRUCTURE_LAYOUT_MAX][8];
 extern const uint16  g_table_structure_layoutTileCount[STRUCTURE_LAYOUT_MAX];
@@ -85,10 +85,13 @@ extern const tile32  g_table_structure_layoutTileDiff[STRUCTURE_LAYOUT_MAX];
 extern const XYSize  g_table_structure_layoutSize[STRUCTURE_LAYOUT_MAX];
 extern const int16   g_table_structure_layoutTilesAround[STRUCTURE_LAYOUT_MAX][16];
 
-extern Structure *g_structureActive;
-extern uint16 g_structureActivePosition;
-extern uint16 g_structureActiveType;
+extern THREAD_LOCAL Structure *g_structureActive;
+extern THREAD_LOCAL uint16 g_structureActivePosition;
+extern THREAD_LOCAL uint16 g_structureActiveType;
 
+extern void Structure_SyncScriptDelays(void);
+extern void Structure_WakeScript(const Structure *s);
+extern void Structure_ResetScriptWheel(void);
 extern void GameLoop_Structure(void);
 extern uint8 Structure_StringToType(const char *name);
 extern Structure *Structure_Create(uint16 index, uint8 typeID, uint8 houseID, uint16 position);
@@ -119,8 +119,8 @@ const HouseInfo g_table_houseInfo_original[HOUSE_NEUTRAL] = {
 	}
 };
 
-HouseInfo g_table_houseInfo[HOUSE_NEUTRAL];
-enum HouseAlliance g_table_houseAlliance[HOUSE_NEUTRAL][HOUSE_NEUTRAL];
+THREAD_LOCAL HouseInfo g_table_houseInfo[HOUSE_NEUTRAL];
+THREAD_LOCAL enum HouseAlliance g_table_houseAlliance[HOUSE_NEUTRAL][HOUSE_NEUTRAL];
 
 const enum HouseType g_table_houseRemap6to3[HOUSE_NEUTRAL] = {
 	HOUSE_HARKONNEN, HOUSE_ATREIDES, HOUSE_ORDOS,
@@ -1265,7 +1265,7 @@ const StructureInfo g_table_structureInfo_original[STRUCTURE_MAX] = {
 	}
 };
 
-StructureInfo g_table_structureInfo[STRUCTURE_MAX];
+THREAD_LOCAL StructureInfo g_table_structureInfo[STRUCTURE_MAX];
 
 /** Array with position offset per tile in a structure layout. */
 const uint16 g_table_structure_layoutTiles[STRUCTURE_LAYOUT_MAX][9] = {
@@ -2014,7 +2014,7 @@ const UnitInfo g_table_unitInfo_original[UNIT_MAX] = {
 	}
 };
 
-UnitInfo g_table_unitInfo[UNIT_MAX];
+THREAD_LOCAL UnitInfo g_table_unitInfo[UNIT_MAX];
 
 const ActionInfo g_table_actionInfo[ACTION_MAX] = {
 	{ /* 0 */
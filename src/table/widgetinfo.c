@@ -11,7 +11,7 @@
 #include "../newui/menubar.h"
 #include "../newui/viewport.h"
 
-WidgetInfo g_table_gameWidgetInfo[GAME_WIDGET_MAX + 1] = {
+THREAD_LOCAL WidgetInfo g_table_gameWidgetInfo[GAME_WIDGET_MAX + 1] = {
 	{ /* 0 */
 		/* index       */ 1,
 		/* clickProc   */ &MenuBar_ClickMentat,
@@ -43,6 +43,6 @@ typedef struct WidgetInfo {
 	enum ScreenDivID div;
 } WidgetInfo;
 
-extern WidgetInfo g_table_gameWidgetInfo[GAME_WIDGET_MAX + 1];
+extern THREAD_LOCAL WidgetInfo g_table_gameWidgetInfo[GAME_WIDGET_MAX + 1];
 
 #endif
@@ -8,6 +8,7 @@
 
 #include "opendune.h"
 #include "enhancement.h"
+#include "gamecontext.h"
 #include "house.h"
 #include "pool/pool.h"
 #include "pool/pool_house.h"
@@ -22,19 +23,19 @@ void GameLoop_Team(void)
 {
 	PoolFindStruct find;
 
-	if (g_tickTeamGameLoop > g_timerGame) return;
-	g_tickTeamGameLoop = g_timerGame + (Tools_Random_256() & 7) + 5;
+	if (g_game->tickTeamGameLoop > g_game->timerGame) return;
+	g_game->tickTeamGameLoop = g_game->timerGame + (Tools_Random_256() & 7) + 5;
 
-	g_scriptCurrentObject    = NULL;
-	g_scriptCurrentUnit      = NULL;
-	g_scriptCurrentStructure = NULL;
+	g_game->scriptCurrentObject    = NULL;
+	g_game->scriptCurrentUnit      = NULL;
+	g_game->scriptCurrentStructure = NULL;
 
 	for (Team *t = Team_FindFirst(&find, HOUSE_INVALID);
 			t != NULL;
 			t = Team_FindNext(&find)) {
 		const House *h = House_Get_ByIndex(t->houseID);
 
-		g_scriptCurrentTeam = t;
+		g_game->scriptCurrentTeam = t;
 
 		if (!h->flags.isAIActive) continue;
 
@@ -78,7 +79,7 @@ Team *Team_Create(uint8 houseID, uint8 teamActionType, uint8 movementType, uint1
 	t->minMembers  = minMembers;
 	t->maxMembers  = maxMembers;
 
-	Script_Reset(&t->script, g_scriptTeam);
+	Script_Reset(&t->script, &g_scriptTeam);
 	Script_Load(&t->script, teamActionType);
 
 	t->script.delay = 0;
@@ -7,60 +7,35 @@
 
 #include "../config.h"
 #include "../enhancement.h"
-
-int64_t g_timerGame;
-int64_t g_tickScenarioStart = 0;
-
-int64_t g_tickHousePowerMaintenance = 0;
-int64_t g_tickHouseHouse = 0;
-int64_t g_tickHouseStarport = 0;
-int64_t g_tickHouseReinforcement = 0;
-int64_t g_tickHouseMissileCountdown = 0;
-int64_t g_tickHouseStarportAvailability = 0;
-int64_t g_tickHouseStarportRecalculatePrices = 0;
-
-int64_t g_tickStructureDegrade  = 0;
-int64_t g_tickStructureStructure= 0;
-int64_t g_tickStructureScript   = 0;
-int64_t g_tickStructurePalace   = 0;
-
-int64_t g_tickTeamGameLoop  = 0;
-
-int64_t g_tickUnitMovement  = 0;
-int64_t g_tickUnitRotation  = 0;
-int64_t g_tickUnitBlinking  = 0;
-int64_t g_tickUnitUnknown4  = 0;
-int64_t g_tickUnitScript    = 0;
-int64_t g_tickUnitUnknown5  = 0;
-int64_t g_tickUnitDeviation = 0;
+#include "../gamecontext.h"
 
 void
 Timer_ResetScriptTimers(void)
 {
-	g_timerGame = Timer_GameTicks();
-
-	g_tickHousePowerMaintenance = g_timerGame;
-	g_tickHouseHouse = g_timerGame;
-	g_tickHouseStarport = g_timerGame;
-	g_tickHouseReinforcement = g_timerGame;
-	g_tickHouseMissileCountdown = g_timerGame;
-	g_tickHouseStarportAvailability = g_timerGame;
-	g_tickHouseStarportRecalculatePrices = g_timerGame;
-
-	g_tickStructureDegrade  = g_timerGame;
-	g_tickStructureStructure= g_timerGame;
-	g_tickStructureScript   = g_timerGame;
-	g_tickStructurePalace   = g_timerGame;
-
-	g_tickTeamGameLoop  = g_timerGame;
-
-	g_tickUnitMovement  = g_timerGame;
-	g_tickUnitRotation  = g_timerGame;
-	g_tickUnitBlinking  = g_timerGame;
-	g_tickUnitUnknown4  = g_timerGame;
-	g_tickUnitScript    = g_timerGame;
-	g_tickUnitUnknown5  = g_timerGame;
-	g_tickUnitDeviation = g_timerGame;
+	g_game->timerGame = Timer_GameTicks();
+
+	g_game->tickHousePowerMaintenance = g_game->timerGame;
+	g_game->tickHouseHouse = g_game->timerGame;
+	g_game->tickHouseStarport = g_game->timerGame;
+	g_game->tickHouseReinforcement = g_game->timerGame;
+	g_game->tickHouseMissileCountdown = g_game->timerGame;
+	g_game->tickHouseStarportAvailability = g_game->timerGame;
+	g_game->tickHouseStarportRecalculatePrices = g_game->timerGame;
+
+	g_game->tickStructureDegrade  = g_game->timerGame;
+	g_game->tickStructureStructure= g_game->timerGame;
+	g_game->tickStructureScript   = g_game->timerGame;
+	g_game->tickStructurePalace   = g_game->timerGame;
+
+	g_game->tickTeamGameLoop  = g_game->timerGame;
+
+	g_game->tickUnitMovement  = g_game->timerGame;
+	g_game->tickUnitRotation  = g_game->timerGame;
+	g_game->tickUnitBlinking  = g_game->timerGame;
+	g_game->tickUnitUnknown4  = g_game->timerGame;
+	g_game->tickUnitScript    = g_game->timerGame;
+	g_game->tickUnitUnknown5  = g_game->timerGame;
+	g_game->tickUnitDeviation = g_game->timerGame;
 }
 
 uint16
@@ -99,7 +74,7 @@ double
 Timer_GetUnitMovementFrame(void)
 {
 	const int duration = 3;
-	const int frame = clamp(0, duration + g_timerGame - g_tickUnitMovement, duration - 1);
+	const int frame = clamp(0, duration + g_game->timerGame - g_game->tickUnitMovement, duration - 1);
 
 	return (double)frame / duration;
 }
@@ -108,7 +83,7 @@ double
 Timer_GetUnitRotationFrame(void)
 {
 	const int duration = Tools_AdjustToGameSpeed(4, 2, 8, true);
-	const int frame = clamp(0, duration + g_timerGame - g_tickUnitRotation, duration - 1);
+	const int frame = clamp(0, duration + g_game->timerGame - g_game->tickUnitRotation, duration - 1);
 
 	return (double)frame / duration;
 }
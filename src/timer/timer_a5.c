@@ -144,3 +144,9 @@ Timer_QueueIsEmpty(void)
 {
 	return al_event_queue_is_empty(s_timer_queue);
 }
+
+double
+Timer_GetTime(void)
+{
+	return al_get_time();
+}
@@ -0,0 +1,214 @@
+/* timer_posix.c
+ *
+ * Timers for the dedicated server, counted off the monotonic clock
+ * instead of Allegro timer events.
+ */
+
+#include <assert.h>
+#include <time.h>
+
+#include "timer_posix.h"
+
+#include "../config.h"
+#include "../enhancement.h"
+#include "../net/net.h"
+
+enum GameSpeed {
+	GAMESPEED_SLOWEST   = 0,
+	GAMESPEED_SLOW      = 1,
+	GAMESPEED_NORMAL    = 2,
+	GAMESPEED_FAST      = 3,
+	GAMESPEED_FASTEST   = 4,
+
+	GAMESPEED_MAX
+};
+
+static const double s_game_speed[GAMESPEED_MAX] = {
+	1.0/30.0, 1.0/45.0, 1.0/60.0, 1.0/90.0, 1.0/120.0
+};
+
+typedef struct PosixTimer {
+	bool started;
+	double speed;
+
+	/* Ticks counted before the timer was last started, and when. */
+	int64_t base;
+	double start_time;
+
+	/* Last tick handed out by Timer_WaitForEvent. */
+	int64_t waited;
+} PosixTimer;
+
+static THREAD_LOCAL PosixTimer s_timer[2] = {
+	{ false, 1.0/60.0, 0, 0.0, 0 },
+	{ false, 1.0/60.0, 0, 0.0, 0 },
+};
+
+static int64_t
+TimerPosix_Count(const PosixTimer *t, double now)
+{
+	if (!t->started)
+		return t->base;
+
+	return t->base + (int64_t)((now - t->start_time) / t->speed);
+}
+
+static void
+TimerPosix_SleepUntil(double when)
+{
+	const double delay = when - Timer_GetTime();
+
+	if (delay <= 0.0)
+		return;
+
+	struct timespec ts;
+	ts.tv_sec = (time_t)delay;
+	ts.tv_nsec = (long)((delay - ts.tv_sec) * 1e9);
+	nanosleep(&ts, NULL);
+}
+
+int
+TimerPosix_GetMillisecondsToNextTick(enum TimerType timer)
+{
+	assert(timer <= TIMER_GAME);
+
+	const PosixTimer *t = &s_timer[timer];
+	if (!t->started)
+		return 0;
+
+	const double now = Timer_GetTime();
+	const int64_t next = TimerPosix_Count(t, now) + 1 - t->base;
+	const double delay = t->start_time + next * t->speed - now;
+
+	return (delay <= 0.0) ? 0 : (int)(1000.0 * delay);
+}
+
+/*--------------------------------------------------------------*/
+
+double
+Timer_GetTime(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool
+Timer_SetTimer(enum TimerType timer, bool set)
+{
+	assert(timer <= TIMER_GAME);
+
+	PosixTimer *t = &s_timer[timer];
+	const double now = Timer_GetTime();
+
+	if (set) {
+		double speed = t->speed;
+
+		if (timer == TIMER_GAME) {
+			if (enhancement_true_game_speed_adjustment) {
+				speed = s_game_speed[g_gameConfig.gameSpeed];
+			} else {
+				speed = s_game_speed[GAMESPEED_NORMAL];
+			}
+		}
+
+		/* Like al_set_timer_speed, keep the count across changes. */
+		t->base = TimerPosix_Count(t, now);
+		t->start_time = now;
+		t->speed = speed;
+		t->started = true;
+		return true;
+	} else {
+		if (g_host_type == HOSTTYPE_NONE) {
+			t->base = TimerPosix_Count(t, now);
+			t->started = false;
+		}
+		return false;
+	}
+}
+
+int64_t
+Timer_GetTimer(enum TimerType timer)
+{
+	assert(timer <= TIMER_GAME);
+
+	return TimerPosix_Count(&s_timer[timer], Timer_GetTime());
+}
+
+bool
+Timer_IsStarted(enum TimerType timer)
+{
+	assert(timer <= TIMER_GAME);
+
+	return s_timer[timer].started;
+}
+
+void
+Timer_RegisterSource(void)
+{
+	const double now = Timer_GetTime();
+
+	for (enum TimerType timer = TIMER_GUI; timer <= TIMER_GAME; timer++)
+		s_timer[timer].waited = TimerPosix_Count(&s_timer[timer], now);
+}
+
+void
+Timer_UnregisterSource(void)
+{
+}
+
+enum TimerType
+Timer_WaitForEvent(void)
+{
+	for (;;) {
+		const double now = Timer_GetTime();
+		double next_time = now + 1.0;
+
+		for (enum TimerType timer = TIMER_GUI; timer <= TIMER_GAME; timer++) {
+			PosixTimer *t = &s_timer[timer];
+
+			if (!t->started)
+				continue;
+
+			if (TimerPosix_Count(t, now) > t->waited) {
+				t->waited++;
+				return timer;
+			}
+
+			const double when = t->start_time + (t->waited + 1 - t->base) * t->speed;
+			if (when < next_time)
+				next_time = when;
+		}
+
+		TimerPosix_SleepUntil(next_time);
+	}
+}
+
+void
+Timer_Sleep(int tics)
+{
+	PosixTimer *t = &s_timer[TIMER_GUI];
+
+	if (!t->started)
+		Timer_SetTimer(TIMER_GUI, true);
+
+	const int64_t end = Timer_GetTimer(TIMER_GUI) + tics;
+	while (Timer_GetTimer(TIMER_GUI) < end)
+		TimerPosix_SleepUntil(t->start_time + (end - t->base) * t->speed);
+}
+
+bool
+Timer_QueueIsEmpty(void)
+{
+	const double now = Timer_GetTime();
+
+	for (enum TimerType timer = TIMER_GUI; timer <= TIMER_GAME; timer++) {
+		const PosixTimer *t = &s_timer[timer];
+
+		if (t->started && TimerPosix_Count(t, now) > t->waited)
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,8 @@
+#ifndef TIMER_TIMERPOSIX_H
+#define TIMER_TIMERPOSIX_H
+
+#include "timer.h"
+
+extern int TimerPosix_GetMillisecondsToNextTick(enum TimerType timer);
+
+#endif
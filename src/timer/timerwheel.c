@@ -0,0 +1,171 @@
+/**
+ * @file src/timer/timerwheel.c
+ *
+ * Hierarchical timer wheel.
+ *
+ * Scheduling, cancelling and rescheduling an entry take constant time,
+ * and a tick on which nothing is due costs one empty slot.  Entries
+ * move down a level when their 64 ticks come round, and out of the
+ * overflow list when their 4096 do.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "timerwheel.h"
+
+#define TIMERWHEEL_OVERFLOW     (TIMERWHEEL_LEVELS * TIMERWHEEL_SLOTS)
+
+static unsigned int
+TimerWheel_GetSlot(const TimerWheel *w, uint32 when)
+{
+	const unsigned int mask = TIMERWHEEL_SLOTS - 1;
+
+	if ((when >> TIMERWHEEL_SLOT_BITS) == (w->now >> TIMERWHEEL_SLOT_BITS))
+		return when & mask;
+
+	if ((when >> (2 * TIMERWHEEL_SLOT_BITS)) == (w->now >> (2 * TIMERWHEEL_SLOT_BITS)))
+		return TIMERWHEEL_SLOTS + ((when >> TIMERWHEEL_SLOT_BITS) & mask);
+
+	return TIMERWHEEL_OVERFLOW;
+}
+
+static void
+TimerWheel_Link(TimerWheel *w, uint16 id)
+{
+	const unsigned int slot = TimerWheel_GetSlot(w, w->when[id]);
+
+	w->slot[id] = slot;
+	w->prev[id] = TIMERWHEEL_NONE;
+	w->next[id] = w->head[slot];
+
+	if (w->head[slot] != TIMERWHEEL_NONE)
+		w->prev[w->head[slot]] = id;
+
+	w->head[slot] = id;
+}
+
+static void
+TimerWheel_Unlink(TimerWheel *w, uint16 id)
+{
+	const uint16 prev = w->prev[id];
+	const uint16 next = w->next[id];
+
+	if (prev != TIMERWHEEL_NONE) {
+		w->next[prev] = next;
+	} else {
+		w->head[w->slot[id]] = next;
+	}
+
+	if (next != TIMERWHEEL_NONE)
+		w->prev[next] = prev;
+
+	w->slot[id] = TIMERWHEEL_NONE;
+}
+
+/* Sorts the entries of a slot again, now that the current tick moved. */
+static void
+TimerWheel_Cascade(TimerWheel *w, unsigned int slot)
+{
+	uint16 id = w->head[slot];
+
+	w->head[slot] = TIMERWHEEL_NONE;
+
+	while (id != TIMERWHEEL_NONE) {
+		const uint16 next = w->next[id];
+
+		TimerWheel_Link(w, id);
+		id = next;
+	}
+}
+
+/**
+ * @brief   Empties the wheel.
+ * @param   now The tick the next TimerWheel_Advance handles.
+ */
+void
+TimerWheel_Init(TimerWheel *w, uint32 now)
+{
+	w->now = now;
+	memset(w->head, 0xFF, sizeof(w->head));
+	memset(w->slot, 0xFF, sizeof(w->slot));
+}
+
+/**
+ * @brief   Makes the entry due on the given tick, instead of any tick it
+ *          was due on before.
+ * @details Ticks already handled are taken as the next one.
+ */
+void
+TimerWheel_Schedule(TimerWheel *w, uint16 id, uint32 when)
+{
+	assert(id < TIMERWHEEL_MAX_ENTRIES);
+
+	if (w->slot[id] != TIMERWHEEL_NONE)
+		TimerWheel_Unlink(w, id);
+
+	w->when[id] = ((int32)(when - w->now) < 0) ? w->now : when;
+	TimerWheel_Link(w, id);
+}
+
+void
+TimerWheel_Cancel(TimerWheel *w, uint16 id)
+{
+	assert(id < TIMERWHEEL_MAX_ENTRIES);
+
+	if (w->slot[id] != TIMERWHEEL_NONE)
+		TimerWheel_Unlink(w, id);
+}
+
+bool
+TimerWheel_IsScheduled(const TimerWheel *w, uint16 id)
+{
+	assert(id < TIMERWHEEL_MAX_ENTRIES);
+
+	return w->slot[id] != TIMERWHEEL_NONE;
+}
+
+uint32
+TimerWheel_GetWhen(const TimerWheel *w, uint16 id)
+{
+	assert(TimerWheel_IsScheduled(w, id));
+
+	return w->when[id];
+}
+
+uint32
+TimerWheel_GetNow(const TimerWheel *w)
+{
+	return w->now;
+}
+
+/**
+ * @brief   Handles the current tick, and moves on to the next one.
+ * @details The entries due are no longer scheduled afterwards.
+ * @return  The number of entries that were due.
+ */
+int
+TimerWheel_Advance(TimerWheel *w)
+{
+	const unsigned int mask = TIMERWHEEL_SLOTS - 1;
+	const unsigned int slot = w->now & mask;
+	int count = 0;
+
+	if (slot == 0) {
+		if ((w->now & ((1 << (2 * TIMERWHEEL_SLOT_BITS)) - 1)) == 0)
+			TimerWheel_Cascade(w, TIMERWHEEL_OVERFLOW);
+
+		TimerWheel_Cascade(w, TIMERWHEEL_SLOTS + ((w->now >> TIMERWHEEL_SLOT_BITS) & mask));
+	}
+
+	for (uint16 id = w->head[slot]; id != TIMERWHEEL_NONE; id = w->next[id]) {
+		assert(w->when[id] == w->now);
+
+		w->slot[id] = TIMERWHEEL_NONE;
+		count++;
+	}
+
+	w->head[slot] = TIMERWHEEL_NONE;
+	w->now++;
+	return count;
+}
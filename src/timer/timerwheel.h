@@ -0,0 +1,43 @@
+/** @file src/timer/timerwheel.h Hierarchical timer wheel. */
+
+#ifndef TIMER_TIMERWHEEL_H
+#define TIMER_TIMERWHEEL_H
+
+#include <stdbool.h>
+#include "types.h"
+
+enum {
+	TIMERWHEEL_SLOT_BITS    = 6,
+	TIMERWHEEL_SLOTS        = 1 << TIMERWHEEL_SLOT_BITS,
+	TIMERWHEEL_LEVELS       = 2,
+
+	/* One for every Unit, with the raised unit cap. */
+	TIMERWHEEL_MAX_ENTRIES  = 512,
+
+	TIMERWHEEL_NONE         = 0xFFFF
+};
+
+/**
+ * Entries, identified by a pool index, each wait for one tick of their
+ * own.  The first level has a slot for every tick of the current 64,
+ * the second level one for every 64 ticks of the current 4096, and
+ * anything later waits in an overflow list.
+ */
+typedef struct TimerWheel {
+	uint32 now;                                                 /*!< Tick the next TimerWheel_Advance handles. */
+	uint16 head[TIMERWHEEL_LEVELS * TIMERWHEEL_SLOTS + 1];      /*!< First entry of each slot, overflow last. */
+	uint16 next[TIMERWHEEL_MAX_ENTRIES];
+	uint16 prev[TIMERWHEEL_MAX_ENTRIES];
+	uint16 slot[TIMERWHEEL_MAX_ENTRIES];                        /*!< Slot of each entry, or TIMERWHEEL_NONE. */
+	uint32 when[TIMERWHEEL_MAX_ENTRIES];
+} TimerWheel;
+
+extern void TimerWheel_Init(TimerWheel *w, uint32 now);
+extern void TimerWheel_Schedule(TimerWheel *w, uint16 id, uint32 when);
+extern void TimerWheel_Cancel(TimerWheel *w, uint16 id);
+extern bool TimerWheel_IsScheduled(const TimerWheel *w, uint16 id);
+extern uint32 TimerWheel_GetWhen(const TimerWheel *w, uint16 id);
+extern uint32 TimerWheel_GetNow(const TimerWheel *w);
+extern int TimerWheel_Advance(TimerWheel *w);
+
+#endif
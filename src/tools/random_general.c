@@ -7,7 +7,7 @@
 #include "random_general.h"
 
 /** variable_76A2. */
-static uint8 s_seed[4];
+static THREAD_LOCAL uint8 s_seed[4];
 
 /**
  * @brief   Sets s_seed (variable_76A2).
@@ -24,6 +24,17 @@ Tools_Random_Seed(uint32 seed)
 	s_seed[3] = (seed >> 24) & 0xFF;
 }
 
+/**
+ * @brief   Returns s_seed, packed the same way as Tools_Random_Seed.
+ * @details Introduced.  Used to record and restore the RNG in replays.
+ */
+uint32
+Tools_Random_GetState(void)
+{
+	return (s_seed[0] <<  0) | (s_seed[1] <<  8)
+	     | (s_seed[2] << 16) | ((uint32)s_seed[3] << 24);
+}
+
 /**
  * @brief   f__2BB4_0004_0027_DC1D.
  * @details Likely to have been hand-written assembly.
@@ -7,5 +7,6 @@
 
 extern void  Tools_Random_Seed(uint32 seed);
 extern uint8 Tools_Random_256(void);
+extern uint32 Tools_Random_GetState(void);
 
 #endif
@@ -7,7 +7,7 @@
 #include "random_lcg.h"
 
 /** variable_79E4. */
-static uint32 s_seed;
+static THREAD_LOCAL uint32 s_seed;
 
 /**
  * @brief   f__01F7_07D4_0011_370E.
@@ -19,6 +19,27 @@ Tools_RandomLCG_Seed(uint16 seed)
 	s_seed = seed;
 }
 
+/**
+ * @brief   Returns the full LCG state.
+ * @details Introduced.  Unlike Tools_RandomLCG_Seed, this is not
+ *          truncated to 16 bits.
+ */
+uint32
+Tools_RandomLCG_GetState(void)
+{
+	return s_seed;
+}
+
+/**
+ * @brief   Restores the full LCG state.
+ * @details Introduced.  @see Tools_RandomLCG_GetState.
+ */
+void
+Tools_RandomLCG_SetState(uint32 state)
+{
+	s_seed = state;
+}
+
 /**
  * @brief   f__01F7_07E5_0011_F68B.
  * @details Exact: int rand(void).
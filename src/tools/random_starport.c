@@ -7,12 +7,13 @@
 #include <assert.h>
 #include "random_starport.h"
 
+#include "../gamecontext.h"
 #include "../structure.h"
 #include "../timer/timer.h"
 #include "../unit.h"
 
-static uint16 s_initialSeed;
-static uint32 s_seed;
+static THREAD_LOCAL uint16 s_initialSeed;
+static THREAD_LOCAL uint32 s_seed;
 
 /**
  * @brief   Gets the number of minutes elapsed.
@@ -21,7 +22,7 @@ static uint32 s_seed;
 int64_t
 Random_Starport_GetSeedTime(void)
 {
-	return (g_timerGame - g_tickScenarioStart) / 60 / 60;
+	return (g_game->timerGame - g_game->tickScenarioStart) / 60 / 60;
 }
 
 /**
@@ -69,6 +70,27 @@ Random_Starport_Seed(uint16 seed)
 	s_seed = seed;
 }
 
+/**
+ * @brief   Tools_RandomLCG_GetState, for starport.
+ * @details @see Tools_RandomLCG_GetState.
+ */
+uint32
+Random_Starport_GetState(void)
+{
+	return s_seed;
+}
+
+/**
+ * @brief   Tools_RandomLCG_SetState, for starport.
+ * @details @see Tools_RandomLCG_SetState.
+ */
+void
+Random_Starport_SetState(uint16 initialSeed, uint32 state)
+{
+	s_initialSeed = initialSeed;
+	s_seed = state;
+}
+
 /**
  * @brief   Tools_RandomLCG, for starport.
  * @details @see Tools_RandomLCG.
@@ -12,6 +12,8 @@ extern uint16  Random_Starport_GetSeed(uint16 scenarioID, enum HouseType houseID
 extern uint16  Random_Starport_GetInitialSeed(void);
 extern void    Random_Starport_Reseed(void);
 extern void    Random_Starport_Seed(uint16 seed);
+extern uint32  Random_Starport_GetState(void);
+extern void    Random_Starport_SetState(uint16 initialSeed, uint32 state);
 extern uint16  Random_Starport_CalculatePrice(uint16 credits);
 extern uint16  Random_Starport_CalculateUnitPrice(enum UnitType unitType);
 
@@ -14,7 +14,7 @@ typedef struct xorshift {
 	uint32 w;
 } xorshift_t;
 
-static xorshift_t s_xorshift;
+static THREAD_LOCAL xorshift_t s_xorshift;
 
 /**
  * @brief   Reseeds the xorshift state.
@@ -85,3 +85,13 @@ Random_Xorshift_Range(uint16 min, uint16 max)
 
 	return ret;
 }
+
+/**
+ * @brief   A random 32-bit number, for non-game-mechanics.
+ * @details Introduced.
+ */
+uint32
+Random_Xorshift_32(void)
+{
+	return xor128();
+}
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "enum_string.h"
+#include "errorlog.h"
 #include "types.h"
 #include "os/common.h"
 #include "os/math.h"
@@ -18,6 +19,7 @@
 #include "config.h"
 #include "enhancement.h"
 #include "explosion.h"
+#include "gamecontext.h"
 #include "gui/gui.h"
 #include "gui/widget.h"
 #include "house.h"
@@ -41,20 +43,21 @@
 #include "team.h"
 #include "tile.h"
 #include "timer/timer.h"
+#include "timer/timerwheel.h"
 #include "tools/coord.h"
 #include "tools/encoded_index.h"
 #include "tools/orientation.h"
 #include "tools/random_general.h"
 
 
-Unit *g_unitActive = NULL;
-static Unit *g_unitSelected[MAX_SELECTABLE_UNITS];
+THREAD_LOCAL Unit *g_unitActive = NULL;
+static THREAD_LOCAL Unit *g_unitSelected[MAX_SELECTABLE_UNITS];
 
 /**
  * Number of units of each type available at the starport.
  * \c 0 means not available, \c -1 means \c 0 units, \c >0 means that number of units available.
  */
-int16 g_starportAvailable[UNIT_MAX];
+THREAD_LOCAL int16 g_starportAvailable[UNIT_MAX];
 
 Unit *
 Unit_FirstSelected(int *iter)
@@ -346,6 +349,134 @@ static void Unit_MovementTick(Unit *unit)
 	unit->speedRemainder = speed & 0xFF;
 }
 
+/* A sleeping script counts its delay down by one on every script tick
+ * on which GameLoop_Unit visits its Unit.  Instead, every Unit waits in
+ * s_unitScriptWheel for the script tick on which its delay would reach
+ * zero.  A script tick on which no Unit is due leaves the delays alone
+ * and is counted in s_unitScriptTicksOwed, which
+ * Unit_SyncScriptDelays takes off the Units on the map when anything
+ * else needs their delays.
+ *
+ * The wheel may say a Unit is due before it is, but never after.  Units
+ * the loop does not visit, and Units changed from outside their own
+ * script, are due on the next script tick, and a script tick with any
+ * Unit due counts every delay down as the original game does.
+ */
+static THREAD_LOCAL TimerWheel s_unitScriptWheel;
+static THREAD_LOCAL uint32 s_unitScriptTicksOwed;    /*!< Script ticks not yet taken off the delays. */
+static THREAD_LOCAL uint32 s_unitScriptTick;         /*!< The script tick being run. */
+static THREAD_LOCAL bool   s_unitScriptLazy;         /*!< The script tick being run has no Unit due. */
+static THREAD_LOCAL uint16 s_unitScriptPassed;       /*!< Find positions before this one have had the script tick being run. */
+static THREAD_LOCAL bool   s_unitScriptReset = true; /*!< The wheel does not know the Units yet. */
+
+/**
+ * @brief   Takes the script ticks that had no Unit due off the delays of
+ *          the Units on the map.
+ * @details Introduced.  script.delay is only up to date after this.
+ */
+void
+Unit_SyncScriptDelays(void)
+{
+	if (s_unitScriptTicksOwed == 0 && !s_unitScriptLazy)
+		return;
+
+	for (uint16 i = 0; i < g_game->unitFindCount; i++) {
+		Unit *u = g_game->unitFindArray[i];
+		uint32 owed = s_unitScriptTicksOwed;
+
+		if (u == NULL || u->o.flags.s.isNotOnMap)
+			continue;
+
+		if (s_unitScriptLazy && i < s_unitScriptPassed)
+			owed++;
+
+		/* A delay set without waking the script first; it should have
+		 * run already, so run it on the next script tick. */
+		if (u->o.script.delay < owed) {
+			Warning("Unit %d: script delay %d is behind by %d script ticks.\n",
+					u->o.index, u->o.script.delay, (int)(owed - u->o.script.delay));
+			u->o.script.delay = 0;
+			if (!s_unitScriptReset)
+				TimerWheel_Schedule(&s_unitScriptWheel, u->o.index, TimerWheel_GetNow(&s_unitScriptWheel));
+			continue;
+		}
+
+		u->o.script.delay -= owed;
+	}
+
+	/* The rest of the script tick being run counts down as usual. */
+	s_unitScriptTicksOwed = 0;
+	s_unitScriptLazy = false;
+}
+
+/**
+ * @brief   Makes the Unit's script due on the next script tick.
+ * @details Introduced.  Must be called before anything but the Unit's
+ *          own script sets its script.delay, or before the Unit is put on
+ *          or taken off the map.
+ */
+void
+Unit_WakeScript(const Unit *u)
+{
+	Unit_SyncScriptDelays();
+
+	if (!s_unitScriptReset) {
+		TimerWheel_Schedule(&s_unitScriptWheel, u->o.index,
+				TimerWheel_GetNow(&s_unitScriptWheel));
+	}
+}
+
+/**
+ * @brief   Makes every Unit's script due on the next script tick.
+ * @details Introduced.  For when the Unit pool is loaded or rebuilt.
+ */
+void
+Unit_ResetScriptWheel(void)
+{
+	Unit_SyncScriptDelays();
+	s_unitScriptReset = true;
+}
+
+static void
+Unit_BeginScriptTick(void)
+{
+	if (s_unitScriptReset)
+		TimerWheel_Init(&s_unitScriptWheel, 0);
+
+	s_unitScriptTick = TimerWheel_GetNow(&s_unitScriptWheel);
+
+	const bool due = (TimerWheel_Advance(&s_unitScriptWheel) != 0);
+
+	s_unitScriptLazy = g_scriptWheel && !due && !s_unitScriptReset;
+	s_unitScriptPassed = 0;
+	s_unitScriptReset = false;
+
+	if (!s_unitScriptLazy)
+		Unit_SyncScriptDelays();
+}
+
+static void
+Unit_EndScriptTick(void)
+{
+	PoolFindStruct find;
+
+	if (s_unitScriptLazy) {
+		s_unitScriptLazy = false;
+		s_unitScriptTicksOwed++;
+		return;
+	}
+
+	/* Units the loop did not get to look again next script tick. */
+	for (const Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
+			u != NULL;
+			u = Unit_FindNext(&find)) {
+		if (!u->o.flags.s.isNotOnMap
+				&& !TimerWheel_IsScheduled(&s_unitScriptWheel, u->o.index)) {
+			TimerWheel_Schedule(&s_unitScriptWheel, u->o.index, s_unitScriptTick + 1);
+		}
+	}
+}
+
 /**
  * Loop over all units, performing various of tasks.
  */
@@ -362,50 +493,53 @@ void GameLoop_Unit(void)
 
 	if (g_debugScenario) return;
 
-	if (g_tickUnitMovement <= g_timerGame) {
+	if (g_game->tickUnitMovement <= g_game->timerGame) {
 		tickMovement = true;
-		g_tickUnitMovement = g_timerGame + 3;
+		g_game->tickUnitMovement = g_game->timerGame + 3;
 	}
 
-	if (g_tickUnitRotation <= g_timerGame) {
+	if (g_game->tickUnitRotation <= g_game->timerGame) {
 		tickRotation = true;
-		g_tickUnitRotation = g_timerGame + Tools_AdjustToGameSpeed(4, 2, 8, true);
+		g_game->tickUnitRotation = g_game->timerGame + Tools_AdjustToGameSpeed(4, 2, 8, true);
 	}
 
-	if (g_tickUnitBlinking <= g_timerGame) {
+	if (g_game->tickUnitBlinking <= g_game->timerGame) {
 		tickBlinking = true;
-		g_tickUnitBlinking = g_timerGame + Tools_AdjustToGameSpeed(6, 3, 12, true);
+		g_game->tickUnitBlinking = g_game->timerGame + Tools_AdjustToGameSpeed(6, 3, 12, true);
 	}
 
-	if (g_tickUnitUnknown4 <= g_timerGame) {
+	if (g_game->tickUnitUnknown4 <= g_game->timerGame) {
 		tickUnknown4 = true;
-		g_tickUnitUnknown4 = g_timerGame + 20;
+		g_game->tickUnitUnknown4 = g_game->timerGame + 20;
 	}
 
-	if (g_tickUnitScript <= g_timerGame) {
+	if (g_game->tickUnitScript <= g_game->timerGame) {
 		tickScript = true;
-		g_tickUnitScript = g_timerGame + 5;
+		g_game->tickUnitScript = g_game->timerGame + 5;
 	}
 
-	if (g_tickUnitUnknown5 <= g_timerGame) {
+	if (g_game->tickUnitUnknown5 <= g_game->timerGame) {
 		tickUnknown5 = true;
-		g_tickUnitUnknown5 = g_timerGame + 5;
+		g_game->tickUnitUnknown5 = g_game->timerGame + 5;
 	}
 
-	if (g_tickUnitDeviation <= g_timerGame) {
+	if (g_game->tickUnitDeviation <= g_game->timerGame) {
 		tickDeviation = true;
-		g_tickUnitDeviation = g_timerGame + 60;
+		g_game->tickUnitDeviation = g_game->timerGame + 60;
 	}
 
+	if (tickScript)
+		Unit_BeginScriptTick();
+
 	for (Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
 			u != NULL;
 			u = Unit_FindNext(&find)) {
 		const UnitInfo *ui = &g_table_unitInfo[u->o.type];
 
-		g_scriptCurrentObject    = &u->o;
-		g_scriptCurrentStructure = NULL;
-		g_scriptCurrentUnit      = u;
-		g_scriptCurrentTeam      = NULL;
+		g_game->scriptCurrentObject    = &u->o;
+		g_game->scriptCurrentStructure = NULL;
+		g_game->scriptCurrentUnit      = u;
+		g_game->scriptCurrentTeam      = NULL;
 
 		if (u->o.flags.s.isNotOnMap) continue;
 
@@ -513,7 +647,9 @@ void GameLoop_Unit(void)
 			}
 		}
 
-		if (tickScript) {
+		if (tickScript && s_unitScriptLazy) {
+			s_unitScriptPassed = find.index + 1;
+		} else if (tickScript) {
 			if (u->o.script.delay == 0) {
 				if (Script_IsLoaded(&u->o.script)) {
 					/* The scripts compare
@@ -537,6 +673,9 @@ void GameLoop_Unit(void)
 			} else {
 				u->o.script.delay--;
 			}
+
+			TimerWheel_Schedule(&s_unitScriptWheel, u->o.index,
+					s_unitScriptTick + 1 + u->o.script.delay);
 		}
 
 		if (u->nextActionID == ACTION_INVALID) continue;
@@ -545,6 +684,9 @@ void GameLoop_Unit(void)
 		Unit_Server_SetAction(u, u->nextActionID);
 		u->nextActionID = ACTION_INVALID;
 	}
+
+	if (tickScript)
+		Unit_EndScriptTick();
 }
 
 /**
@@ -683,7 +825,7 @@ Unit *Unit_Create(uint16 index, uint8 typeID, uint8 houseID, tile32 position, in
 	u->blinkCounter  = 0;
 	u->timer   = 0;
 
-	Script_Reset(&u->o.script, g_scriptUnit);
+	Script_Reset(&u->o.script, &g_scriptUnit);
 
 	u->o.flags.s.allocated = true;
 
@@ -749,8 +891,9 @@ Unit_Server_SetAction(Unit *u, enum UnitActionType action)
 			u->nextActionID = ACTION_INVALID;
 			u->currentDestination.x = 0;
 			u->currentDestination.y = 0;
+			Unit_WakeScript(u);
 			u->o.script.delay = 0;
-			Script_Reset(&u->o.script, g_scriptUnit);
+			Script_Reset(&u->o.script, &g_scriptUnit);
 			u->o.script.variables[0] = action;
 			Script_Load(&u->o.script, u->o.type);
 			return;
@@ -827,22 +970,22 @@ void Unit_Sort(void)
 	h->unitCountEnemy = 0;
 	h->unitCountAllied = 0;
 
-	for (uint16 i = 0; i < g_unitFindCount - 1; i++) {
+	for (uint16 i = 0; i < g_game->unitFindCount - 1; i++) {
 		Unit *u1;
 		Unit *u2;
 		uint16 y1;
 		uint16 y2;
 
-		u1 = g_unitFindArray[i];
-		u2 = g_unitFindArray[i + 1];
+		u1 = g_game->unitFindArray[i];
+		u2 = g_game->unitFindArray[i + 1];
 		y1 = u1->o.position.y;
 		y2 = u2->o.position.y;
 		if (g_table_unitInfo[u1->o.type].movementType == MOVEMENT_FOOT) y1 -= 0x100;
 		if (g_table_unitInfo[u2->o.type].movementType == MOVEMENT_FOOT) y2 -= 0x100;
 
 		if ((int16)y1 > (int16)y2) {
-			g_unitFindArray[i] = u2;
-			g_unitFindArray[i + 1] = u1;
+			g_game->unitFindArray[i] = u2;
+			g_game->unitFindArray[i + 1] = u1;
 		}
 	}
 
@@ -871,7 +1014,7 @@ Unit *Unit_Get_ByPackedTile(uint16 packed)
 
 	if (Tile_IsOutOfMap(packed)) return NULL;
 
-	tile = &g_map[packed];
+	tile = &g_game->map[packed];
 	if (!tile->hasUnit) return NULL;
 	return Unit_Get_ByIndex(tile->index - 1);
 }
@@ -1116,6 +1259,7 @@ bool Unit_SetPosition(Unit *u, tile32 position)
 	if (u == NULL) return false;
 
 	ui = &g_table_unitInfo[u->o.type];
+	Unit_WakeScript(u);
 	u->o.flags.s.isNotOnMap = false;
 
 	u->o.position = Tile_Center(position);
@@ -1176,7 +1320,7 @@ void Unit_Remove(Unit *u)
 
 	Unit_HouseUnitCount_Remove(u);
 
-	Script_Reset(&u->o.script, g_scriptUnit);
+	Script_Reset(&u->o.script, &g_scriptUnit);
 
 	Unit_Free(u);
 }
@@ -1645,7 +1789,7 @@ bool Unit_Move(Unit *unit, uint16 distance)
 		} else {
 			uint16 type = Map_GetLandscapeType(packed);
 			/* Produce tracks in the sand */
-			if ((type == LST_NORMAL_SAND || type == LST_ENTIRELY_DUNE) && g_map[packed].overlaySpriteID == 0) {
+			if ((type == LST_NORMAL_SAND || type == LST_ENTIRELY_DUNE) && g_game->map[packed].overlaySpriteID == 0) {
 				uint8 animationID = Orientation_256To8(unit->orientation[0].current);
 
 				assert(animationID < 8);
@@ -1708,7 +1852,7 @@ bool Unit_Move(Unit *unit, uint16 distance)
 			uint16 type = Map_GetLandscapeType(Tile_PackTile(newPosition));
 			if (type == LST_WALL || type == LST_STRUCTURE) {
 				if (Tools_Index_GetType(unit->originEncoded) == IT_STRUCTURE) {
-					if (g_map[Tile_PackTile(newPosition)].houseID == unit->o.houseID) {
+					if (g_game->map[Tile_PackTile(newPosition)].houseID == unit->o.houseID) {
 						type = LST_NORMAL_SAND;
 					}
 				}
@@ -1744,7 +1888,7 @@ bool Unit_Move(Unit *unit, uint16 distance)
 							}
 						}
 					} else if (ui->explosionType != 0xFFFF) {
-						if (ui->flags.impactOnSand && g_map[Tile_PackTile(unit->o.position)].index == 0 && Map_GetLandscapeType(Tile_PackTile(unit->o.position)) == LST_NORMAL_SAND) {
+						if (ui->flags.impactOnSand && g_game->map[Tile_PackTile(unit->o.position)].index == 0 && Map_GetLandscapeType(Tile_PackTile(unit->o.position)) == LST_NORMAL_SAND) {
 							Map_MakeExplosion(EXPLOSION_SAND_BURST, newPosition, unit->o.hitpoints, unit->originEncoded);
 						} else if (unit->o.type == UNIT_MISSILE_DEVIATOR) {
 							Map_DeviateArea(ui->explosionType, newPosition, 32, unit->o.houseID);
@@ -1813,9 +1957,9 @@ bool Unit_Move(Unit *unit, uint16 distance)
 				}
 
 				if (unit->o.type != UNIT_SANDWORM) {
-					if (g_map[packed].groundSpriteID == g_bloomSpriteID) {
+					if (g_game->map[packed].groundSpriteID == g_bloomSpriteID) {
 						isSpiceBloom = true;
-					} else if (g_map[packed].groundSpriteID == g_bloomSpriteID + 1) {
+					} else if (g_game->map[packed].groundSpriteID == g_bloomSpriteID + 1) {
 						isSpecialBloom = true;
 					}
 				}
@@ -2517,10 +2661,11 @@ void Unit_Hide(Unit *unit)
 	Unit_UpdateMap(0, unit);
 	unit->o.flags.s.bulletIsBig = false;
 
-	Script_Reset(&unit->o.script, g_scriptUnit);
+	Script_Reset(&unit->o.script, &g_scriptUnit);
 	Unit_UntargetMe(unit);
 	Unit_Unselect(unit);
 
+	Unit_WakeScript(unit);
 	unit->o.flags.s.isNotOnMap = true;
 	Unit_HouseUnitCount_Remove(unit);
 }
@@ -2640,6 +2785,7 @@ void Unit_EnterStructure(Unit *unit, Structure *s)
 
 		h = House_Get_ByIndex(s->o.houseID);
 		s->o.houseID = capturer;
+		Structure_UpdateIndex(s);
 		h->structuresBuilt = Structure_GetStructuresBuilt(h);
 
 		/* ENHANCEMENT -- recalculate the power and credits for the house losing the structure. */
@@ -2726,6 +2872,7 @@ Unit_FindBestTargetStructure(Unit *unit, uint16 mode)
 {
 	const Structure *best = NULL;
 	uint16 bestPriority = 0;
+	uint32 bestOrder = 0;
 	tile32 position;
 	uint16 distance;
 	PoolFindStruct find;
@@ -2735,32 +2882,47 @@ Unit_FindBestTargetStructure(Unit *unit, uint16 mode)
 	position = Tools_Index_GetTile(unit->originEncoded);
 	distance = g_table_unitInfo[unit->o.type].fireDistance << 8;
 
-	for (const Structure *s = Structure_FindFirst(&find, HOUSE_INVALID, STRUCTURE_INVALID);
-			s != NULL;
-			s = Structure_FindNext(&find)) {
-		tile32 curPosition;
-		uint16 priority;
-
-		if (Structure_SharesPoolElement(s->o.type))
+	/* Allied structures always have zero priority, so only visit the
+	 * enemy houses.  Ties go to the structure found last by a search
+	 * over all houses.
+	 */
+	for (enum HouseType houseID = HOUSE_HARKONNEN; houseID < HOUSE_NEUTRAL; houseID++) {
+		if (House_AreAllied(Unit_GetHouseID(unit), houseID))
 			continue;
 
-		if (mode != 0 && mode != 4) {
-			if (mode == 1) {
-				if (!Unit_StructureInRange(unit, s, distance)) continue;
-			} else {
-				if (mode != 2) continue;
+		for (enum StructureType type = STRUCTURE_SLAB_1x1; type < STRUCTURE_MAX; type++) {
+			if (Structure_SharesPoolElement(type))
+				continue;
 
-				curPosition.x = s->o.position.x + g_table_structure_layoutTileDiff[g_table_structureInfo[s->o.type].layout].x;
-				curPosition.y = s->o.position.y + g_table_structure_layoutTileDiff[g_table_structureInfo[s->o.type].layout].y;
-				if (Tile_GetDistance(position, curPosition) > distance * 2) continue;
-			}
-		}
+			for (const Structure *s = Structure_FindFirst(&find, houseID, type);
+					s != NULL;
+					s = Structure_FindNext(&find)) {
+				tile32 curPosition;
+				uint16 priority;
+				uint32 order;
 
-		priority = Unit_GetTargetStructurePriority(unit, s);
+				if (mode != 0 && mode != 4) {
+					if (mode == 1) {
+						if (!Unit_StructureInRange(unit, s, distance)) continue;
+					} else {
+						if (mode != 2) continue;
 
-		if (priority >= bestPriority) {
-			best = s;
-			bestPriority = priority;
+						curPosition.x = s->o.position.x + g_table_structure_layoutTileDiff[g_table_structureInfo[s->o.type].layout].x;
+						curPosition.y = s->o.position.y + g_table_structure_layoutTileDiff[g_table_structureInfo[s->o.type].layout].y;
+						if (Tile_GetDistance(position, curPosition) > distance * 2) continue;
+					}
+				}
+
+				priority = Unit_GetTargetStructurePriority(unit, s);
+				order = Structure_GetFindOrder(s);
+
+				if (priority > bestPriority
+						|| (priority == bestPriority && order > bestOrder)) {
+					best = s;
+					bestPriority = priority;
+					bestOrder = order;
+				}
+			}
 		}
 	}
 
@@ -2816,7 +2978,7 @@ int16 Unit_GetTileEnterScore(Unit *unit, uint16 packed, uint16 orient8)
 	}
 
 	if (unit->o.type == UNIT_SABOTEUR && type == LST_WALL) {
-		if (!House_AreAllied(g_map[packed].houseID, Unit_GetHouseID(unit))) res = 255;
+		if (!House_AreAllied(g_game->map[packed].houseID, Unit_GetHouseID(unit))) res = 255;
 	}
 
 	if (res == 0) return 256;
@@ -2905,6 +3067,50 @@ void Unit_RemovePlayer(Unit *unit)
 	}
 }
 
+/**
+ * Records that the tile at packed refers to the Unit.
+ */
+static void
+Unit_OccupyTile(Unit *unit, uint16 packed)
+{
+	for (int i = 0; i < 2; i++) {
+		if (unit->occupiedTiles[i] == packed)
+			return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		if (unit->occupiedTiles[i] == 0) {
+			unit->occupiedTiles[i] = packed;
+			return;
+		}
+	}
+
+	/* A unit should never hold more than its tile and destination.
+	 * The tile would not be released when the unit leaves.
+	 */
+	assert(false);
+}
+
+/**
+ * Removes the Unit from the tiles it holds, except for its destination.
+ *  Tiles since taken over by another object are forgotten.
+ */
+static void
+Unit_LeaveOccupiedTiles(Unit *unit)
+{
+	for (int i = 0; i < 2; i++) {
+		const uint16 packed = unit->occupiedTiles[i];
+
+		if (packed == 0)
+			continue;
+
+		Unit_RemoveFromTile(unit, packed);
+
+		if (Unit_Get_ByPackedTile(packed) != unit)
+			unit->occupiedTiles[i] = 0;
+	}
+}
+
 /**
  * Update the map around the Unit depending on the type (entering tile, leaving, staying).
  * @param type The type of action on the map.
@@ -2929,9 +3135,9 @@ void Unit_UpdateMap(uint16 type, Unit *unit)
 
 	position = unit->o.position;
 	packed = Tile_PackTile(position);
-	t = &g_map[packed];
+	t = &g_game->map[packed];
 
-	if ((g_mapVisible[packed].fogOverlayBits != 0xF) || (unit->o.houseID == g_playerHouseID)) {
+	if ((g_game->mapVisible[packed].fogOverlayBits != 0xF) || (unit->o.houseID == g_playerHouseID)) {
 		Unit_HouseUnitCount_Add(unit, g_playerHouseID);
 	} else {
 		Unit_HouseUnitCount_Remove(unit);
@@ -2946,7 +3152,15 @@ void Unit_UpdateMap(uint16 type, Unit *unit)
 		if (Object_GetByPackedTile(packed) == NULL) {
 			t->index = unit->o.index + 1;
 			t->hasUnit = true;
+			Map_MarkDirty(packed);
+			Unit_OccupyTile(unit, packed);
 		}
+	} else if (type == 0) {
+		/* Only the tiles the unit holds can refer to it, so there is no
+		 * need to search the area around it.
+		 */
+		Unit_LeaveOccupiedTiles(unit);
+		return;
 	}
 
 	radius = ui->dimension + 3;
@@ -2970,11 +3184,35 @@ void Unit_UpdateMap(uint16 type, Unit *unit)
  */
 void Unit_RemoveFromTile(Unit *unit, uint16 packed)
 {
-	Tile *t = &g_map[packed];
+	Tile *t = &g_game->map[packed];
 
 	if (t->hasUnit && Unit_Get_ByPackedTile(packed) == unit && (packed != Tile_PackTile(unit->currentDestination) || unit->o.flags.s.bulletIsBig)) {
 		t->index = 0;
 		t->hasUnit = false;
+		Map_MarkDirty(packed);
+	}
+}
+
+/**
+ * Recovers which tiles each unit holds from the map, e.g. after
+ *  loading a game.
+ */
+void Unit_RebuildOccupiedTiles(void)
+{
+	PoolFindStruct find;
+
+	for (Unit *u = Unit_FindFirst(&find, HOUSE_INVALID, UNIT_INVALID);
+			u != NULL;
+			u = Unit_FindNext(&find)) {
+		u->occupiedTiles[0] = 0;
+		u->occupiedTiles[1] = 0;
+	}
+
+	for (uint16 packed = 0; packed < MAP_SIZE_MAX * MAP_SIZE_MAX; packed++) {
+		Unit *u = Unit_Get_ByPackedTile(packed);
+
+		if (u != NULL && u->o.flags.s.used)
+			Unit_OccupyTile(u, packed);
 	}
 }
 
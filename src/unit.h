@@ -60,6 +60,12 @@ typedef struct Unit {
 	bool deviationDecremented;
 	enum SquadID squadID;
 	enum SquadID aiSquad;
+
+	/* Tiles whose index refers to this unit, or 0.  A unit holds the
+	 * tile it is on, and keeps the one it is heading to while it
+	 * leaves it.
+	 */
+	uint16 occupiedTiles[2];
 } Unit;
 
 /**
@@ -123,10 +129,10 @@ extern const char * const g_table_movementTypeName[MOVEMENT_MAX];
 extern const uint16 g_table_actionsAI[4];
 extern const ActionInfo g_table_actionInfo[ACTION_MAX];
 extern const UnitInfo g_table_unitInfo_original[UNIT_MAX];
-extern UnitInfo g_table_unitInfo[UNIT_MAX];
+extern THREAD_LOCAL UnitInfo g_table_unitInfo[UNIT_MAX];
 
-extern Unit *g_unitActive;
-extern int16 g_starportAvailable[UNIT_MAX];
+extern THREAD_LOCAL Unit *g_unitActive;
+extern THREAD_LOCAL int16 g_starportAvailable[UNIT_MAX];
 
 static inline bool Unit_IsMoving(const Unit *u) { return u->currentDestination.x != 0 || u->currentDestination.y != 0; }
 
@@ -144,6 +150,9 @@ extern Unit *Unit_GetForActionPanel(void);
 extern enum UnitActionType Unit_GetSimilarAction(const uint16 *actions, enum UnitActionType actionID);
 extern tile32 Unit_GetNextDestination(const Unit *u);
 
+extern void Unit_SyncScriptDelays(void);
+extern void Unit_WakeScript(const Unit *u);
+extern void Unit_ResetScriptWheel(void);
 extern void GameLoop_Unit(void);
 extern uint8 Unit_GetHouseID(const Unit *u);
 extern uint8 Unit_StringToType(const char *name);
@@ -187,6 +196,7 @@ extern int16 Unit_GetTileEnterScore(Unit *unit, uint16 packed, uint16 orient8);
 extern void Unit_RemovePlayer(Unit *unit);
 extern void Unit_UpdateMap(uint16 type, Unit *unit);
 extern void Unit_RemoveFromTile(Unit *unit, uint16 packed);
+extern void Unit_RebuildOccupiedTiles(void);
 extern void Unit_AddToTile(Unit *unit, uint16 packed);
 extern void Unit_Server_LaunchHouseMissile(struct House *h, uint16 packed);
 extern void Unit_HouseUnitCount_Remove(Unit *unit);
@@ -0,0 +1,16 @@
+#ifndef VIDEO_ATLASCACHE_H
+#define VIDEO_ATLASCACHE_H
+
+#include <allegro5/allegro.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include "types.h"
+
+extern uint64_t AtlasCache_HashFile(uint64_t hash, const char *filename);
+extern uint64_t AtlasCache_HashPath(uint64_t hash, const char *path);
+extern uint64_t AtlasCache_HashBytes(uint64_t hash, const void *data, size_t len);
+
+extern bool AtlasCache_Load(uint64_t key, ALLEGRO_BITMAP * const *bmp, int num_bmp, void *table, size_t table_size);
+extern bool AtlasCache_Save(uint64_t key, ALLEGRO_BITMAP * const *bmp, int num_bmp, const void *table, size_t table_size);
+
+#endif
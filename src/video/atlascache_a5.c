@@ -0,0 +1,280 @@
+/* atlascache_a5.c
+ *
+ * On-disk cache of the texture atlases built at start up.
+ *
+ * Converting the original sprites, icons, CPS, WSA and fonts into
+ * house-remapped atlases takes a good part of the start up time, yet
+ * the result only changes when the data files do.  The finished
+ * atlases and the coordinate tables pointing into them are written to
+ * the personal data directory, keyed by a hash of the source files.
+ *
+ * File layout, native byte order (the cache never leaves the machine):
+ *
+ *   magic, version, key, table size, number of bitmaps
+ *   table
+ *   for each bitmap: width, height, then each row as run-length
+ *     tokens: (0x80000000 | n) for n transparent pixels, or n followed
+ *     by n ABGR pixels
+ *   key again, to catch truncated files
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "../os/common.h"
+
+#include "atlascache.h"
+
+#include "../file.h"
+
+#define ATLAS_CACHE_FILENAME    "atlas.cache"
+#define ATLAS_CACHE_MAGIC       0x43414444  /* "DDAC" */
+#define ATLAS_CACHE_VERSION     1
+
+#define FNV_OFFSET_BASIS        0xCBF29CE484222325ULL
+#define FNV_PRIME               0x00000100000001B3ULL
+
+#define ATLAS_RUN_FLAG          0x80000000U
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   FNV-1a.  Start with hash = 0 for a fresh hash.
+ */
+uint64_t
+AtlasCache_HashBytes(uint64_t hash, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+
+	if (hash == 0)
+		hash = FNV_OFFSET_BASIS;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= p[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief   Hashes the name and contents of a data file, loose or
+ *          inside a PAK.  Missing files only contribute their name.
+ */
+uint64_t
+AtlasCache_HashFile(uint64_t hash, const char *filename)
+{
+	unsigned char buf[4096];
+
+	hash = AtlasCache_HashBytes(hash, filename, strlen(filename) + 1);
+
+	if (!File_Exists(filename))
+		return hash;
+
+	const uint8 fileID = File_Open(filename, FILE_MODE_READ);
+	uint32 len;
+
+	while ((len = File_Read(fileID, buf, sizeof(buf))) > 0)
+		hash = AtlasCache_HashBytes(hash, buf, len);
+
+	File_Close(fileID);
+	return hash;
+}
+
+uint64_t
+AtlasCache_HashPath(uint64_t hash, const char *path)
+{
+	unsigned char buf[4096];
+	size_t len;
+
+	hash = AtlasCache_HashBytes(hash, path, strlen(path) + 1);
+
+	FILE *fp = fopen(path, "rb");
+	if (fp == NULL)
+		return hash;
+
+	while ((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+		hash = AtlasCache_HashBytes(hash, buf, len);
+
+	fclose(fp);
+	return hash;
+}
+
+/*--------------------------------------------------------------*/
+
+static bool
+AtlasCache_ReadUint32(FILE *fp, uint32 *value)
+{
+	return (fread(value, sizeof(*value), 1, fp) == 1);
+}
+
+static bool
+AtlasCache_WriteUint32(FILE *fp, uint32 value)
+{
+	return (fwrite(&value, sizeof(value), 1, fp) == 1);
+}
+
+static bool
+AtlasCache_ReadBitmap(FILE *fp, ALLEGRO_BITMAP *bmp)
+{
+	const int w = al_get_bitmap_width(bmp);
+	const int h = al_get_bitmap_height(bmp);
+	uint32 file_w, file_h;
+
+	if (!AtlasCache_ReadUint32(fp, &file_w) || file_w != (uint32)w
+	 || !AtlasCache_ReadUint32(fp, &file_h) || file_h != (uint32)h)
+		return false;
+
+	ALLEGRO_LOCKED_REGION *reg = al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_WRITEONLY);
+	if (reg == NULL)
+		return false;
+
+	bool ok = true;
+
+	for (int y = 0; ok && y < h; y++) {
+		unsigned char *row = (unsigned char *)reg->data + reg->pitch * y;
+		int x = 0;
+
+		while (x < w) {
+			uint32 token;
+
+			if (!AtlasCache_ReadUint32(fp, &token)) {
+				ok = false;
+				break;
+			}
+
+			const uint32 n = token & ~ATLAS_RUN_FLAG;
+			if (n == 0 || n > (uint32)(w - x)) {
+				ok = false;
+				break;
+			}
+
+			if (token & ATLAS_RUN_FLAG) {
+				memset(row + 4 * x, 0, 4 * n);
+			} else if (fread(row + 4 * x, 4, n, fp) != n) {
+				ok = false;
+				break;
+			}
+
+			x += n;
+		}
+	}
+
+	al_unlock_bitmap(bmp);
+	return ok;
+}
+
+static bool
+AtlasCache_WriteBitmap(FILE *fp, ALLEGRO_BITMAP *bmp)
+{
+	const int w = al_get_bitmap_width(bmp);
+	const int h = al_get_bitmap_height(bmp);
+
+	AtlasCache_WriteUint32(fp, w);
+	AtlasCache_WriteUint32(fp, h);
+
+	ALLEGRO_LOCKED_REGION *reg = al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_READONLY);
+	if (reg == NULL)
+		return false;
+
+	for (int y = 0; y < h; y++) {
+		const unsigned char *row = (const unsigned char *)reg->data + reg->pitch * y;
+		int x = 0;
+
+		while (x < w) {
+			const bool transparent = (memcmp(row + 4 * x, "\0\0\0\0", 4) == 0);
+			int n = 1;
+
+			while (x + n < w && (memcmp(row + 4 * (x + n), "\0\0\0\0", 4) == 0) == transparent)
+				n++;
+
+			if (transparent) {
+				AtlasCache_WriteUint32(fp, ATLAS_RUN_FLAG | n);
+			} else {
+				AtlasCache_WriteUint32(fp, n);
+				fwrite(row + 4 * x, 4, n, fp);
+			}
+
+			x += n;
+		}
+	}
+
+	al_unlock_bitmap(bmp);
+	return true;
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   Fills the bitmaps and the table from the cache.
+ * @details The bitmaps must already exist with the cached sizes.  On
+ *          failure their contents are undefined.
+ */
+bool
+AtlasCache_Load(uint64_t key, ALLEGRO_BITMAP * const *bmp, int num_bmp, void *table, size_t table_size)
+{
+	char filename[PATH_MAX];
+	uint32 magic, version, file_table_size, file_num_bmp;
+	uint64_t file_key;
+
+	snprintf(filename, sizeof(filename), "%s/%s", g_personal_data_dir, ATLAS_CACHE_FILENAME);
+
+	FILE *fp = fopen(filename, "rb");
+	if (fp == NULL)
+		return false;
+
+	bool ok
+		=  AtlasCache_ReadUint32(fp, &magic) && magic == ATLAS_CACHE_MAGIC
+		&& AtlasCache_ReadUint32(fp, &version) && version == ATLAS_CACHE_VERSION
+		&& fread(&file_key, sizeof(file_key), 1, fp) == 1 && file_key == key
+		&& AtlasCache_ReadUint32(fp, &file_table_size) && file_table_size == table_size
+		&& AtlasCache_ReadUint32(fp, &file_num_bmp) && file_num_bmp == (uint32)num_bmp
+		&& fread(table, table_size, 1, fp) == 1;
+
+	for (int i = 0; ok && i < num_bmp; i++)
+		ok = AtlasCache_ReadBitmap(fp, bmp[i]);
+
+	ok = ok && fread(&file_key, sizeof(file_key), 1, fp) == 1 && file_key == key;
+
+	fclose(fp);
+	return ok;
+}
+
+bool
+AtlasCache_Save(uint64_t key, ALLEGRO_BITMAP * const *bmp, int num_bmp, const void *table, size_t table_size)
+{
+	char filename[PATH_MAX];
+	char tmpname[PATH_MAX];
+
+	snprintf(filename, sizeof(filename), "%s/%s", g_personal_data_dir, ATLAS_CACHE_FILENAME);
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+
+	FILE *fp = fopen(tmpname, "wb");
+	if (fp == NULL)
+		return false;
+
+	AtlasCache_WriteUint32(fp, ATLAS_CACHE_MAGIC);
+	AtlasCache_WriteUint32(fp, ATLAS_CACHE_VERSION);
+	fwrite(&key, sizeof(key), 1, fp);
+	AtlasCache_WriteUint32(fp, table_size);
+	AtlasCache_WriteUint32(fp, num_bmp);
+	fwrite(table, table_size, 1, fp);
+
+	bool ok = true;
+	for (int i = 0; ok && i < num_bmp; i++)
+		ok = AtlasCache_WriteBitmap(fp, bmp[i]);
+
+	fwrite(&key, sizeof(key), 1, fp);
+
+	ok = (fclose(fp) == 0) && ok;
+
+	if (ok) {
+		/* rename does not replace existing files on Windows. */
+		remove(filename);
+		ok = (rename(tmpname, filename) == 0);
+	}
+
+	if (!ok)
+		remove(tmpname);
+
+	return ok;
+}
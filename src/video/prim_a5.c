@@ -3,9 +3,14 @@
 #include <assert.h>
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_primitives.h>
+#include "buildcfg.h"
 
 #include "prim.h"
 
+#ifdef WITH_SOFTWARE_VIDEO
+#include "video_soft_a5.h"
+#endif
+
 extern ALLEGRO_COLOR paltoRGB[256];
 
 /*--------------------------------------------------------------*/
@@ -13,6 +18,11 @@ extern ALLEGRO_COLOR paltoRGB[256];
 void
 Prim_Line(float x1, float y1, float x2, float y2, uint8 c, float thickness)
 {
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawLine(x1, y1, x2, y2, c))
+		return;
+#endif
+
 	al_draw_line(x1, y1, x2, y2, paltoRGB[c], thickness);
 }
 
@@ -20,6 +30,12 @@ void
 Prim_Hline(int x1, int y, int x2, uint8 c)
 {
 	assert(x1 <= x2);
+
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawFilledRect(x1, y, x2 + 1, y + 1, c))
+		return;
+#endif
+
 	al_draw_line(x1, y + 0.5f, x2 + 0.99f, y + 0.5f, paltoRGB[c], 1.0f);
 }
 
@@ -27,6 +43,12 @@ void
 Prim_Vline(int x, int y1, int y2, uint8 c)
 {
 	assert(y1 <= y2);
+
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawFilledRect(x, y1, x + 1, y2 + 1, c))
+		return;
+#endif
+
 	al_draw_line(x + 0.5f, y1, x + 0.5f, y2 + 0.99f, paltoRGB[c], 1.0f);
 }
 
@@ -75,6 +97,11 @@ Prim_FillCircle_RGBA(float cx, float cy, float rd, unsigned char r, unsigned cha
 void
 Prim_Rect(float x1, float y1, float x2, float y2, uint8 c, float thickness)
 {
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawRect(x1, y1, x2, y2, c))
+		return;
+#endif
+
 	al_draw_rectangle(x1, y1, x2, y2, paltoRGB[c], thickness);
 }
 
@@ -84,6 +111,11 @@ Prim_Rect_i(int x1, int y1, int x2, int y2, uint8 c)
 	assert(x1 <= x2);
 	assert(y1 <= y2);
 
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawRect(x1 + 0.5f, y1 + 0.5f, x2 + 0.5f, y2 + 0.5f, c))
+		return;
+#endif
+
 	al_draw_rectangle(x1 + 0.5f, y1 + 0.5f, x2 + 0.5f, y2 + 0.5f, paltoRGB[c], 1.0f);
 }
 
@@ -98,6 +130,11 @@ Prim_Rect_RGBA(float x1, float y1, float x2, float y2, unsigned char r, unsigned
 void
 Prim_FillRect(float x1, float y1, float x2, float y2, uint8 c)
 {
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawFilledRect(x1, y1, x2, y2, c))
+		return;
+#endif
+
 	al_draw_filled_rectangle(x1, y1, x2, y2, paltoRGB[c]);
 }
 
@@ -107,6 +144,11 @@ Prim_FillRect_i(int x1, int y1, int x2, int y2, uint8 c)
 	assert(x1 <= x2);
 	assert(y1 <= y2);
 
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawFilledRect(x1, y1, x2 + 1, y2 + 1, c))
+		return;
+#endif
+
 	al_draw_filled_rectangle(x1 + 0.01f, y1 + 0.01f, x2 + 0.99f, y2 + 0.99f, paltoRGB[c]);
 }
 
@@ -117,6 +159,11 @@ Prim_FillRect_RGBA(float x1, float y1, float x2, float y2,
 	assert(x1 <= x2);
 	assert(y1 <= y2);
 
+#ifdef WITH_SOFTWARE_VIDEO
+	if (VideoSoftA5_DrawFilledRectRGBA(x1, y1, x2, y2, r, g, b, alpha))
+		return;
+#endif
+
 	al_draw_filled_rectangle(x1, y1, x2, y2, al_map_rgba(r, g, b, alpha));
 }
 
@@ -1,6 +1,7 @@
 #ifndef VIDEO_VIDEO_H
 #define VIDEO_VIDEO_H
 
+#include "buildcfg.h"
 #include "../shape.h"
 
 enum {
@@ -69,11 +70,24 @@ extern void Video_DrawMinimap(int left, int top, int map_scale, enum MinimapDraw
 #define Video_DrawCPSRegion          VideoA5_DrawCPSRegion
 #define Video_DrawCPSSpecial         VideoA5_DrawCPSSpecial
 #define Video_DrawCPSSpecialScale    VideoA5_DrawCPSSpecialScale
-#define Video_DrawIcon          VideoA5_DrawIcon
-#define Video_DrawIconAlpha     VideoA5_DrawIconAlpha
-#define Video_DrawChar          VideoA5_DrawChar
-#define Video_DrawCharAlpha     VideoA5_DrawCharAlpha
+#define Video_DrawTextBegin     VideoA5_DrawTextBegin
+#define Video_DrawTextChar      VideoA5_DrawTextChar
+#define Video_DrawTextEnd       VideoA5_DrawTextEnd
 #define Video_DrawWSA           VideoA5_DrawWSA
 #define Video_DrawWSAStatic     VideoA5_DrawWSAStatic
 
+#if defined(WITH_SOFTWARE_VIDEO) && !defined(DEDICATED_SERVER)
+#include "video_soft_a5.h"
+
+#define Video_BeginViewport     VideoSoftA5_BeginViewport
+#define Video_EndViewport       VideoSoftA5_EndViewport
+#define Video_DrawIcon          VideoSoftA5_DrawIcon
+#define Video_DrawIconAlpha     VideoSoftA5_DrawIconAlpha
+#else
+#define Video_BeginViewport()
+#define Video_EndViewport()
+#define Video_DrawIcon          VideoA5_DrawIcon
+#define Video_DrawIconAlpha     VideoA5_DrawIconAlpha
+#endif
+
 #endif
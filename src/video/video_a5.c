@@ -39,21 +39,30 @@
 #include "../os/math.h"
 
 #include "video_a5.h"
+#ifdef WITH_SOFTWARE_VIDEO
+#include "video_soft_a5.h"
+#endif
 
+#include "atlascache.h"
 #include "../common_a5.h"
 #include "../config.h"
 #include "../enhancement.h"
 #include "../file.h"
+#include "../gamecontext.h"
 #include "../gfx.h"
 #include "../gui/font.h"
 #include "../gui/gui.h"
 #include "../input/input_a5.h"
 #include "../input/mouse.h"
 #include "../map.h"
+#include "../net/net.h"
+#include "../net/telemetry.h"
 #include "../newui/viewport.h"
 #include "../opendune.h"
+#include "../profile.h"
 #include "../scenario.h"
 #include "../sprites.h"
+#include "../string.h"
 #include "../structure.h"
 #include "../table/widgetinfo.h"
 #include "../timer/timer.h"
@@ -76,7 +85,6 @@
 #endif
 
 #define OUTPUT_TEXTURES     false
-#define ICONID_MAX          512
 #define SHAPEID_MAX         640
 #define FONTID_MAX          8
 #define CURSOR_MAX          6
@@ -114,6 +122,12 @@ typedef struct IconCoord {
 	int sx48, sy48;
 } IconCoord;
 
+/* Opaque part of a blur brush, in brush coordinates. */
+typedef struct BlurRect {
+	int x1, y1;
+	int x2, y2;     /* exclusive. */
+} BlurRect;
+
 typedef struct IconConnectivity {
 	uint16 iconU;
 	uint16 iconD;
@@ -158,8 +172,10 @@ enum GraphicsDriver g_graphics_driver;
 /* Exposed for prim_a5.c. */
 ALLEGRO_COLOR paltoRGB[256];
 
+/* Exposed for video_soft_a5.c. */
+unsigned char paletteRGB[3 * 256];
+
 static ALLEGRO_DISPLAY *display;
-static unsigned char paletteRGB[3 * 256];
 
 static CPSStore *s_cps;
 static ALLEGRO_BITMAP *scratch; /* temporary bitmap for non-speed-critical images. */
@@ -173,13 +189,22 @@ static ALLEGRO_BITMAP *region_texture;    /* strategic map shapes. */
 static IconCoord s_icon[ICONID_MAX][HOUSE_NEUTRAL];
 static ALLEGRO_BITMAP *s_shape[SHAPEID_MAX][HOUSE_NEUTRAL];
 static ALLEGRO_BITMAP *s_font[FONTID_MAX][256];
+static ALLEGRO_BITMAP **s_text_font;
+static ALLEGRO_COLOR s_text_tint;
 static ALLEGRO_MOUSE_CURSOR *s_cursor[CURSOR_MAX];
+static bool s_have_stencil;
+static BlurRect *s_blur_rect[SHAPEID_MAX];
+static int s_blur_rect_count[SHAPEID_MAX];
 
 static ALLEGRO_BITMAP *s_minimap;
 static int s_minimap_colour[MAP_SIZE_MAX * MAP_SIZE_MAX];
 
 static bool take_screenshot = false;
 static bool show_fps = false;
+static bool show_net_stats = false;
+#ifdef WITH_PROFILER
+static bool show_profiler = false;
+#endif /* WITH_PROFILER */
 static FadeInAux s_fadeInAux;
 
 /* VideoA5_GetNextXY:
@@ -396,6 +421,9 @@ VideoA5_Init(void)
 
 	al_set_window_title(display, DUNE_DYNASTY_STR);
 
+	/* Software GL and some kiosk drivers do not give us one. */
+	s_have_stencil = (al_get_display_option(display, ALLEGRO_STENCIL_SIZE) > 0);
+
 	/* al_set_new_bitmap_flags(ALLEGRO_MAG_LINEAR); */
 	TRUE_DISPLAY_WIDTH = al_get_display_width(display);
 	TRUE_DISPLAY_HEIGHT = al_get_display_height(display);
@@ -475,6 +503,16 @@ VideoA5_Uninit(void)
 
 	VideoA5_UninitCPSStore();
 
+#ifdef WITH_SOFTWARE_VIDEO
+	VideoSoftA5_Uninit();
+#endif
+
+	for (enum ShapeID shapeID = 0; shapeID < SHAPEID_MAX; shapeID++) {
+		free(s_blur_rect[shapeID]);
+		s_blur_rect[shapeID] = NULL;
+		s_blur_rect_count[shapeID] = 0;
+	}
+
 	al_destroy_bitmap(scratch);
 	scratch = NULL;
 
@@ -534,6 +572,71 @@ VideoA5_ToggleFPS(void)
 	show_fps = !show_fps;
 }
 
+void
+VideoA5_ToggleNetStats(void)
+{
+	show_net_stats = !show_net_stats;
+}
+
+#ifdef WITH_PROFILER
+void
+VideoA5_ToggleProfiler(void)
+{
+	show_profiler = !show_profiler;
+}
+
+/**
+ * @brief   Draws the last PROFILE_HISTORY frames as stacked bars, one
+ *          colour per zone, with a line at 1/60 s.
+ */
+static void
+VideoA5_DrawProfiler(int left, int bottom)
+{
+	static const unsigned char colour[PROFILE_ZONE_MAX][3] = {
+		{ 0x80, 0x00, 0x00 }, { 0xC0, 0x40, 0x00 }, { 0xFF, 0x00, 0x00 },
+		{ 0xFF, 0x80, 0x00 }, { 0xFF, 0xC0, 0x40 }, { 0xFF, 0xFF, 0x00 },
+		{ 0xC0, 0xC0, 0x80 }, { 0x80, 0x40, 0x40 }, { 0xFF, 0x00, 0xFF },
+		{ 0x40, 0x40, 0xC0 }, { 0x00, 0x80, 0x00 }, { 0x00, 0xFF, 0x00 },
+		{ 0x00, 0xFF, 0xFF }, { 0x80, 0x80, 0x80 }, { 0x00, 0x80, 0xFF },
+		{ 0xFF, 0xFF, 0xFF }, { 0x40, 0x40, 0x40 },
+	};
+	const float ms = 4.0f;
+
+	for (int frame = 0; frame < PROFILE_HISTORY; frame++) {
+		const float x = left + 2 * frame;
+		float y = bottom;
+
+		for (enum ProfileZone zone = 0; zone < PROFILE_ZONE_MAX; zone++) {
+			const float h = 1000.0f * ms * Profile_GetFrameTime(frame, zone);
+			if (h <= 0.0f)
+				continue;
+
+			al_draw_filled_rectangle(x, y - h, x + 2, y,
+					al_map_rgb(colour[zone][0], colour[zone][1], colour[zone][2]));
+			y -= h;
+		}
+	}
+
+	al_draw_line(left, bottom - ms * 1000.0f / 60.0f,
+			left + 2 * PROFILE_HISTORY, bottom - ms * 1000.0f / 60.0f,
+			al_map_rgb(0xFF, 0xFF, 0xFF), 1.0f);
+
+	for (enum ProfileZone zone = 0; zone < PROFILE_ZONE_MAX; zone++) {
+		const char *str = Profile_GetZoneName(zone);
+		const int x = left + 2 * PROFILE_HISTORY + 4;
+		const int y = bottom - 8 * (PROFILE_ZONE_MAX - zone);
+
+		al_draw_filled_rectangle(x, y + 1, x + 5, y + 6,
+				al_map_rgb(colour[zone][0], colour[zone][1], colour[zone][2]));
+
+		for (int i = 0; str[i] != '\0'; i++) {
+			const unsigned char c = str[i];
+			al_draw_tinted_bitmap(s_font[2][c], paltoRGB[15], x + 8 + 6 * i, y, 0);
+		}
+	}
+}
+#endif /* WITH_PROFILER */
+
 void
 VideoA5_CaptureScreenshot(void)
 {
@@ -668,6 +771,25 @@ VideoA5_Tick(void)
 		}
 	}
 
+	if (show_net_stats && g_host_type != HOSTTYPE_NONE) {
+		char str[MAX_CHAT_LEN + 1];
+
+		for (int line = 0; line < 10; line++) {
+			if (!NetTelemetry_GetLine(line, str, sizeof(str)))
+				break;
+
+			for (int i = 0; str[i] != '\0'; i++) {
+				const unsigned char c = str[i];
+				al_draw_tinted_bitmap(s_font[2][c], paltoRGB[15], 2 + 6 * i, 52 + 8 * line, 0);
+			}
+		}
+	}
+
+#ifdef WITH_PROFILER
+	if (show_profiler)
+		VideoA5_DrawProfiler(2, 200);
+#endif /* WITH_PROFILER */
+
 	/* Draw software mouse cursor for people who have trouble with hardware cursors. */
 	if (!g_gameConfig.hardwareCursor && !g_mouseHidden) {
 		const int size = (TRUE_DISPLAY_WIDTH >= 640) ? 32 : 16;
@@ -780,10 +902,24 @@ Video_ShadeScreen(int alpha)
 	A5_UseTransform(prev_transform);
 }
 
+/**
+ * Holds nest, so that a caller can batch several strings (or a string
+ * and its shadow) into one draw call.
+ */
 void
 Video_HoldBitmapDrawing(bool hold)
 {
-	al_hold_bitmap_drawing(hold);
+	static int l_depth;
+
+	if (hold) {
+		if (l_depth++ == 0)
+			al_hold_bitmap_drawing(true);
+	} else {
+		assert(l_depth > 0);
+
+		if (--l_depth == 0)
+			al_hold_bitmap_drawing(false);
+	}
 }
 
 /*--------------------------------------------------------------*/
@@ -1428,7 +1564,7 @@ Video_InitFadeInCPS(const char *filename, int x, int y, int w, int h, bool fade_
 
 /*--------------------------------------------------------------*/
 
-static int
+int
 VideoA5_NumIconsInGroup(enum IconMapEntries group)
 {
 	if (!(0 < group && group < ICM_ICONGROUP_EOF))
@@ -1903,7 +2039,12 @@ VideoA5_InitIcons(unsigned char *buf)
 #endif
 
 	VideoA5_SetBitmapFlags(ALLEGRO_VIDEO_BITMAP);
+	free(connect);
+}
 
+static void
+VideoA5_ConvertIconTextures(void)
+{
 	const int bitmap_flags = al_get_new_bitmap_flags();
 	al_set_new_bitmap_flags(bitmap_flags & ~ALLEGRO_NO_PRESERVE_TEXTURE);
 
@@ -1917,9 +2058,53 @@ VideoA5_InitIcons(unsigned char *buf)
 		icon_texture48 = VideoA5_ConvertToVideoBitmap(icon_texture48);
 
 	al_set_new_bitmap_flags(bitmap_flags);
-	free(connect);
 }
 
+#ifdef WITH_SOFTWARE_VIDEO
+bool
+VideoA5_IconHasHouseColours(uint16 iconID)
+{
+	assert(iconID < ICONID_MAX);
+
+	for (enum HouseType houseID = HOUSE_HARKONNEN + 1; houseID < HOUSE_NEUTRAL; houseID++) {
+		if (s_icon[iconID][houseID].sx != s_icon[iconID][HOUSE_HARKONNEN].sx
+				|| s_icon[iconID][houseID].sy != s_icon[iconID][HOUSE_HARKONNEN].sy)
+			return true;
+	}
+
+	return false;
+}
+
+/* VideoA5_GetIconAlpha:
+ *
+ * The alpha of an icon, e.g. from the rubble mask, as TILE_SIZE rows
+ * of TILE_SIZE.  Only before VideoA5_ConvertIconTextures.
+ */
+bool
+VideoA5_GetIconAlpha(uint16 iconID, uint8 *alpha)
+{
+	assert(iconID < ICONID_MAX);
+
+	const IconCoord *coord = &s_icon[iconID][HOUSE_HARKONNEN];
+	if (icon_texture == NULL || (coord->sx == 0 && coord->sy == 0))
+		return false;
+
+	ALLEGRO_LOCKED_REGION *reg = al_lock_bitmap_region(icon_texture, coord->sx, coord->sy, TILE_SIZE, TILE_SIZE, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_READONLY);
+	if (reg == NULL)
+		return false;
+
+	for (int y = 0; y < TILE_SIZE; y++) {
+		const unsigned char *row = &((unsigned char *)reg->data)[reg->pitch*y];
+
+		for (int x = 0; x < TILE_SIZE; x++)
+			alpha[TILE_SIZE * y + x] = row[reg->pixel_size*x + 3];
+	}
+
+	al_unlock_bitmap(icon_texture);
+	return true;
+}
+#endif /* WITH_SOFTWARE_VIDEO */
+
 void
 VideoA5_DrawIcon(uint16 iconID, enum HouseType houseID, int x, int y)
 {
@@ -1989,7 +2174,14 @@ VideoA5_DrawRectCross(int x1, int y1, int w, int h, unsigned char c)
 		0,  0, 101, 183, /* h = 3 */
 	};
 
-	if (enhancement_high_res_overlays || w >= 4 || h >= 4) {
+	bool use_prims = enhancement_high_res_overlays || w >= 4 || h >= 4;
+
+#ifdef WITH_SOFTWARE_VIDEO
+	/* The crosses are only in the icon texture. */
+	use_prims = use_prims || VideoSoftA5_IsDrawing();
+#endif
+
+	if (use_prims) {
 		const int x2 = x1 + (w * TILE_SIZE) - 1;
 		const int y2 = y1 + (h * TILE_SIZE) - 1;
 
@@ -2384,6 +2576,117 @@ VideoA5_DrawBlur_D3DStencil(ALLEGRO_BITMAP *brush, int x, int y, int blurx)
 }
 #endif
 
+/* VideoA5_InitBlurRects:
+ *
+ * Splits the opaque pixels of a blur brush into rectangles: runs of
+ * pixels in each row, merged with the run directly above if it has
+ * the same extent.  The brush is only read back once.
+ */
+static void
+VideoA5_InitBlurRects(enum ShapeID shapeID, ALLEGRO_BITMAP *brush)
+{
+	const int w = al_get_bitmap_width(brush);
+	const int h = al_get_bitmap_height(brush);
+	BlurRect *rect = malloc(w * h * sizeof(rect[0]));
+	int count = 0;
+	int prev_row = 0;
+
+	assert(rect != NULL);
+
+	al_lock_bitmap(brush, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
+
+	for (int y = 0; y < h; y++) {
+		const int curr_row = count;
+
+		for (int x = 0; x < w; x++) {
+			unsigned char r, g, b, a;
+
+			al_unmap_rgba(al_get_pixel(brush, x, y), &r, &g, &b, &a);
+			if (a <= 0x80)
+				continue;
+
+			int x2 = x + 1;
+			for (; x2 < w; x2++) {
+				al_unmap_rgba(al_get_pixel(brush, x2, y), &r, &g, &b, &a);
+				if (a <= 0x80)
+					break;
+			}
+
+			/* Extend a rectangle from the previous row if possible. */
+			int i;
+			for (i = prev_row; i < curr_row; i++) {
+				if (rect[i].x1 == x && rect[i].x2 == x2 && rect[i].y2 == y)
+					break;
+			}
+
+			if (i < curr_row) {
+				rect[i].y2 = y + 1;
+			} else {
+				rect[count].x1 = x;
+				rect[count].y1 = y;
+				rect[count].x2 = x2;
+				rect[count].y2 = y + 1;
+				count++;
+			}
+
+			x = x2;
+		}
+
+		prev_row = curr_row;
+	}
+
+	al_unlock_bitmap(brush);
+
+	s_blur_rect[shapeID] = rect;
+	s_blur_rect_count[shapeID] = count;
+}
+
+/* Requires nothing but clipping rectangles.
+ * Used when there is no stencil buffer.
+ */
+static void
+VideoA5_DrawBlur_ClipRects(enum ShapeID shapeID, ALLEGRO_BITMAP *brush, int x, int y, int blurx)
+{
+	const ALLEGRO_TRANSFORM *trans = al_get_current_transform();
+	const bool held = al_is_bitmap_drawing_held();
+	int cx, cy, cw, ch;
+
+	if (s_blur_rect[shapeID] == NULL)
+		VideoA5_InitBlurRects(shapeID, brush);
+
+	al_get_clipping_rectangle(&cx, &cy, &cw, &ch);
+
+	/* Clipping changes do not apply to deferred drawing. */
+	if (held)
+		al_hold_bitmap_drawing(false);
+
+	for (int i = 0; i < s_blur_rect_count[shapeID]; i++) {
+		const BlurRect *rect = &s_blur_rect[shapeID][i];
+		float x1 = x + rect->x1, y1 = y + rect->y1;
+		float x2 = x + rect->x2, y2 = y + rect->y2;
+
+		al_transform_coordinates(trans, &x1, &y1);
+		al_transform_coordinates(trans, &x2, &y2);
+
+		/* Round every edge the same way so neighbours do not overlap. */
+		const int l = max(cx,      (int)(x1 + 0.5f));
+		const int t = max(cy,      (int)(y1 + 0.5f));
+		const int r = min(cx + cw, (int)(x2 + 0.5f));
+		const int b = min(cy + ch, (int)(y2 + 0.5f));
+
+		if (l >= r || t >= b)
+			continue;
+
+		al_set_clipping_rectangle(l, t, r - l, b - t);
+		Viewport_RenderBrush(x + blurx, y, blurx);
+	}
+
+	al_set_clipping_rectangle(cx, cy, cw, ch);
+
+	if (held)
+		al_hold_bitmap_drawing(true);
+}
+
 void
 VideoA5_DrawShape(enum ShapeID shapeID, enum HouseType houseID, int x, int y, int flags)
 {
@@ -2410,6 +2713,11 @@ VideoA5_DrawShape(enum ShapeID shapeID, enum HouseType houseID, int x, int y, in
 
 		ALLEGRO_BITMAP *brush = s_shape[shapeID][houseID];
 
+		if (!s_have_stencil) {
+			VideoA5_DrawBlur_ClipRects(shapeID, brush, x, y, s_variable_60[effect]);
+			return;
+		}
+
 		switch (g_graphics_driver) {
 			case GRAPHICS_DRIVER_OPENGL:
 				VideoA5_DrawBlur_GLStencil(brush, x, y, s_variable_60[effect]);
@@ -2424,6 +2732,7 @@ VideoA5_DrawShape(enum ShapeID shapeID, enum HouseType houseID, int x, int y, in
 			default:
 				/* VideoA5_DrawBlur_SeparateBlender(brush, x, y, s_variable_60[effect]); */
 				/* VideoA5_DrawBlur_DestMinusSrc(brush, x, y, s_variable_60[effect]); */
+				VideoA5_DrawBlur_ClipRects(shapeID, brush, x, y, s_variable_60[effect]);
 				break;
 		}
 	} else if ((flags & 0x300) == 0x300) {
@@ -2501,6 +2810,16 @@ VideoA5_DrawShapeTint(enum ShapeID shapeID, int x, int y, unsigned char c, int f
 	al_draw_tinted_bitmap(s_shape[shapeID][HOUSE_HARKONNEN], paltoRGB[c], x, y, flags);
 }
 
+#ifdef WITH_SOFTWARE_VIDEO
+bool
+VideoA5_ShapeHasHouseColours(enum ShapeID shapeID)
+{
+	assert(shapeID < SHAPEID_MAX);
+
+	return s_shape[shapeID][HOUSE_HARKONNEN] != s_shape[shapeID][HOUSE_HARKONNEN + 1];
+}
+#endif /* WITH_SOFTWARE_VIDEO */
+
 FadeInAux *
 Video_InitFadeInShape(enum ShapeID shapeID, enum HouseType houseID, int x, int y)
 {
@@ -2648,29 +2967,44 @@ VideoA5_InitFonts(unsigned char *buf)
 	}
 }
 
+/**
+ * Text is drawn as a run of characters sharing one font, palette and
+ * tint.  The glyphs all live in interface_texture, so with drawing held
+ * the whole run is submitted as a single batch.
+ */
 void
-VideoA5_DrawChar(unsigned char c, const uint8 *pal, int x, int y)
+VideoA5_DrawTextBegin(const uint8 *pal, unsigned char alpha)
 {
-	const int fnt = VideoA5_FontIndex(g_fontCurrent, pal);
-	const ALLEGRO_COLOR fg = paltoRGB[pal[1]];
+	s_text_font = s_font[VideoA5_FontIndex(g_fontCurrent, pal)];
 
-	if (s_font[fnt][c] != NULL)
-		al_draw_tinted_bitmap(s_font[fnt][c], fg, x, y, 0);
+	if (alpha == 0xFF) {
+		s_text_tint = paltoRGB[pal[1]];
+	} else {
+		s_text_tint
+			= al_map_rgba(
+					paletteRGB[3 * pal[1] + 0],
+					paletteRGB[3 * pal[1] + 1],
+					paletteRGB[3 * pal[1] + 2],
+					alpha);
+	}
+
+	Video_HoldBitmapDrawing(true);
 }
 
 void
-VideoA5_DrawCharAlpha(unsigned char c, const uint8 *pal, int x, int y, unsigned char alpha)
+VideoA5_DrawTextChar(unsigned char c, int x, int y)
 {
-	const int fnt = VideoA5_FontIndex(g_fontCurrent, pal);
-	const ALLEGRO_COLOR tint
-		= al_map_rgba(
-				paletteRGB[3 * pal[1] + 0],
-				paletteRGB[3 * pal[1] + 1],
-				paletteRGB[3 * pal[1] + 2],
-				alpha);
+	assert(s_text_font != NULL);
 
-	if (s_font[fnt][c] != NULL)
-		al_draw_tinted_bitmap(s_font[fnt][c], tint, x, y, 0);
+	if (s_text_font[c] != NULL)
+		al_draw_tinted_bitmap(s_text_font[c], s_text_tint, x, y, 0);
+}
+
+void
+VideoA5_DrawTextEnd(void)
+{
+	Video_HoldBitmapDrawing(false);
+	s_text_font = NULL;
 }
 
 /*--------------------------------------------------------------*/
@@ -2765,7 +3099,7 @@ Video_DrawMinimap(int left, int top, int map_scale, enum MinimapDrawMode mode)
 		int i = mapInfo->sizeX * y;
 
 		for (int x = 0; x < mapInfo->sizeX; x++, i++, packed++) {
-			const Tile *t = &g_map[packed];
+			const Tile *t = &g_game->map[packed];
 			int colour = 12;
 
 			if (mode == 1) {
@@ -2775,7 +3109,7 @@ Video_DrawMinimap(int left, int top, int map_scale, enum MinimapDrawMode mode)
 					&& Map_IsUnveiledToHouse(g_playerHouseID, packed)) {
 				Unit *u;
 
-				if (enhancement_fog_of_war && g_mapVisible[packed].timeout[g_playerHouseID] <= g_timerGame) {
+				if (enhancement_fog_of_war && g_game->mapVisible[packed].timeout[g_playerHouseID] <= g_game->timerGame) {
 				} else if (t->hasUnit && ((u = Unit_Get_ByPackedTile(packed)) != NULL)) {
 					if (u->o.type == UNIT_SANDWORM) {
 						/* Really shouldn't have more than 3, but anyway. */
@@ -2794,7 +3128,7 @@ Video_DrawMinimap(int left, int top, int map_scale, enum MinimapDrawMode mode)
 
 					if (g_table_landscapeInfo[type].radarColour == 0xFFFF) {
 						colour = g_table_houseInfo[t->houseID].minimapColor;
-					} else if (enhancement_fog_of_war && g_mapVisible[packed].timeout[g_playerHouseID] <= g_timerGame) {
+					} else if (enhancement_fog_of_war && g_game->mapVisible[packed].timeout[g_playerHouseID] <= g_game->timerGame) {
 						colour = -g_table_landscapeInfo[type].radarColour;
 					} else {
 						colour = g_table_landscapeInfo[type].radarColour;
@@ -2980,6 +3314,174 @@ Video_InitMentatSprites(bool use_benepal)
 	Widget_SetCurrentWidget(old_widget);
 }
 
+/*--------------------------------------------------------------*/
+
+enum ShapeCoordParent {
+	SHAPECOORD_NONE,
+	SHAPECOORD_SHAPE_TEXTURE,
+	SHAPECOORD_REGION_TEXTURE,
+	SHAPECOORD_HARKONNEN        /* Same bitmap as the Harkonnen shape. */
+};
+
+typedef struct ShapeCoord {
+	int parent;
+	int x, y;
+	int w, h;
+} ShapeCoord;
+
+typedef struct AtlasCacheTable {
+	IconCoord icon[ICONID_MAX][HOUSE_NEUTRAL];
+	ShapeCoord shape[SHAPEID_MAX][HOUSE_NEUTRAL];
+} AtlasCacheTable;
+
+/* VideoA5_AtlasCacheKey:
+ *
+ * Everything the atlases are built from.  Bump ATLAS_CACHE_VERSION in
+ * atlascache_a5.c when the way they are built changes.
+ */
+static uint64_t
+VideoA5_AtlasCacheKey(void)
+{
+	const char * const files[] = {
+		"IBM.PAL", "GRAYRMAP.TBL", "ICON.ICN", "ICON.MAP",
+		"MOUSE.SHP", "SHAPES.SHP", "UNITS.SHP", "UNITS1.SHP", "UNITS2.SHP",
+		"PIECES.SHP", "ARROWS.SHP", "BTTN.ENG", "CHOAM.ENG",
+		"SCREEN.CPS", "FAME.CPS", "MAPMACH.CPS", "STATIC.WSA",
+		"INTRO.FNT", "NEW6P.FNT", "NEW6PG.FNT", "NEW8P.FNT",
+	};
+
+	const char * const localised[] = { "BTTN", "CHOAM", "MENTAT" };
+
+	const int size[2] = {
+		g_widgetProperties[WINDOWID_RENDER_TEXTURE].width,
+		g_widgetProperties[WINDOWID_RENDER_TEXTURE].height
+	};
+
+	char path[PATH_MAX];
+	uint64_t hash = AtlasCache_HashBytes(0, DUNE_DYNASTY_VERSION, sizeof(DUNE_DYNASTY_VERSION));
+
+	hash = AtlasCache_HashBytes(hash, size, sizeof(size));
+
+	for (unsigned int i = 0; i < lengthof(files); i++)
+		hash = AtlasCache_HashFile(hash, files[i]);
+
+	for (unsigned int i = 0; i < lengthof(localised); i++)
+		hash = AtlasCache_HashFile(hash, String_GenerateFilename(localised[i]));
+
+	snprintf(path, sizeof(path), "%s/gfx/rubblemask.png", g_dune_data_dir);
+	return AtlasCache_HashPath(hash, path);
+}
+
+static bool
+VideoA5_LoadAtlasCache(uint64_t key)
+{
+	const int WINDOW_W = g_widgetProperties[WINDOWID_RENDER_TEXTURE].width;
+	const int WINDOW_H = g_widgetProperties[WINDOWID_RENDER_TEXTURE].height;
+
+	AtlasCacheTable *table = malloc(sizeof(*table));
+	if (table == NULL)
+		return false;
+
+	VideoA5_SetBitmapFlags(ALLEGRO_MEMORY_BITMAP);
+	icon_texture = al_create_bitmap(WINDOW_W, WINDOW_H);
+	assert(icon_texture != NULL);
+	VideoA5_SetBitmapFlags(ALLEGRO_VIDEO_BITMAP);
+
+	ALLEGRO_BITMAP * const bmp[] = { icon_texture, shape_texture, region_texture, interface_texture };
+
+	if (!AtlasCache_Load(key, bmp, lengthof(bmp), table, sizeof(*table))) {
+		al_destroy_bitmap(icon_texture);
+		icon_texture = NULL;
+
+		/* Do not leave half a cache behind for the regular path. */
+		for (unsigned int i = 1; i < lengthof(bmp); i++) {
+			al_set_target_bitmap(bmp[i]);
+			al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+		}
+
+		free(table);
+		return false;
+	}
+
+	memcpy(s_icon, table->icon, sizeof(s_icon));
+
+	for (enum ShapeID shapeID = 0; shapeID < SHAPEID_MAX; shapeID++) {
+		for (enum HouseType houseID = HOUSE_HARKONNEN; houseID < HOUSE_NEUTRAL; houseID++) {
+			const ShapeCoord *coord = &table->shape[shapeID][houseID];
+
+			switch (coord->parent) {
+				case SHAPECOORD_SHAPE_TEXTURE:
+				case SHAPECOORD_REGION_TEXTURE:
+					s_shape[shapeID][houseID] = al_create_sub_bitmap(
+							(coord->parent == SHAPECOORD_SHAPE_TEXTURE) ? shape_texture : region_texture,
+							coord->x, coord->y, coord->w, coord->h);
+					assert(s_shape[shapeID][houseID] != NULL);
+					break;
+
+				case SHAPECOORD_HARKONNEN:
+					s_shape[shapeID][houseID] = s_shape[shapeID][HOUSE_HARKONNEN];
+					break;
+
+				default:
+					s_shape[shapeID][houseID] = NULL;
+					break;
+			}
+		}
+	}
+
+	free(table);
+
+	/* Side effect of VideoA5_InitShapeCHOAMButtons. */
+	Sprites_InitCHOAM("BTTN.ENG", "CHOAM.ENG");
+	return true;
+}
+
+static void
+VideoA5_SaveAtlasCache(uint64_t key)
+{
+	AtlasCacheTable *table = calloc(1, sizeof(*table));
+	if (table == NULL)
+		return;
+
+	memcpy(table->icon, s_icon, sizeof(s_icon));
+
+	for (enum ShapeID shapeID = 0; shapeID < SHAPEID_MAX; shapeID++) {
+		for (enum HouseType houseID = HOUSE_HARKONNEN; houseID < HOUSE_NEUTRAL; houseID++) {
+			ALLEGRO_BITMAP *bmp = s_shape[shapeID][houseID];
+			ShapeCoord *coord = &table->shape[shapeID][houseID];
+
+			if (bmp == NULL)
+				continue;
+
+			if (houseID != HOUSE_HARKONNEN && bmp == s_shape[shapeID][HOUSE_HARKONNEN]) {
+				coord->parent = SHAPECOORD_HARKONNEN;
+				continue;
+			}
+
+			if (al_get_parent_bitmap(bmp) == shape_texture) {
+				coord->parent = SHAPECOORD_SHAPE_TEXTURE;
+			} else if (al_get_parent_bitmap(bmp) == region_texture) {
+				coord->parent = SHAPECOORD_REGION_TEXTURE;
+			} else {
+				free(table);
+				return;
+			}
+
+			coord->x = al_get_sub_bitmap_x(bmp);
+			coord->y = al_get_sub_bitmap_y(bmp);
+			coord->w = al_get_bitmap_width(bmp);
+			coord->h = al_get_bitmap_height(bmp);
+		}
+	}
+
+	ALLEGRO_BITMAP * const bmp[] = { icon_texture, shape_texture, region_texture, interface_texture };
+
+	if (!AtlasCache_Save(key, bmp, lengthof(bmp), table, sizeof(*table)))
+		fprintf(stderr, "Failed to write the atlas cache.\n");
+
+	free(table);
+}
+
 void
 VideoA5_InitSprites(void)
 {
@@ -2992,24 +3494,40 @@ VideoA5_InitSprites(void)
 
 	VideoA5_ReadPalette("IBM.PAL");
 
-	memset(buf, 0, WINDOW_W * WINDOW_H);
-	VideoA5_InitIcons(buf);
+	const uint64_t key = VideoA5_AtlasCacheKey();
+	const bool cached = VideoA5_LoadAtlasCache(key);
+
+	if (!cached) {
+		memset(buf, 0, WINDOW_W * WINDOW_H);
+		VideoA5_InitIcons(buf);
+
+		memset(buf, 0, WINDOW_W * WINDOW_H);
+		VideoA5_InitShapes(buf);
+	}
 
-	memset(buf, 0, WINDOW_W * WINDOW_H);
-	VideoA5_InitShapes(buf);
 	VideoA5_InitCursor(buf);
 
-	memset(buf, 0, WINDOW_W * WINDOW_H);
-	VideoA5_InitCPS();
-	memset(buf, 0, WINDOW_W * WINDOW_H);
-	VideoA5_InitWSA(buf);
-	memset(buf, 0, WINDOW_W * WINDOW_H);
-	VideoA5_InitFonts(buf);
+	if (!cached) {
+		memset(buf, 0, WINDOW_W * WINDOW_H);
+		VideoA5_InitCPS();
+		memset(buf, 0, WINDOW_W * WINDOW_H);
+		VideoA5_InitWSA(buf);
+		memset(buf, 0, WINDOW_W * WINDOW_H);
+		VideoA5_InitFonts(buf);
+
+		VideoA5_SaveAtlasCache(key);
+	}
 
 #if OUTPUT_TEXTURES
 	al_save_bitmap("interface.png", interface_texture);
 #endif
 
+#ifdef WITH_SOFTWARE_VIDEO
+	VideoSoftA5_InitSprites();
+#endif
+
+	VideoA5_ConvertIconTextures();
+
 	const int bitmap_flags = al_get_new_bitmap_flags();
 	al_set_new_bitmap_flags(bitmap_flags & ~ALLEGRO_NO_PRESERVE_TEXTURE);
 	interface_texture = VideoA5_ConvertToVideoBitmap(interface_texture);
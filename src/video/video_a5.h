@@ -3,6 +3,9 @@
 
 #include "video.h"
 #include "../file.h"
+#include "../sprites.h"
+
+#define ICONID_MAX          512
 
 enum GraphicsDriver {
 	GRAPHICS_DRIVER_OPENGL,
@@ -22,6 +25,8 @@ extern bool VideoA5_Init(void);
 extern void VideoA5_Uninit(void);
 extern void VideoA5_ToggleFullscreen(void);
 extern void VideoA5_ToggleFPS(void);
+extern void VideoA5_ToggleNetStats(void);
+extern void VideoA5_ToggleProfiler(void);
 extern void VideoA5_CaptureScreenshot(void);
 extern void VideoA5_Tick(void);
 
@@ -41,8 +46,9 @@ extern void VideoA5_DrawShapeScale(enum ShapeID shapeID, int x, int y, int w, in
 extern void VideoA5_DrawShapeGrey(enum ShapeID shapeID, int x, int y, int flags);
 extern void VideoA5_DrawShapeGreyScale(enum ShapeID shapeID, int x, int y, int w, int h, int flags);
 extern void VideoA5_DrawShapeTint(enum ShapeID shapeID, int x, int y, unsigned char c, int flags);
-extern void VideoA5_DrawChar(unsigned char c, const uint8 *pal, int x, int y);
-extern void VideoA5_DrawCharAlpha(unsigned char c, const uint8 *pal, int x, int y, unsigned char alpha);
+extern void VideoA5_DrawTextBegin(const uint8 *pal, unsigned char alpha);
+extern void VideoA5_DrawTextChar(unsigned char c, int x, int y);
+extern void VideoA5_DrawTextEnd(void);
 extern bool VideoA5_DrawWSA(void *wsa, int frame, int sx, int sy, int dx, int dy, int w, int h);
 extern void VideoA5_DrawWSAStatic(int frame, int x, int y);
 
@@ -52,6 +58,11 @@ extern int VideoA5_GetDesktopHeight(void);
 extern int VideoA5_GetHeight(enum ShapeID shapeID);
 extern int VideoA5_GetWidth(enum ShapeID shapeID);
 
+extern int VideoA5_NumIconsInGroup(enum IconMapEntries group);
+extern bool VideoA5_IconHasHouseColours(uint16 iconID);
+extern bool VideoA5_GetIconAlpha(uint16 iconID, uint8 *alpha);
+extern bool VideoA5_ShapeHasHouseColours(enum ShapeID shapeID);
+
 struct DisplayMode* VideoA5_GetDisplayModes(void);
 int VideoA5_GetNumDisplayModes(void);
 int VideoA5_GetCurrentDisplayMode(void);
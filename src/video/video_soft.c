@@ -0,0 +1,589 @@
+/**
+ * @file src/video/video_soft.c
+ *
+ * 8-bit indexed framebuffer and its drawing kernels.
+ *
+ * Everything is drawn as colour indices, and only turned into RGB when
+ * a frame is converted through the palette, so the kernels move one
+ * byte per pixel.  The blit, house colour, tint and blur kernels do 16
+ * pixels at a time with SSE2 where the compiler targets it, and the
+ * table lookups skip runs of transparent pixels the same way.  The
+ * plain loops after them handle the rest of a row, and are what the
+ * vector code has to agree with.
+ *
+ * Nothing here depends on Allegro or the game, so it can be tested
+ * and measured on its own.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../os/math.h"
+
+#include "video_soft.h"
+
+#if defined(__SSE2__)
+#define VIDEOSOFT_SSE2
+#include <emmintrin.h>
+#endif
+
+typedef struct VideoSoftArea {
+	int dx, dy;     /*!< Top-left pixel in the framebuffer. */
+	int sx, sy;     /*!< Top-left pixel in the image, before flipping. */
+	int w, h;
+} VideoSoftArea;
+
+typedef struct VideoSoftRowArgs {
+	const uint8 *table;
+	uint8 c;
+	uint8 first;
+	uint8 span;
+	uint8 offset;
+} VideoSoftRowArgs;
+
+typedef void (*VideoSoftRowFunc)(uint8 *dst, const uint8 *src, int n, const VideoSoftRowArgs *args);
+
+/*--------------------------------------------------------------*/
+
+bool
+VideoSoft_InitFramebuffer(VideoSoftFramebuffer *fb, int width, int height)
+{
+	assert(width > 0 && height > 0);
+
+	fb->width = width;
+	fb->height = height;
+	fb->pitch = (width + 15) & ~15;
+	fb->data = malloc(fb->pitch * height);
+
+	if (fb->data == NULL) {
+		fb->width = fb->height = 0;
+		return false;
+	}
+
+	VideoSoft_SetClip(fb, 0, 0, width, height);
+	return true;
+}
+
+void
+VideoSoft_FreeFramebuffer(VideoSoftFramebuffer *fb)
+{
+	free(fb->data);
+	fb->data = NULL;
+	fb->width = fb->height = 0;
+}
+
+void
+VideoSoft_SetClip(VideoSoftFramebuffer *fb, int x, int y, int w, int h)
+{
+	fb->clipx1 = clamp(x, 0, fb->width);
+	fb->clipy1 = clamp(y, 0, fb->height);
+	fb->clipx2 = clamp(x + w, fb->clipx1, fb->width);
+	fb->clipy2 = clamp(y + h, fb->clipy1, fb->height);
+}
+
+void
+VideoSoft_Clear(VideoSoftFramebuffer *fb, uint8 c)
+{
+	memset(fb->data, c, fb->pitch * fb->height);
+}
+
+/*--------------------------------------------------------------*/
+
+bool
+VideoSoft_InitImage(VideoSoftImage *img, const uint8 *src, int src_pitch, int width, int height)
+{
+	assert(width > 0 && height > 0);
+
+	img->width = width;
+	img->height = height;
+	img->data = malloc(2 * width * height);
+
+	if (img->data == NULL) {
+		img->mirror = NULL;
+		return false;
+	}
+
+	img->mirror = img->data + width * height;
+
+	for (int y = 0; y < height; y++) {
+		const uint8 *row = src + src_pitch * y;
+
+		memcpy(img->data + width * y, row, width);
+
+		for (int x = 0; x < width; x++)
+			img->mirror[width * y + x] = row[width - 1 - x];
+	}
+
+	return true;
+}
+
+void
+VideoSoft_FreeImage(VideoSoftImage *img)
+{
+	free(img->data);
+	img->data = NULL;
+	img->mirror = NULL;
+}
+
+/*--------------------------------------------------------------*/
+
+/* Clips a width x height rectangle at (x, y) to the clipping rectangle. */
+static bool
+VideoSoft_ClipArea(const VideoSoftFramebuffer *fb, int x, int y, int width, int height, VideoSoftArea *a)
+{
+	const int x1 = max(x, fb->clipx1);
+	const int y1 = max(y, fb->clipy1);
+	const int x2 = min(x + width, fb->clipx2);
+	const int y2 = min(y + height, fb->clipy2);
+
+	if (x1 >= x2 || y1 >= y2)
+		return false;
+
+	a->dx = x1;
+	a->dy = y1;
+	a->sx = x1 - x;
+	a->sy = y1 - y;
+	a->w = x2 - x1;
+	a->h = y2 - y1;
+	return true;
+}
+
+#ifdef VIDEOSOFT_SSE2
+/* Keeps d where key is set, and takes s elsewhere. */
+static inline __m128i
+VideoSoft_Select(__m128i key, __m128i d, __m128i s)
+{
+	return _mm_or_si128(_mm_and_si128(key, d), _mm_andnot_si128(key, s));
+}
+
+/* One bit for every opaque pixel of the 16 at src. */
+static inline int
+VideoSoft_OpaqueMask(const uint8 *src)
+{
+	const __m128i s = _mm_loadu_si128((const __m128i *)src);
+
+	return ~_mm_movemask_epi8(_mm_cmpeq_epi8(s, _mm_setzero_si128())) & 0xFFFF;
+}
+#endif
+
+static void
+VideoSoft_RowBlit(uint8 *dst, const uint8 *src, int n, const VideoSoftRowArgs *args)
+{
+	int i = 0;
+
+	VARIABLE_NOT_USED(args);
+
+#ifdef VIDEOSOFT_SSE2
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 16 <= n; i += 16) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		_mm_storeu_si128((__m128i *)(dst + i), VideoSoft_Select(_mm_cmpeq_epi8(s, zero), d, s));
+	}
+#endif
+
+	for (; i < n; i++) {
+		if (src[i] != 0)
+			dst[i] = src[i];
+	}
+}
+
+/* Colours first .. first + span move by offset, like house colours. */
+static void
+VideoSoft_RowRange(uint8 *dst, const uint8 *src, int n, const VideoSoftRowArgs *args)
+{
+	int i = 0;
+
+#ifdef VIDEOSOFT_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i first = _mm_set1_epi8((char)args->first);
+	const __m128i span = _mm_set1_epi8((char)args->span);
+	const __m128i offset = _mm_set1_epi8((char)args->offset);
+
+	for (; i + 16 <= n; i += 16) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		/* (s - first) <= span as unsigned bytes, without an unsigned compare. */
+		const __m128i in = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(s, first), span), zero);
+		const __m128i c = _mm_add_epi8(s, _mm_and_si128(in, offset));
+
+		_mm_storeu_si128((__m128i *)(dst + i), VideoSoft_Select(_mm_cmpeq_epi8(s, zero), d, c));
+	}
+#endif
+
+	for (; i < n; i++) {
+		const uint8 s = src[i];
+
+		if (s == 0)
+			continue;
+
+		dst[i] = ((uint8)(s - args->first) <= args->span) ? (uint8)(s + args->offset) : s;
+	}
+}
+
+static void
+VideoSoft_RowTint(uint8 *dst, const uint8 *src, int n, const VideoSoftRowArgs *args)
+{
+	int i = 0;
+
+#ifdef VIDEOSOFT_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c = _mm_set1_epi8((char)args->c);
+
+	for (; i + 16 <= n; i += 16) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+
+		_mm_storeu_si128((__m128i *)(dst + i), VideoSoft_Select(_mm_cmpeq_epi8(s, zero), d, c));
+	}
+#endif
+
+	for (; i < n; i++) {
+		if (src[i] != 0)
+			dst[i] = args->c;
+	}
+}
+
+static void
+VideoSoft_RowRemap(uint8 *dst, const uint8 *src, int n, const VideoSoftRowArgs *args)
+{
+	int i = 0;
+
+#ifdef VIDEOSOFT_SSE2
+	for (; i + 16 <= n; i += 16) {
+		for (int m = VideoSoft_OpaqueMask(src + i); m != 0; m &= m - 1) {
+			const int k = i + __builtin_ctz(m);
+			dst[k] = args->table[src[k]];
+		}
+	}
+#endif
+
+	for (; i < n; i++) {
+		if (src[i] != 0)
+			dst[i] = args->table[src[i]];
+	}
+}
+
+/* The image is only a mask: what is under it goes through the table. */
+static void
+VideoSoft_RowShade(uint8 *dst, const uint8 *src, int n, const VideoSoftRowArgs *args)
+{
+	int i = 0;
+
+#ifdef VIDEOSOFT_SSE2
+	for (; i + 16 <= n; i += 16) {
+		for (int m = VideoSoft_OpaqueMask(src + i); m != 0; m &= m - 1) {
+			const int k = i + __builtin_ctz(m);
+			dst[k] = args->table[dst[k]];
+		}
+	}
+#endif
+
+	for (; i < n; i++) {
+		if (src[i] != 0)
+			dst[i] = args->table[dst[i]];
+	}
+}
+
+static void
+VideoSoft_DrawRows(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags,
+		VideoSoftRowFunc row, const VideoSoftRowArgs *args)
+{
+	VideoSoftArea a;
+
+	if (!VideoSoft_ClipArea(fb, x, y, img->width, img->height, &a))
+		return;
+
+	/* Flipped horizontally, the image is its mirror drawn as it is. */
+	const uint8 *pixels = (flags & VIDEOSOFT_HFLIP) ? img->mirror : img->data;
+	uint8 *dst = fb->data + fb->pitch * a.dy + a.dx;
+
+	for (int j = 0; j < a.h; j++, dst += fb->pitch) {
+		const int sy = (flags & VIDEOSOFT_VFLIP) ? (img->height - 1 - (a.sy + j)) : (a.sy + j);
+
+		row(dst, pixels + img->width * sy + a.sx, a.w, args);
+	}
+}
+
+/*--------------------------------------------------------------*/
+
+void
+VideoSoft_Blit(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags)
+{
+	VideoSoft_DrawRows(fb, img, x, y, flags, VideoSoft_RowBlit, NULL);
+}
+
+/**
+ * @brief   Draws an image with the colours first .. last moved by offset.
+ * @details Introduced.  House colours are a range of 7 colours, which
+ *          is cheaper to move than to look up.
+ */
+void
+VideoSoft_BlitRange(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags,
+		uint8 first, uint8 last, uint8 offset)
+{
+	assert(first <= last);
+
+	const VideoSoftRowArgs args = { .first = first, .span = last - first, .offset = offset };
+
+	VideoSoft_DrawRows(fb, img, x, y, flags, VideoSoft_RowRange, &args);
+}
+
+void
+VideoSoft_BlitRemap(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, const uint8 *remap)
+{
+	const VideoSoftRowArgs args = { .table = remap };
+
+	VideoSoft_DrawRows(fb, img, x, y, flags, VideoSoft_RowRemap, &args);
+}
+
+void
+VideoSoft_BlitTint(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, uint8 c)
+{
+	const VideoSoftRowArgs args = { .c = c };
+
+	VideoSoft_DrawRows(fb, img, x, y, flags, VideoSoft_RowTint, &args);
+}
+
+/**
+ * @brief   Puts the pixels under an image through a table, e.g. one
+ *          from VideoSoft_CreateShade for shadows.
+ * @details Introduced.
+ */
+void
+VideoSoft_BlitShade(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, const uint8 *shade)
+{
+	const VideoSoftRowArgs args = { .table = shade };
+
+	VideoSoft_DrawRows(fb, img, x, y, flags, VideoSoft_RowShade, &args);
+}
+
+/**
+ * @brief   Draws an image rotated clockwise about its centre, which is
+ *          put at (cx, cy).
+ * @details Introduced.  Nearest pixel.  The colours go through remap if
+ *          given; with shade, the image is a shadow instead.
+ */
+void
+VideoSoft_BlitRotate(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int cx, int cy, int orient256,
+		const uint8 *remap, const uint8 *shade)
+{
+	const double angle = 2.0 * 3.14159265358979323846 * orient256 / 256.0;
+	const int32 c = (int32)lround(65536.0 * cos(angle));
+	const int32 s = (int32)lround(65536.0 * sin(angle));
+	const int r = (int)ceil(sqrt(img->width * img->width + img->height * img->height) / 2.0) + 1;
+	const int32 w16 = img->width << 16;
+	const int32 h16 = img->height << 16;
+	VideoSoftArea a;
+
+	if (!VideoSoft_ClipArea(fb, cx - r, cy - r, 2 * r, 2 * r, &a))
+		return;
+
+	/* Centre of the first pixel, from the centre of rotation. */
+	const int64_t u = (int64_t)(a.dx - cx) * 65536 + 0x8000;
+
+	for (int j = 0; j < a.h; j++) {
+		const int64_t v = (int64_t)(a.dy + j - cy) * 65536 + 0x8000;
+		uint8 *dst = fb->data + fb->pitch * (a.dy + j) + a.dx;
+
+		/* Rotated back into the image, which turns c, -s per pixel. */
+		int32 px = (img->width << 15) + (int32)((c * u + s * v) >> 16);
+		int32 py = (img->height << 15) + (int32)((c * v - s * u) >> 16);
+
+		for (int i = 0; i < a.w; i++, px += c, py -= s) {
+			if (px < 0 || px >= w16 || py < 0 || py >= h16)
+				continue;
+
+			const uint8 p = img->data[img->width * (py >> 16) + (px >> 16)];
+
+			if (p == 0)
+				continue;
+
+			if (shade != NULL) {
+				dst[i] = shade[dst[i]];
+			} else {
+				dst[i] = (remap != NULL) ? remap[p] : p;
+			}
+		}
+	}
+}
+
+/**
+ * @brief   The sandworm and sonic wave effect.
+ * @details Introduced.  Under the opaque pixels of the brush, every
+ *          pixel takes the one blurx to its right, as GUI_DrawSprite_
+ *          did to the screen buffer.  Pixels beyond the clipping
+ *          rectangle repeat its last column.
+ */
+void
+VideoSoft_Blur(VideoSoftFramebuffer *fb, const VideoSoftImage *brush, int x, int y, int blurx)
+{
+	VideoSoftArea a;
+
+	assert(blurx >= 0);
+
+	if (!VideoSoft_ClipArea(fb, x, y, brush->width, brush->height, &a))
+		return;
+
+	const int avail = fb->clipx2 - a.dx;
+
+	for (int j = 0; j < a.h; j++) {
+		const uint8 *src = brush->data + brush->width * (a.sy + j) + a.sx;
+		uint8 *dst = fb->data + fb->pitch * (a.dy + j) + a.dx;
+		int i = 0;
+
+		/* Reads run ahead of writes, so 16 at a time reads the same. */
+#ifdef VIDEOSOFT_SSE2
+		const __m128i zero = _mm_setzero_si128();
+
+		for (; i + 16 <= a.w && i + 16 + blurx <= avail; i += 16) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+			const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+			const __m128i b = _mm_loadu_si128((const __m128i *)(dst + i + blurx));
+
+			_mm_storeu_si128((__m128i *)(dst + i), VideoSoft_Select(_mm_cmpeq_epi8(s, zero), d, b));
+		}
+#endif
+
+		for (; i < a.w; i++) {
+			if (src[i] != 0)
+				dst[i] = dst[min(i + blurx, avail - 1)];
+		}
+	}
+}
+
+/*--------------------------------------------------------------*/
+
+/* x2 and y2 are inclusive. */
+void
+VideoSoft_FillRect(VideoSoftFramebuffer *fb, int x1, int y1, int x2, int y2, uint8 c)
+{
+	x1 = max(x1, fb->clipx1);
+	y1 = max(y1, fb->clipy1);
+	x2 = min(x2 + 1, fb->clipx2);
+	y2 = min(y2 + 1, fb->clipy2);
+
+	if (x1 >= x2)
+		return;
+
+	for (int y = y1; y < y2; y++)
+		memset(fb->data + fb->pitch * y + x1, c, x2 - x1);
+}
+
+void
+VideoSoft_Line(VideoSoftFramebuffer *fb, int x1, int y1, int x2, int y2, uint8 c)
+{
+	const int dx = abs(x2 - x1);
+	const int dy = -abs(y2 - y1);
+	const int sx = (x1 < x2) ? 1 : -1;
+	const int sy = (y1 < y2) ? 1 : -1;
+	int err = dx + dy;
+
+	for (;;) {
+		if (fb->clipx1 <= x1 && x1 < fb->clipx2 && fb->clipy1 <= y1 && y1 < fb->clipy2)
+			fb->data[fb->pitch * y1 + x1] = c;
+
+		if (x1 == x2 && y1 == y2)
+			break;
+
+		const int e2 = 2 * err;
+		if (e2 >= dy) { err += dy; x1 += sx; }
+		if (e2 <= dx) { err += dx; y1 += sy; }
+	}
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * @brief   The closest colour in the palette, leaving out the colours
+ *          set in avoid (if not NULL), such as animated ones.
+ * @details Introduced.
+ */
+uint8
+VideoSoft_FindColour(const uint8 *paletteRGB, int r, int g, int b, const bool *avoid)
+{
+	int best = 0;
+	int best_dist = 0x7FFFFFFF;
+
+	for (int i = 0; i < 256; i++) {
+		if (avoid != NULL && avoid[i])
+			continue;
+
+		const int dr = paletteRGB[3*i + 0] - r;
+		const int dg = paletteRGB[3*i + 1] - g;
+		const int db = paletteRGB[3*i + 2] - b;
+		const int dist = dr * dr + dg * dg + db * db;
+
+		if (dist < best_dist) {
+			best = i;
+			best_dist = dist;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * @brief   Maps each colour to the closest one scale/256 as bright.
+ * @details Introduced.  Below 256 for shadows and fog, above for
+ *          highlights.
+ */
+void
+VideoSoft_CreateShade(uint8 *shade, const uint8 *paletteRGB, int scale, const bool *avoid)
+{
+	for (int i = 0; i < 256; i++) {
+		const int r = min(255, (paletteRGB[3*i + 0] * scale) >> 8);
+		const int g = min(255, (paletteRGB[3*i + 1] * scale) >> 8);
+		const int b = min(255, (paletteRGB[3*i + 2] * scale) >> 8);
+
+		shade[i] = VideoSoft_FindColour(paletteRGB, r, g, b, avoid);
+	}
+}
+
+/**
+ * @brief   Packs the palette for VideoSoft_Convert.
+ * @details Introduced.  Red in the low byte, alpha in the high byte,
+ *          i.e. ALLEGRO_PIXEL_FORMAT_ABGR_8888 on any byte order.
+ */
+void
+VideoSoft_CreateLookup(uint32 *lookup, const uint8 *paletteRGB)
+{
+	for (int i = 0; i < 256; i++) {
+		lookup[i] = (uint32)paletteRGB[3*i + 0]
+			| ((uint32)paletteRGB[3*i + 1] << 8)
+			| ((uint32)paletteRGB[3*i + 2] << 16)
+			| 0xFF000000;
+	}
+}
+
+/**
+ * @brief   Converts the whole framebuffer to 32-bit pixels.
+ * @details Introduced.  dst_pitch is in bytes, and may be negative.
+ *          SSE2 has no byte gather, so this is a plain lookup,
+ *          unrolled.
+ */
+void
+VideoSoft_Convert(const VideoSoftFramebuffer *fb, const uint32 *lookup, void *dst, int dst_pitch)
+{
+	for (int y = 0; y < fb->height; y++) {
+		const uint8 *src = fb->data + fb->pitch * y;
+		uint32 *row = (uint32 *)((uint8 *)dst + (ptrdiff_t)dst_pitch * y);
+		int x = 0;
+
+		for (; x + 4 <= fb->width; x += 4) {
+			row[x + 0] = lookup[src[x + 0]];
+			row[x + 1] = lookup[src[x + 1]];
+			row[x + 2] = lookup[src[x + 2]];
+			row[x + 3] = lookup[src[x + 3]];
+		}
+
+		for (; x < fb->width; x++)
+			row[x] = lookup[src[x]];
+	}
+}
@@ -0,0 +1,56 @@
+/** @file src/video/video_soft.h 8-bit indexed framebuffer and its drawing kernels. */
+
+#ifndef VIDEO_VIDEO_SOFT_H
+#define VIDEO_VIDEO_SOFT_H
+
+#include <stdbool.h>
+#include "types.h"
+
+enum VideoSoftFlag {
+	VIDEOSOFT_HFLIP = 0x01,
+	VIDEOSOFT_VFLIP = 0x02
+};
+
+/** An indexed image.  Colour 0 is transparent. */
+typedef struct VideoSoftImage {
+	int width;
+	int height;
+	uint8 *data;        /*!< width * height pixels, row by row. */
+	uint8 *mirror;      /*!< The same pixels, flipped horizontally. */
+} VideoSoftImage;
+
+/** An indexed framebuffer.  Drawing is clipped to the clipping rectangle. */
+typedef struct VideoSoftFramebuffer {
+	int width;
+	int height;
+	int pitch;
+	uint8 *data;
+	int clipx1, clipy1;
+	int clipx2, clipy2;     /*!< exclusive. */
+} VideoSoftFramebuffer;
+
+extern bool VideoSoft_InitFramebuffer(VideoSoftFramebuffer *fb, int width, int height);
+extern void VideoSoft_FreeFramebuffer(VideoSoftFramebuffer *fb);
+extern void VideoSoft_SetClip(VideoSoftFramebuffer *fb, int x, int y, int w, int h);
+extern void VideoSoft_Clear(VideoSoftFramebuffer *fb, uint8 c);
+
+extern bool VideoSoft_InitImage(VideoSoftImage *img, const uint8 *src, int src_pitch, int width, int height);
+extern void VideoSoft_FreeImage(VideoSoftImage *img);
+
+extern void VideoSoft_Blit(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags);
+extern void VideoSoft_BlitRange(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, uint8 first, uint8 last, uint8 offset);
+extern void VideoSoft_BlitRemap(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, const uint8 *remap);
+extern void VideoSoft_BlitTint(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, uint8 c);
+extern void VideoSoft_BlitShade(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int x, int y, int flags, const uint8 *shade);
+extern void VideoSoft_BlitRotate(VideoSoftFramebuffer *fb, const VideoSoftImage *img, int cx, int cy, int orient256, const uint8 *remap, const uint8 *shade);
+extern void VideoSoft_Blur(VideoSoftFramebuffer *fb, const VideoSoftImage *brush, int x, int y, int blurx);
+
+extern void VideoSoft_FillRect(VideoSoftFramebuffer *fb, int x1, int y1, int x2, int y2, uint8 c);
+extern void VideoSoft_Line(VideoSoftFramebuffer *fb, int x1, int y1, int x2, int y2, uint8 c);
+
+extern uint8 VideoSoft_FindColour(const uint8 *paletteRGB, int r, int g, int b, const bool *avoid);
+extern void VideoSoft_CreateShade(uint8 *shade, const uint8 *paletteRGB, int scale, const bool *avoid);
+extern void VideoSoft_CreateLookup(uint32 *lookup, const uint8 *paletteRGB);
+extern void VideoSoft_Convert(const VideoSoftFramebuffer *fb, const uint32 *lookup, void *dst, int dst_pitch);
+
+#endif
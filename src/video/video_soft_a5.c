@@ -0,0 +1,516 @@
+/**
+ * @file src/video/video_soft_a5.c
+ *
+ * The viewport, drawn through the 8-bit framebuffer.
+ *
+ * Between VideoSoftA5_BeginViewport and VideoSoftA5_EndViewport, the
+ * icons, shapes and primitives of the viewport go into a framebuffer
+ * of colour indices, the way the original game drew them.  House
+ * colours, shadows, fog and the blur effect are all table lookups on
+ * those indices, and the frame goes through the palette once, as one
+ * bitmap.  Windtraps and the selection box animate with the palette.
+ *
+ * Everything drawn outside that pair, e.g. the menus and the sidebar,
+ * is still drawn by video_a5.c.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <allegro5/allegro.h>
+
+#include "video_soft_a5.h"
+
+#include "video.h"
+#include "video_soft.h"
+#include "../enhancement.h"
+#include "../gfx.h"
+#include "../gui/gui.h"
+#include "../sprites.h"
+
+enum {
+	SHADE_LEVELS = 16
+};
+
+enum ShapeRemap {
+	SHAPE_REMAP_NONE,
+	SHAPE_REMAP_HOUSE,
+	SHAPE_REMAP_DEVIATOR_GAS
+};
+
+/* Exported from video_a5.c. */
+extern unsigned char paletteRGB[3 * 256];
+
+static VideoSoftFramebuffer s_fb;
+static ALLEGRO_BITMAP *s_bitmap;
+static bool s_drawing;
+
+static VideoSoftImage s_icon[ICONID_MAX];
+static bool s_icon_house_colours[ICONID_MAX];
+static VideoSoftImage s_shape[SHAPE_MAX];
+static enum ShapeRemap s_shape_remap[SHAPE_MAX];
+static uint8 s_deviator_gas_remap[HOUSE_NEUTRAL][256];
+
+/* Animated colours, which the shading tables must not produce. */
+static bool s_animated[256];
+
+/* The palette the shading tables were made from. */
+static uint8 s_palette[3 * 256];
+static uint8 s_shade[SHADE_LEVELS][256];
+static bool s_shade_valid[SHADE_LEVELS];
+static uint8 s_brighten[256];
+static bool s_brighten_valid;
+
+static uint32 s_lookup[256];
+
+/*--------------------------------------------------------------*/
+
+static void
+VideoSoftA5_ExportIcons(uint8 *buf, int stride)
+{
+	uint8 alpha[TILE_SIZE * TILE_SIZE];
+
+	for (enum IconMapEntries group = 0; group < ICM_ICONGROUP_EOF; group++) {
+		const int num = VideoA5_NumIconsInGroup(group);
+
+		for (int idx = 0; idx < num; idx++) {
+			const uint16 iconID = g_iconMap[g_iconMap[group] + idx];
+			assert(iconID < ICONID_MAX);
+
+			if (s_icon[iconID].data != NULL)
+				continue;
+
+			for (int y = 0; y < TILE_SIZE; y++)
+				memset(buf + stride * y, 0, TILE_SIZE);
+
+			GFX_DrawSprite_(iconID, 0, 0, HOUSE_HARKONNEN);
+
+			/* Transparent rubble is only in the icon texture's alpha. */
+			if (VideoA5_GetIconAlpha(iconID, alpha)) {
+				for (int y = 0; y < TILE_SIZE; y++) {
+					for (int x = 0; x < TILE_SIZE; x++) {
+						if (alpha[TILE_SIZE * y + x] <= 0x80)
+							buf[stride * y + x] = 0;
+					}
+				}
+			}
+
+			VideoSoft_InitImage(&s_icon[iconID], buf, stride, TILE_SIZE, TILE_SIZE);
+			s_icon_house_colours[iconID] = VideoA5_IconHasHouseColours(iconID);
+		}
+	}
+}
+
+static void
+VideoSoftA5_ExportShapes(uint8 *buf, int stride, int height)
+{
+	for (enum ShapeID shapeID = 0; shapeID < SHAPE_MAX; shapeID++) {
+		if (g_sprites[shapeID] == NULL)
+			continue;
+
+		const int w = Shape_Width(shapeID);
+		const int h = Shape_Height(shapeID);
+
+		if (!(0 < w && w <= stride && 0 < h && h <= height))
+			continue;
+
+		for (int y = 0; y < h; y++)
+			memset(buf + stride * y, 0, w);
+
+		GUI_DrawSprite_(SCREEN_0, g_sprites[shapeID], 0, 0, WINDOWID_RENDER_TEXTURE, 0);
+		VideoSoft_InitImage(&s_shape[shapeID], buf, stride, w, h);
+
+		if (SHAPE_DEVIATOR_GAS_CLOUD <= shapeID && shapeID <= SHAPE_DEVIATOR_GAS_CLOUD_FINAL) {
+			s_shape_remap[shapeID] = SHAPE_REMAP_DEVIATOR_GAS;
+		} else if (VideoA5_ShapeHasHouseColours(shapeID)) {
+			s_shape_remap[shapeID] = SHAPE_REMAP_HOUSE;
+		} else {
+			s_shape_remap[shapeID] = SHAPE_REMAP_NONE;
+		}
+	}
+}
+
+/**
+ * @brief   Makes indexed copies of the icons and shapes.
+ * @details Called by VideoA5_InitSprites, with SCREEN_0 active and the
+ *          render texture widget selected, before the icon texture
+ *          becomes a video bitmap.
+ */
+void
+VideoSoftA5_InitSprites(void)
+{
+	const int WINDOW_W = g_widgetProperties[WINDOWID_RENDER_TEXTURE].width;
+	const int WINDOW_H = g_widgetProperties[WINDOWID_RENDER_TEXTURE].height;
+	uint8 *buf = GFX_Screen_GetActive();
+	uint8 remap[256];
+
+	memcpy(remap, g_remap, sizeof(remap));
+
+	VideoSoftA5_ExportIcons(buf, WINDOW_W);
+	VideoSoftA5_ExportShapes(buf, WINDOW_W, WINDOW_H);
+
+	for (enum HouseType houseID = HOUSE_HARKONNEN; houseID < HOUSE_NEUTRAL; houseID++) {
+		GUI_Palette_CreateRemapDeviatorGas(houseID);
+		memcpy(s_deviator_gas_remap[houseID], g_remap, 256);
+	}
+
+	memcpy(g_remap, remap, sizeof(remap));
+
+	s_animated[WINDTRAP_COLOUR] = true;
+	s_animated[239] = true;
+	s_animated[255] = true;
+}
+
+void
+VideoSoftA5_Uninit(void)
+{
+	for (int i = 0; i < ICONID_MAX; i++)
+		VideoSoft_FreeImage(&s_icon[i]);
+
+	for (int i = 0; i < SHAPE_MAX; i++)
+		VideoSoft_FreeImage(&s_shape[i]);
+
+	VideoSoft_FreeFramebuffer(&s_fb);
+	al_destroy_bitmap(s_bitmap);
+	s_bitmap = NULL;
+}
+
+/*--------------------------------------------------------------*/
+
+static bool
+VideoSoftA5_ResizeFramebuffer(int w, int h)
+{
+	if (s_fb.width == w && s_fb.height == h && s_bitmap != NULL)
+		return true;
+
+	VideoSoft_FreeFramebuffer(&s_fb);
+	al_destroy_bitmap(s_bitmap);
+	s_bitmap = NULL;
+
+	if (w <= 0 || h <= 0 || !VideoSoft_InitFramebuffer(&s_fb, w, h))
+		return false;
+
+	/* Rewritten every frame, so there is nothing to preserve. */
+	const int bitmap_flags = al_get_new_bitmap_flags();
+	const int bitmap_format = al_get_new_bitmap_format();
+
+	al_set_new_bitmap_flags((bitmap_flags & ~ALLEGRO_MEMORY_BITMAP) | ALLEGRO_VIDEO_BITMAP | ALLEGRO_NO_PRESERVE_TEXTURE);
+	al_set_new_bitmap_format(ALLEGRO_PIXEL_FORMAT_ABGR_8888);
+	s_bitmap = al_create_bitmap(w, h);
+	al_set_new_bitmap_format(bitmap_format);
+	al_set_new_bitmap_flags(bitmap_flags);
+
+	if (s_bitmap == NULL) {
+		VideoSoft_FreeFramebuffer(&s_fb);
+		return false;
+	}
+
+	return true;
+}
+
+/* Drops the shading tables if the palette changed, animation aside. */
+static void
+VideoSoftA5_CheckPalette(void)
+{
+	for (int i = 0; i < 256; i++) {
+		if (s_animated[i] || memcmp(&s_palette[3*i], &paletteRGB[3*i], 3) == 0)
+			continue;
+
+		memset(s_shade_valid, 0, sizeof(s_shade_valid));
+		s_brighten_valid = false;
+		break;
+	}
+
+	memcpy(s_palette, paletteRGB, sizeof(s_palette));
+}
+
+void
+VideoSoftA5_BeginViewport(void)
+{
+	assert(!s_drawing);
+
+	if (!VideoSoftA5_ResizeFramebuffer(g_screenDiv[SCREENDIV_VIEWPORT].width, g_screenDiv[SCREENDIV_VIEWPORT].height))
+		return;
+
+	VideoSoftA5_CheckPalette();
+	VideoSoft_Clear(&s_fb, 0);
+	s_drawing = true;
+}
+
+/**
+ * @brief   Converts the frame through the current palette, and draws it
+ *          to the viewport.
+ */
+void
+VideoSoftA5_EndViewport(void)
+{
+	if (!s_drawing)
+		return;
+
+	s_drawing = false;
+
+	VideoSoft_CreateLookup(s_lookup, paletteRGB);
+
+	ALLEGRO_LOCKED_REGION *reg = al_lock_bitmap(s_bitmap, ALLEGRO_PIXEL_FORMAT_ABGR_8888, ALLEGRO_LOCK_WRITEONLY);
+	if (reg == NULL)
+		return;
+
+	VideoSoft_Convert(&s_fb, s_lookup, reg->data, reg->pitch);
+	al_unlock_bitmap(s_bitmap);
+
+	al_draw_bitmap(s_bitmap, 0, 0, 0);
+}
+
+bool
+VideoSoftA5_IsDrawing(void)
+{
+	return s_drawing;
+}
+
+/*--------------------------------------------------------------*/
+
+/* Darkens by alpha/256, in steps of 16, like a black tint. */
+static const uint8 *
+VideoSoftA5_GetShade(int alpha)
+{
+	const int level = (alpha >> 4) & (SHADE_LEVELS - 1);
+
+	if (!s_shade_valid[level]) {
+		VideoSoft_CreateShade(s_shade[level], s_palette, 256 - 16 * level, s_animated);
+		s_shade_valid[level] = true;
+	}
+
+	return s_shade[level];
+}
+
+/* Doubles the colour, like drawing the shape again additively. */
+static const uint8 *
+VideoSoftA5_GetBrighten(void)
+{
+	if (!s_brighten_valid) {
+		VideoSoft_CreateShade(s_brighten, s_palette, 512, s_animated);
+		s_brighten_valid = true;
+	}
+
+	return s_brighten;
+}
+
+static const VideoSoftImage *
+VideoSoftA5_GetShape(enum ShapeID shapeID)
+{
+	if (shapeID >= SHAPE_MAX || s_shape[shapeID].data == NULL)
+		return NULL;
+
+	return &s_shape[shapeID];
+}
+
+/* The colours of a shape for a house, as one table. */
+static void
+VideoSoftA5_CreateRemap(uint8 *remap, enum ShapeID shapeID, enum HouseType houseID)
+{
+	switch (s_shape_remap[shapeID]) {
+		case SHAPE_REMAP_DEVIATOR_GAS:
+			memcpy(remap, s_deviator_gas_remap[houseID], 256);
+			break;
+
+		case SHAPE_REMAP_HOUSE: {
+			const int offset = houseID << 4;
+
+			for (int i = 0; i < 256; i++)
+				remap[i] = (0x90 <= i && i <= 0x96) ? (i + offset) : i;
+			break;
+		}
+
+		default:
+			for (int i = 0; i < 256; i++)
+				remap[i] = i;
+			break;
+	}
+}
+
+void
+VideoSoftA5_DrawIcon(uint16 iconID, enum HouseType houseID, int x, int y)
+{
+	if (!s_drawing) {
+		VideoA5_DrawIcon(iconID, houseID, x, y);
+		return;
+	}
+
+	assert(iconID < ICONID_MAX);
+	assert(houseID < HOUSE_NEUTRAL);
+
+	const VideoSoftImage *img = &s_icon[iconID];
+	if (img->data == NULL)
+		return;
+
+	if (houseID != HOUSE_HARKONNEN && s_icon_house_colours[iconID]) {
+		/* As GFX_DrawSprite_ remaps them. */
+		const uint8 last = enhancement_fix_ix_colour_remapping ? 0x96 : 0xA0;
+
+		VideoSoft_BlitRange(&s_fb, img, x, y, 0, 0x90, last, houseID << 4);
+	} else {
+		VideoSoft_Blit(&s_fb, img, x, y, 0);
+	}
+}
+
+void
+VideoSoftA5_DrawIconAlpha(uint16 iconID, int x, int y, unsigned char alpha)
+{
+	if (!s_drawing) {
+		VideoA5_DrawIconAlpha(iconID, x, y, alpha);
+		return;
+	}
+
+	assert(iconID < ICONID_MAX);
+
+	const VideoSoftImage *img = &s_icon[iconID];
+	if (img->data == NULL)
+		return;
+
+	VideoSoft_BlitShade(&s_fb, img, x, y, 0, VideoSoftA5_GetShade(alpha));
+}
+
+void
+VideoSoftA5_DrawShape(enum ShapeID shapeID, enum HouseType houseID, int x, int y, int flags)
+{
+	if (!s_drawing) {
+		VideoA5_DrawShape(shapeID, houseID, x, y, flags);
+		return;
+	}
+
+	assert(houseID < HOUSE_NEUTRAL);
+
+	const VideoSoftImage *img = VideoSoftA5_GetShape(shapeID);
+	if (img == NULL)
+		return;
+
+	const int flip = flags & (VIDEOSOFT_HFLIP | VIDEOSOFT_VFLIP);
+
+	if ((flags & 0x300) == 0x100) {
+		/* Highlight. */
+		const uint8 *brighten = VideoSoftA5_GetBrighten();
+		uint8 remap[256];
+
+		VideoSoftA5_CreateRemap(remap, shapeID, houseID);
+		for (int i = 0; i < 256; i++)
+			remap[i] = brighten[remap[i]];
+
+		VideoSoft_BlitRemap(&s_fb, img, x, y, flip, remap);
+	} else if ((flags & 0x300) == 0x200) {
+		/* Blur tile (sandworm, sonic wave). */
+		const int s_variable_60[8] = {1, 3, 2, 5, 4, 3, 2, 1};
+		const int effect = (flags >> 4) & 0x7;
+
+		VideoSoft_Blur(&s_fb, img, x, y, s_variable_60[effect]);
+	} else if ((flags & 0x300) == 0x300) {
+		/* Shadow. */
+		VideoSoft_BlitShade(&s_fb, img, x, y, flip, VideoSoftA5_GetShade(flags & 0xF0));
+	} else if (s_shape_remap[shapeID] == SHAPE_REMAP_DEVIATOR_GAS) {
+		VideoSoft_BlitRemap(&s_fb, img, x, y, flip, s_deviator_gas_remap[houseID]);
+	} else if (s_shape_remap[shapeID] == SHAPE_REMAP_HOUSE && houseID != HOUSE_HARKONNEN) {
+		VideoSoft_BlitRange(&s_fb, img, x, y, flip, 0x90, 0x96, houseID << 4);
+	} else {
+		VideoSoft_Blit(&s_fb, img, x, y, flip);
+	}
+}
+
+void
+VideoSoftA5_DrawShapeRotate(enum ShapeID shapeID, enum HouseType houseID, int x, int y, int orient256, int flags)
+{
+	if (!s_drawing) {
+		VideoA5_DrawShapeRotate(shapeID, houseID, x, y, orient256, flags);
+		return;
+	}
+
+	assert(houseID < HOUSE_NEUTRAL);
+	assert((flags & 0x300) != 0x100);
+	assert((flags & 0x300) != 0x200);
+
+	const VideoSoftImage *img = VideoSoftA5_GetShape(shapeID);
+	if (img == NULL)
+		return;
+
+	if ((flags & 0x300) == 0x300) {
+		VideoSoft_BlitRotate(&s_fb, img, x, y, orient256, NULL, VideoSoftA5_GetShade(flags & 0xF0));
+	} else if (s_shape_remap[shapeID] != SHAPE_REMAP_NONE) {
+		uint8 remap[256];
+
+		VideoSoftA5_CreateRemap(remap, shapeID, houseID);
+		VideoSoft_BlitRotate(&s_fb, img, x, y, orient256, remap, NULL);
+	} else {
+		VideoSoft_BlitRotate(&s_fb, img, x, y, orient256, NULL, NULL);
+	}
+}
+
+void
+VideoSoftA5_DrawShapeTint(enum ShapeID shapeID, int x, int y, unsigned char c, int flags)
+{
+	if (!s_drawing) {
+		VideoA5_DrawShapeTint(shapeID, x, y, c, flags);
+		return;
+	}
+
+	const VideoSoftImage *img = VideoSoftA5_GetShape(shapeID);
+	if (img == NULL)
+		return;
+
+	VideoSoft_BlitTint(&s_fb, img, x, y, flags & (VIDEOSOFT_HFLIP | VIDEOSOFT_VFLIP), c);
+}
+
+/*--------------------------------------------------------------*/
+
+/* The primitives return false when not drawing the viewport, so that
+ * prim_a5.c draws them as usual.  Line thickness is one pixel.
+ */
+
+bool
+VideoSoftA5_DrawLine(float x1, float y1, float x2, float y2, uint8 c)
+{
+	if (!s_drawing)
+		return false;
+
+	VideoSoft_Line(&s_fb, floorf(x1), floorf(y1), floorf(x2), floorf(y2), c);
+	return true;
+}
+
+/* Outline through the pixels the corners are in. */
+bool
+VideoSoftA5_DrawRect(float x1, float y1, float x2, float y2, uint8 c)
+{
+	if (!s_drawing)
+		return false;
+
+	const int l = floorf(x1), t = floorf(y1);
+	const int r = floorf(x2), b = floorf(y2);
+
+	VideoSoft_FillRect(&s_fb, l, t, r, t, c);
+	VideoSoft_FillRect(&s_fb, l, b, r, b, c);
+	VideoSoft_FillRect(&s_fb, l, t, l, b, c);
+	VideoSoft_FillRect(&s_fb, r, t, r, b, c);
+	return true;
+}
+
+/* Fills the pixels whose centres are inside. */
+bool
+VideoSoftA5_DrawFilledRect(float x1, float y1, float x2, float y2, uint8 c)
+{
+	if (!s_drawing)
+		return false;
+
+	VideoSoft_FillRect(&s_fb, ceilf(x1 - 0.5f), ceilf(y1 - 0.5f), ceilf(x2 - 0.5f) - 1, ceilf(y2 - 0.5f) - 1, c);
+	return true;
+}
+
+/* Closest colour, or nothing if it is mostly see-through. */
+bool
+VideoSoftA5_DrawFilledRectRGBA(float x1, float y1, float x2, float y2,
+		unsigned char r, unsigned char g, unsigned char b, unsigned char alpha)
+{
+	if (!s_drawing)
+		return false;
+
+	if (alpha >= 0x80)
+		VideoSoftA5_DrawFilledRect(x1, y1, x2, y2, VideoSoft_FindColour(paletteRGB, r, g, b, s_animated));
+
+	return true;
+}
@@ -0,0 +1,28 @@
+/** @file src/video/video_soft_a5.h Viewport drawn through the 8-bit framebuffer. */
+
+#ifndef VIDEO_VIDEO_SOFT_A5_H
+#define VIDEO_VIDEO_SOFT_A5_H
+
+#include <stdbool.h>
+#include "types.h"
+#include "../shape.h"
+
+extern void VideoSoftA5_InitSprites(void);
+extern void VideoSoftA5_Uninit(void);
+
+extern void VideoSoftA5_BeginViewport(void);
+extern void VideoSoftA5_EndViewport(void);
+extern bool VideoSoftA5_IsDrawing(void);
+
+extern void VideoSoftA5_DrawIcon(uint16 iconID, enum HouseType houseID, int x, int y);
+extern void VideoSoftA5_DrawIconAlpha(uint16 iconID, int x, int y, unsigned char alpha);
+extern void VideoSoftA5_DrawShape(enum ShapeID shapeID, enum HouseType houseID, int x, int y, int flags);
+extern void VideoSoftA5_DrawShapeRotate(enum ShapeID shapeID, enum HouseType houseID, int x, int y, int orient256, int flags);
+extern void VideoSoftA5_DrawShapeTint(enum ShapeID shapeID, int x, int y, unsigned char c, int flags);
+
+extern bool VideoSoftA5_DrawLine(float x1, float y1, float x2, float y2, uint8 c);
+extern bool VideoSoftA5_DrawRect(float x1, float y1, float x2, float y2, uint8 c);
+extern bool VideoSoftA5_DrawFilledRect(float x1, float y1, float x2, float y2, uint8 c);
+extern bool VideoSoftA5_DrawFilledRectRGBA(float x1, float y1, float x2, float y2, unsigned char r, unsigned char g, unsigned char b, unsigned char alpha);
+
+#endif
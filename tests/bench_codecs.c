@@ -0,0 +1,365 @@
+/* bench_codecs.c
+ *
+ * Throughput of the data decoders, on synthetic corpora so that no game
+ * data is needed.
+ *
+ * The corpora are generated from a fixed seed.  Each decoder runs for
+ * a while over its corpus, and the decoded bytes per second are
+ * reported along with a hash of the decoded output.  A decoder that is
+ * changed must keep the hash of the build it is compared against.
+ *
+ * Usage: bench_codecs [seconds per decoder]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+
+#include "common.h"
+#include "../src/codec/digram.h"
+#include "../src/codec/format40.h"
+#include "../src/codec/format80.h"
+#include "../src/codec/image.h"
+#include "../src/codec/voc.h"
+#include "../src/gfx.h"
+
+enum {
+	BENCH_IMAGE_SIZE = SCREEN_WIDTH * SCREEN_HEIGHT,
+	BENCH_DELTA_WIDTH = 200,
+	BENCH_DELTA_HEIGHT = 150,
+	BENCH_NUM_STRINGS = 512,
+	BENCH_VOC_SIZE = 16384
+};
+
+static double s_seconds;
+
+static uint32
+Bench_Hash(const uint8 *data, size_t len, uint32 hash)
+{
+	/* FNV-1a. */
+	for (size_t i = 0; i < len; i++)
+		hash = (hash ^ data[i]) * 16777619;
+
+	return hash;
+}
+
+/* Bytes and seconds per call. */
+static void
+Bench_Report(const char *name, double bytes, double seconds, uint32 hash)
+{
+	printf("%-28s %10.1f MB/s   %08X\n", name, bytes / seconds / 1e6, hash);
+}
+
+/*--------------------------------------------------------------*/
+
+/**
+ * Writes a format80 stream decoding to len bytes, mixing literals,
+ *  fills and relative and absolute back-references, as in a CPS image.
+ * @return The length of the stream.
+ */
+static size_t
+Bench_MakeFormat80(uint8 *out, int len)
+{
+	uint8 *p = out;
+	int pos = 0;
+
+	while (pos < len) {
+		const int r = Random_Xorshift_32() % 10;
+		const int left = len - pos;
+		int n;
+
+		if (pos < 16 || r < 3 || left < 3) {
+			/* Short copy: 1 to 63 literals. */
+			n = 1 + Random_Xorshift_32() % 63;
+			if (n > left) n = left;
+
+			*p++ = 0x80 | n;
+			for (int i = 0; i < n; i++) *p++ = (Random_Xorshift_32() % 4 == 0) ? Random_Xorshift_32() : (uint32)(pos / 8) % 7;
+		} else if (r < 5) {
+			/* Short move, relative: 3 to 10 bytes, up to 4095 back. */
+			int offset = 1 + Random_Xorshift_32() % ((pos < 4095) ? pos : 4095);
+
+			n = 3 + Random_Xorshift_32() % 8;
+			if (n > left) n = left;
+			if (Random_Xorshift_32() % 3 == 0) offset = 1 + Random_Xorshift_32() % 3;
+
+			*p++ = ((n - 3) << 4) | (offset >> 8);
+			*p++ = offset & 0xFF;
+		} else if (r < 6) {
+			/* Long set. */
+			n = 1 + Random_Xorshift_32() % 300;
+			if (n > left) n = left;
+
+			*p++ = 0xFE;
+			*p++ = n & 0xFF;
+			*p++ = n >> 8;
+			*p++ = Random_Xorshift_32();
+		} else if (r < 8) {
+			/* Short move, absolute: 3 to 64 bytes. */
+			const int offset = Random_Xorshift_32() % pos;
+
+			n = 3 + Random_Xorshift_32() % 62;
+			if (n > left) n = left;
+
+			*p++ = 0xC0 | (n - 3);
+			*p++ = offset & 0xFF;
+			*p++ = offset >> 8;
+		} else {
+			/* Long move, absolute. */
+			const int offset = Random_Xorshift_32() % pos;
+
+			n = 1 + Random_Xorshift_32() % 400;
+			if (n > left) n = left;
+
+			*p++ = 0xFF;
+			*p++ = n & 0xFF;
+			*p++ = n >> 8;
+			*p++ = offset & 0xFF;
+			*p++ = offset >> 8;
+		}
+
+		pos += n;
+	}
+
+	*p++ = 0x80;
+	return p - out;
+}
+
+/**
+ * Writes a format40 stream changing len bytes, as a WSA frame delta:
+ *  literals, fills and skips, short and long.
+ * @return The length of the stream.
+ */
+static size_t
+Bench_MakeFormat40(uint8 *out, int len)
+{
+	uint8 *p = out;
+	int pos = 0;
+
+	while (pos < len) {
+		const int r = Random_Xorshift_32() % 8;
+		const int left = len - pos;
+		int n;
+
+		if (r < 2) {
+			n = 1 + Random_Xorshift_32() % 127;
+			if (n > left) n = left;
+
+			*p++ = n;
+			for (int i = 0; i < n; i++) *p++ = Random_Xorshift_32();
+		} else if (r < 3) {
+			n = 1 + Random_Xorshift_32() % 255;
+			if (n > left) n = left;
+
+			*p++ = 0;
+			*p++ = n;
+			*p++ = Random_Xorshift_32();
+		} else if (r < 5) {
+			n = 1 + Random_Xorshift_32() % 127;
+			if (n > left) n = left;
+
+			*p++ = 0x80 | n;
+		} else {
+			/* Long skip, literal or fill. */
+			const int kind = Random_Xorshift_32() % 3;
+
+			n = 1 + Random_Xorshift_32() % 1000;
+			if (n > left) n = left;
+
+			*p++ = 0x80;
+			*p++ = n & 0xFF;
+			*p++ = (n >> 8) | ((kind == 0) ? 0x00 : (kind == 1) ? 0x80 : 0xC0);
+
+			if (kind == 1) {
+				for (int i = 0; i < n; i++) *p++ = Random_Xorshift_32();
+			} else if (kind == 2) {
+				*p++ = Random_Xorshift_32();
+			}
+		}
+
+		pos += n;
+	}
+
+	*p++ = 0x80;
+	*p++ = 0x00;
+	*p++ = 0x00;
+	return p - out;
+}
+
+/*--------------------------------------------------------------*/
+
+static uint8 s_src[10 + 3 * BENCH_IMAGE_SIZE];
+static uint8 s_dst[0x10000];
+static uint8 s_screen[BENCH_IMAGE_SIZE];
+static char s_strings[BENCH_NUM_STRINGS][128];
+static char s_decoded[BENCH_NUM_STRINGS][256];
+static VocSample s_voc;
+static long s_calls;
+
+static void
+Bench_Format80_Once(void)
+{
+	Format80_Decode(s_dst, s_src, BENCH_IMAGE_SIZE);
+}
+
+static void
+Bench_Format80(void)
+{
+	Bench_MakeFormat80(s_src, BENCH_IMAGE_SIZE);
+
+	Bench_Report("Format80_Decode", BENCH_IMAGE_SIZE, Bench_Run(Bench_Format80_Once, s_seconds),
+			Bench_Hash(s_dst, BENCH_IMAGE_SIZE, 2166136261u));
+}
+
+static void
+Bench_Format40_Once(void)
+{
+	Format40_Decode(s_dst, s_src);
+	s_calls++;
+}
+
+static void
+Bench_Format40(void)
+{
+	Bench_MakeFormat40(s_src, BENCH_IMAGE_SIZE);
+	memset(s_dst, 0, sizeof(s_dst));
+
+	/* Each pass xors the frame back and forth. */
+	s_calls = 0;
+	const double seconds = Bench_Run(Bench_Format40_Once, s_seconds);
+
+	if ((s_calls & 1) == 0)
+		Format40_Decode(s_dst, s_src);
+
+	Bench_Report("Format40_Decode", BENCH_IMAGE_SIZE, seconds,
+			Bench_Hash(s_dst, BENCH_IMAGE_SIZE, 2166136261u));
+}
+
+static void
+Bench_Format40_XorToScreen_Once(void)
+{
+	Format40_Decode_XorToScreen(s_screen + 20 * SCREEN_WIDTH + 60, s_src, BENCH_DELTA_WIDTH);
+	s_calls++;
+}
+
+static void
+Bench_Format40_XorToScreen(void)
+{
+	Bench_MakeFormat40(s_src, BENCH_DELTA_WIDTH * BENCH_DELTA_HEIGHT);
+	memset(s_screen, 0, sizeof(s_screen));
+
+	s_calls = 0;
+	const double seconds = Bench_Run(Bench_Format40_XorToScreen_Once, s_seconds);
+
+	if ((s_calls & 1) == 0)
+		Bench_Format40_XorToScreen_Once();
+
+	Bench_Report("Format40_Decode_XorToScreen", BENCH_DELTA_WIDTH * BENCH_DELTA_HEIGHT, seconds,
+			Bench_Hash(s_screen, sizeof(s_screen), 2166136261u));
+}
+
+static void
+Bench_Image_Once(void)
+{
+	Image_Decode(s_src, s_dst);
+}
+
+static void
+Bench_Image(void)
+{
+	/* A CPS file: compression 4, size, no palette. */
+	memset(s_src, 0, 10);
+	s_src[0] = 0x04;
+	s_src[2] = BENCH_IMAGE_SIZE & 0xFF;
+	s_src[3] = (BENCH_IMAGE_SIZE >> 8) & 0xFF;
+	Bench_MakeFormat80(s_src + 8, BENCH_IMAGE_SIZE);
+
+	Bench_Report("Image_Decode", BENCH_IMAGE_SIZE, Bench_Run(Bench_Image_Once, s_seconds),
+			Bench_Hash(s_dst, BENCH_IMAGE_SIZE, 2166136261u));
+}
+
+static void
+Bench_Digram_Once(void)
+{
+	for (int i = 0; i < BENCH_NUM_STRINGS; i++)
+		Digram_Decode(s_strings[i], s_decoded[i]);
+}
+
+static void
+Bench_Digram(void)
+{
+	uint32 hash = 2166136261u;
+	double bytes = 0.0;
+
+	/* Mentat and briefing text: mostly digrams, with some plain
+	 * characters.
+	 */
+	for (int i = 0; i < BENCH_NUM_STRINGS; i++) {
+		const int len = 20 + Random_Xorshift_32() % 100;
+
+		for (int j = 0; j < len; j++)
+			s_strings[i][j] = (Random_Xorshift_32() % 4 != 0) ? (char)(0x80 | Random_Xorshift_32()) : (char)(0x20 + Random_Xorshift_32() % 0x5F);
+
+		s_strings[i][len] = '\0';
+	}
+
+	const double seconds = Bench_Run(Bench_Digram_Once, s_seconds);
+
+	for (int i = 0; i < BENCH_NUM_STRINGS; i++) {
+		bytes += strlen(s_decoded[i]);
+		hash = Bench_Hash((const uint8 *)s_decoded[i], strlen(s_decoded[i]), hash);
+	}
+
+	Bench_Report("Digram_Decode", bytes, seconds, hash);
+}
+
+/* As AudioA5_StoreSample loads a voice: parse the header, then copy out
+ * the samples.
+ */
+static void
+Bench_Voc_Once(void)
+{
+	if (Voc_ReadHeader(s_src, VOC_HEADER_SIZE + BENCH_VOC_SIZE, &s_voc))
+		memcpy(s_dst, s_src + s_voc.offset, s_voc.length);
+}
+
+static void
+Bench_Voc(void)
+{
+	const uint32 block_size = BENCH_VOC_SIZE + 2;
+
+	memcpy(s_src, "Creative Voice File\x1A\x1A\x00\x0A\x01\x29\x11", 0x1A);
+	s_src[0x1A] = 0x01;
+	s_src[0x1B] = block_size & 0xFF;
+	s_src[0x1C] = (block_size >> 8) & 0xFF;
+	s_src[0x1D] = (block_size >> 16) & 0xFF;
+	s_src[0x1E] = 0x83; /* 8 kHz */
+	s_src[0x1F] = 0x00;
+	for (int i = 0; i < BENCH_VOC_SIZE; i++)
+		s_src[VOC_HEADER_SIZE + i] = 0x80 + (int)(Random_Xorshift_32() % 64) - 32;
+
+	memset(&s_voc, 0, sizeof(s_voc));
+
+	const double seconds = Bench_Run(Bench_Voc_Once, s_seconds);
+
+	Bench_Report("Voc_ReadHeader", s_voc.length, seconds,
+			Bench_Hash(s_dst, s_voc.length, 2166136261u ^ s_voc.frequency));
+}
+
+int
+main(int argc, char **argv)
+{
+	s_seconds = Bench_ParseArgs(argc, argv);
+
+	printf("%-28s %15s   %s\n", "decoder", "throughput", "output hash");
+
+	Bench_Format80();
+	Bench_Format40();
+	Bench_Format40_XorToScreen();
+	Bench_Image();
+	Bench_Digram();
+	Bench_Voc();
+
+	return EXIT_SUCCESS;
+}
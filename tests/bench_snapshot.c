@@ -0,0 +1,176 @@
+/* bench_snapshot.c
+ *
+ * Cost of taking and restoring a GameSnapshot of a full game: every
+ * house, the unit and structure pools filled up to the raised caps, and five items in
+ * every build queue.  Maps are at most 64x64 tiles, but the tile
+ * arrays are always that size, so the map size does not change the
+ * cost.  The last line times copying the tile arrays of a 128x128 map
+ * one way, which is what a snapshot would add at that size.
+ *
+ * The save line times the part of a background save that holds up
+ * the game: gathering the saved globals and copying the game context
+ * and build queues.  The rest runs on a thread of its own.
+ *
+ * Does not need the game data.
+ *
+ * Usage: bench_snapshot [seconds per measurement]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+
+#include "common.h"
+#include "../src/animation.h"
+#include "../src/buildqueue.h"
+#include "../src/enhancement.h"
+#include "../src/explosion.h"
+#include "../src/gamecontext.h"
+#include "../src/house.h"
+#include "../src/map.h"
+#include "../src/mods/mapgenerator.h"
+#include "../src/opendune.h"
+#include "../src/pool/pool_house.h"
+#include "../src/pool/pool_structure.h"
+#include "../src/pool/pool_team.h"
+#include "../src/pool/pool_unit.h"
+#include "../src/saveload/saveload.h"
+#include "../src/snapshot.h"
+#include "../src/structure.h"
+#include "../src/team.h"
+#include "../src/unit.h"
+
+/* Defined by dedicated.c, which is not linked in. */
+THREAD_LOCAL enum MapGeneratorMode lobby_map_generator_mode;
+
+static double s_seconds;
+static GameSnapshot *s_snap;
+static int s_structures;
+
+static GameContext *s_saveContext;
+static BuildQueueItem *s_saveQueueItem;
+static int s_saveMaxQueueItems;
+
+/* Four times the 64x64 tile arrays. */
+static uint8 *s_bigMapSrc;
+static uint8 *s_bigMapDst;
+static size_t s_bigMapSize;
+
+static void
+Bench_Fill(uint8 *p, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		p[i] = Random_Xorshift_32();
+}
+
+static void
+Bench_InitGame(void)
+{
+	memcpy(g_table_houseInfo, g_table_houseInfo_original, sizeof(g_table_houseInfo_original));
+	memcpy(g_table_structureInfo, g_table_structureInfo_original, sizeof(g_table_structureInfo_original));
+	memcpy(g_table_unitInfo, g_table_unitInfo_original, sizeof(g_table_unitInfo_original));
+
+	Game_Init();
+
+	/* The largest pools the game allows. */
+	enhancement_raise_unit_cap = true;
+	enhancement_raise_structure_cap = true;
+
+	g_validateStrictIfZero++;
+
+	for (enum HouseType h = HOUSE_HARKONNEN; h < HOUSE_MAX; h++)
+		House_Allocate(h);
+
+	for (int i = 0; ; i++) {
+		Structure *s = Structure_Allocate(STRUCTURE_INDEX_INVALID, STRUCTURE_HEAVY_VEHICLE);
+
+		if (s == NULL)
+			break;
+
+		s_structures++;
+		s->o.houseID = i % HOUSE_MAX;
+		for (int j = 0; j < 5; j++)
+			BuildQueue_Append(&s->queue, UNIT_TANK + j, 300);
+	}
+
+	for (int i = 0; ; i++) {
+		if (Unit_Allocate(UNIT_INDEX_INVALID, UNIT_TANK, i % HOUSE_MAX) == NULL)
+			break;
+	}
+
+	while (Team_Allocate(TEAM_INDEX_INVALID) != NULL) {
+	}
+
+	g_validateStrictIfZero--;
+
+	Bench_Fill((uint8 *)g_game->map, sizeof(g_game->map));
+	Bench_Fill((uint8 *)g_game->mapVisible, sizeof(g_game->mapVisible));
+	Bench_Fill((uint8 *)g_game->mapSpriteID, sizeof(g_game->mapSpriteID));
+}
+
+static void
+Bench_Take(void)
+{
+	GameSnapshot_Take(s_snap);
+}
+
+static void
+Bench_Restore(void)
+{
+	GameSnapshot_Restore(s_snap);
+}
+
+/* As SaveFile_Background does before handing over to its thread. */
+static void
+Bench_SaveCopy(void)
+{
+	Unit_SyncScriptDelays();
+	Structure_SyncScriptDelays();
+
+	Info_Save_Prepare();
+	Map_Save_Prepare();
+	Scenario_Save_Prepare();
+
+	GameContext_Copy(s_saveContext, g_game);
+	GameContext_CopyQueues(s_saveContext, &s_saveQueueItem, &s_saveMaxQueueItems);
+}
+
+static void
+Bench_CopyBigMap(void)
+{
+	memcpy(s_bigMapDst, s_bigMapSrc, s_bigMapSize);
+}
+
+int
+main(int argc, char **argv)
+{
+	s_seconds = Bench_ParseArgs(argc, argv);
+
+	Bench_InitGame();
+
+	s_bigMapSize = 4 * (sizeof(g_game->map) + sizeof(g_game->mapVisible) + sizeof(g_game->mapSpriteID));
+	s_bigMapSrc = malloc(s_bigMapSize);
+	s_bigMapDst = malloc(s_bigMapSize);
+	Bench_Fill(s_bigMapSrc, s_bigMapSize);
+
+	s_snap = GameSnapshot_Create();
+	s_saveContext = GameContext_Create();
+
+	printf("%d units, %d structures\n", g_game->unitFindCount, s_structures);
+	printf("%-24s %8.1f us\n", "take",
+			Bench_Run(Bench_Take, s_seconds) * 1e6);
+	printf("%-24s %8.1f us\n", "restore",
+			Bench_Run(Bench_Restore, s_seconds) * 1e6);
+	printf("%-24s %8.1f us\n", "save",
+			Bench_Run(Bench_SaveCopy, s_seconds) * 1e6);
+	printf("%-24s %8.1f us  %u KiB\n", "tile arrays at 128x128",
+			Bench_Run(Bench_CopyBigMap, s_seconds) * 1e6, (unsigned int)(s_bigMapSize / 1024));
+
+	GameSnapshot_Free(s_snap);
+	GameContext_Free(s_saveContext);
+	free(s_saveQueueItem);
+	free(s_bigMapSrc);
+	free(s_bigMapDst);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,193 @@
+/* bench_videosoft.c
+ *
+ * Cost of a 1920x1080 frame drawn by src/video/video_soft.c, on one
+ * core, shaped like a busy viewport: a screen of 16x16 tiles with a
+ * quarter of them in house colours, fog over a third of the screen,
+ * shadowed units in house colours, some of them rotated, sandworm
+ * blurs, and the conversion to 32-bit pixels.
+ *
+ * Each part is timed on its own, then the whole frame.
+ *
+ * Usage: bench_videosoft [seconds per measurement]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "types.h"
+
+#include "common.h"
+#include "../src/video/video_soft.h"
+
+enum {
+	BENCH_WIDTH = 1920,
+	BENCH_HEIGHT = 1080,
+	BENCH_TILE = 16,
+	BENCH_TILES = 64,
+	BENCH_UNITS = 400,
+	BENCH_ROTATED = 100,
+	BENCH_BLURS = 8
+};
+
+static double s_seconds;
+
+static VideoSoftFramebuffer s_fb;
+static VideoSoftImage s_tile[BENCH_TILES];
+static VideoSoftImage s_fog;
+static VideoSoftImage s_unit;
+static VideoSoftImage s_worm;
+static uint8 s_shade[256];
+static uint8 s_remap[256];
+static uint32 s_lookup[256];
+static uint32 *s_rgba;
+
+/* Opaque where the ellipse is, like a unit or a worm. */
+static void
+Bench_InitImage(VideoSoftImage *img, int w, int h, bool opaque)
+{
+	uint8 *pixels = malloc(w * h);
+
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++) {
+			const int dx = 2 * x + 1 - w;
+			const int dy = 2 * y + 1 - h;
+			const bool inside = opaque || (dx * dx * h * h + dy * dy * w * w <= w * w * h * h);
+
+			pixels[w * y + x] = inside ? (0x8C + Random_Xorshift_32() % 16) : 0;
+		}
+	}
+
+	VideoSoft_InitImage(img, pixels, w, w, h);
+	free(pixels);
+}
+
+static void
+Bench_Tiles(void)
+{
+	int n = 0;
+
+	for (int y = 0; y < BENCH_HEIGHT; y += BENCH_TILE) {
+		for (int x = 0; x < BENCH_WIDTH; x += BENCH_TILE, n++) {
+			const VideoSoftImage *tile = &s_tile[n % BENCH_TILES];
+
+			if (n % 4 == 0) {
+				VideoSoft_BlitRange(&s_fb, tile, x, y, 0, 0x90, 0x96, 0x20);
+			} else {
+				VideoSoft_Blit(&s_fb, tile, x, y, 0);
+			}
+		}
+	}
+}
+
+static void
+Bench_Fog(void)
+{
+	for (int y = 0; y < BENCH_HEIGHT; y += BENCH_TILE) {
+		for (int x = 0; x < BENCH_WIDTH / 3; x += BENCH_TILE)
+			VideoSoft_BlitShade(&s_fb, &s_fog, x, y, 0, s_shade);
+	}
+}
+
+static void
+Bench_Units(void)
+{
+	for (int i = 0; i < BENCH_UNITS; i++) {
+		const int x = (i * 97) % BENCH_WIDTH;
+		const int y = (i * 61) % BENCH_HEIGHT;
+
+		VideoSoft_BlitShade(&s_fb, &s_unit, x + 1, y + 3, i & 1, s_shade);
+		VideoSoft_BlitRange(&s_fb, &s_unit, x, y, i & 1, 0x90, 0x96, 0x10 * (i % 6));
+	}
+
+	for (int i = 0; i < BENCH_ROTATED; i++) {
+		const int x = (i * 193) % BENCH_WIDTH;
+		const int y = (i * 127) % BENCH_HEIGHT;
+
+		VideoSoft_BlitRotate(&s_fb, &s_unit, x, y, i * 37, s_remap, NULL);
+	}
+}
+
+static void
+Bench_Blurs(void)
+{
+	for (int i = 0; i < BENCH_BLURS; i++)
+		VideoSoft_Blur(&s_fb, &s_worm, (i * 211) % BENCH_WIDTH, (i * 131) % BENCH_HEIGHT, 1 + i % 5);
+}
+
+static void
+Bench_Convert(void)
+{
+	VideoSoft_Convert(&s_fb, s_lookup, s_rgba, sizeof(uint32) * BENCH_WIDTH);
+}
+
+static void
+Bench_Frame(void)
+{
+	Bench_Tiles();
+	Bench_Blurs();
+	Bench_Units();
+	Bench_Fog();
+	Bench_Convert();
+}
+
+int
+main(int argc, char **argv)
+{
+	static const struct {
+		const char *name;
+		void (*draw)(void);
+	} part[] = {
+		{ "tiles", Bench_Tiles },
+		{ "blurs", Bench_Blurs },
+		{ "units", Bench_Units },
+		{ "fog", Bench_Fog },
+		{ "convert", Bench_Convert },
+		{ "frame", Bench_Frame },
+	};
+
+	uint8 palette[3 * 256];
+
+	s_seconds = Bench_ParseArgs(argc, argv);
+
+	s_rgba = malloc(sizeof(uint32) * BENCH_WIDTH * BENCH_HEIGHT);
+	if (s_rgba == NULL || !VideoSoft_InitFramebuffer(&s_fb, BENCH_WIDTH, BENCH_HEIGHT))
+		return EXIT_FAILURE;
+
+	for (int i = 0; i < BENCH_TILES; i++)
+		Bench_InitImage(&s_tile[i], BENCH_TILE, BENCH_TILE, true);
+
+	Bench_InitImage(&s_fog, BENCH_TILE, BENCH_TILE, false);
+	Bench_InitImage(&s_unit, 24, 24, false);
+	Bench_InitImage(&s_worm, 32, 32, false);
+
+	for (int i = 0; i < 3 * 256; i++)
+		palette[i] = Random_Xorshift_32() & 0xFF;
+
+	for (int i = 0; i < 256; i++)
+		s_remap[i] = (0x90 <= i && i <= 0x96) ? (i + 0x30) : i;
+
+	VideoSoft_CreateShade(s_shade, palette, 128, NULL);
+	VideoSoft_CreateLookup(s_lookup, palette);
+	VideoSoft_Clear(&s_fb, 0);
+
+	printf("%dx%d\n", BENCH_WIDTH, BENCH_HEIGHT);
+
+	for (unsigned int i = 0; i < sizeof(part) / sizeof(part[0]); i++)
+		printf("%8s %8.3f ms\n", part[i].name, Bench_Run(part[i].draw, s_seconds) * 1e3);
+
+	/* Keep the result alive. */
+	uint32 sum = 0;
+	for (int i = 0; i < BENCH_WIDTH * BENCH_HEIGHT; i += 4096)
+		sum += s_rgba[i];
+	printf("checksum %08X\n", sum);
+
+	for (int i = 0; i < BENCH_TILES; i++)
+		VideoSoft_FreeImage(&s_tile[i]);
+
+	VideoSoft_FreeImage(&s_fog);
+	VideoSoft_FreeImage(&s_unit);
+	VideoSoft_FreeImage(&s_worm);
+	VideoSoft_FreeFramebuffer(&s_fb);
+	free(s_rgba);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+/* common.c
+ *
+ * Helpers shared by the tests and benchmarks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "common.h"
+
+/* The seed when none is given. */
+#define TEST_DEFAULT_SEED   0x2545F491
+
+static void
+Test_Seed(uint32 seed)
+{
+	Random_Xorshift_Seed(seed, seed ^ 0x5A5A5A5A, seed ^ 0xA5A5A5A5, ~seed);
+}
+
+/**
+ * Parses the "[count [seed]]" arguments of a test and seeds
+ *  Random_Xorshift.
+ *
+ * @param count The count to use when none is given.
+ * @return The number of iterations or ticks to run.
+ */
+long
+Test_ParseArgs(int argc, char **argv, long count)
+{
+	const uint32 seed = (argc > 2) ? (uint32)strtoul(argv[2], NULL, 0) : TEST_DEFAULT_SEED;
+
+	if (argc > 3) {
+		fprintf(stderr, "Usage: %s [count [seed]]\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	Test_Seed(seed);
+	return (argc > 1) ? atol(argv[1]) : count;
+}
+
+/**
+ * Parses the "[seconds]" argument of a benchmark and seeds
+ *  Random_Xorshift, so that the synthetic data is the same every run.
+ *
+ * @return The seconds to spend on each measurement.
+ */
+double
+Bench_ParseArgs(int argc, char **argv)
+{
+	if (argc > 2) {
+		fprintf(stderr, "Usage: %s [seconds per measurement]\n", argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	Test_Seed(TEST_DEFAULT_SEED);
+	return (argc > 1) ? atof(argv[1]) : 0.5;
+}
+
+static double
+Bench_GetTime(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Calls proc over and over for at least the given time.
+ *
+ * @return The seconds per call.
+ */
+double
+Bench_Run(void (*proc)(void), double seconds)
+{
+	const double start = Bench_GetTime();
+	long calls = 0;
+	double now;
+
+	do {
+		proc();
+		calls++;
+		now = Bench_GetTime();
+	} while (now < start + seconds);
+
+	return (now - start) / calls;
+}
@@ -0,0 +1,18 @@
+/* common.h
+ *
+ * Helpers shared by the tests and benchmarks.  Random numbers come from
+ * src/tools/random_xorshift.c, so that runs repeat across platforms.
+ */
+
+#ifndef TESTS_COMMON_H
+#define TESTS_COMMON_H
+
+#include "types.h"
+
+#include "../src/tools/random_xorshift.h"
+
+extern long Test_ParseArgs(int argc, char **argv, long count);
+extern double Bench_ParseArgs(int argc, char **argv);
+extern double Bench_Run(void (*proc)(void), double seconds);
+
+#endif
@@ -0,0 +1,432 @@
+/* test_determinism.c
+ *
+ * Runs the same skirmish twice, once with sleeping scripts counted
+ * down every script tick as in the original game (g_scriptWheel off)
+ * and once with them waiting in the timer wheels, and checks that the
+ * game state is the same after every tick.
+ *
+ * Then takes a GameSnapshot, runs on for a while, restores the
+ * snapshot and runs the same ticks again, which must give the same
+ * state after every tick as the first time.
+ *
+ * The match is set up once and the process forks, so that both runs
+ * start from the same bytes.  The first run sends a hash of every part
+ * of the state through a pipe after each tick.  Delays of sleeping
+ * scripts are only brought up to date every SYNC_INTERVAL ticks, so
+ * that script ticks with nothing due pile up in between as they do in
+ * a game.
+ *
+ * Needs the Dune II data files; skipped without them.
+ *
+ * Usage: test_determinism [--data-dir DIR] [ticks [seed]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "buildcfg.h"
+#include "enum_string.h"
+
+#include "../src/file.h"
+#include "../src/gamecontext.h"
+#include "../src/gfx.h"
+#include "../src/house.h"
+#include "../src/map.h"
+#include "../src/mods/mapgenerator.h"
+#include "../src/mods/skirmish.h"
+#include "../src/opendune.h"
+#include "../src/pool/pool.h"
+#include "../src/pool/pool_house.h"
+#include "../src/pool/pool_structure.h"
+#include "../src/pool/pool_team.h"
+#include "../src/pool/pool_unit.h"
+#include "../src/scenario.h"
+#include "../src/snapshot.h"
+#include "../src/sprites.h"
+#include "../src/string.h"
+#include "../src/structure.h"
+#include "../src/team.h"
+#include "../src/timer/timer.h"
+#include "../src/tools/random_general.h"
+#include "../src/tools/random_lcg.h"
+#include "../src/tools/random_starport.h"
+#include "../src/tools/random_xorshift.h"
+#include "../src/unit.h"
+
+/* Exit code ctest treats as skipped. */
+#define EXIT_SKIP           77
+
+#define SYNC_INTERVAL       97
+
+#define SNAPSHOT_TICKS      3000
+
+enum {
+	PART_RANDOM,
+	PART_UNITS,
+	PART_STRUCTURES,
+	PART_HOUSES,
+	PART_TEAMS,
+	PART_MAP,
+
+	PART_MAX
+};
+
+static const char * const s_partName[PART_MAX] = {
+	"random number generators", "units", "structures", "houses", "teams", "map"
+};
+
+/* Defined by dedicated.c, which is not linked in. */
+THREAD_LOCAL enum MapGeneratorMode lobby_map_generator_mode;
+
+/* Only this test builds with SCRIPT_WHEEL_TOGGLE. */
+bool g_scriptWheel = true;
+
+static uint32
+Test_Hash(uint32 hash, const void *data, size_t length)
+{
+	const uint8 *p = data;
+
+	/* FNV-1a. */
+	for (size_t i = 0; i < length; i++) {
+		hash ^= p[i];
+		hash *= 16777619;
+	}
+
+	return hash;
+}
+
+static void
+Test_HashState(uint32 hash[PART_MAX], bool withDelays)
+{
+	const uint32 basis = 2166136261U;
+	PoolFindStruct find;
+
+	for (int part = 0; part < PART_MAX; part++)
+		hash[part] = basis;
+
+	const uint32 random[] = {
+		Tools_Random_GetState(),
+		Tools_RandomLCG_GetState(),
+		Random_Starport_GetInitialSeed(),
+		Random_Starport_GetState()
+	};
+	hash[PART_RANDOM] = Test_Hash(hash[PART_RANDOM], random, sizeof(random));
+
+	for (uint16 i = 0; i < UnitPool_GetMaxIndex(); i++) {
+		Unit u = *Unit_Get_ByIndex(i);
+
+		if (!u.o.flags.s.used)
+			continue;
+
+		if (!withDelays)
+			u.o.script.delay = 0;
+
+		hash[PART_UNITS] = Test_Hash(hash[PART_UNITS], &u, sizeof(u));
+	}
+
+	for (uint16 i = 0; i < StructurePool_GetIndex(STRUCTURE_INDEX_MAX_HARD); i++) {
+		Structure s = *Structure_Get_ByIndex(i);
+
+		if (!s.o.flags.s.used)
+			continue;
+
+		if (!withDelays)
+			s.o.script.delay = 0;
+
+		hash[PART_STRUCTURES] = Test_Hash(hash[PART_STRUCTURES], &s, sizeof(s));
+	}
+
+	g_validateStrictIfZero++;
+
+	for (const House *h = House_FindFirst(&find, HOUSE_INVALID);
+			h != NULL;
+			h = House_FindNext(&find)) {
+		hash[PART_HOUSES] = Test_Hash(hash[PART_HOUSES], h, sizeof(*h));
+	}
+
+	for (const Team *t = Team_FindFirst(&find, HOUSE_INVALID);
+			t != NULL;
+			t = Team_FindNext(&find)) {
+		hash[PART_TEAMS] = Test_Hash(hash[PART_TEAMS], t, sizeof(*t));
+	}
+
+	g_validateStrictIfZero--;
+
+	hash[PART_MAP] = Test_Hash(hash[PART_MAP], g_game->map, sizeof(g_game->map));
+}
+
+static void
+Test_Initialise(uint32 seed)
+{
+	FileHash_Init();
+
+	memcpy(g_table_houseInfo, g_table_houseInfo_original, sizeof(g_table_houseInfo_original));
+	memcpy(g_table_structureInfo, g_table_structureInfo_original, sizeof(g_table_structureInfo_original));
+	memcpy(g_table_unitInfo, g_table_unitInfo_original, sizeof(g_table_unitInfo_original));
+
+	srand(seed);
+	Tools_RandomLCG_Seed(seed);
+	Random_Xorshift_Seed(seed, seed ^ 0x5A5A5A5A, seed ^ 0xA5A5A5A5, ~seed);
+
+	GFX_Init();
+	String_Init();
+
+	/* The campaign IDs must match dedicated.c's. */
+	Campaign *camp;
+
+	camp = Campaign_Alloc(NULL);
+	camp->house[0] = HOUSE_ATREIDES;
+	camp->house[1] = HOUSE_ORDOS;
+	camp->house[2] = HOUSE_HARKONNEN;
+	camp->intermission = true;
+	snprintf(camp->name, sizeof(camp->name), "%s", String_Get_ByIndex(STR_THE_BATTLE_FOR_ARRAKIS));
+
+	camp = Campaign_Alloc("skirmish");
+	snprintf(camp->name, sizeof(camp->name), "Skirmish");
+
+	camp = Campaign_Alloc("multiplayer");
+	snprintf(camp->name, sizeof(camp->name), "Multiplayer");
+
+	g_campaign_selected = CAMPAIGNID_SKIRMISH;
+	Sprites_LoadTiles();
+}
+
+/* An idle player against two computer players on separate teams. */
+static bool
+Test_StartSkirmish(uint32 seed)
+{
+	Skirmish_Initialise();
+	g_skirmish.seed = seed;
+	g_skirmish.player_config[HOUSE_ATREIDES].brain = BRAIN_HUMAN;
+	g_skirmish.player_config[HOUSE_HARKONNEN].brain = BRAIN_CPU;
+	g_skirmish.player_config[HOUSE_ORDOS].brain = BRAIN_CPU;
+
+	if (!Skirmish_GenerateMap(MAP_GENERATOR_FINAL))
+		return false;
+
+	Sprites_UnloadTiles();
+	Sprites_LoadTiles();
+
+	Timer_ResetScriptTimers();
+	Skirmish_StartScenario();
+
+	g_gameMode = GM_NORMAL;
+	return true;
+}
+
+static void
+Test_Tick(void)
+{
+	g_game->timerGame++;
+	GameLoop_Server_Logic();
+}
+
+static bool
+Test_Write(int fd, const void *data, size_t length)
+{
+	return write(fd, data, length) == (ssize_t)length;
+}
+
+static bool
+Test_Read(int fd, void *data, size_t length)
+{
+	uint8 *p = data;
+
+	while (length > 0) {
+		const ssize_t n = read(fd, p, length);
+
+		if (n <= 0)
+			return false;
+
+		p += n;
+		length -= n;
+	}
+
+	return true;
+}
+
+/* The original countdown: sends the hashes after every tick. */
+static int
+Test_RunReference(int fd, long ticks)
+{
+	g_scriptWheel = false;
+
+	for (long tick = 1; tick <= ticks; tick++) {
+		uint32 hash[PART_MAX];
+
+		Test_Tick();
+
+		/* With the wheel off there is never anything to sync. */
+		Test_HashState(hash, (tick % SYNC_INTERVAL) == 0);
+
+		if (!Test_Write(fd, hash, sizeof(hash)))
+			return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* The timer wheels: checks the hashes after every tick. */
+static int
+Test_RunWheel(int fd, long ticks)
+{
+	g_scriptWheel = true;
+
+	for (long tick = 1; tick <= ticks; tick++) {
+		const bool withDelays = (tick % SYNC_INTERVAL) == 0;
+		uint32 expected[PART_MAX];
+		uint32 hash[PART_MAX];
+
+		Test_Tick();
+
+		if (withDelays) {
+			Unit_SyncScriptDelays();
+			Structure_SyncScriptDelays();
+		}
+
+		Test_HashState(hash, withDelays);
+
+		if (!Test_Read(fd, expected, sizeof(expected))) {
+			fprintf(stderr, "tick %ld: the reference run stopped\n", tick);
+			return EXIT_FAILURE;
+		}
+
+		for (int part = 0; part < PART_MAX; part++) {
+			if (hash[part] != expected[part]) {
+				fprintf(stderr, "tick %ld: %s differ%s\n", tick, s_partName[part],
+						withDelays ? "" : " (not counting script delays)");
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
+/* Runs from a snapshot twice: the second run must repeat the first. */
+static int
+Test_RunSnapshot(void)
+{
+	static uint32 s_expected[SNAPSHOT_TICKS][PART_MAX];
+	GameSnapshot *snap = GameSnapshot_Create();
+	int res = EXIT_SUCCESS;
+
+	GameSnapshot_Take(snap);
+
+	for (int run = 0; run < 2 && res == EXIT_SUCCESS; run++) {
+		if (run > 0 && !GameSnapshot_Restore(snap)) {
+			fprintf(stderr, "the snapshot could not be restored\n");
+			res = EXIT_FAILURE;
+			break;
+		}
+
+		for (int tick = 0; tick < SNAPSHOT_TICKS; tick++) {
+			uint32 hash[PART_MAX];
+
+			Test_Tick();
+			Unit_SyncScriptDelays();
+			Structure_SyncScriptDelays();
+			Test_HashState(hash, true);
+
+			if (run == 0) {
+				memcpy(s_expected[tick], hash, sizeof(hash));
+				continue;
+			}
+
+			for (int part = 0; part < PART_MAX; part++) {
+				if (hash[part] != s_expected[tick][part]) {
+					fprintf(stderr, "tick %d after restoring the snapshot: %s differ\n",
+							tick + 1, s_partName[part]);
+					res = EXIT_FAILURE;
+					break;
+				}
+			}
+
+			if (res != EXIT_SUCCESS)
+				break;
+		}
+	}
+
+	GameSnapshot_Free(snap);
+	return res;
+}
+
+int
+main(int argc, char **argv)
+{
+	long ticks = 20000;
+	uint32 seed = 12345;
+	int arg = 0;
+
+	snprintf(g_dune_data_dir, sizeof(g_dune_data_dir), "%s", DUNE_DATA_DIR);
+	snprintf(g_personal_data_dir, sizeof(g_personal_data_dir), "%s", DUNE_DATA_DIR);
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--data-dir") == 0 && i + 1 < argc) {
+			snprintf(g_dune_data_dir, sizeof(g_dune_data_dir), "%s", argv[++i]);
+			snprintf(g_personal_data_dir, sizeof(g_personal_data_dir), "%s", g_dune_data_dir);
+		} else if (arg == 0) {
+			ticks = atol(argv[i]);
+			arg++;
+		} else if (arg == 1) {
+			seed = (uint32)strtoul(argv[i], NULL, 0);
+			arg++;
+		} else {
+			fprintf(stderr, "Usage: %s [--data-dir DIR] [ticks [seed]]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!File_Exists("DUNE.PAK")) {
+		printf("test_determinism: no game data in '%s', skipped\n", g_dune_data_dir);
+		return EXIT_SKIP;
+	}
+
+	Test_Initialise(seed);
+
+	if (!Test_StartSkirmish(seed)) {
+		fprintf(stderr, "could not generate a map with seed %u\n", seed);
+		return EXIT_FAILURE;
+	}
+
+	int fd[2];
+	if (pipe(fd) != 0) {
+		perror("pipe");
+		return EXIT_FAILURE;
+	}
+
+	const pid_t pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		return EXIT_FAILURE;
+	}
+
+	if (pid == 0) {
+		close(fd[0]);
+		const int res = Test_RunReference(fd[1], ticks);
+		close(fd[1]);
+		_exit(res);
+	}
+
+	close(fd[1]);
+	int res = Test_RunWheel(fd[0], ticks);
+	close(fd[0]);
+
+	int status;
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+		res = EXIT_FAILURE;
+
+	if (res == EXIT_SUCCESS)
+		printf("test_determinism: %ld ticks matched\n", ticks);
+
+	if (res == EXIT_SUCCESS) {
+		res = Test_RunSnapshot();
+
+		if (res == EXIT_SUCCESS)
+			printf("test_determinism: %d ticks matched after restoring a snapshot\n", SNAPSHOT_TICKS);
+	}
+
+	return res;
+}
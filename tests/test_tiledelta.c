@@ -0,0 +1,239 @@
+/* test_tiledelta.c
+ *
+ * Round-trip fuzz test for the landscape and fog of war delta codec in
+ * src/net/tiledelta.c.
+ *
+ * Random sets of changed tiles, in the patterns that explosions and
+ * fog sweeps produce, are encoded block by block and decoded again.
+ * Every truncation of each encoding, and random garbage, must be
+ * rejected or decoded without reading past the end.
+ *
+ * Usage: test_tiledelta [iterations [seed]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "../src/net/tiledelta.h"
+
+static uint32
+Test_RandomValue(int value_size)
+{
+	const uint32 skip = (value_size >= 4) ? 0xFFFFFFFF : ((1u << (8 * value_size)) - 1);
+
+	/* Anything but the skip value. */
+	return Random_Xorshift_32() % skip;
+}
+
+/* Picks which tiles of a block change. */
+static uint64_t
+Test_RandomMask(void)
+{
+	uint64_t mask = 0;
+
+	switch (Random_Xorshift_32() % 5) {
+		case 0: /* A few scattered tiles. */
+			for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++) {
+				if (Random_Xorshift_32() % 16 == 0)
+					mask |= (uint64_t)1 << i;
+			}
+			break;
+
+		case 1: /* Half of them. */
+			mask = ((uint64_t)Random_Xorshift_32() << 32) | Random_Xorshift_32();
+			break;
+
+		case 2: /* All of them. */
+			mask = ~(uint64_t)0;
+			break;
+
+		case 3: /* A run up to the end of the block, as a sweep. */
+			mask = ~(uint64_t)0 << (Random_Xorshift_32() % TILEDELTA_BLOCK_TILES);
+			break;
+
+		default: /* A square patch, as an explosion. */
+			{
+				const int x0 = Random_Xorshift_32() % TILEDELTA_BLOCK_SIZE;
+				const int y0 = Random_Xorshift_32() % TILEDELTA_BLOCK_SIZE;
+				const int w = 1 + Random_Xorshift_32() % (TILEDELTA_BLOCK_SIZE - x0);
+				const int h = 1 + Random_Xorshift_32() % (TILEDELTA_BLOCK_SIZE - y0);
+
+				for (int y = y0; y < y0 + h; y++) {
+					for (int x = x0; x < x0 + w; x++)
+						mask |= (uint64_t)1 << (y * TILEDELTA_BLOCK_SIZE + x);
+				}
+			}
+			break;
+	}
+
+	return mask;
+}
+
+/**
+ * @brief   Decodes one block from an exact-size heap copy of the data,
+ *          so that memory checkers see any read past the end.
+ */
+static int
+Test_DecodeCopy(const unsigned char *data, size_t len, size_t *used,
+		uint64_t *changed, uint32 *value, int value_size)
+{
+	unsigned char *copy = malloc((len > 0) ? len : 1);
+	const unsigned char *r = copy;
+
+	memcpy(copy, data, len);
+
+	const int block = TileDelta_DecodeBlock(&r, copy + len, changed, value, value_size);
+
+	*used = r - copy;
+	free(copy);
+	return block;
+}
+
+static bool
+Test_Geometry(void)
+{
+	for (int packed = 0; packed < 64 * 64; packed++) {
+		const int block = TileDelta_GetBlock(packed);
+		const int bit = TileDelta_GetBit(packed);
+
+		if (block < 0 || block >= TILEDELTA_NUM_BLOCKS || bit < 0 || bit >= TILEDELTA_BLOCK_TILES
+				|| TileDelta_GetPacked(block, bit) != packed) {
+			fprintf(stderr, "tile %d: block %d bit %d does not map back\n", packed, block, bit);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief   Encodes a random update of a whole map and decodes it.
+ * @return  False on the first mismatch.
+ */
+static bool
+Test_RoundTrip(int iter)
+{
+	static unsigned char buf[TILEDELTA_NUM_BLOCKS * TILEDELTA_MAX_BLOCK_LEN];
+	static uint32 value[TILEDELTA_NUM_BLOCKS][TILEDELTA_BLOCK_TILES];
+	static size_t offset[TILEDELTA_NUM_BLOCKS + 1];
+	uint64_t changed[TILEDELTA_NUM_BLOCKS];
+	int block_of[TILEDELTA_NUM_BLOCKS];
+	const int value_size = 1 + Random_Xorshift_32() % 4;
+	unsigned char *end = buf;
+	int num_blocks = 0;
+
+	for (int b = 0; b < TILEDELTA_NUM_BLOCKS; b++) {
+		changed[b] = (Random_Xorshift_32() % 4 == 0) ? Test_RandomMask() : 0;
+		if (changed[b] == 0)
+			continue;
+
+		/* Mostly one value, as when a patch turns to craters. */
+		const uint32 common = Test_RandomValue(value_size);
+		for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++)
+			value[b][i] = (Random_Xorshift_32() % 3 != 0) ? common : Test_RandomValue(value_size);
+
+		const size_t len = TileDelta_EncodeBlock(end, buf + sizeof(buf) - end,
+				b, changed[b], value[b], value_size);
+		if (len == 0 || len > TILEDELTA_MAX_BLOCK_LEN) {
+			fprintf(stderr, "iteration %d: block %d encoded to %d bytes\n", iter, b, (int)len);
+			return false;
+		}
+
+		/* Too little room must fail cleanly. */
+		if (TileDelta_EncodeBlock(end, len - 1, b, changed[b], value[b], value_size) != 0) {
+			fprintf(stderr, "iteration %d: block %d overran its buffer\n", iter, b);
+			return false;
+		}
+
+		offset[num_blocks] = end - buf;
+		block_of[num_blocks] = b;
+		num_blocks++;
+		end += len;
+	}
+	offset[num_blocks] = end - buf;
+
+	const unsigned char *r = buf;
+	for (int n = 0; n < num_blocks; n++) {
+		uint32 decoded[TILEDELTA_BLOCK_TILES];
+		uint64_t mask;
+		const int b = block_of[n];
+
+		if (TileDelta_DecodeBlock(&r, end, &mask, decoded, value_size) != b
+				|| mask != changed[b]
+				|| r != buf + offset[n + 1]) {
+			fprintf(stderr, "iteration %d: block %d did not decode\n", iter, b);
+			return false;
+		}
+
+		for (int i = 0; i < TILEDELTA_BLOCK_TILES; i++) {
+			if ((mask & ((uint64_t)1 << i)) && decoded[i] != value[b][i]) {
+				fprintf(stderr, "iteration %d: block %d tile %d is %u, not %u\n",
+						iter, b, i, decoded[i], value[b][i]);
+				return false;
+			}
+		}
+
+		/* Every truncation of the block must be rejected. */
+		for (size_t len = 0; len < offset[n + 1] - offset[n]; len++) {
+			size_t used;
+
+			if (Test_DecodeCopy(buf + offset[n], len, &used, &mask, decoded, value_size) >= 0) {
+				fprintf(stderr, "iteration %d: block %d decoded from %d of %d bytes\n",
+						iter, b, (int)len, (int)(offset[n + 1] - offset[n]));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/* Garbage may decode to anything, but must stay within its bounds. */
+static bool
+Test_Garbage(int iter)
+{
+	unsigned char buf[TILEDELTA_MAX_BLOCK_LEN];
+	const int value_size = 1 + Random_Xorshift_32() % 4;
+	const size_t len = Random_Xorshift_32() % sizeof(buf);
+	size_t pos = 0;
+
+	for (size_t i = 0; i < len; i++)
+		buf[i] = Random_Xorshift_32();
+
+	while (pos < len) {
+		uint32 decoded[TILEDELTA_BLOCK_TILES];
+		uint64_t mask;
+		size_t used;
+
+		if (Test_DecodeCopy(buf + pos, len - pos, &used, &mask, decoded, value_size) < 0)
+			break;
+
+		if (used == 0 || used > len - pos) {
+			fprintf(stderr, "iteration %d: garbage moved the read position out of bounds\n", iter);
+			return false;
+		}
+
+		pos += used;
+	}
+
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	const int iterations = Test_ParseArgs(argc, argv, 2000);
+
+	if (!Test_Geometry())
+		return EXIT_FAILURE;
+
+	for (int iter = 0; iter < iterations; iter++) {
+		if (!Test_RoundTrip(iter) || !Test_Garbage(iter))
+			return EXIT_FAILURE;
+	}
+
+	printf("test_tiledelta: %d iterations passed\n", iterations);
+	return EXIT_SUCCESS;
+}
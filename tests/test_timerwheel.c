@@ -0,0 +1,95 @@
+/* test_timerwheel.c
+ *
+ * Checks src/timer/timerwheel.c against a plain array of due ticks.
+ *
+ * Entries are scheduled, rescheduled and cancelled at random, with
+ * delays that stay on the first level, cross into the second, or go
+ * past both into the overflow list, and with a start tick just before
+ * the wheel wraps.  Every tick must hand out exactly the entries due.
+ *
+ * Usage: test_timerwheel [ticks [seed]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "../src/timer/timerwheel.h"
+
+enum {
+	TEST_ENTRIES = 300
+};
+
+static TimerWheel s_wheel;
+static bool s_scheduled[TEST_ENTRIES];
+static uint32 s_when[TEST_ENTRIES];
+
+static uint32
+Test_RandomDelay(void)
+{
+	switch (Random_Xorshift_32() % 4) {
+		case 0:  return Random_Xorshift_32() % 8;
+		case 1:  return Random_Xorshift_32() % 64;
+		case 2:  return Random_Xorshift_32() % 4096;
+		default: return Random_Xorshift_32() % 20000;
+	}
+}
+
+static bool
+Test_Tick(long tick)
+{
+	const uint32 now = TimerWheel_GetNow(&s_wheel);
+	int due = 0;
+
+	/* A few changes before every tick. */
+	for (int n = Random_Xorshift_32() % 4; n > 0; n--) {
+		const uint16 id = Random_Xorshift_32() % TEST_ENTRIES;
+
+		if (Random_Xorshift_32() % 5 == 0) {
+			TimerWheel_Cancel(&s_wheel, id);
+			s_scheduled[id] = false;
+		} else {
+			s_when[id] = now + Test_RandomDelay();
+			s_scheduled[id] = true;
+			TimerWheel_Schedule(&s_wheel, id, s_when[id]);
+		}
+	}
+
+	for (uint16 id = 0; id < TEST_ENTRIES; id++) {
+		if (TimerWheel_IsScheduled(&s_wheel, id) != s_scheduled[id]
+				|| (s_scheduled[id] && TimerWheel_GetWhen(&s_wheel, id) != s_when[id])) {
+			fprintf(stderr, "tick %ld: entry %u is not scheduled as it should be\n", tick, id);
+			return false;
+		}
+
+		if (s_scheduled[id] && s_when[id] == now) {
+			s_scheduled[id] = false;
+			due++;
+		}
+	}
+
+	const int count = TimerWheel_Advance(&s_wheel);
+	if (count != due) {
+		fprintf(stderr, "tick %ld: %d entries were due, not %d\n", tick, count, due);
+		return false;
+	}
+
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	const long ticks = Test_ParseArgs(argc, argv, 200000);
+
+	/* Start close to the end, to go through the wrap. */
+	TimerWheel_Init(&s_wheel, 0xFFFFFFFF - (uint32)(ticks / 2));
+
+	for (long tick = 0; tick < ticks; tick++) {
+		if (!Test_Tick(tick))
+			return EXIT_FAILURE;
+	}
+
+	printf("test_timerwheel: %ld ticks passed\n", ticks);
+	return EXIT_SUCCESS;
+}
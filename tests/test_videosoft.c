@@ -0,0 +1,416 @@
+/* test_videosoft.c
+ *
+ * Checks the kernels of src/video/video_soft.c against plain per-pixel
+ * versions of them.
+ *
+ * Random images are drawn at random positions, partly or entirely
+ * outside a random clipping rectangle, with every flip, into a
+ * framebuffer whose width is not a multiple of 16.  Whatever the SSE2
+ * code does, the whole framebuffer must come out as the reference.
+ *
+ * Usage: test_videosoft [iterations [seed]]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "../src/os/math.h"
+#include "../src/video/video_soft.h"
+
+enum {
+	TEST_WIDTH = 83,
+	TEST_HEIGHT = 47,
+	TEST_MAX_IMAGE = 40
+};
+
+enum TestKernel {
+	TEST_BLIT,
+	TEST_RANGE,
+	TEST_REMAP,
+	TEST_TINT,
+	TEST_SHADE,
+	TEST_BLUR,
+	TEST_ROTATE,
+	TEST_FILL_RECT,
+	TEST_LINE,
+
+	TEST_KERNEL_MAX
+};
+
+static const char * const s_kernel_name[TEST_KERNEL_MAX] = {
+	"blit", "range", "remap", "tint", "shade", "blur", "rotate", "fill rect", "line"
+};
+
+static VideoSoftFramebuffer s_fb;
+static uint8 s_ref[TEST_HEIGHT][TEST_WIDTH];
+static uint8 s_orig[TEST_HEIGHT][TEST_WIDTH];
+static uint8 s_pixels[TEST_MAX_IMAGE * TEST_MAX_IMAGE];
+static uint8 s_table[256];
+
+static int
+Test_RandomRange(int lo, int hi)
+{
+	return lo + (int)(Random_Xorshift_32() % (uint32)(hi - lo + 1));
+}
+
+/* Mostly house colours and transparency, which the kernels treat apart. */
+static uint8
+Test_RandomColour(void)
+{
+	switch (Random_Xorshift_32() % 4) {
+		case 0:  return 0;
+		case 1:  return Test_RandomRange(0x88, 0xA8);
+		default: return Random_Xorshift_32() & 0xFF;
+	}
+}
+
+static bool
+Test_InClip(int x, int y)
+{
+	return s_fb.clipx1 <= x && x < s_fb.clipx2 && s_fb.clipy1 <= y && y < s_fb.clipy2;
+}
+
+static void
+Test_Fill(void)
+{
+	for (int y = 0; y < TEST_HEIGHT; y++) {
+		for (int x = 0; x < TEST_WIDTH; x++)
+			s_ref[y][x] = s_orig[y][x] = s_fb.data[s_fb.pitch * y + x] = Random_Xorshift_32() & 0xFF;
+	}
+}
+
+static uint8
+Test_Apply(enum TestKernel kernel, uint8 d, uint8 s, uint8 c, uint8 first, uint8 last, uint8 offset)
+{
+	switch (kernel) {
+		case TEST_RANGE: return (first <= s && s <= last) ? (uint8)(s + offset) : s;
+		case TEST_REMAP: return s_table[s];
+		case TEST_TINT:  return c;
+		case TEST_SHADE: return s_table[d];
+		default:         return s;
+	}
+}
+
+static void
+Test_RefImage(enum TestKernel kernel, const VideoSoftImage *img, int x, int y, int flags,
+		uint8 c, uint8 first, uint8 last, uint8 offset, int blurx)
+{
+	for (int j = 0; j < img->height; j++) {
+		for (int i = 0; i < img->width; i++) {
+			const int sx = (flags & VIDEOSOFT_HFLIP) ? (img->width - 1 - i) : i;
+			const int sy = (flags & VIDEOSOFT_VFLIP) ? (img->height - 1 - j) : j;
+			const uint8 s = img->data[img->width * sy + sx];
+
+			if (s == 0 || !Test_InClip(x + i, y + j))
+				continue;
+
+			if (kernel == TEST_BLUR) {
+				s_ref[y + j][x + i] = s_orig[y + j][min(x + i + blurx, s_fb.clipx2 - 1)];
+			} else {
+				s_ref[y + j][x + i] = Test_Apply(kernel, s_ref[y + j][x + i], s, c, first, last, offset);
+			}
+		}
+	}
+}
+
+/* Only quarter turns, where the sine and cosine are exact. */
+static void
+Test_RefRotate(const VideoSoftImage *img, int cx, int cy, int quarter)
+{
+	const int c[4] = { 1, 0, -1, 0 };
+	const int s[4] = { 0, 1, 0, -1 };
+
+	for (int y = 0; y < TEST_HEIGHT; y++) {
+		for (int x = 0; x < TEST_WIDTH; x++) {
+			const double u = x - cx + 0.5;
+			const double v = y - cy + 0.5;
+			const int px = (int)floor(img->width / 2.0 + c[quarter] * u + s[quarter] * v);
+			const int py = (int)floor(img->height / 2.0 - s[quarter] * u + c[quarter] * v);
+
+			if (!Test_InClip(x, y) || px < 0 || px >= img->width || py < 0 || py >= img->height)
+				continue;
+
+			const uint8 p = img->data[img->width * py + px];
+			if (p != 0)
+				s_ref[y][x] = s_table[p];
+		}
+	}
+}
+
+/* Draws the line again without clipping, into a framebuffer large
+ * enough for all of it, and checks that it is a line: one pixel per
+ * step along the major axis, each at most half a pixel off.
+ */
+static bool
+Test_RefLine(long iter, int x1, int y1, int x2, int y2, uint8 c)
+{
+	const int m = 2 * TEST_MAX_IMAGE;
+	const int dx = x2 - x1;
+	const int dy = y2 - y1;
+	const int n = max(abs(dx), abs(dy));
+	VideoSoftFramebuffer big;
+	int count = 0;
+
+	if (!VideoSoft_InitFramebuffer(&big, TEST_WIDTH + 2 * m, TEST_HEIGHT + 2 * m))
+		return false;
+
+	VideoSoft_Clear(&big, 0);
+	VideoSoft_Line(&big, x1 + m, y1 + m, x2 + m, y2 + m, 1);
+
+	for (int y = 0; y < big.height; y++) {
+		for (int x = 0; x < big.width; x++) {
+			if (big.data[big.pitch * y + x] == 0)
+				continue;
+
+			const int px = x - m - x1;
+			const int py = y - m - y1;
+			const double off = (abs(dx) >= abs(dy))
+				? fabs(py - (dx == 0 ? 0.0 : (double)dy * px / dx))
+				: fabs(px - (double)dx * py / dy);
+
+			if (off > 0.5 + 1e-9) {
+				fprintf(stderr, "iteration %ld: line: (%d, %d) is %.2f off the line\n", iter, x - m, y - m, off);
+				VideoSoft_FreeFramebuffer(&big);
+				return false;
+			}
+
+			if (Test_InClip(x - m, y - m))
+				s_ref[y - m][x - m] = c;
+
+			count++;
+		}
+	}
+
+	VideoSoft_FreeFramebuffer(&big);
+
+	if (count != n + 1) {
+		fprintf(stderr, "iteration %ld: line: %d pixels, not %d\n", iter, count, n + 1);
+		return false;
+	}
+
+	return true;
+}
+
+static bool
+Test_Compare(long iter, enum TestKernel kernel)
+{
+	for (int y = 0; y < TEST_HEIGHT; y++) {
+		for (int x = 0; x < TEST_WIDTH; x++) {
+			if (s_fb.data[s_fb.pitch * y + x] != s_ref[y][x]) {
+				fprintf(stderr, "iteration %ld: %s: pixel (%d, %d) is %d, not %d\n",
+						iter, s_kernel_name[kernel], x, y, s_fb.data[s_fb.pitch * y + x], s_ref[y][x]);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool
+Test_Iteration(long iter)
+{
+	const enum TestKernel kernel = Random_Xorshift_32() % TEST_KERNEL_MAX;
+	const int w = Test_RandomRange(1, TEST_MAX_IMAGE);
+	const int h = Test_RandomRange(1, TEST_MAX_IMAGE);
+	const int x = Test_RandomRange(-TEST_MAX_IMAGE, TEST_WIDTH);
+	const int y = Test_RandomRange(-TEST_MAX_IMAGE, TEST_HEIGHT);
+	const int flags = Random_Xorshift_32() & (VIDEOSOFT_HFLIP | VIDEOSOFT_VFLIP);
+	const uint8 c = Random_Xorshift_32() & 0xFF;
+	const uint8 first = Test_RandomRange(0x88, 0x98);
+	const uint8 last = Test_RandomRange(first, 0xA0);
+	const uint8 offset = (Random_Xorshift_32() % 6) << 4;
+	VideoSoftImage img;
+	bool ok = true;
+
+	if (Random_Xorshift_32() % 4 == 0) {
+		VideoSoft_SetClip(&s_fb, 0, 0, TEST_WIDTH, TEST_HEIGHT);
+	} else {
+		const int cx = Test_RandomRange(-8, TEST_WIDTH);
+		const int cy = Test_RandomRange(-8, TEST_HEIGHT);
+
+		VideoSoft_SetClip(&s_fb, cx, cy, Test_RandomRange(0, TEST_WIDTH), Test_RandomRange(0, TEST_HEIGHT));
+	}
+
+	for (int i = 0; i < w * h; i++)
+		s_pixels[i] = Test_RandomColour();
+
+	for (int i = 0; i < 256; i++)
+		s_table[i] = Random_Xorshift_32() & 0xFF;
+
+	if (!VideoSoft_InitImage(&img, s_pixels, w, w, h)) {
+		fprintf(stderr, "iteration %ld: out of memory\n", iter);
+		return false;
+	}
+
+	Test_Fill();
+
+	switch (kernel) {
+		case TEST_BLIT:
+			VideoSoft_Blit(&s_fb, &img, x, y, flags);
+			Test_RefImage(kernel, &img, x, y, flags, 0, 0, 0, 0, 0);
+			break;
+
+		case TEST_RANGE:
+			VideoSoft_BlitRange(&s_fb, &img, x, y, flags, first, last, offset);
+			Test_RefImage(kernel, &img, x, y, flags, 0, first, last, offset, 0);
+			break;
+
+		case TEST_REMAP:
+			VideoSoft_BlitRemap(&s_fb, &img, x, y, flags, s_table);
+			Test_RefImage(kernel, &img, x, y, flags, 0, 0, 0, 0, 0);
+			break;
+
+		case TEST_TINT:
+			VideoSoft_BlitTint(&s_fb, &img, x, y, flags, c);
+			Test_RefImage(kernel, &img, x, y, flags, c, 0, 0, 0, 0);
+			break;
+
+		case TEST_SHADE:
+			VideoSoft_BlitShade(&s_fb, &img, x, y, flags, s_table);
+			Test_RefImage(kernel, &img, x, y, flags, 0, 0, 0, 0, 0);
+			break;
+
+		case TEST_BLUR: {
+			const int blurx = Test_RandomRange(0, 5);
+
+			VideoSoft_Blur(&s_fb, &img, x, y, blurx);
+			Test_RefImage(kernel, &img, x, y, 0, 0, 0, 0, 0, blurx);
+			break;
+		}
+
+		case TEST_ROTATE: {
+			const int quarter = Random_Xorshift_32() % 4;
+			const int cx = x + TEST_MAX_IMAGE / 2;
+			const int cy = y + TEST_MAX_IMAGE / 2;
+
+			VideoSoft_BlitRotate(&s_fb, &img, cx, cy, 64 * quarter, s_table, NULL);
+			Test_RefRotate(&img, cx, cy, quarter);
+			break;
+		}
+
+		case TEST_FILL_RECT:
+			VideoSoft_FillRect(&s_fb, x, y, x + w - 1, y + h - 1, c);
+
+			for (int j = y; j < y + h; j++) {
+				for (int i = x; i < x + w; i++) {
+					if (Test_InClip(i, j))
+						s_ref[j][i] = c;
+				}
+			}
+			break;
+
+		case TEST_LINE: {
+			const int x2 = Test_RandomRange(-TEST_MAX_IMAGE, TEST_WIDTH + TEST_MAX_IMAGE);
+			const int y2 = Test_RandomRange(-TEST_MAX_IMAGE, TEST_HEIGHT + TEST_MAX_IMAGE);
+
+			VideoSoft_Line(&s_fb, x, y, x2, y2, c);
+			ok = Test_RefLine(iter, x, y, x2, y2, c);
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	ok = ok && Test_Compare(iter, kernel);
+	VideoSoft_FreeImage(&img);
+	return ok;
+}
+
+/* The shading tables keep away from the colours asked to. */
+static bool
+Test_Palette(void)
+{
+	uint8 palette[3 * 256];
+	uint8 shade[256];
+	uint32 lookup[256];
+	bool avoid[256] = { false };
+
+	for (int i = 0; i < 3 * 256; i++)
+		palette[i] = Random_Xorshift_32() & 0xFF;
+
+	/* Exact matches exist for these. */
+	memset(&palette[3 * 10], 0, 3);
+	palette[3 * 20 + 0] = 0x10, palette[3 * 20 + 1] = 0x20, palette[3 * 20 + 2] = 0x30;
+	memcpy(&palette[3 * 21], &palette[3 * 20], 3);
+	avoid[20] = true;
+
+	if (VideoSoft_FindColour(palette, 0x10, 0x20, 0x30, avoid) != 21
+			|| VideoSoft_FindColour(palette, 0x10, 0x20, 0x30, NULL) != 20) {
+		fprintf(stderr, "palette: wrong closest colour\n");
+		return false;
+	}
+
+	avoid[10] = false;
+	VideoSoft_CreateShade(shade, palette, 256, avoid);
+	for (int i = 0; i < 256; i++) {
+		if (avoid[shade[i]] || (!avoid[i] && memcmp(&palette[3 * shade[i]], &palette[3 * i], 3) != 0)) {
+			fprintf(stderr, "palette: full brightness changes colour %d to %d\n", i, shade[i]);
+			return false;
+		}
+	}
+
+	VideoSoft_CreateShade(shade, palette, 0, avoid);
+	for (int i = 0; i < 256; i++) {
+		if (memcmp(&palette[3 * shade[i]], &palette[3 * 10], 3) != 0) {
+			fprintf(stderr, "palette: no brightness changes colour %d to %d\n", i, shade[i]);
+			return false;
+		}
+	}
+
+	/* Bottom-up, as with a negative pitch. */
+	VideoSoft_SetClip(&s_fb, 0, 0, TEST_WIDTH, TEST_HEIGHT);
+	VideoSoft_CreateLookup(lookup, palette);
+	Test_Fill();
+
+	uint32 *rgba = malloc(sizeof(uint32) * TEST_WIDTH * TEST_HEIGHT);
+	if (rgba == NULL)
+		return false;
+
+	VideoSoft_Convert(&s_fb, lookup, rgba + TEST_WIDTH * (TEST_HEIGHT - 1), -(int)sizeof(uint32) * TEST_WIDTH);
+
+	for (int y = 0; y < TEST_HEIGHT; y++) {
+		for (int x = 0; x < TEST_WIDTH; x++) {
+			const uint8 p = s_ref[y][x];
+			const uint32 expect = palette[3*p] | (palette[3*p + 1] << 8) | (palette[3*p + 2] << 16) | 0xFF000000;
+
+			if (rgba[TEST_WIDTH * (TEST_HEIGHT - 1 - y) + x] != expect) {
+				fprintf(stderr, "palette: pixel (%d, %d) converted wrong\n", x, y);
+				free(rgba);
+				return false;
+			}
+		}
+	}
+
+	free(rgba);
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	const long iterations = Test_ParseArgs(argc, argv, 50000);
+
+	if (!VideoSoft_InitFramebuffer(&s_fb, TEST_WIDTH, TEST_HEIGHT))
+		return EXIT_FAILURE;
+
+	for (long iter = 0; iter < iterations; iter++) {
+		if (!Test_Iteration(iter)) {
+			VideoSoft_FreeFramebuffer(&s_fb);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!Test_Palette()) {
+		VideoSoft_FreeFramebuffer(&s_fb);
+		return EXIT_FAILURE;
+	}
+
+	VideoSoft_FreeFramebuffer(&s_fb);
+	printf("test_videosoft: %ld iterations passed\n", iterations);
+	return EXIT_SUCCESS;
+}